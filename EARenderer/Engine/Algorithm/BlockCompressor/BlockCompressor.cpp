@@ -0,0 +1,221 @@
+//
+//  BlockCompressor.cpp
+//  EARenderer
+//
+//  Created by Pavlo Muratov on 17.10.2026.
+//  Copyright © 2026 MPO. All rights reserved.
+//
+
+#include "BlockCompressor.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <limits>
+#include <stdexcept>
+#include <glm/vec3.hpp>
+#include <glm/mat3x3.hpp>
+#include <glm/geometric.hpp>
+
+namespace EARenderer {
+
+    static constexpr size_t TexelsPerBlock = BlockCompressor::BlockDimension * BlockCompressor::BlockDimension;
+
+    static uint16_t PackRGB565(const glm::vec3 &color) {
+        glm::vec3 clamped = glm::clamp(color, glm::vec3(0.0f), glm::vec3(255.0f));
+        auto r = static_cast<uint16_t>(std::lround(clamped.r * 31.0f / 255.0f));
+        auto g = static_cast<uint16_t>(std::lround(clamped.g * 63.0f / 255.0f));
+        auto b = static_cast<uint16_t>(std::lround(clamped.b * 31.0f / 255.0f));
+        return (r << 11) | (g << 5) | b;
+    }
+
+    static glm::vec3 UnpackRGB565(uint16_t color) {
+        uint32_t r = (color >> 11) & 31;
+        uint32_t g = (color >> 5) & 63;
+        uint32_t b = color & 31;
+        return glm::vec3((r << 3) | (r >> 2), (g << 2) | (g >> 4), (b << 3) | (b >> 2));
+    }
+
+#pragma mark - Private helpers
+
+    void BlockCompressor::EncodeColorBlock(const uint8_t *rgbaTexels, uint8_t *block) {
+        std::array<glm::vec3, TexelsPerBlock> colors;
+        glm::vec3 mean(0.0f);
+
+        for (size_t i = 0; i < TexelsPerBlock; i++) {
+            colors[i] = glm::vec3(rgbaTexels[i * 4], rgbaTexels[i * 4 + 1], rgbaTexels[i * 4 + 2]);
+            mean += colors[i];
+        }
+        mean /= float(TexelsPerBlock);
+
+        glm::mat3 covariance(0.0f);
+        for (const glm::vec3 &color : colors) {
+            glm::vec3 d = color - mean;
+            covariance += glm::mat3(d * d.x, d * d.y, d * d.z);
+        }
+
+        // Principal axis of the block's colors by power iteration
+        glm::vec3 axis(1.0f);
+        for (size_t iteration = 0; iteration < 8; iteration++) {
+            glm::vec3 next = covariance * axis;
+            float length = glm::length(next);
+            if (length < 1e-6f) {
+                break;
+            }
+            axis = next / length;
+        }
+
+        float minProjection = std::numeric_limits<float>::max();
+        float maxProjection = std::numeric_limits<float>::lowest();
+        for (const glm::vec3 &color : colors) {
+            float projection = glm::dot(color - mean, axis);
+            minProjection = std::min(minProjection, projection);
+            maxProjection = std::max(maxProjection, projection);
+        }
+
+        // Pull endpoints slightly inwards, extremes are usually outliers of a smooth gradient
+        float inset = (maxProjection - minProjection) / 16.0f;
+        uint16_t color0 = PackRGB565(mean + axis * (maxProjection - inset));
+        uint16_t color1 = PackRGB565(mean + axis * (minProjection + inset));
+
+        // color0 > color1 selects the four color mode without transparency
+        if (color0 < color1) {
+            std::swap(color0, color1);
+        }
+
+        uint32_t indices = 0;
+
+        if (color0 != color1) {
+            glm::vec3 endpoint0 = UnpackRGB565(color0);
+            glm::vec3 endpoint1 = UnpackRGB565(color1);
+            std::array<glm::vec3, 4> palette{
+                    endpoint0, endpoint1, (endpoint0 * 2.0f + endpoint1) / 3.0f, (endpoint0 + endpoint1 * 2.0f) / 3.0f
+            };
+
+            for (size_t i = 0; i < TexelsPerBlock; i++) {
+                uint32_t bestIndex = 0;
+                float bestDistance = std::numeric_limits<float>::max();
+                for (uint32_t index = 0; index < palette.size(); index++) {
+                    glm::vec3 d = colors[i] - palette[index];
+                    float distance = glm::dot(d, d);
+                    if (distance < bestDistance) {
+                        bestDistance = distance;
+                        bestIndex = index;
+                    }
+                }
+                indices |= bestIndex << (i * 2);
+            }
+        }
+
+        block[0] = color0 & 0xFF;
+        block[1] = color0 >> 8;
+        block[2] = color1 & 0xFF;
+        block[3] = color1 >> 8;
+        for (size_t byte = 0; byte < 4; byte++) {
+            block[4 + byte] = (indices >> (byte * 8)) & 0xFF;
+        }
+    }
+
+    void BlockCompressor::EncodeChannelBlock(const uint8_t *rgbaTexels, size_t channel, uint8_t *block) {
+        uint8_t minValue = 255;
+        uint8_t maxValue = 0;
+        for (size_t i = 0; i < TexelsPerBlock; i++) {
+            minValue = std::min(minValue, rgbaTexels[i * 4 + channel]);
+            maxValue = std::max(maxValue, rgbaTexels[i * 4 + channel]);
+        }
+
+        uint64_t indices = 0;
+
+        // value0 > value1 selects the mode with six interpolated values
+        if (maxValue != minValue) {
+            std::array<float, 8> palette;
+            palette[0] = maxValue;
+            palette[1] = minValue;
+            for (size_t index = 2; index < palette.size(); index++) {
+                palette[index] = ((8 - index) * maxValue + (index - 1) * minValue) / 7.0f;
+            }
+
+            for (size_t i = 0; i < TexelsPerBlock; i++) {
+                float value = rgbaTexels[i * 4 + channel];
+                uint64_t bestIndex = 0;
+                float bestDistance = std::numeric_limits<float>::max();
+                for (uint64_t index = 0; index < palette.size(); index++) {
+                    float distance = std::abs(value - palette[index]);
+                    if (distance < bestDistance) {
+                        bestDistance = distance;
+                        bestIndex = index;
+                    }
+                }
+                indices |= bestIndex << (i * 3);
+            }
+        }
+
+        block[0] = maxValue;
+        block[1] = minValue;
+        for (size_t byte = 0; byte < 6; byte++) {
+            block[2 + byte] = (indices >> (byte * 8)) & 0xFF;
+        }
+    }
+
+#pragma mark - Public interface
+
+    size_t BlockCompressor::BlockByteSize(Format format) {
+        switch (format) {
+            case Format::BC1:
+            case Format::BC4:
+                return 8;
+            case Format::BC3:
+            case Format::BC5:
+                return 16;
+        }
+        throw std::invalid_argument("Unknown block compression format");
+    }
+
+    size_t BlockCompressor::CompressedByteSize(Format format, uint32_t width, uint32_t height) {
+        size_t blocksX = (width + BlockDimension - 1) / BlockDimension;
+        size_t blocksY = (height + BlockDimension - 1) / BlockDimension;
+        return blocksX * blocksY * BlockByteSize(format);
+    }
+
+    std::vector<uint8_t> BlockCompressor::Compress(Format format, const uint8_t *rgbaTexels, uint32_t width, uint32_t height) {
+        std::vector<uint8_t> blocks(CompressedByteSize(format, width, height));
+        std::array<uint8_t, TexelsPerBlock * 4> blockTexels;
+        uint8_t *block = blocks.data();
+
+        for (uint32_t blockY = 0; blockY < height; blockY += BlockDimension) {
+            for (uint32_t blockX = 0; blockX < width; blockX += BlockDimension) {
+
+                for (uint32_t y = 0; y < BlockDimension; y++) {
+                    for (uint32_t x = 0; x < BlockDimension; x++) {
+                        uint32_t sourceX = std::min(blockX + x, width - 1);
+                        uint32_t sourceY = std::min(blockY + y, height - 1);
+                        const uint8_t *texel = rgbaTexels + (size_t(sourceY) * width + sourceX) * 4;
+                        std::copy(texel, texel + 4, blockTexels.data() + (y * BlockDimension + x) * 4);
+                    }
+                }
+
+                switch (format) {
+                    case Format::BC1:
+                        EncodeColorBlock(blockTexels.data(), block);
+                        break;
+                    case Format::BC3:
+                        EncodeChannelBlock(blockTexels.data(), 3, block);
+                        EncodeColorBlock(blockTexels.data(), block + 8);
+                        break;
+                    case Format::BC4:
+                        EncodeChannelBlock(blockTexels.data(), 0, block);
+                        break;
+                    case Format::BC5:
+                        EncodeChannelBlock(blockTexels.data(), 0, block);
+                        EncodeChannelBlock(blockTexels.data(), 1, block + 8);
+                        break;
+                }
+
+                block += BlockByteSize(format);
+            }
+        }
+
+        return blocks;
+    }
+
+}
@@ -0,0 +1,65 @@
+//
+//  BlockCompressor.hpp
+//  EARenderer
+//
+//  Created by Pavlo Muratov on 17.10.2026.
+//  Copyright © 2026 MPO. All rights reserved.
+//
+
+#ifndef BlockCompressor_hpp
+#define BlockCompressor_hpp
+
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+
+namespace EARenderer {
+
+    // Encodes 8-bit RGBA images into BCn block compressed formats.
+    //
+    // Every 4x4 texel block is encoded independently. Colors are fit along the principal axis
+    // of the block's colors, single channels between their minimum and maximum, after which every
+    // texel picks the closest palette entry. Blocks hanging over the image edge repeat edge texels.
+
+    class BlockCompressor {
+    public:
+        enum class Format : uint32_t {
+            BC1,    // RGB, 4 bits per texel
+            BC3,    // RGBA, 8 bits per texel
+            BC4,    // R, 4 bits per texel
+            BC5     // RG, 8 bits per texel
+        };
+
+        static constexpr size_t BlockDimension = 4;
+
+    private:
+        static void EncodeColorBlock(const uint8_t *rgbaTexels, uint8_t *block);
+
+        static void EncodeChannelBlock(const uint8_t *rgbaTexels, size_t channel, uint8_t *block);
+
+    public:
+        /**
+         @return Number of bytes a single 4x4 block occupies
+         */
+        static size_t BlockByteSize(Format format);
+
+        /**
+         @return Number of bytes an image of the given dimensions occupies once compressed
+         */
+        static size_t CompressedByteSize(Format format, uint32_t width, uint32_t height);
+
+        /**
+         Compresses an image
+
+         @param format target format. Channels that the format doesn't store are ignored
+         @param rgbaTexels tightly packed rows of 4-byte texels
+         @param width image width in texels
+         @param height image height in texels
+         @return blocks in row-major order
+         */
+        static std::vector<uint8_t> Compress(Format format, const uint8_t *rgbaTexels, uint32_t width, uint32_t height);
+    };
+
+}
+
+#endif /* BlockCompressor_hpp */
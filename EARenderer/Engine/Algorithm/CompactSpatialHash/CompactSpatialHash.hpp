@@ -0,0 +1,189 @@
+//
+//  CompactSpatialHash.hpp
+//  EARenderer
+//
+//  Created by Pavlo Muratov on 17.10.2026.
+//  Copyright © 2026 MPO. All rights reserved.
+//
+
+#ifndef CompactSpatialHash_hpp
+#define CompactSpatialHash_hpp
+
+#include "AxisAlignedBox3D.hpp"
+
+#include <vector>
+#include <array>
+#include <stdexcept>
+#include <limits>
+
+#include <glm/vec3.hpp>
+
+namespace EARenderer {
+
+    // Drop-in alternative to SpatialHash tuned for frequent neighbourhood queries.
+    //
+    // Cells live in a single open addressing table with linear probing instead of
+    // a node based std::unordered_map, and objects of all cells are kept in one contiguous
+    // array where objects of the same cell are chained through indices.
+    // A neighbourhood query costs 27 probes into a flat table and no allocations.
+    //
+    // Objects are iterated in insertion order both within a cell and during whole container traversal.
+
+    template<class T>
+    class CompactSpatialHash {
+    private:
+
+#pragma mark - Nested types
+
+        static constexpr uint32_t InvalidIndex = std::numeric_limits<uint32_t>::max();
+        static constexpr uint64_t EmptyKey = std::numeric_limits<uint64_t>::max();
+
+        // Cell coordinates are packed into 16 bits each
+        static constexpr uint32_t MaximumResolution = 65536;
+
+        struct Entry {
+            T object;
+            uint32_t next = InvalidIndex;
+        };
+
+        struct Slot {
+            uint64_t key = EmptyKey;
+            uint32_t head = InvalidIndex;
+            uint32_t tail = InvalidIndex;
+        };
+
+    public:
+
+#pragma mark Range
+
+        class Range {
+        public:
+            class Iterator {
+            private:
+                friend Range;
+
+                const std::vector<Entry> *mEntries = nullptr;
+                std::array<uint32_t, 27> mCellHeads;
+                size_t mCellCount = 0;
+                size_t mCurrentCell = 0;
+                uint32_t mCurrentEntry = InvalidIndex;
+
+                Iterator(const std::vector<Entry> *entries, const std::array<uint32_t, 27> &cellHeads, size_t cellCount, bool end);
+
+            public:
+                Iterator &operator++();
+
+                const T &operator*() const;
+
+                const T *operator->() const;
+
+                bool operator!=(const Iterator &other) const;
+            };
+
+        private:
+            friend CompactSpatialHash;
+
+            const std::vector<Entry> *mEntries;
+            std::array<uint32_t, 27> mCellHeads;
+            size_t mCellCount;
+
+            Range(const std::vector<Entry> *entries, const std::array<uint32_t, 27> &cellHeads, size_t cellCount);
+
+        public:
+            Iterator begin() const;
+
+            Iterator end() const;
+        };
+
+#pragma mark Forward iterator
+
+        class ForwardIterator {
+        private:
+            friend CompactSpatialHash;
+
+            using EntryIterator = typename std::vector<Entry>::iterator;
+
+            EntryIterator mEntryIterator;
+
+            ForwardIterator(EntryIterator i);
+
+        public:
+            ForwardIterator &operator++();
+
+            T &operator*();
+
+            T *operator->();
+
+            const T &operator*() const;
+
+            const T *operator->() const;
+
+            bool operator!=(const ForwardIterator &other) const;
+        };
+
+    private:
+
+#pragma mark - Member variables
+
+        std::vector<Slot> mSlots;
+        std::vector<Entry> mEntries;
+        size_t mOccupiedSlotCount = 0;
+        AxisAlignedBox3D mBoundaries;
+        uint32_t mResolution;
+
+        // (resolution - 1) / extent along each axis, zero for degenerate axes
+        glm::vec3 mCellsPerUnit;
+
+#pragma mark - Member functions
+
+        uint64_t cellKey(uint16_t x, uint16_t y, uint16_t z) const;
+
+        glm::ivec3 cellCoordinates(const glm::vec3 &position) const;
+
+        size_t slotIndex(uint64_t key) const;
+
+        const Slot *findSlot(uint64_t key) const;
+
+        Slot &findOrCreateSlot(uint64_t key);
+
+        void rehash(size_t slotCount);
+
+    public:
+
+#pragma mark - Lifecycle
+
+        CompactSpatialHash(const AxisAlignedBox3D &boundaries, uint32_t resolution);
+
+#pragma mark - Modifiers
+
+        void insert(const T &object, const glm::vec3 &position);
+
+        /**
+         Preallocates storage for the specified number of objects
+
+         @param objectCount expected number of objects
+         */
+        void reserve(size_t objectCount);
+
+#pragma mark - Queries
+
+        /**
+         @param position point inside hash's boundaries
+         @return objects from the cell containing the position and from the 26 cells around it
+         */
+        Range neighbours(const glm::vec3 &position) const;
+
+        size_t size() const;
+
+#pragma mark - Iteration
+
+        ForwardIterator begin();
+
+        ForwardIterator end();
+    };
+
+}
+
+#include "CompactSpatialHashImpl.hpp"
+
+#endif /* CompactSpatialHash_hpp */
@@ -0,0 +1,312 @@
+//
+//  CompactSpatialHashImpl.hpp
+//  EARenderer
+//
+//  Created by Pavlo Muratov on 17.10.2026.
+//  Copyright © 2026 MPO. All rights reserved.
+//
+
+#ifndef CompactSpatialHashImpl_hpp
+#define CompactSpatialHashImpl_hpp
+
+#include <glm/common.hpp>
+
+namespace EARenderer {
+
+#pragma mark - Lifecycle
+
+    template<typename T>
+    CompactSpatialHash<T>::CompactSpatialHash(const AxisAlignedBox3D &boundaries, uint32_t resolution)
+            :
+            mBoundaries(boundaries),
+            mResolution(resolution) {
+
+        if (resolution == 0 || resolution > MaximumResolution) {
+            throw std::invalid_argument("Spatial hash resolution must be in [1, 65536] range");
+        }
+
+        for (int32_t axis = 0; axis < 3; axis++) {
+            float delta = mBoundaries.max[axis] - mBoundaries.min[axis];
+            mCellsPerUnit[axis] = fabs(delta) < 1e-09 ? 0.0 : (mResolution - 1) / delta;
+        }
+
+        rehash(64);
+    }
+
+#pragma mark - Private helpers
+
+    template<typename T>
+    uint64_t
+    CompactSpatialHash<T>::cellKey(uint16_t x, uint16_t y, uint16_t z) const {
+        return uint64_t(x) | (uint64_t(y) << 16) | (uint64_t(z) << 32);
+    }
+
+    template<typename T>
+    glm::ivec3
+    CompactSpatialHash<T>::cellCoordinates(const glm::vec3 &position) const {
+        glm::ivec3 coordinates((position - mBoundaries.min) * mCellsPerUnit);
+        return glm::clamp(coordinates, glm::ivec3(0), glm::ivec3(int32_t(mResolution) - 1));
+    }
+
+    template<typename T>
+    size_t
+    CompactSpatialHash<T>::slotIndex(uint64_t key) const {
+        // Fibonacci hashing spreads neighbouring cells across the table
+        return (key * 0x9E3779B97F4A7C15ull) >> 32 & (mSlots.size() - 1);
+    }
+
+    template<typename T>
+    const typename CompactSpatialHash<T>::Slot *
+    CompactSpatialHash<T>::findSlot(uint64_t key) const {
+        size_t mask = mSlots.size() - 1;
+        for (size_t i = slotIndex(key);; i = (i + 1) & mask) {
+            const Slot &slot = mSlots[i];
+            if (slot.key == key) {
+                return &slot;
+            }
+            if (slot.key == EmptyKey) {
+                return nullptr;
+            }
+        }
+    }
+
+    template<typename T>
+    typename CompactSpatialHash<T>::Slot &
+    CompactSpatialHash<T>::findOrCreateSlot(uint64_t key) {
+        // Keep load factor under 0.5 to have short probe sequences
+        if ((mOccupiedSlotCount + 1) * 2 > mSlots.size()) {
+            rehash(mSlots.size() * 2);
+        }
+
+        size_t mask = mSlots.size() - 1;
+        for (size_t i = slotIndex(key);; i = (i + 1) & mask) {
+            Slot &slot = mSlots[i];
+            if (slot.key == key) {
+                return slot;
+            }
+            if (slot.key == EmptyKey) {
+                slot.key = key;
+                mOccupiedSlotCount++;
+                return slot;
+            }
+        }
+    }
+
+    template<typename T>
+    void
+    CompactSpatialHash<T>::rehash(size_t slotCount) {
+        std::vector<Slot> oldSlots(slotCount);
+        std::swap(oldSlots, mSlots);
+
+        size_t mask = mSlots.size() - 1;
+        for (const Slot &oldSlot : oldSlots) {
+            if (oldSlot.key == EmptyKey) {
+                continue;
+            }
+            size_t i = slotIndex(oldSlot.key);
+            while (mSlots[i].key != EmptyKey) {
+                i = (i + 1) & mask;
+            }
+            mSlots[i] = oldSlot;
+        }
+    }
+
+#pragma mark - Modifiers
+
+    template<typename T>
+    void
+    CompactSpatialHash<T>::insert(const T &object, const glm::vec3 &position) {
+        if (!mBoundaries.contains(position)) {
+            throw std::out_of_range("Attempt to insert an object outside of spatial hash's boundaries");
+        }
+
+        glm::ivec3 cell = cellCoordinates(position);
+        Slot &slot = findOrCreateSlot(cellKey(cell.x, cell.y, cell.z));
+
+        uint32_t entryIndex = (uint32_t) mEntries.size();
+        mEntries.push_back({object, InvalidIndex});
+
+        if (slot.head == InvalidIndex) {
+            slot.head = entryIndex;
+        } else {
+            mEntries[slot.tail].next = entryIndex;
+        }
+        slot.tail = entryIndex;
+    }
+
+    template<typename T>
+    void
+    CompactSpatialHash<T>::reserve(size_t objectCount) {
+        mEntries.reserve(objectCount);
+    }
+
+#pragma mark - Queries
+
+    template<typename T>
+    typename CompactSpatialHash<T>::Range
+    CompactSpatialHash<T>::neighbours(const glm::vec3 &position) const {
+        glm::ivec3 center = cellCoordinates(position);
+        glm::ivec3 min = glm::max(center - 1, glm::ivec3(0));
+        glm::ivec3 max = glm::min(center + 1, glm::ivec3(int32_t(mResolution) - 1));
+
+        std::array<uint32_t, 27> cellHeads;
+        size_t cellCount = 0;
+
+        for (int32_t x = min.x; x <= max.x; ++x) {
+            for (int32_t y = min.y; y <= max.y; ++y) {
+                for (int32_t z = min.z; z <= max.z; ++z) {
+                    const Slot *slot = findSlot(cellKey(x, y, z));
+                    if (slot) {
+                        cellHeads[cellCount] = slot->head;
+                        cellCount++;
+                    }
+                }
+            }
+        }
+
+        return Range(&mEntries, cellHeads, cellCount);
+    }
+
+    template<typename T>
+    size_t
+    CompactSpatialHash<T>::size() const {
+        return mEntries.size();
+    }
+
+#pragma mark - Iteration
+
+    template<typename T>
+    typename CompactSpatialHash<T>::ForwardIterator
+    CompactSpatialHash<T>::begin() {
+        return ForwardIterator(mEntries.begin());
+    }
+
+    template<typename T>
+    typename CompactSpatialHash<T>::ForwardIterator
+    CompactSpatialHash<T>::end() {
+        return ForwardIterator(mEntries.end());
+    }
+
+#pragma mark - Range
+
+    template<typename T>
+    CompactSpatialHash<T>::Range::Range(const std::vector<Entry> *entries, const std::array<uint32_t, 27> &cellHeads, size_t cellCount)
+            :
+            mEntries(entries),
+            mCellHeads(cellHeads),
+            mCellCount(cellCount) {
+    }
+
+    template<typename T>
+    typename CompactSpatialHash<T>::Range::Iterator
+    CompactSpatialHash<T>::Range::begin() const {
+        return Iterator(mEntries, mCellHeads, mCellCount, false);
+    }
+
+    template<typename T>
+    typename CompactSpatialHash<T>::Range::Iterator
+    CompactSpatialHash<T>::Range::end() const {
+        return Iterator(mEntries, mCellHeads, mCellCount, true);
+    }
+
+#pragma mark - Range iterator
+
+    template<typename T>
+    CompactSpatialHash<T>::Range::Iterator::Iterator(const std::vector<Entry> *entries, const std::array<uint32_t, 27> &cellHeads, size_t cellCount, bool end)
+            :
+            mEntries(entries),
+            mCellHeads(cellHeads),
+            mCellCount(cellCount),
+            mCurrentCell(end ? cellCount : 0) {
+
+        // Every registered cell holds at least one object, so the first entry of the first cell is the beginning
+        if (!end && cellCount > 0) {
+            mCurrentEntry = mCellHeads[0];
+        }
+    }
+
+    template<typename T>
+    typename CompactSpatialHash<T>::Range::Iterator &
+    CompactSpatialHash<T>::Range::Iterator::operator++() {
+        if (mCurrentCell == mCellCount) {
+            throw std::out_of_range("Incrementing an iterator which had reached the end already");
+        }
+
+        mCurrentEntry = (*mEntries)[mCurrentEntry].next;
+
+        if (mCurrentEntry == InvalidIndex) {
+            mCurrentCell++;
+            if (mCurrentCell < mCellCount) {
+                mCurrentEntry = mCellHeads[mCurrentCell];
+            }
+        }
+
+        return *this;
+    }
+
+    template<typename T>
+    const T &
+    CompactSpatialHash<T>::Range::Iterator::operator*() const {
+        return (*mEntries)[mCurrentEntry].object;
+    }
+
+    template<typename T>
+    const T *
+    CompactSpatialHash<T>::Range::Iterator::operator->() const {
+        return &(*mEntries)[mCurrentEntry].object;
+    }
+
+    template<typename T>
+    bool
+    CompactSpatialHash<T>::Range::Iterator::operator!=(const Iterator &other) const {
+        return mCurrentCell != other.mCurrentCell || mCurrentEntry != other.mCurrentEntry;
+    }
+
+#pragma mark - Forward iterator
+
+    template<typename T>
+    CompactSpatialHash<T>::ForwardIterator::ForwardIterator(EntryIterator i)
+            :
+            mEntryIterator(i) {
+    }
+
+    template<typename T>
+    typename CompactSpatialHash<T>::ForwardIterator &
+    CompactSpatialHash<T>::ForwardIterator::operator++() {
+        ++mEntryIterator;
+        return *this;
+    }
+
+    template<typename T>
+    T &
+    CompactSpatialHash<T>::ForwardIterator::operator*() {
+        return mEntryIterator->object;
+    }
+
+    template<typename T>
+    T *
+    CompactSpatialHash<T>::ForwardIterator::operator->() {
+        return &mEntryIterator->object;
+    }
+
+    template<typename T>
+    const T &
+    CompactSpatialHash<T>::ForwardIterator::operator*() const {
+        return mEntryIterator->object;
+    }
+
+    template<typename T>
+    const T *
+    CompactSpatialHash<T>::ForwardIterator::operator->() const {
+        return &mEntryIterator->object;
+    }
+
+    template<typename T>
+    bool
+    CompactSpatialHash<T>::ForwardIterator::operator!=(const ForwardIterator &other) const {
+        return mEntryIterator != other.mEntryIterator;
+    }
+
+}
+
+#endif /* CompactSpatialHashImpl_hpp */
@@ -9,11 +9,28 @@
 #include "EmbreeRayTracer.hpp"
 
 #include <stdio.h>
+#include <algorithm>
 
 namespace EARenderer {
 
 #pragma mark - Lifecycle
 
+    EmbreeRayTracer::IntersectContext::IntersectContext(FaceFilter faceFilter)
+            : faceFilter(faceFilter) {
+        rtcInitIntersectContext(&context);
+    }
+
+    EmbreeRayTracer::EmbreeRayTracer()
+            : mDevice(rtcNewDevice(nullptr)), mScene(rtcNewScene(mDevice)) {
+
+        // Instance transforms may change, in which case only the top level hierarchy is refitted
+        rtcSetSceneFlags(mScene, RTCSceneFlags(RTC_SCENE_FLAG_ROBUST | RTC_SCENE_FLAG_DYNAMIC));
+        rtcSetSceneBuildQuality(mScene, RTC_BUILD_QUALITY_LOW);
+
+        deviceErrorCallback(this, rtcGetDeviceError(mDevice), "");
+        rtcSetDeviceErrorFunction(mDevice, deviceErrorCallback, this);
+    }
+
     EmbreeRayTracer::EmbreeRayTracer(const std::vector<Triangle3D> &triangles)
             : mDevice(rtcNewDevice(nullptr)), mScene(rtcNewScene(mDevice)) {
 
@@ -46,9 +63,7 @@ namespace EARenderer {
             }
         }
 
-        rtcSetGeometryUserData(geometry, this);
-        rtcSetGeometryIntersectFilterFunction(geometry, intersectionFilter);
-        rtcSetGeometryOccludedFilterFunction(geometry, intersectionFilter);
+        setupGeometry(geometry);
 
         rtcCommitGeometry(geometry);
         rtcAttachGeometry(mScene, geometry);
@@ -65,6 +80,9 @@ namespace EARenderer {
     }
 
     EmbreeRayTracer::~EmbreeRayTracer() {
+        for (RTCScene prototype : mPrototypes) {
+            rtcReleaseScene(prototype);
+        }
         rtcReleaseScene(mScene);
         rtcReleaseDevice(mDevice);
     }
@@ -81,44 +99,118 @@ namespace EARenderer {
     void EmbreeRayTracer::swap(EmbreeRayTracer &that) {
         std::swap(mDevice, that.mDevice);
         std::swap(mScene, that.mScene);
+        std::swap(mPrototypes, that.mPrototypes);
     }
 
     void swap(EmbreeRayTracer &lhs, EmbreeRayTracer &rhs) {
         lhs.swap(rhs);
     }
 
+#pragma mark - Scene construction
+
+    void EmbreeRayTracer::setupGeometry(RTCGeometry geometry) {
+        rtcSetGeometryIntersectFilterFunction(geometry, intersectionFilter);
+        rtcSetGeometryOccludedFilterFunction(geometry, intersectionFilter);
+    }
+
+    uint32_t EmbreeRayTracer::addGeometry(const void *vertices, size_t vertexStride, size_t vertexCount, const uint32_t *indices, size_t triangleCount) {
+        RTCGeometry geometry = rtcNewGeometry(mDevice, RTC_GEOMETRY_TYPE_TRIANGLE);
+
+        rtcSetSharedGeometryBuffer(geometry, RTC_BUFFER_TYPE_VERTEX, 0, RTC_FORMAT_FLOAT3, vertices, 0, vertexStride, vertexCount);
+
+        if (indices) {
+            rtcSetSharedGeometryBuffer(geometry, RTC_BUFFER_TYPE_INDEX, 0, RTC_FORMAT_UINT3, indices, 0, sizeof(glm::uvec3), triangleCount);
+        } else {
+            glm::uvec3 *indexBuffer = (glm::uvec3 *) rtcSetNewGeometryBuffer(geometry,
+                    RTC_BUFFER_TYPE_INDEX,
+                    0,
+                    RTC_FORMAT_UINT3,
+                    sizeof(glm::uvec3),
+                    triangleCount);
+
+            if (indexBuffer) {
+                for (uint32_t i = 0; i < triangleCount; ++i) {
+                    indexBuffer[i] = glm::uvec3(i * 3, i * 3 + 1, i * 3 + 2);
+                }
+            }
+        }
+
+        setupGeometry(geometry);
+        rtcCommitGeometry(geometry);
+
+        RTCScene prototype = rtcNewScene(mDevice);
+        rtcSetSceneFlags(prototype, RTC_SCENE_FLAG_ROBUST);
+        rtcAttachGeometry(prototype, geometry);
+        rtcReleaseGeometry(geometry);
+        rtcCommitScene(prototype);
+
+        mPrototypes.push_back(prototype);
+
+        return (uint32_t) mPrototypes.size() - 1;
+    }
+
+    uint32_t EmbreeRayTracer::addInstance(uint32_t geometryID, const glm::mat4 &transform) {
+        RTCGeometry instance = rtcNewGeometry(mDevice, RTC_GEOMETRY_TYPE_INSTANCE);
+        rtcSetGeometryInstancedScene(instance, mPrototypes.at(geometryID));
+        rtcSetGeometryBuildQuality(instance, RTC_BUILD_QUALITY_REFIT);
+        rtcSetGeometryTransform(instance, 0, RTC_FORMAT_FLOAT4X4_COLUMN_MAJOR, &transform);
+        rtcCommitGeometry(instance);
+
+        uint32_t instanceID = rtcAttachGeometry(mScene, instance);
+        rtcReleaseGeometry(instance);
+
+        return instanceID;
+    }
+
+    void EmbreeRayTracer::setInstanceTransform(uint32_t instanceID, const glm::mat4 &transform) {
+        RTCGeometry instance = rtcGetGeometry(mScene, instanceID);
+        rtcSetGeometryTransform(instance, 0, RTC_FORMAT_FLOAT4X4_COLUMN_MAJOR, &transform);
+        rtcCommitGeometry(instance);
+    }
+
+    void EmbreeRayTracer::commit() {
+        rtcCommitScene(mScene);
+    }
+
 #pragma mark - Callbacks
 
-    void EmbreeRayTracer::deviceErrorCallback(void *userPtr, enum RTCError code, const char *str) {
+    void EmbreeRayTracer::deviceErrorCallback(void *, enum RTCError code, const char *str) {
         if (code == RTC_ERROR_NONE) {return;}
         printf("Embree device error detected: \ncode: %d, message: %s \n", code, str);
     }
 
     void EmbreeRayTracer::intersectionFilter(const struct RTCFilterFunctionNArguments *args) {
-        EmbreeRayTracer *thisPtr = reinterpret_cast<EmbreeRayTracer *>(args->geometryUserPtr);
-
-        if (thisPtr->mFaceFilter == FaceFilter::None) return;
-
-        glm::vec3 triangleNormal(RTCHitN_Ng_x(args->hit, args->N, 0),
-                RTCHitN_Ng_y(args->hit, args->N, 0),
-                RTCHitN_Ng_z(args->hit, args->N, 0));
-
-        glm::vec3 rayDirection(RTCRayN_dir_x(args->ray, args->N, 0),
-                RTCRayN_dir_y(args->ray, args->N, 0),
-                RTCRayN_dir_z(args->ray, args->N, 0));
-
-        float dot = glm::dot(triangleNormal, rayDirection);
-        bool vectorsPointingInSameHemisphere = dot > 0.0;
-
-        switch (thisPtr->mFaceFilter) {
-            case FaceFilter::CullFront:
-                args->valid[0] = vectorsPointingInSameHemisphere ? -1 : 0;
-                break;
-            case FaceFilter::CullBack:
-                args->valid[0] = vectorsPointingInSameHemisphere ? 0 : -1;
-                break;
-            default:
-                break;
+        const IntersectContext *context = reinterpret_cast<const IntersectContext *>(args->context);
+
+        FaceFilter faceFilter = context->faceFilter;
+
+        if (faceFilter == FaceFilter::None) return;
+
+        // Packet queries invoke the filter for several rays at once, inactive lanes are marked with 0
+        for (unsigned int i = 0; i < args->N; i++) {
+            if (args->valid[i] != -1) continue;
+
+            glm::vec3 triangleNormal(RTCHitN_Ng_x(args->hit, args->N, i),
+                    RTCHitN_Ng_y(args->hit, args->N, i),
+                    RTCHitN_Ng_z(args->hit, args->N, i));
+
+            glm::vec3 rayDirection(RTCRayN_dir_x(args->ray, args->N, i),
+                    RTCRayN_dir_y(args->ray, args->N, i),
+                    RTCRayN_dir_z(args->ray, args->N, i));
+
+            float dot = glm::dot(triangleNormal, rayDirection);
+            bool vectorsPointingInSameHemisphere = dot > 0.0;
+
+            switch (faceFilter) {
+                case FaceFilter::CullFront:
+                    args->valid[i] = vectorsPointingInSameHemisphere ? -1 : 0;
+                    break;
+                case FaceFilter::CullBack:
+                    args->valid[i] = vectorsPointingInSameHemisphere ? 0 : -1;
+                    break;
+                default:
+                    break;
+            }
         }
     }
 
@@ -129,12 +221,9 @@ namespace EARenderer {
             const glm::vec3 &p1,
             float p0OffsetFactor,
             float p1OffsetFactor,
-            FaceFilter faceFilter) {
+            FaceFilter faceFilter) const {
 
-        RTCIntersectContext context;
-        rtcInitIntersectContext(&context);
-
-        mFaceFilter = faceFilter;
+        IntersectContext context(faceFilter);
 
         p0OffsetFactor = std::clamp(p0OffsetFactor, 0.0f, 1.0f);
         p1OffsetFactor = std::clamp(p1OffsetFactor, 0.0f, 1.0f);
@@ -152,7 +241,7 @@ namespace EARenderer {
         ray.tfar = 1.0 - p1OffsetFactor;
         ray.flags = 0;
 
-        rtcOccluded1(mScene, &context, &ray);
+        rtcOccluded1(mScene, &context.context, &ray);
 
         // When no intersection is found, the ray data is not updated.
         // In case a hit was found, the tfar component of the ray is set to -inf.
@@ -160,11 +249,8 @@ namespace EARenderer {
         return ray.tfar < 0.0;
     }
 
-    bool EmbreeRayTracer::rayHit(const Ray3D &ray, float &distance, FaceFilter faceFilter) {
-        RTCIntersectContext context;
-        rtcInitIntersectContext(&context);
-
-        mFaceFilter = faceFilter;
+    bool EmbreeRayTracer::rayHit(const Ray3D &ray, float &distance, FaceFilter faceFilter) const {
+        IntersectContext context(faceFilter);
 
         RTCRayHit rayHit;
 
@@ -182,11 +268,120 @@ namespace EARenderer {
         rayHit.hit.instID[0] = RTC_INVALID_GEOMETRY_ID;
         rayHit.hit.geomID = RTC_INVALID_GEOMETRY_ID;
 
-        rtcIntersect1(mScene, &context, &rayHit);
+        rtcIntersect1(mScene, &context.context, &rayHit);
 
         distance = rayHit.ray.tfar;
 
         return rayHit.hit.geomID != RTC_INVALID_GEOMETRY_ID;
     }
 
+#pragma mark - Batched queries
+
+    void EmbreeRayTracer::lineSegmentsOccluded(
+            const std::vector<LineSegment> &segments,
+            std::vector<bool> &occluded,
+            float p0OffsetFactor,
+            float p1OffsetFactor,
+            FaceFilter faceFilter) const {
+
+        occluded.assign(segments.size(), false);
+
+        IntersectContext context(faceFilter);
+        context.context.flags = RTC_INTERSECT_CONTEXT_FLAG_COHERENT;
+
+        p0OffsetFactor = std::clamp(p0OffsetFactor, 0.0f, 1.0f);
+        p1OffsetFactor = std::clamp(p1OffsetFactor, 0.0f, 1.0f);
+
+        alignas(64) int valid[PacketSize];
+        RTCRay16 packet;
+
+        for (size_t packetStart = 0; packetStart < segments.size(); packetStart += PacketSize) {
+            size_t packetEnd = std::min(packetStart + PacketSize, segments.size());
+
+            for (size_t lane = 0; lane < PacketSize; lane++) {
+                size_t segmentIndex = packetStart + lane;
+
+                if (segmentIndex >= packetEnd) {
+                    valid[lane] = 0;
+                    continue;
+                }
+
+                const LineSegment &segment = segments[segmentIndex];
+                glm::vec3 direction = segment.p1 - segment.p0;
+
+                valid[lane] = -1;
+                packet.org_x[lane] = segment.p0.x;
+                packet.org_y[lane] = segment.p0.y;
+                packet.org_z[lane] = segment.p0.z;
+                packet.dir_x[lane] = direction.x;
+                packet.dir_y[lane] = direction.y;
+                packet.dir_z[lane] = direction.z;
+                packet.tnear[lane] = p0OffsetFactor;
+                packet.tfar[lane] = 1.0 - p1OffsetFactor;
+                packet.time[lane] = 0.0;
+                packet.mask[lane] = -1;
+                packet.flags[lane] = 0;
+            }
+
+            rtcOccluded16(valid, mScene, &context.context, &packet);
+
+            for (size_t i = packetStart; i < packetEnd; i++) {
+                occluded[i] = packet.tfar[i - packetStart] < 0.0;
+            }
+        }
+    }
+
+    size_t EmbreeRayTracer::raysHit(const std::vector<Ray3D> &rays, std::vector<float> &distances, FaceFilter faceFilter) const {
+        distances.assign(rays.size(), std::numeric_limits<float>::max());
+
+        IntersectContext context(faceFilter);
+
+        size_t hitCount = 0;
+        alignas(64) int valid[PacketSize];
+        RTCRayHit16 packet;
+
+        for (size_t packetStart = 0; packetStart < rays.size(); packetStart += PacketSize) {
+            size_t packetEnd = std::min(packetStart + PacketSize, rays.size());
+
+            for (size_t lane = 0; lane < PacketSize; lane++) {
+                size_t rayIndex = packetStart + lane;
+
+                if (rayIndex >= packetEnd) {
+                    valid[lane] = 0;
+                    continue;
+                }
+
+                const Ray3D &ray = rays[rayIndex];
+
+                valid[lane] = -1;
+                packet.ray.org_x[lane] = ray.origin.x;
+                packet.ray.org_y[lane] = ray.origin.y;
+                packet.ray.org_z[lane] = ray.origin.z;
+                packet.ray.dir_x[lane] = ray.direction.x;
+                packet.ray.dir_y[lane] = ray.direction.y;
+                packet.ray.dir_z[lane] = ray.direction.z;
+                packet.ray.tnear[lane] = 0.0f;
+                packet.ray.tfar[lane] = std::numeric_limits<float>::max();
+                packet.ray.time[lane] = 0.0f;
+                packet.ray.mask[lane] = -1;
+                packet.ray.flags[lane] = 0;
+
+                packet.hit.instID[0][lane] = RTC_INVALID_GEOMETRY_ID;
+                packet.hit.geomID[lane] = RTC_INVALID_GEOMETRY_ID;
+            }
+
+            rtcIntersect16(valid, mScene, &context.context, &packet);
+
+            for (size_t i = packetStart; i < packetEnd; i++) {
+                size_t lane = i - packetStart;
+                if (packet.hit.geomID[lane] != RTC_INVALID_GEOMETRY_ID) {
+                    distances[i] = packet.ray.tfar[lane];
+                    hitCount++;
+                }
+            }
+        }
+
+        return hitCount;
+    }
+
 }
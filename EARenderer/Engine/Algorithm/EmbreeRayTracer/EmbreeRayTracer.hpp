@@ -14,29 +14,58 @@
 
 #include <vector>
 #include <glm/vec3.hpp>
+#include <glm/mat4x4.hpp>
 #include <rtcore.h>
 
 namespace EARenderer {
 
+    // All query functions are safe to be called concurrently from any number of threads.
+    // Each query carries its settings in its own intersection context and doesn't modify the tracer.
+    // Construction, move and assignment are not thread safe.
+
     class EmbreeRayTracer {
     public:
         enum class FaceFilter {
             None, CullFront, CullBack
         };
 
+        struct LineSegment {
+            glm::vec3 p0;
+            glm::vec3 p1;
+        };
+
     private:
+        // Width of ray packets used by batched queries
+        static constexpr size_t PacketSize = 16;
+
+        // Embree passes the context pointer to filter functions as is,
+        // which makes it a natural carrier for per-query settings.
+        // RTCIntersectContext must stay the first member.
+        struct IntersectContext {
+            RTCIntersectContext context;
+            FaceFilter faceFilter;
+
+            IntersectContext(FaceFilter faceFilter);
+        };
+
         RTCDevice mDevice = nullptr;
         RTCScene mScene = nullptr;
 
-        FaceFilter mFaceFilter;
+        // Scenes holding a single geometry each, referenced by instances attached to mScene
+        std::vector<RTCScene> mPrototypes;
 
-        static void deviceErrorCallback(void *userPtr, enum RTCError code, const char *str);
+        void setupGeometry(RTCGeometry geometry);
 
-        static void intersectionFilter(const struct RTCFilterFunctionNArguments *args);
+        static void deviceErrorCallback(void *, enum RTCError code, const char *str);
 
-        static void occlusionFilter(const struct RTCFilterFunctionNArguments *args);
+        static void intersectionFilter(const struct RTCFilterFunctionNArguments *args);
 
     public:
+        /**
+         Creates an empty ray tracer to be populated with addGeometry() and addInstance() and then committed
+         */
+        EmbreeRayTracer();
+
         EmbreeRayTracer(const std::vector<Triangle3D> &triangles);
 
         EmbreeRayTracer(const EmbreeRayTracer &that) = delete;
@@ -49,6 +78,42 @@ namespace EARenderer {
 
         void swap(EmbreeRayTracer &that);
 
+        /**
+         Creates geometry which can be placed into the scene any number of times through addInstance().
+         Vertex and index data are not copied and must outlive the ray tracer.
+
+         @param vertices pointer to the position of the first vertex. Positions are expected to be 3 consecutive floats.
+         @param vertexStride distance in bytes between positions of adjacent vertices
+         @param vertexCount number of vertices
+         @param indices 3 indices per triangle. If null, every 3 consecutive vertices form a triangle.
+         @param triangleCount number of triangles
+         @return identifier of the created geometry
+         */
+        uint32_t addGeometry(const void *vertices, size_t vertexStride, size_t vertexCount, const uint32_t *indices, size_t triangleCount);
+
+        /**
+         Places previously created geometry into the scene
+
+         @param geometryID identifier returned by addGeometry()
+         @param transform object to world transformation
+         @return identifier of the instance
+         */
+        uint32_t addInstance(uint32_t geometryID, const glm::mat4 &transform);
+
+        /**
+         Moves an instance. Takes effect after commit(), which only refits the top level hierarchy.
+
+         @param instanceID identifier returned by addInstance()
+         @param transform new object to world transformation
+         */
+        void setInstanceTransform(uint32_t instanceID, const glm::mat4 &transform);
+
+        /**
+         Builds or refits acceleration structures. Must be called after the scene has been modified
+         and before any queries are issued.
+         */
+        void commit();
+
         ///
         /// @param p0 line segment start
         /// @param p1 line segment end
@@ -66,9 +131,36 @@ namespace EARenderer {
                 float p0OffsetFactor = 0.0f,
                 float p1OffsetFactor = 0.0f,
                 FaceFilter faceFilter = FaceFilter::None
-        );
+        ) const;
+
+        bool rayHit(const Ray3D &ray, float &distance, FaceFilter faceFilter = FaceFilter::None) const;
+
+        ///
+        /// Batched version of lineSegmentOccluded(). Segments are traced in packets of 16,
+        /// which is considerably faster than issuing them one by one.
+        ///
+        /// @param segments line segments to be tested
+        /// @param occluded receives occlusion flags, one per segment, in the same order
+        /// @param p0OffsetFactor same as in lineSegmentOccluded(), applied to every segment
+        /// @param p1OffsetFactor same as in lineSegmentOccluded(), applied to every segment
+        /// @param faceFilter indicates which faces should be ignored during ray tracing, applied to every segment
+        void lineSegmentsOccluded(
+                const std::vector<LineSegment> &segments,
+                std::vector<bool> &occluded,
+                float p0OffsetFactor = 0.0f,
+                float p1OffsetFactor = 0.0f,
+                FaceFilter faceFilter = FaceFilter::None
+        ) const;
 
-        bool rayHit(const Ray3D &ray, float &distance, FaceFilter faceFilter = FaceFilter::None);
+        ///
+        /// Batched version of rayHit(). Rays are traced in packets of 16.
+        ///
+        /// @param rays rays to be traced
+        /// @param distances receives hit distances, one per ray, in the same order.
+        /// Rays that didn't hit anything get std::numeric_limits<float>::max()
+        /// @param faceFilter indicates which faces should be ignored during ray tracing, applied to every ray
+        /// @return number of rays that hit geometry
+        size_t raysHit(const std::vector<Ray3D> &rays, std::vector<float> &distances, FaceFilter faceFilter = FaceFilter::None) const;
     };
 
     void swap(EmbreeRayTracer &lhs, EmbreeRayTracer &rhs);
@@ -0,0 +1,67 @@
+//
+//  FenwickTree.hpp
+//  EARenderer
+//
+//  Created by Pavlo Muratov on 17.10.2026.
+//  Copyright © 2026 MPO. All rights reserved.
+//
+
+#ifndef FenwickTree_hpp
+#define FenwickTree_hpp
+
+#include <vector>
+#include <cstddef>
+#include <stdexcept>
+
+namespace EARenderer {
+
+    // Binary indexed tree (Fenwick, "A New Data Structure for Cumulative Frequency Tables").
+    // Keeps prefix sums of an array of non-negative values under point updates,
+    // both updates and prefix queries are O(log n).
+
+    template<typename T>
+    class FenwickTree {
+    private:
+        /// 1-based, node i holds the sum of values (i - lowbit(i), i]
+        std::vector<T> mNodes;
+        std::vector<T> mValues;
+        size_t mHighestPowerOfTwo = 0;
+
+    public:
+        FenwickTree() = default;
+
+        explicit FenwickTree(size_t size);
+
+        size_t size() const;
+
+        const T &value(size_t index) const;
+
+        /**
+         @return sum of all values
+         */
+        T total() const;
+
+        /**
+         @return sum of values in [0, index)
+         */
+        T prefixSum(size_t index) const;
+
+        void add(size_t index, T delta);
+
+        void set(size_t index, T value);
+
+        /**
+         Finds the value a cumulative weight falls into, which turns the tree into a sampler
+         of indices with probability proportional to their values.
+
+         @param target weight in [0, total())
+         @return smallest index whose inclusive prefix sum exceeds target, size() if there is none
+         */
+        size_t upperBound(T target) const;
+    };
+
+}
+
+#include "FenwickTreeImpl.hpp"
+
+#endif /* FenwickTree_hpp */
@@ -0,0 +1,108 @@
+//
+//  FenwickTreeImpl.hpp
+//  EARenderer
+//
+//  Created by Pavlo Muratov on 17.10.2026.
+//  Copyright © 2026 MPO. All rights reserved.
+//
+
+#ifndef FenwickTreeImpl_hpp
+#define FenwickTreeImpl_hpp
+
+#include "StringUtils.hpp"
+
+namespace EARenderer {
+
+#pragma mark - Lifecycle
+
+    template<typename T>
+    FenwickTree<T>::FenwickTree(size_t size)
+            :
+            mNodes(size + 1, T(0)),
+            mValues(size, T(0)) {
+        mHighestPowerOfTwo = 1;
+        while (mHighestPowerOfTwo * 2 <= size) {
+            mHighestPowerOfTwo *= 2;
+        }
+    }
+
+#pragma mark - Getters
+
+    template<typename T>
+    size_t
+    FenwickTree<T>::size() const {
+        return mValues.size();
+    }
+
+    template<typename T>
+    const T &
+    FenwickTree<T>::value(size_t index) const {
+        return mValues[index];
+    }
+
+    template<typename T>
+    T
+    FenwickTree<T>::total() const {
+        return prefixSum(mValues.size());
+    }
+
+    template<typename T>
+    T
+    FenwickTree<T>::prefixSum(size_t index) const {
+        T sum = T(0);
+        for (size_t node = index; node > 0; node &= node - 1) {
+            sum += mNodes[node];
+        }
+        return sum;
+    }
+
+#pragma mark - Updating
+
+    template<typename T>
+    void
+    FenwickTree<T>::add(size_t index, T delta) {
+        if (index >= mValues.size()) {
+            throw std::out_of_range(string_format("Fenwick tree index %zu is out of bounds [0, %zu)", index, mValues.size()));
+        }
+
+        mValues[index] += delta;
+
+        for (size_t node = index + 1; node < mNodes.size(); node += node & (~node + 1)) {
+            mNodes[node] += delta;
+        }
+    }
+
+    template<typename T>
+    void
+    FenwickTree<T>::set(size_t index, T value) {
+        if (index >= mValues.size()) {
+            throw std::out_of_range(string_format("Fenwick tree index %zu is out of bounds [0, %zu)", index, mValues.size()));
+        }
+
+        add(index, value - mValues[index]);
+
+        // Snaps the stored value, so that repeated updates don't accumulate rounding errors in it
+        mValues[index] = value;
+    }
+
+#pragma mark - Searching
+
+    template<typename T>
+    size_t
+    FenwickTree<T>::upperBound(T target) const {
+        size_t position = 0;
+
+        for (size_t step = mHighestPowerOfTwo; step > 0; step /= 2) {
+            size_t next = position + step;
+            if (next < mNodes.size() && mNodes[next] <= target) {
+                position = next;
+                target -= mNodes[next];
+            }
+        }
+
+        return position;
+    }
+
+}
+
+#endif /* FenwickTreeImpl_hpp */
@@ -9,16 +9,20 @@
 #ifndef LogarithmicBin_hpp
 #define LogarithmicBin_hpp
 
-#include <unordered_set>
-#include <unordered_map>
+#include <vector>
 #include <random>
 
 #include "StringUtils.hpp"
-#include "PackedLookupTable.hpp"
+#include "FenwickTree.hpp"
 
 namespace EARenderer {
 
     // Based on paper http://www.cg.tuwien.ac.at/research/publications/2009/cline-09-poisson/cline-09-poisson-paper.pdf
+    //
+    // Bin i holds objects with weights in [minWeight * 2^i, minWeight * 2^(i+1)). Bins live in a dense array
+    // indexed by that exponent, and a Fenwick tree over their total weights picks a bin in O(log(bin count)).
+    // Objects of a bin are stored contiguously, so rejection sampling inside of a bin is a plain array access
+    // and erasing swaps the last object into the freed slot.
 
     template<class T>
     class LogarithmicBin {
@@ -28,6 +32,9 @@ namespace EARenderer {
 
         using Index = uint64_t;
 
+        /// Weights outside of the range covered by this many bins go to the first or the last bin
+        static constexpr Index MaximumBinCount = 64;
+
         struct BinObject {
             T object;
             float weight = 0.0f;
@@ -37,32 +44,33 @@ namespace EARenderer {
         };
 
         struct Bin {
-            PackedLookupTable<BinObject> objects;
-            float totalWeight = 0.0f;
-
-            Bin() : objects(1000) {
-            }
+            std::vector<BinObject> objects;
+            double totalWeight = 0.0;
         };
 
-        using BinsIterator = typename std::unordered_map<Index, Bin>::iterator;
-        using BinObjectsIterator = typename PackedLookupTable<BinObject>::Iterator;
-
 #pragma mark Forward iterator
 
     public:
+        /**
+         Erasing an object invalidates the iterators pointing to it and to the last object of its bin
+         */
         class Iterator {
         private:
             friend LogarithmicBin;
 
-            BinsIterator mBinsIterator;
-            BinsIterator mBinsEndIterator;
-            BinObjectsIterator mBinObjectsIterator;
+            LogarithmicBin *mContainer = nullptr;
+            Index mBinIndex = 0;
+            size_t mObjectIndex = 0;
 
-            Iterator(BinsIterator i, BinsIterator endIterator, BinObjectsIterator binObjectsIterator);
+            Iterator(LogarithmicBin *container, Index binIndex, size_t objectIndex);
 
-            Iterator(BinsIterator endIterator);
+            BinObject &binObject() const;
+
+            void skipEmptyBins();
 
         public:
+            Iterator() = default;
+
             Iterator &operator++();
 
             T &operator*();
@@ -80,25 +88,41 @@ namespace EARenderer {
 
     private:
         std::mt19937 mEngine;
-        std::uniform_real_distribution<float> mDistribution;
-        std::unordered_map<Index, Bin> mBins;
+        std::vector<Bin> mBins;
+        FenwickTree<double> mBinWeights;
 
         float mMinWeight = 0.0f;
         float mMaxWeight = 0.0f;
-        float mTotalWeight = 0.0f;
+
+        /// Lower weight bound of the first bin, differs from mMinWeight when the latter is 0
+        float mBaseWeight = 0.0f;
         uint64_t mSize = 0;
 
-        int32_t index(float weight);
+        Index index(float weight) const;
 
-        float binMinWeight(Index index);
+        float binMinWeight(Index index) const;
 
-        float binMaxWeight(Index index);
+        float binMaxWeight(Index index) const;
+
+        /**
+         @return upper bound of weights that can end up in the bin, used for rejection sampling
+         */
+        float rejectionBound(Index index) const;
+
+        /**
+         Rounding errors in the accumulated weights may point the search at an empty bin
+
+         @return index of the closest bin containing objects
+         */
+        Index nonEmptyBinNear(Index index) const;
 
 #pragma mark - Public members
 
     public:
         LogarithmicBin(float minWeight, float maxWeight);
 
+        LogarithmicBin(float minWeight, float maxWeight, uint32_t seed);
+
         LogarithmicBin(float maxWeight);
 
         float minWeight() const;
@@ -115,8 +139,23 @@ namespace EARenderer {
 
         void erase(const Iterator &it);
 
+        /**
+         Picks an object with probability proportional to its weight using bin's own random engine
+
+         @return iterator pointing to the picked object
+         */
         Iterator random();
 
+        /**
+         Picks an object with probability proportional to its weight. Results only depend on the state
+         of the injected engine, which makes sampling reproducible regardless of the bin's seed.
+
+         @param engine uniform random bit generator
+         @return iterator pointing to the picked object
+         */
+        template<class Engine>
+        Iterator random(Engine &engine);
+
 #pragma mark Iteration
 
         Iterator begin();
@@ -125,12 +164,12 @@ namespace EARenderer {
     };
 
     template<typename T>
-    typename LogarithmicBin<T>::Iterator begin(const LogarithmicBin<T> &bin) {
+    typename LogarithmicBin<T>::Iterator begin(LogarithmicBin<T> &bin) {
         return bin.begin();
     }
 
     template<typename T>
-    typename LogarithmicBin<T>::Iterator end(const LogarithmicBin<T> &bin) {
+    typename LogarithmicBin<T>::Iterator end(LogarithmicBin<T> &bin) {
         return bin.end();
     }
 
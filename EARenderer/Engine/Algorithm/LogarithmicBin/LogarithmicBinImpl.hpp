@@ -9,6 +9,10 @@
 #ifndef LogarithmicBinImpl_h
 #define LogarithmicBinImpl_h
 
+#include <cmath>
+#include <limits>
+#include <algorithm>
+
 namespace EARenderer {
 
 #pragma mark - Lifecycle
@@ -16,13 +20,28 @@ namespace EARenderer {
     template<typename T>
     LogarithmicBin<T>::LogarithmicBin::LogarithmicBin(float minWeight, float maxWeight)
             :
+            LogarithmicBin(minWeight, maxWeight, std::random_device()()) {
+    }
+
+    template<typename T>
+    LogarithmicBin<T>::LogarithmicBin::LogarithmicBin(float minWeight, float maxWeight, uint32_t seed)
+            :
+            mEngine(seed),
             mMinWeight(minWeight),
-            mMaxWeight(maxWeight),
-            mEngine(std::random_device()()),
-            mDistribution(0.0f, 1.0f) {
+            mMaxWeight(maxWeight) {
         if (maxWeight < minWeight) {
             throw std::invalid_argument(string_format("Maximum weight (%f) in LogarithmicBin must be larger than minimum weight (%f)!\n", maxWeight, minWeight));
         }
+
+        // Without a lower bound bins cover as much of the range below the maximum weight as they can
+        mBaseWeight = minWeight > 0.0f ? minWeight : std::ldexp(maxWeight, 1 - int(MaximumBinCount));
+        mBaseWeight = std::max(mBaseWeight, std::numeric_limits<float>::min());
+
+        float exponent = std::floor(std::log2(std::max(mMaxWeight / mBaseWeight, 1.0f)));
+        Index binCount = std::min(Index(exponent) + 1, MaximumBinCount);
+
+        mBins.resize(binCount);
+        mBinWeights = FenwickTree<double>(binCount);
     }
 
     template<typename T>
@@ -34,23 +53,62 @@ namespace EARenderer {
 #pragma mark - Accessors
 
     template<typename T>
-    int32_t
-    LogarithmicBin<T>::index(float weight) {
+    typename LogarithmicBin<T>::Index
+    LogarithmicBin<T>::index(float weight) const {
+        if (weight <= mBaseWeight) {
+            return 0;
+        }
+
         // I believe that formula for index calculation presented in the article is incorrect
         // I changed it to log2f(weight / mMinWeight)
-        return log2f(weight / mMinWeight);
+        Index lastBin = mBins.size() - 1;
+        Index i = std::min(Index(std::log2(weight / mBaseWeight)), lastBin);
+
+        // log2 may round across a power of two
+        while (i < lastBin && weight >= binMinWeight(i + 1)) {
+            i++;
+        }
+        while (i > 0 && weight < binMinWeight(i)) {
+            i--;
+        }
+
+        return i;
     }
 
     template<typename T>
     float
-    LogarithmicBin<T>::binMinWeight(Index index) {
-        return mMinWeight * powf(2.0f, (float) index);
+    LogarithmicBin<T>::binMinWeight(Index index) const {
+        return std::ldexp(mBaseWeight, int(index));
     }
 
     template<typename T>
     float
-    LogarithmicBin<T>::binMaxWeight(Index index) {
-        return mMinWeight * powf(2.0f, (float) (index + 1));
+    LogarithmicBin<T>::binMaxWeight(Index index) const {
+        return std::ldexp(mBaseWeight, int(index + 1));
+    }
+
+    template<typename T>
+    float
+    LogarithmicBin<T>::rejectionBound(Index index) const {
+        // The last bin also takes weights above its range when the bin count is capped
+        return index + 1 == mBins.size() ? std::max(binMaxWeight(index), mMaxWeight) : binMaxWeight(index);
+    }
+
+    template<typename T>
+    typename LogarithmicBin<T>::Index
+    LogarithmicBin<T>::nonEmptyBinNear(Index index) const {
+        index = std::min(index, Index(mBins.size() - 1));
+
+        for (Index distance = 0; distance < mBins.size(); distance++) {
+            if (index >= distance && !mBins[index - distance].objects.empty()) {
+                return index - distance;
+            }
+            if (index + distance < mBins.size() && !mBins[index + distance].objects.empty()) {
+                return index + distance;
+            }
+        }
+
+        throw std::logic_error("LogarithmicBin has no objects");
     }
 
     template<typename T>
@@ -68,7 +126,7 @@ namespace EARenderer {
     template<typename T>
     float
     LogarithmicBin<T>::totalWeight() const {
-        return mTotalWeight;
+        return mBinWeights.total();
     }
 
     template<typename T>
@@ -83,6 +141,8 @@ namespace EARenderer {
         return mSize == 0;
     }
 
+#pragma mark - Modification
+
     template<typename T>
     void
     LogarithmicBin<T>::insert(const T &object, float weight) {
@@ -91,86 +151,78 @@ namespace EARenderer {
         }
 
         Index i = index(weight);
-        auto &bin = mBins[i];
-        bin.objects.emplace(BinObject(object, weight));
+        Bin &bin = mBins[i];
+        bin.objects.emplace_back(object, weight);
         bin.totalWeight += weight;
-        mTotalWeight += weight;
+        mBinWeights.set(i, bin.totalWeight);
         mSize++;
     }
 
     template<typename T>
     void
     LogarithmicBin<T>::erase(const Iterator &it) {
-        ID idToDelete = *it.mBinObjectsIterator;
-        Bin &bin = it.mBinsIterator->second;
-        BinObject &binObject = bin.objects[idToDelete];
+        Bin &bin = mBins[it.mBinIndex];
+        float weight = bin.objects[it.mObjectIndex].weight;
 
-        mTotalWeight -= binObject.weight;
-        bin.totalWeight -= binObject.weight;
-        mSize--;
-        bin.objects.erase(idToDelete);
+        if (it.mObjectIndex + 1 != bin.objects.size()) {
+            bin.objects[it.mObjectIndex] = std::move(bin.objects.back());
+        }
+        bin.objects.pop_back();
 
         // Floating point errors may cause negative weights
-        if (mTotalWeight < 0.0f) {
-            mTotalWeight = 0.0f;
-        }
+        bin.totalWeight = bin.objects.empty() ? 0.0 : std::max(bin.totalWeight - weight, 0.0);
 
-        if (bin.totalWeight < 0.0f) {
-            bin.totalWeight = 0.0f;
-        }
+        mBinWeights.set(it.mBinIndex, bin.totalWeight);
+        mSize--;
     }
 
+#pragma mark - Sampling
+
     template<typename T>
     typename LogarithmicBin<T>::Iterator
     LogarithmicBin<T>::random() {
-        float randomWeight = mDistribution(mEngine);
-        float accumulatedWeight = 0.0f;
+        return random(mEngine);
+    }
 
-        Index randomBinIndex = 0;
-        BinsIterator randomBinIterator;
+    template<typename T>
+    template<class Engine>
+    typename LogarithmicBin<T>::Iterator
+    LogarithmicBin<T>::random(Engine &engine) {
+        if (mSize == 0) {
+            throw std::logic_error("Can't pick a random object from an empty LogarithmicBin");
+        }
 
-        // Perform linear search of a random bin based on a probability
-        // proportional to bin's total weight
-        for (auto it = mBins.begin(); it != mBins.end(); ++it) {
-            accumulatedWeight += it->second.totalWeight / mTotalWeight;
+        // Choose a bin with probability proportional to its total weight
+        std::uniform_real_distribution<double> binDistribution(0.0, mBinWeights.total());
+        Index binIndex = mBinWeights.upperBound(binDistribution(engine));
 
-            if (it->second.objects.empty()) {
-                continue;
-            }
+        if (binIndex >= mBins.size() || mBins[binIndex].objects.empty()) {
+            binIndex = nonEmptyBinNear(binIndex);
+        }
 
-            randomBinIndex = it->first;
-            randomBinIterator = it;
+        Bin &bin = mBins[binIndex];
+        float bound = rejectionBound(binIndex);
 
-            if (randomWeight < accumulatedWeight) {
-                break;
-            }
-        }
+        std::uniform_int_distribution<size_t> objectDistribution(0, bin.objects.size() - 1);
+        std::uniform_real_distribution<float> acceptanceDistribution(0.0f, bound);
 
-        Index randomBinObjectIndex = 0;
-        BinObjectsIterator binObjectsIterator{0};
+        // Objects of zero weight can only be picked when there is nothing else
+        if (bin.totalWeight <= 0.0) {
+            return Iterator(this, binIndex, objectDistribution(engine));
+        }
 
         // Choose an object within the bin based on rejection sampling:
         // Pick an object at random within the bin and then accept it with probability At/Bmax,
         // where At is the object’s weight, and Bmax is the maximum weight of objects assigned to the bin.
-        // Repeat until an object is accepted.
-        //
+        // Repeat until an object is accepted. Weights within a bin differ by less than a factor of 2,
+        // so it takes less than 2 attempts on average.
         while (true) {
-            auto &binObjects = randomBinIterator->second.objects;
-            randomBinObjectIndex = mDistribution(mEngine) * (binObjects.size() - 1);
-            randomWeight = mDistribution(mEngine);
-
-            binObjectsIterator = binObjects.begin() + randomBinObjectIndex;
-            BinObject &randomBinObject = binObjects[*binObjectsIterator];
-
-            float probability = randomBinObject.weight / binMaxWeight(randomBinIndex);
+            size_t objectIndex = objectDistribution(engine);
 
-            if (randomWeight < probability) {
-                break;
+            if (acceptanceDistribution(engine) <= bin.objects[objectIndex].weight) {
+                return Iterator(this, binIndex, objectIndex);
             }
         }
-
-        Iterator i = Iterator(randomBinIterator, mBins.end(), binObjectsIterator);
-        return i;
     }
 
 #pragma mark Iteration
@@ -178,13 +230,15 @@ namespace EARenderer {
     template<typename T>
     typename LogarithmicBin<T>::Iterator
     LogarithmicBin<T>::begin() {
-        return Iterator(mBins.begin(), mBins.end(), mBins.begin()->second.objects.begin());
+        Iterator it(this, 0, 0);
+        it.skipEmptyBins();
+        return it;
     }
 
     template<typename T>
     typename LogarithmicBin<T>::Iterator
     LogarithmicBin<T>::end() {
-        return Iterator(mBins.end());
+        return Iterator(this, mBins.size(), 0);
     }
 
 }
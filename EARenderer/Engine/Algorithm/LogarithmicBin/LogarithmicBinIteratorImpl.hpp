@@ -14,18 +14,29 @@ namespace EARenderer {
 #pragma mark - Lifecycle
 
     template<typename T>
-    LogarithmicBin<T>::Iterator::Iterator(BinsIterator i, BinsIterator endIterator, BinObjectsIterator binObjectsIterator)
+    LogarithmicBin<T>::Iterator::Iterator(LogarithmicBin *container, Index binIndex, size_t objectIndex)
             :
-            mBinsIterator(i),
-            mBinsEndIterator(endIterator),
-            mBinObjectsIterator(binObjectsIterator) {
+            mContainer(container),
+            mBinIndex(binIndex),
+            mObjectIndex(objectIndex) {
     }
 
+#pragma mark - Private helpers
+
     template<typename T>
-    LogarithmicBin<T>::Iterator::Iterator(BinsIterator endIterator)
-            :
-            mBinsIterator(endIterator),
-            mBinsEndIterator(endIterator) {
+    typename LogarithmicBin<T>::BinObject &
+    LogarithmicBin<T>::Iterator::binObject() const {
+        return mContainer->mBins[mBinIndex].objects[mObjectIndex];
+    }
+
+    template<typename T>
+    void
+    LogarithmicBin<T>::Iterator::skipEmptyBins() {
+        auto &bins = mContainer->mBins;
+        while (mBinIndex < bins.size() && mObjectIndex >= bins[mBinIndex].objects.size()) {
+            mBinIndex++;
+            mObjectIndex = 0;
+        }
     }
 
 #pragma mark - Operators
@@ -33,18 +44,12 @@ namespace EARenderer {
     template<typename T>
     typename LogarithmicBin<T>::Iterator &
     LogarithmicBin<T>::Iterator::operator++() {
-        if (mBinsIterator == mBinsEndIterator) {
+        if (mBinIndex >= mContainer->mBins.size()) {
             throw std::out_of_range("Incrementing an iterator which had reached the end already");
         }
 
-        mBinObjectsIterator++;
-
-        if (mBinObjectsIterator == mBinsIterator->second.objects.end()) {
-            mBinsIterator++;
-            if (mBinsIterator != mBinsEndIterator) {
-                mBinObjectsIterator = mBinsIterator->second.objects.begin();
-            }
-        }
+        mObjectIndex++;
+        skipEmptyBins();
 
         return *this;
     }
@@ -52,48 +57,31 @@ namespace EARenderer {
     template<typename T>
     T &
     LogarithmicBin<T>::Iterator::operator*() {
-        ID id = *mBinObjectsIterator;
-        Bin &bin = mBinsIterator->second;
-        BinObject &binObject = bin.objects[id];
-        return binObject.object;
+        return binObject().object;
     }
 
     template<typename T>
     T *
     LogarithmicBin<T>::Iterator::operator->() {
-        ID id = *mBinObjectsIterator;
-        Bin &bin = mBinsIterator->second;
-        BinObject &binObject = bin.objects[id];
-        return &(binObject.object);
+        return &(binObject().object);
     }
 
     template<typename T>
     const T &
     LogarithmicBin<T>::Iterator::operator*() const {
-        ID id = *mBinObjectsIterator;
-        Bin &bin = mBinsIterator->second;
-        BinObject &binObject = bin.objects[id];
-        return binObject.object;
+        return binObject().object;
     }
 
     template<typename T>
     const T *
     LogarithmicBin<T>::Iterator::operator->() const {
-        ID id = *mBinObjectsIterator;
-        Bin &bin = mBinsIterator->second;
-        BinObject &binObject = bin.objects[id];
-        return &(binObject.object);
+        return &(binObject().object);
     }
 
     template<typename T>
     bool
     LogarithmicBin<T>::Iterator::operator!=(const Iterator &other) const {
-        // Don't touch vector's iterator if we're at the end of unordered_map
-        if (mBinsIterator == mBinsEndIterator) {
-            return mBinsIterator != other.mBinsIterator;
-        } else {
-            return mBinsIterator != other.mBinsIterator || mBinObjectsIterator != other.mBinObjectsIterator;
-        }
+        return mContainer != other.mContainer || mBinIndex != other.mBinIndex || mObjectIndex != other.mObjectIndex;
     }
 
 }
@@ -0,0 +1,78 @@
+//
+//  ChunkedArray.hpp
+//  EARenderer
+//
+//  Created by Pavlo Muratov on 17.10.2026.
+//  Copyright © 2026 MPO. All rights reserved.
+//
+
+#ifndef ChunkedArray_hpp
+#define ChunkedArray_hpp
+
+#include <memory>
+#include <new>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace EARenderer {
+
+    // Raw storage for objects split into fixed size chunks.
+    //
+    // Growing only allocates new chunks, so objects never move and references to them stay valid.
+    // The array doesn't know which of its elements are alive: constructing and destroying them
+    // is up to the owner, which is also why it can't be copied.
+
+    template<typename T, size_t ChunkSize>
+    class ChunkedArray {
+    private:
+        static_assert(ChunkSize > 0 && (ChunkSize & (ChunkSize - 1)) == 0, "Chunk size must be a power of two");
+
+        using Storage = std::aligned_storage_t<sizeof(T), alignof(T)>;
+
+        std::vector<std::unique_ptr<Storage[]>> mChunks;
+
+    public:
+
+#pragma mark - Lifecycle
+
+        ChunkedArray() = default;
+
+        ChunkedArray(ChunkedArray &&that) = default;
+
+        ChunkedArray &operator=(ChunkedArray &&rhs) = default;
+
+        ChunkedArray(const ChunkedArray &that) = delete;
+
+        ChunkedArray &operator=(const ChunkedArray &rhs) = delete;
+
+        void swap(ChunkedArray &other);
+
+#pragma mark - Accessors
+
+        size_t capacity() const;
+
+        T &operator[](size_t index);
+
+        const T &operator[](size_t index) const;
+
+#pragma mark - Modifiers
+
+        /**
+         Allocates chunks until the array is able to hold the requested number of objects
+
+         @param capacity number of objects
+         */
+        void reserve(size_t capacity);
+
+        template<class... Args>
+        T &construct(size_t index, Args &&... args);
+
+        void destroy(size_t index);
+    };
+
+}
+
+#include "ChunkedArrayImpl.hpp"
+
+#endif /* ChunkedArray_hpp */
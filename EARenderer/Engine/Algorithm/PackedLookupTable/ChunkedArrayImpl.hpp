@@ -0,0 +1,67 @@
+//
+//  ChunkedArrayImpl.hpp
+//  EARenderer
+//
+//  Created by Pavlo Muratov on 17.10.2026.
+//  Copyright © 2026 MPO. All rights reserved.
+//
+
+#ifndef ChunkedArrayImpl_h
+#define ChunkedArrayImpl_h
+
+namespace EARenderer {
+
+#pragma mark - Lifecycle
+
+    template<typename T, size_t ChunkSize>
+    void
+    ChunkedArray<T, ChunkSize>::swap(ChunkedArray &other) {
+        std::swap(mChunks, other.mChunks);
+    }
+
+#pragma mark - Accessors
+
+    template<typename T, size_t ChunkSize>
+    size_t
+    ChunkedArray<T, ChunkSize>::capacity() const {
+        return mChunks.size() * ChunkSize;
+    }
+
+    template<typename T, size_t ChunkSize>
+    T &
+    ChunkedArray<T, ChunkSize>::operator[](size_t index) {
+        return *std::launder(reinterpret_cast<T *>(&mChunks[index / ChunkSize][index % ChunkSize]));
+    }
+
+    template<typename T, size_t ChunkSize>
+    const T &
+    ChunkedArray<T, ChunkSize>::operator[](size_t index) const {
+        return *std::launder(reinterpret_cast<const T *>(&mChunks[index / ChunkSize][index % ChunkSize]));
+    }
+
+#pragma mark - Modifiers
+
+    template<typename T, size_t ChunkSize>
+    void
+    ChunkedArray<T, ChunkSize>::reserve(size_t capacity) {
+        while (this->capacity() < capacity) {
+            mChunks.emplace_back(new Storage[ChunkSize]);
+        }
+    }
+
+    template<typename T, size_t ChunkSize>
+    template<class... Args>
+    T &
+    ChunkedArray<T, ChunkSize>::construct(size_t index, Args &&... args) {
+        return *new(&mChunks[index / ChunkSize][index % ChunkSize]) T(std::forward<Args>(args)...);
+    }
+
+    template<typename T, size_t ChunkSize>
+    void
+    ChunkedArray<T, ChunkSize>::destroy(size_t index) {
+        (*this)[index].~T();
+    }
+
+}
+
+#endif /* ChunkedArrayImpl_h */
@@ -14,55 +14,95 @@
 #include <assert.h>
 #include <stdexcept>
 #include <limits>
+#include <tuple>
+#include <type_traits>
+#include <vector>
 
 #include "StringUtils.hpp"
+#include "ChunkedArray.hpp"
+#include "ThreadPool.hpp"
 
 // http://bitsquid.blogspot.ca/2011/09/managing-decoupling-part-4-id-lookup.html
 
 namespace EARenderer {
 
+    // An ID is a slot index in the lower 32 bits and the slot's generation in the upper 32 bits.
+    // Generations start at 1 and are bumped every time a slot is freed, so an ID of an erased object
+    // never aliases an object inserted later, and no valid ID is equal to IDNotFound.
     typedef uint64_t ID;
     static ID IDNotFound = 0;
 
-    template<typename T>
+    // Objects are packed densely and relocated on erase, slots map stable IDs to their current locations.
+    //
+    // Dense storage is split into chunks of ChunkSize objects, so growing never moves live objects.
+    // Optional Columns are stored as a structure of arrays alongside the objects: a column value follows
+    // its object on erase and is reachable by the object's ID or dense index. Keeping hot fields
+    // in columns lets tight loops (culling, transform updates) touch only the data they need.
+
+    template<typename T, typename... Columns>
     class PackedLookupTable {
+    public:
+        /// Number of objects in a chunk of dense storage, ranges passed to parallelForEachRange never cross chunks
+        static constexpr size_t ChunkSize = 64;
+
     private:
+        static_assert(((std::is_nothrow_default_constructible_v<Columns> && std::is_nothrow_copy_constructible_v<Columns>) && ...),
+                "Columns are meant for plain hot data and must not throw when created or copied");
 
 #pragma mark - Private
 
-        struct Allocation {
-            ID objectID;
-            uint64_t objectIndex;
-            uint64_t nextAllocationIndex;
+        template<typename U>
+        using Storage = ChunkedArray<U, ChunkSize>;
+
+        struct Slot {
+            uint32_t generation;
+            uint32_t objectIndex;
+            uint32_t nextFreeSlotIndex;
         };
 
-        // Used to mark an allocation as owning no object
-        static const uint64_t DeadObjectIndex = -1;
+        // Used to mark a slot as owning no object
+        static constexpr uint32_t DeadObjectIndex = -1;
+
+        // Used to terminate the free list
+        static constexpr uint32_t NotAnIndex = -1;
 
-        // Used to mark an allocation as owning no object
-        static const uint64_t NotAnIndex = -1;
+        // Slot index has to fit into the lower half of an ID
+        static constexpr uint64_t MaximumCapacity = NotAnIndex;
 
         // Storage for objects
-        // Objects are contiguous, and always packed to the start of the storage.
-        // Objects can be relocated in this storage thanks to the separate list of allocations.
+        // Objects are contiguous within a chunk, and always packed to the start of the storage.
+        // Objects can be relocated in this storage thanks to the separate list of slots.
         size_t mObjectsCount = 0;
-        uint64_t mCapacity = 0;
-        uint64_t mMaxCapacity = std::numeric_limits<uint64_t>::max();
-        T *mObjects = nullptr;
+        Storage<T> mObjects;
+        std::tuple<Storage<Columns>...> mColumns;
+
+        // The ID of each object in the object array (1-1 mapping)
+        std::vector<ID> mObjectIDs;
+
+        std::vector<Slot> mSlots;
+
+        // FIFO queue of free slots, reusing the least recently freed slot delays generation wraparound
+        uint32_t mFirstFreeSlotIndex = NotAnIndex;
+        uint32_t mLastFreeSlotIndex = NotAnIndex;
+
+        static ID MakeID(uint32_t slotIndex, uint32_t generation);
+
+        static uint32_t SlotIndex(ID id);
 
-        // The allocation ID of each object in the object array (1-1 mapping)
-        ID *mObjectIDs = nullptr;
+        static uint32_t Generation(ID id);
 
-        // FIFO queue to allocate objects
-        Allocation *mAllocations = nullptr;
+        template<typename Column>
+        Storage<Column> &columnStorage();
 
-        // Last possible free allocation slot
-        uint64_t mLastAllocationIndex = NotAnIndex;
+        template<typename Column>
+        const Storage<Column> &columnStorage() const;
 
-        // The next index struct to use for an allocation
-        uint64_t mNextAllocationIndex = NotAnIndex;
+        Slot &popFreeSlot();
 
-        Allocation *popFreeAllocation();
+        template<class... Args>
+        ID emplaceObject(Args &&... args);
+
+        void destroyObjects();
 
     public:
 
@@ -71,10 +111,10 @@ namespace EARenderer {
 
         struct Iterator {
         private:
-            ID *mCurrentObjectID;
+            const ID *mCurrentObjectID;
 
         public:
-            Iterator(ID *in);
+            Iterator(const ID *in);
 
             Iterator &operator++();
 
@@ -91,6 +131,9 @@ namespace EARenderer {
 
         PackedLookupTable(size_t capacity);
 
+        /**
+         Copies live objects only, IDs stay valid in the copy
+         */
         PackedLookupTable(const PackedLookupTable &other);
 
         PackedLookupTable(PackedLookupTable &&other);
@@ -109,6 +152,9 @@ namespace EARenderer {
 
 #pragma mark - Modifiers
 
+        /**
+         Columns of the inserted object are value-initialized
+         */
         ID insert(const T &object);
 
         ID insert(T &&object);
@@ -116,6 +162,9 @@ namespace EARenderer {
         template<class... Args>
         ID emplace(Args &&... args);
 
+        /**
+         @return false for IDs of erased objects, even if their slots have been reused since
+         */
         bool contains(ID id) const;
 
         void erase(ID id);
@@ -130,27 +179,70 @@ namespace EARenderer {
 
         size_t capacity() const;
 
-        const T *data() const;
+        template<typename Column>
+        Column &column(ID id);
+
+        template<typename Column>
+        const Column &column(ID id) const;
+
+#pragma mark Dense access
+
+        /**
+         Dense indices run from 0 to size() - 1 and change when objects are erased.
+         Elements of a dense range not crossing a chunk boundary are contiguous in memory.
+         */
+        T &objectAt(size_t index);
+
+        const T &objectAt(size_t index) const;
+
+        template<typename Column>
+        Column &columnAt(size_t index);
+
+        template<typename Column>
+        const Column &columnAt(size_t index) const;
+
+        ID idAt(size_t index) const;
 
 #pragma mark - Iteration
 
         Iterator begin() const;
 
         Iterator end() const;
+
+        /**
+         Splits dense storage into chunks and processes them on the default thread pool.
+         Objects must not be inserted or erased until the call returns.
+
+         @param func callable taking (size_t begin, size_t end) dense index range lying within a single chunk
+         */
+        template<class Func>
+        void parallelForEachRange(Func &&func) const;
+
+        /**
+         @param func callable taking (ID, T &, Columns &...)
+         */
+        template<class Func>
+        void parallelForEach(Func &&func);
+
+        /**
+         @param func callable taking (ID, const T &, const Columns &...)
+         */
+        template<class Func>
+        void parallelForEach(Func &&func) const;
     };
 
-    template<typename T>
-    typename PackedLookupTable<T>::Iterator begin(const PackedLookupTable<T> &fl) {
+    template<typename T, typename... Columns>
+    typename PackedLookupTable<T, Columns...>::Iterator begin(const PackedLookupTable<T, Columns...> &fl) {
         return fl.begin();
     }
 
-    template<typename T>
-    typename PackedLookupTable<T>::Iterator end(const PackedLookupTable<T> &fl) {
+    template<typename T, typename... Columns>
+    typename PackedLookupTable<T, Columns...>::Iterator end(const PackedLookupTable<T, Columns...> &fl) {
         return fl.end();
     }
 
-    template<typename T>
-    void swap(PackedLookupTable<T> &lhs, PackedLookupTable<T> &rhs) {
+    template<typename T, typename... Columns>
+    void swap(PackedLookupTable<T, Columns...> &lhs, PackedLookupTable<T, Columns...> &rhs) {
         lhs.swap(rhs);
     }
 
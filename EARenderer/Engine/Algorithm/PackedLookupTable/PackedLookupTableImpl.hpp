@@ -1,4 +1,3 @@
-
 //
 //  PackedLookupTableImpl.h
 //  EARenderer
@@ -10,314 +9,415 @@
 #ifndef PackedLookupTableImpl_h
 #define PackedLookupTableImpl_h
 
+#include <algorithm>
+
 namespace EARenderer {
 
-    template<typename T>
-    typename PackedLookupTable<T>::Allocation *
-    PackedLookupTable<T>::popFreeAllocation() {
-        // Reserve more memory if needed
-        if (mNextAllocationIndex == NotAnIndex) {
-            reserve(mCapacity * 2);
-        }
+#pragma mark - Private helpers
 
-        assert(mObjectsCount < mCapacity);
+    template<typename T, typename... Columns>
+    ID
+    PackedLookupTable<T, Columns...>::MakeID(uint32_t slotIndex, uint32_t generation) {
+        return (static_cast<ID>(generation) << 32) | slotIndex;
+    }
 
-        // pop an allocation from the FIFO
-        Allocation *allocation = &mAllocations[mNextAllocationIndex];
-        mNextAllocationIndex = allocation->nextAllocationIndex;
+    template<typename T, typename... Columns>
+    uint32_t
+    PackedLookupTable<T, Columns...>::SlotIndex(ID id) {
+        return static_cast<uint32_t>(id);
+    }
 
-        // always allocate the object at the end of the storage
-        allocation->objectIndex = mObjectsCount;
-        mObjectsCount++;
+    template<typename T, typename... Columns>
+    uint32_t
+    PackedLookupTable<T, Columns...>::Generation(ID id) {
+        return static_cast<uint32_t>(id >> 32);
+    }
 
-        // update reverse-lookup so objects can know their ID
-        mObjectIDs[allocation->objectIndex] = allocation->objectID;
+    template<typename T, typename... Columns>
+    template<typename Column>
+    typename PackedLookupTable<T, Columns...>::template Storage<Column> &
+    PackedLookupTable<T, Columns...>::columnStorage() {
+        return std::get<Storage<Column>>(mColumns);
+    }
 
-        return allocation;
+    template<typename T, typename... Columns>
+    template<typename Column>
+    const typename PackedLookupTable<T, Columns...>::template Storage<Column> &
+    PackedLookupTable<T, Columns...>::columnStorage() const {
+        return std::get<Storage<Column>>(mColumns);
     }
 
-#pragma mark - Lifecycle
+    template<typename T, typename... Columns>
+    typename PackedLookupTable<T, Columns...>::Slot &
+    PackedLookupTable<T, Columns...>::popFreeSlot() {
+        assert(mFirstFreeSlotIndex != NotAnIndex);
 
-    template<typename T>
-    PackedLookupTable<T>::PackedLookupTable(size_t capacity) {
-        mObjectsCount = 0;
-        mCapacity = capacity;
+        // pop a slot from the FIFO
+        uint32_t slotIndex = mFirstFreeSlotIndex;
+        Slot &slot = mSlots[slotIndex];
+        mFirstFreeSlotIndex = slot.nextFreeSlotIndex;
 
-        mObjects = reinterpret_cast<T *>(new char[capacity * sizeof(T)]);
-        assert(mObjects);
+        if (mFirstFreeSlotIndex == NotAnIndex) {
+            mLastFreeSlotIndex = NotAnIndex;
+        }
 
-        mObjectIDs = new ID[mCapacity];
-        assert(mObjectIDs);
+        // always allocate the object at the end of the storage
+        slot.objectIndex = static_cast<uint32_t>(mObjectsCount);
+        slot.nextFreeSlotIndex = NotAnIndex;
 
-        mAllocations = new Allocation[mCapacity];
-        assert(mAllocations);
+        // update reverse-lookup so objects can know their ID
+        mObjectIDs.push_back(MakeID(slotIndex, slot.generation));
 
-        for (size_t i = 0; i < mCapacity; i++) {
-            mAllocations[i].objectID = static_cast<ID>(i);
-            mAllocations[i].objectIndex = DeadObjectIndex;
-            mAllocations[i].nextAllocationIndex = static_cast<uint64_t>(i + 1);
-        }
+        return slot;
+    }
 
-        if (mCapacity > 0) {
-            mAllocations[mCapacity - 1].nextAllocationIndex = NotAnIndex;
+    template<typename T, typename... Columns>
+    template<class... Args>
+    ID
+    PackedLookupTable<T, Columns...>::emplaceObject(Args &&... args) {
+        // Reserve more memory if needed
+        if (mFirstFreeSlotIndex == NotAnIndex) {
+            reserve(std::max<uint64_t>(mSlots.size() * 2, ChunkSize));
         }
 
-        mLastAllocationIndex = mCapacity - 1;
-        mNextAllocationIndex = 0;
-    }
-
-    template<typename T>
-    PackedLookupTable<T>::PackedLookupTable(const PackedLookupTable &other) {
+        // Construct first, so that a throwing constructor leaves the table untouched
+        mObjects.construct(mObjectsCount, std::forward<Args>(args)...);
+        (columnStorage<Columns>().construct(mObjectsCount), ...);
 
-        mObjectsCount = other.mObjectsCount;
-        mCapacity = other.mCapacity;
+        popFreeSlot();
+        mObjectsCount++;
 
-        mObjects = reinterpret_cast<T *>(new char[other.mCapacity * sizeof(T)]);
-        assert(mObjects);
+        return mObjectIDs.back();
+    }
 
-        mObjectIDs = new ID[other.mCapacity];
-        assert(mObjectIDs);
+    template<typename T, typename... Columns>
+    void
+    PackedLookupTable<T, Columns...>::destroyObjects() {
+        for (size_t i = 0; i < mObjectsCount; i++) {
+            mObjects.destroy(i);
+            (columnStorage<Columns>().destroy(i), ...);
+        }
+        mObjectsCount = 0;
+    }
 
-        mAllocations = new Allocation[other.mCapacity];
-        assert(mAllocations);
+#pragma mark - Lifecycle
 
-        for (size_t i = 0; i < other.mCapacity; i++) {
-            new(mObjects + i) T(*(other.mObjects + i));
-            mObjectIDs[i] = other.mObjectIDs[i];
-        }
+    template<typename T, typename... Columns>
+    PackedLookupTable<T, Columns...>::PackedLookupTable(size_t capacity) {
+        reserve(capacity);
+    }
 
-        for (size_t i = 0; i < other.mCapacity; i++) {
-            mAllocations[i] = other.mAllocations[i];
+    template<typename T, typename... Columns>
+    PackedLookupTable<T, Columns...>::PackedLookupTable(const PackedLookupTable &other)
+            :
+            mObjectIDs(other.mObjectIDs),
+            mSlots(other.mSlots),
+            mFirstFreeSlotIndex(other.mFirstFreeSlotIndex),
+            mLastFreeSlotIndex(other.mLastFreeSlotIndex) {
+
+        mObjects.reserve(other.mObjects.capacity());
+        (columnStorage<Columns>().reserve(other.mObjects.capacity()), ...);
+
+        // Only the first mObjectsCount elements of the storage are alive
+        try {
+            for (size_t i = 0; i < other.mObjectsCount; i++) {
+                mObjects.construct(i, other.mObjects[i]);
+                (columnStorage<Columns>().construct(i, other.template columnStorage<Columns>()[i]), ...);
+                mObjectsCount++;
+            }
+        } catch (...) {
+            destroyObjects();
+            throw;
         }
-
-        mLastAllocationIndex = other.mLastAllocationIndex;
-        mNextAllocationIndex = other.mNextAllocationIndex;
     }
 
-    template<typename T>
-    PackedLookupTable<T>::PackedLookupTable(PackedLookupTable &&other) {
+    template<typename T, typename... Columns>
+    PackedLookupTable<T, Columns...>::PackedLookupTable(PackedLookupTable &&other) {
         swap(other);
-
-        other.mObjects = nullptr;
-        other.mObjectIDs = nullptr;
-        other.mAllocations = nullptr;
     }
 
-    template<typename T>
-    PackedLookupTable<T>::~PackedLookupTable() {
-        for (size_t i = 0; i < mObjectsCount; i++) {
-            mObjects[i].~T();
-        }
-        delete[] ((char *) mObjects);
-        delete[] mObjectIDs;
-        delete[] mAllocations;
+    template<typename T, typename... Columns>
+    PackedLookupTable<T, Columns...>::~PackedLookupTable() {
+        destroyObjects();
     }
 
-    template<typename T>
+    template<typename T, typename... Columns>
     void
-    PackedLookupTable<T>::swap(PackedLookupTable &other) {
+    PackedLookupTable<T, Columns...>::swap(PackedLookupTable &other) {
         std::swap(mObjectsCount, other.mObjectsCount);
-        std::swap(mCapacity, other.mCapacity);
-        std::swap(mObjects, other.mObjects);
+        mObjects.swap(other.mObjects);
+        std::swap(mColumns, other.mColumns);
         std::swap(mObjectIDs, other.mObjectIDs);
-        std::swap(mAllocations, other.mAllocations);
-        std::swap(mLastAllocationIndex, other.mLastAllocationIndex);
-        std::swap(mNextAllocationIndex, other.mNextAllocationIndex);
+        std::swap(mSlots, other.mSlots);
+        std::swap(mFirstFreeSlotIndex, other.mFirstFreeSlotIndex);
+        std::swap(mLastFreeSlotIndex, other.mLastFreeSlotIndex);
     }
 
 #pragma mark - Operators
 
-    template<typename T>
-    PackedLookupTable <T> &
-    PackedLookupTable<T>::operator=(PackedLookupTable rhs) {
+    template<typename T, typename... Columns>
+    PackedLookupTable<T, Columns...> &
+    PackedLookupTable<T, Columns...>::operator=(PackedLookupTable rhs) {
         swap(rhs);
         return *this;
     }
 
-    template<typename T>
+    template<typename T, typename... Columns>
     T &
-    PackedLookupTable<T>::operator[](ID id) {
-        // grab the allocation corresponding to this ID
-        Allocation *allocation = &mAllocations[id];
-
-        // grab the object associated with the allocation
-        return *(mObjects + allocation->objectIndex);
+    PackedLookupTable<T, Columns...>::operator[](ID id) {
+        assert(contains(id));
+        return mObjects[mSlots[SlotIndex(id)].objectIndex];
     }
 
-    template<typename T>
+    template<typename T, typename... Columns>
     const T &
-    PackedLookupTable<T>::operator[](ID id) const {
-        // grab the allocation corresponding to this ID
-        Allocation *allocation = &mAllocations[id];
-
-        // grab the object associated with the allocation
-        return *(mObjects + allocation->objectIndex);
+    PackedLookupTable<T, Columns...>::operator[](ID id) const {
+        assert(contains(id));
+        return mObjects[mSlots[SlotIndex(id)].objectIndex];
     }
 
 #pragma mark - Modifiers
 
-    template<typename T>
+    template<typename T, typename... Columns>
     ID
-    PackedLookupTable<T>::insert(const T &object) {
-        Allocation *allocation = popFreeAllocation();
-        T *insertionPointer = mObjects + allocation->objectIndex;
-        new(insertionPointer) T(object);
-        return allocation->objectID;
+    PackedLookupTable<T, Columns...>::insert(const T &object) {
+        return emplaceObject(object);
     }
 
-    template<typename T>
+    template<typename T, typename... Columns>
     ID
-    PackedLookupTable<T>::insert(T &&object) {
-        Allocation *allocation = popFreeAllocation();
-        T *insertionPointer = mObjects + allocation->objectIndex;
-        new(insertionPointer) T(std::move(object));
-        return allocation->objectID;
+    PackedLookupTable<T, Columns...>::insert(T &&object) {
+        return emplaceObject(std::move(object));
     }
 
-    template<typename T>
+    template<typename T, typename... Columns>
     template<class... Args>
     ID
-    PackedLookupTable<T>::emplace(Args &&... args) {
-        Allocation *allocation = popFreeAllocation();
-        T *o = mObjects + allocation->objectIndex;
-        new(o) T(std::forward<Args>(args)...);
-        return allocation->objectID;
+    PackedLookupTable<T, Columns...>::emplace(Args &&... args) {
+        return emplaceObject(std::forward<Args>(args)...);
     }
 
-    template<typename T>
+    template<typename T, typename... Columns>
     bool
-    PackedLookupTable<T>::contains(ID id) const {
-        Allocation *allocation = &mAllocations[id];
-        bool contains = allocation->objectID == id && allocation->objectIndex != DeadObjectIndex;
-        return contains;
+    PackedLookupTable<T, Columns...>::contains(ID id) const {
+        uint32_t slotIndex = SlotIndex(id);
+        if (slotIndex >= mSlots.size()) {
+            return false;
+        }
+
+        const Slot &slot = mSlots[slotIndex];
+        return slot.generation == Generation(id) && slot.objectIndex != DeadObjectIndex;
     }
 
-    template<typename T>
+    template<typename T, typename... Columns>
     void
-    PackedLookupTable<T>::erase(ID id) {
+    PackedLookupTable<T, Columns...>::erase(ID id) {
         if (!contains(id)) {
-            throw std::invalid_argument(string_format("There is no object with ID %d\n", id));
+            throw std::invalid_argument(string_format("There is no object with ID %llu\n", static_cast<unsigned long long>(id)));
         }
 
-        // grab the allocation to delete
-        ID eresableAllocationIndex = id;
-        Allocation *allocation = &mAllocations[eresableAllocationIndex];
-
-        // grab the object for this allocation
-        T *object = mObjects + allocation->objectIndex;
+        // grab the slot to free
+        uint32_t erasableSlotIndex = SlotIndex(id);
+        Slot &slot = mSlots[erasableSlotIndex];
+        size_t objectIndex = slot.objectIndex;
+        size_t lastObjectIndex = mObjectsCount - 1;
 
         // if necessary, move (aka swap) the last object into the location of the object to erase, then unconditionally delete the last object
-        if (allocation->objectIndex != mObjectsCount - 1) {
-            T *last = mObjects + mObjectsCount - 1;
-            *object = std::move(*last);
-            object = last;
+        if (objectIndex != lastObjectIndex) {
+            mObjects[objectIndex] = std::move(mObjects[lastObjectIndex]);
+            ((columnStorage<Columns>()[objectIndex] = std::move(columnStorage<Columns>()[lastObjectIndex])), ...);
 
             // since the last object was moved into the deleted location, the associated object ID array's value must also be moved similarly
-            ID lastObjectID = mObjectIDs[mObjectsCount - 1];
-            mObjectIDs[allocation->objectIndex] = lastObjectID;
+            ID lastObjectID = mObjectIDs[lastObjectIndex];
+            mObjectIDs[objectIndex] = lastObjectID;
 
-            // since the last object has changed location, its allocation needs to be updated to the new location.
-            uint64_t lastAllocationIndex = lastObjectID;
-            mAllocations[lastAllocationIndex].objectIndex = allocation->objectIndex;
+            // since the last object has changed location, its slot needs to be updated to the new location.
+            mSlots[SlotIndex(lastObjectID)].objectIndex = static_cast<uint32_t>(objectIndex);
         }
 
         // destroy the removed object and pop it from the array
-        object->~T();
+        mObjects.destroy(lastObjectIndex);
+        (columnStorage<Columns>().destroy(lastObjectIndex), ...);
+        mObjectIDs.pop_back();
         mObjectsCount--;
 
-        uint64_t deletedAllocationIndex = allocation->objectID;
-
-        if (mNextAllocationIndex == NotAnIndex) {
-            mNextAllocationIndex = deletedAllocationIndex;
+        // invalidate all outstanding IDs of the slot, 0 is skipped to keep IDNotFound unused
+        slot.generation++;
+        if (slot.generation == 0) {
+            slot.generation = 1;
         }
 
-        // push the deleted allocation onto the FIFO
-        mAllocations[mLastAllocationIndex].nextAllocationIndex = deletedAllocationIndex;
-        mLastAllocationIndex = deletedAllocationIndex;
+        // put a tombstone where the slot used to point to an object index and push the slot onto the FIFO
+        slot.objectIndex = DeadObjectIndex;
+        slot.nextFreeSlotIndex = NotAnIndex;
 
-        // put a tombstone where the allocation used to point to an object index
-        allocation->objectIndex = DeadObjectIndex;
-        allocation->nextAllocationIndex = NotAnIndex;
+        if (mLastFreeSlotIndex == NotAnIndex) {
+            mFirstFreeSlotIndex = erasableSlotIndex;
+        } else {
+            mSlots[mLastFreeSlotIndex].nextFreeSlotIndex = erasableSlotIndex;
+        }
+        mLastFreeSlotIndex = erasableSlotIndex;
     }
 
-    template<typename T>
+    template<typename T, typename... Columns>
     void
-    PackedLookupTable<T>::reserve(uint64_t capacity) {
-        if (mCapacity == mMaxCapacity) {
-            throw std::length_error(string_format("Cannot reserve more memory. Maximum capacity (%d) has already been reached\n", mMaxCapacity));
+    PackedLookupTable<T, Columns...>::reserve(uint64_t capacity) {
+        if (capacity <= mSlots.size()) {
+            return;
         }
 
-        uint64_t newCapacity = std::min(capacity, mMaxCapacity);
-
-        T *objects = reinterpret_cast<T *>(new char[newCapacity * sizeof(T)]);
-        ID *objectIDs = new ID[newCapacity];
-        Allocation *allocations = new Allocation[newCapacity];
-
-        memcpy((char *) objects, (char *) mObjects, mObjectsCount * sizeof(T));
-        memcpy(allocations, mAllocations, mCapacity * sizeof(Allocation));
-        memcpy(objectIDs, mObjectIDs, mCapacity * sizeof(ID));
-
-        for (size_t i = mCapacity; i < newCapacity; ++i) {
-            allocations[i].objectID = static_cast<ID>(i);
-            allocations[i].objectIndex = DeadObjectIndex;
-            allocations[i].nextAllocationIndex = static_cast<uint64_t>(i + 1);
+        if (mSlots.size() == MaximumCapacity) {
+            throw std::length_error(string_format("Cannot reserve more memory. Maximum capacity (%llu) has already been reached\n",
+                    static_cast<unsigned long long>(MaximumCapacity)));
         }
 
-        // Link last allocation to the new memory chunk
-        allocations[mLastAllocationIndex].nextAllocationIndex = mObjectsCount;
-        allocations[newCapacity - 1].nextAllocationIndex = NotAnIndex;
-        mNextAllocationIndex = mObjectsCount;
-        mLastAllocationIndex = newCapacity - 1;
+        size_t oldCapacity = mSlots.size();
+        size_t newCapacity = std::min(capacity, MaximumCapacity);
 
-        delete[] (char *) mObjects;
-        delete[] mObjectIDs;
-        delete[] mAllocations;
+        // Chunks are only added, live objects stay where they are
+        mObjects.reserve(newCapacity);
+        (columnStorage<Columns>().reserve(newCapacity), ...);
+        mObjectIDs.reserve(newCapacity);
 
-        mObjects = objects;
-        mObjectIDs = objectIDs;
-        mAllocations = allocations;
+        mSlots.resize(newCapacity);
 
-        mCapacity = newCapacity;
+        for (size_t i = oldCapacity; i < newCapacity; ++i) {
+            mSlots[i].generation = 1;
+            mSlots[i].objectIndex = DeadObjectIndex;
+            mSlots[i].nextFreeSlotIndex = static_cast<uint32_t>(i + 1);
+        }
+        mSlots[newCapacity - 1].nextFreeSlotIndex = NotAnIndex;
+
+        // Link last free slot to the new ones
+        if (mLastFreeSlotIndex == NotAnIndex) {
+            mFirstFreeSlotIndex = static_cast<uint32_t>(oldCapacity);
+        } else {
+            mSlots[mLastFreeSlotIndex].nextFreeSlotIndex = static_cast<uint32_t>(oldCapacity);
+        }
+        mLastFreeSlotIndex = static_cast<uint32_t>(newCapacity - 1);
     }
 
 #pragma mark - Accessors
 
-    template<typename T>
+    template<typename T, typename... Columns>
     bool
-    PackedLookupTable<T>::empty() const {
+    PackedLookupTable<T, Columns...>::empty() const {
         return mObjectsCount == 0;
     }
 
-    template<typename T>
+    template<typename T, typename... Columns>
     size_t
-    PackedLookupTable<T>::size() const {
+    PackedLookupTable<T, Columns...>::size() const {
         return mObjectsCount;
     }
 
-    template<typename T>
+    template<typename T, typename... Columns>
     size_t
-    PackedLookupTable<T>::capacity() const {
-        return mCapacity;
+    PackedLookupTable<T, Columns...>::capacity() const {
+        return mSlots.size();
+    }
+
+    template<typename T, typename... Columns>
+    template<typename Column>
+    Column &
+    PackedLookupTable<T, Columns...>::column(ID id) {
+        assert(contains(id));
+        return columnStorage<Column>()[mSlots[SlotIndex(id)].objectIndex];
+    }
+
+    template<typename T, typename... Columns>
+    template<typename Column>
+    const Column &
+    PackedLookupTable<T, Columns...>::column(ID id) const {
+        assert(contains(id));
+        return columnStorage<Column>()[mSlots[SlotIndex(id)].objectIndex];
+    }
+
+#pragma mark Dense access
+
+    template<typename T, typename... Columns>
+    T &
+    PackedLookupTable<T, Columns...>::objectAt(size_t index) {
+        assert(index < mObjectsCount);
+        return mObjects[index];
+    }
+
+    template<typename T, typename... Columns>
+    const T &
+    PackedLookupTable<T, Columns...>::objectAt(size_t index) const {
+        assert(index < mObjectsCount);
+        return mObjects[index];
     }
 
-    template<typename T>
-    const T *
-    PackedLookupTable<T>::data() const {
-        return mObjects;
+    template<typename T, typename... Columns>
+    template<typename Column>
+    Column &
+    PackedLookupTable<T, Columns...>::columnAt(size_t index) {
+        assert(index < mObjectsCount);
+        return columnStorage<Column>()[index];
+    }
+
+    template<typename T, typename... Columns>
+    template<typename Column>
+    const Column &
+    PackedLookupTable<T, Columns...>::columnAt(size_t index) const {
+        assert(index < mObjectsCount);
+        return columnStorage<Column>()[index];
+    }
+
+    template<typename T, typename... Columns>
+    ID
+    PackedLookupTable<T, Columns...>::idAt(size_t index) const {
+        return mObjectIDs[index];
     }
 
 #pragma mark - Iteration
 
-    template<typename T>
-    typename PackedLookupTable<T>::Iterator
-    PackedLookupTable<T>::begin() const {
-        return Iterator{mObjectIDs};
+    template<typename T, typename... Columns>
+    typename PackedLookupTable<T, Columns...>::Iterator
+    PackedLookupTable<T, Columns...>::begin() const {
+        return Iterator{mObjectIDs.data()};
     }
 
-    template<typename T>
-    typename PackedLookupTable<T>::Iterator
-    PackedLookupTable<T>::end() const {
-        return Iterator{mObjectIDs + mObjectsCount};
+    template<typename T, typename... Columns>
+    typename PackedLookupTable<T, Columns...>::Iterator
+    PackedLookupTable<T, Columns...>::end() const {
+        return Iterator{mObjectIDs.data() + mObjectsCount};
+    }
+
+    template<typename T, typename... Columns>
+    template<class Func>
+    void
+    PackedLookupTable<T, Columns...>::parallelForEachRange(Func &&func) const {
+        size_t chunkCount = (mObjectsCount + ChunkSize - 1) / ChunkSize;
+
+        ThreadPool::Default().parallelFor(0, chunkCount, 1, [&](size_t firstChunk, size_t lastChunk) {
+            for (size_t chunk = firstChunk; chunk < lastChunk; chunk++) {
+                func(chunk * ChunkSize, std::min((chunk + 1) * ChunkSize, mObjectsCount));
+            }
+        });
+    }
+
+    template<typename T, typename... Columns>
+    template<class Func>
+    void
+    PackedLookupTable<T, Columns...>::parallelForEach(Func &&func) {
+        parallelForEachRange([&](size_t begin, size_t end) {
+            for (size_t i = begin; i < end; i++) {
+                func(mObjectIDs[i], mObjects[i], columnStorage<Columns>()[i]...);
+            }
+        });
+    }
+
+    template<typename T, typename... Columns>
+    template<class Func>
+    void
+    PackedLookupTable<T, Columns...>::parallelForEach(Func &&func) const {
+        parallelForEachRange([&](size_t begin, size_t end) {
+            for (size_t i = begin; i < end; i++) {
+                func(mObjectIDs[i], mObjects[i], columnStorage<Columns>()[i]...);
+            }
+        });
     }
 
 }
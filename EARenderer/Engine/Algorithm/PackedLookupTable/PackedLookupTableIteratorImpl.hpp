@@ -11,43 +11,43 @@
 
 namespace EARenderer {
 
-    template<typename T>
-    PackedLookupTable<T>::Iterator::Iterator(ID *in)
+    template<typename T, typename... Columns>
+    PackedLookupTable<T, Columns...>::Iterator::Iterator(const ID *in)
             :
             mCurrentObjectID(in) {
     }
 
-    template<typename T>
-    typename PackedLookupTable<T>::Iterator &
-    PackedLookupTable<T>::Iterator::operator++() {
+    template<typename T, typename... Columns>
+    typename PackedLookupTable<T, Columns...>::Iterator &
+    PackedLookupTable<T, Columns...>::Iterator::operator++() {
         mCurrentObjectID++;
         return *this;
     }
 
-    template<typename T>
-    typename PackedLookupTable<T>::Iterator &
-    PackedLookupTable<T>::Iterator::operator+=(size_t offset) {
+    template<typename T, typename... Columns>
+    typename PackedLookupTable<T, Columns...>::Iterator &
+    PackedLookupTable<T, Columns...>::Iterator::operator+=(size_t offset) {
         mCurrentObjectID += offset;
         return *this;
     }
 
-    template<typename T>
-    typename PackedLookupTable<T>::Iterator
-    PackedLookupTable<T>::Iterator::operator+(size_t offset) {
+    template<typename T, typename... Columns>
+    typename PackedLookupTable<T, Columns...>::Iterator
+    PackedLookupTable<T, Columns...>::Iterator::operator+(size_t offset) {
         Iterator copy(*this);
         copy += offset;
         return copy;
     }
 
-    template<typename T>
+    template<typename T, typename... Columns>
     ID
-    PackedLookupTable<T>::Iterator::operator*() const {
+    PackedLookupTable<T, Columns...>::Iterator::operator*() const {
         return *mCurrentObjectID;
     }
 
-    template<typename T>
+    template<typename T, typename... Columns>
     bool
-    PackedLookupTable<T>::Iterator::operator!=(const Iterator &other) const {
+    PackedLookupTable<T, Columns...>::Iterator::operator!=(const Iterator &other) const {
         return mCurrentObjectID != other.mCurrentObjectID;
     }
 
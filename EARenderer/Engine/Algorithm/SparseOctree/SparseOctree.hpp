@@ -9,9 +9,9 @@
 #ifndef SparseOctree_hpp
 #define SparseOctree_hpp
 
-#include <unordered_map>
-#include <stack>
 #include <vector>
+#include <array>
+#include <limits>
 #include <functional>
 
 #include <glm/vec3.hpp>
@@ -26,6 +26,12 @@
 
 namespace EARenderer {
 
+    // Octree is populated with insert() and then laid out by build() into two flat arrays:
+    // nodes in breadth-first order, where children of every node are adjacent,
+    // and objects packed so that objects of every node occupy a contiguous range.
+    // Once built, the tree is immutable and all traversal functions are const and
+    // safe to be called from multiple threads at once.
+
     template<typename T>
     class SparseOctree {
     public:
@@ -41,43 +47,81 @@ namespace EARenderer {
 
         static const NodeIndex RootNodeIndex = 0b1;
 
+        // Node indices are paths from the root, 3 bits per level after the leading 1,
+        // so depth is limited by the width of NodeIndex
+        static constexpr size_t DepthCap = 10;
+
+        static constexpr uint32_t InvalidLinearIndex = std::numeric_limits<uint32_t>::max();
+
     public:
 
         struct Node {
         private:
             friend SparseOctree;
 
-            // 8 MSB - child presence mask, 8 LSB - leaf mask
-            uint16_t mChildInfo = 0;
-
             AxisAlignedBox3D mBoundingBox;
-            std::vector<T> mObjects;
+            NodeIndex mIndex = RootNodeIndex;
+            uint32_t mFirstChild = InvalidLinearIndex;
+            uint32_t mObjectsOffset = 0;
+            uint32_t mObjectsCount = 0;
+            uint8_t mDepth = 0;
 
-            void setChildPresent(BitMask childIndex, bool isPresent);
+            // Bit N is set when the child with index N is present
+            BitMask mChildMask = 0;
 
-            void setChildLeaf(BitMask childIndex, bool isLeaf);
+            void setChildPresent(BitMask childIndex, bool isPresent);
 
             bool isChildPresent(BitMask childIndex) const;
 
-            bool isChildLeaf(BitMask childIndex) const;
+            uint32_t childLinearIndex(BitMask childIndex) const;
 
         public:
             const AxisAlignedBox3D &boundingBox() const;
 
-            const std::vector<T> &objects() const;
+            uint8_t depth() const;
+
+            size_t objectsCount() const;
+        };
+
+        struct ObjectRange {
+        private:
+            const T *mBegin;
+            const T *mEnd;
+
+        public:
+            ObjectRange(const T *begin, const T *end);
+
+            const T *begin() const;
+
+            const T *end() const;
         };
 
     private:
 
         struct StackFrame {
             NodeIndex nodeIndex;
+            uint32_t linearIndex;
             uint8_t depth;
             float t_in;
             float t_out;
 
-            StackFrame(NodeIndex nodeIndex, uint8_t nodeDepth);
+            StackFrame() = default;
+
+            StackFrame(NodeIndex nodeIndex, uint32_t linearIndex, uint8_t nodeDepth, float t_in, float t_out);
+        };
+
+        // Fixed capacity stack living on the caller's stack, which keeps traversal reentrant.
+        // Every processed node is replaced by at most 4 children, so the stack never grows
+        // beyond 3 frames per level plus the root.
+        struct TraversalStack {
+            std::array<StackFrame, 3 * DepthCap + 1> frames;
+            size_t size = 0;
 
-            StackFrame(NodeIndex nodeIndex, uint8_t nodeDepth, float t_in, float t_out);
+            void push(const StackFrame &frame);
+
+            StackFrame pop();
+
+            bool empty() const;
         };
 
         // In the original article authors use right-handed coordinate system with Z axis
@@ -101,13 +145,23 @@ namespace EARenderer {
         //    +---+---+' <--Negative Z
         //      ^--Behind: 5
 
+        // Maps indices of boxes produced by AxisAlignedBox3D::octet() to child indices and back
+        static constexpr std::array<BitMask, 8> OctetToChild = {7, 3, 6, 2, 5, 1, 4, 0};
+        static constexpr std::array<BitMask, 8> ChildToOctet = {7, 5, 3, 1, 6, 4, 2, 0};
+
+        struct ObjectPlacement {
+            NodeIndex nodeIndex;
+            uint32_t objectIndex;
+        };
+
 #pragma mark - Private members
 
-        size_t mDepthCap = 10;
         size_t mMaximumDepth;
         AxisAlignedBox3D mBoundingBox;
-        std::unordered_map<NodeIndex, Node> mNodes;
-        std::stack<StackFrame> mTraversalStack;
+        glm::mat4 mLocalNormalizedSpaceMatrix;
+        std::vector<Node> mNodes;
+        std::vector<T> mObjects;
+        std::vector<T> mPendingObjects;
         std::vector<float> mCuttingPlaneOffsets;
         ContainmentDetector mContainmentDetector;
         CollisionDetector mCollisionDetector;
@@ -116,7 +170,13 @@ namespace EARenderer {
 
         glm::mat4 localNormalizedSpaceMatrix() const;
 
-        NodeIndex appendChildIndex(NodeIndex parent, NodeIndex child);
+        NodeIndex appendChildIndex(NodeIndex parent, NodeIndex child) const;
+
+        uint8_t depth(NodeIndex nodeIndex) const;
+
+        AxisAlignedBox3D nodeBoundingBox(NodeIndex nodeIndex) const;
+
+        NodeIndex locate(const T &object) const;
 
         BitMask signMask(const glm::vec3 &valueTriple) const;
 
@@ -124,15 +184,23 @@ namespace EARenderer {
 
         BitMask sortMaskByMaximum(const glm::vec3 &valueTriple) const;
 
-        void pushRootNode();
+        void pushChild(TraversalStack &stack,
+                const StackFrame &currentFrame,
+                BitMask childIndex,
+                float t_in,
+                float t_out) const;
 
-        void pushChildNodes(const StackFrame &currentFrame,
+        void pushChildNodes(TraversalStack &stack,
+                const StackFrame &currentFrame,
                 const glm::vec3 &t,
                 BitMask signMaskA,
                 BitMask signMaskB,
                 BitMask p_first,
                 BitMask p_last,
-                size_t planeIntersectionCounter);
+                size_t planeIntersectionCounter) const;
+
+        template<typename Func>
+        void parallelFor(size_t count, bool multithreaded, Func &&func) const;
 
 #pragma mark - Public interface
 
@@ -142,15 +210,12 @@ namespace EARenderer {
         private:
             friend SparseOctree;
 
-            using MapIterator = typename std::unordered_map<NodeIndex, Node>::iterator;
-            using VectorIterator = typename std::vector<T>::iterator;
-
-            MapIterator mNodesIterator;
-            MapIterator mNodesEndIterator;
+            using VectorIterator = typename std::vector<Node>::const_iterator;
 
-            Iterator(MapIterator i, MapIterator endIterator);
+            VectorIterator mNodesIterator;
+            VectorIterator mNodesEndIterator;
 
-            Iterator(MapIterator endIterator);
+            Iterator(VectorIterator i, VectorIterator endIterator);
 
         public:
             Iterator &operator++();
@@ -171,19 +236,49 @@ namespace EARenderer {
 
 #pragma mark - Building
 
+        /**
+         Queues an object for insertion. Object becomes visible to traversal after the next build().
+         */
         void insert(const T &object);
 
+        /**
+         Lays out all inserted objects into the linear node and object arrays.
+         Objects are placed into the tree independently, so most of the work can be spread across threads.
+
+         @param multithreaded whether to use ThreadPool::Default()
+         */
+        void build(bool multithreaded = true);
+
+        /**
+         @return true if there are no objects inserted since the last build()
+         */
+        bool isBuilt() const;
+
 #pragma mark - Traversal
 
-        bool raymarch(const Ray3D &ray);
+        bool raymarch(const Ray3D &ray) const;
+
+        bool raymarch(const glm::vec3 &p0, const glm::vec3 &p1) const;
 
-        bool raymarch(const glm::vec3 &p0, const glm::vec3 &p1);
+        /**
+         Batched version of raymarch(const Ray3D &)
+
+         @param rays rays to be marched
+         @param hits receives collision flags, one per ray, in the same order
+         @param multithreaded whether to spread rays across ThreadPool::Default() workers
+         */
+        void raymarch(const std::vector<Ray3D> &rays, std::vector<bool> &hits, bool multithreaded = false) const;
 
 #pragma mark - Iteration
 
-        Iterator begin();
+        /**
+         @return objects stored in the node
+         */
+        ObjectRange objects(const Node &node) const;
+
+        Iterator begin() const;
 
-        Iterator end();
+        Iterator end() const;
 
     };
 
@@ -10,8 +10,11 @@
 #define SparseOctreeImpl_h
 
 #include <stdexcept>
+#include <algorithm>
+#include <iterator>
 
 #include "StringUtils.hpp"
+#include "ThreadPool.hpp"
 
 namespace EARenderer {
 
@@ -27,8 +30,8 @@ namespace EARenderer {
             mMaximumDepth(maximumDepth),
             mContainmentDetector(containmentDetector),
             mCollisionDetector(collisionDetector) {
-        if (maximumDepth > mDepthCap) {
-            throw std::invalid_argument(string_format("Octree maximum depth is %d, you requested %d", mDepthCap, maximumDepth));
+        if (maximumDepth > DepthCap) {
+            throw std::invalid_argument(string_format("Octree maximum depth is %d, you requested %d", DepthCap, maximumDepth));
         }
 
         // Root node shoud have 0 offset
@@ -36,6 +39,12 @@ namespace EARenderer {
         for (size_t depth = 1; depth <= maximumDepth; depth++) {
             mCuttingPlaneOffsets.emplace_back(1.0 / std::pow(2, depth));
         }
+
+        mLocalNormalizedSpaceMatrix = localNormalizedSpaceMatrix();
+
+        Node root;
+        root.mBoundingBox = mBoundingBox;
+        mNodes.push_back(root);
     }
 
 #pragma mark - Internal logic
@@ -50,22 +59,62 @@ namespace EARenderer {
     }
 
     template<typename T>
-    void
-    SparseOctree<T>::pushRootNode() {
-        NodeIndex rootNodeIndex = RootNodeIndex;
-        uint8_t rootDepth = 0;
-        float rootT1 = 0.0;
-        float rootT2 = 1.0;
+    typename SparseOctree<T>::NodeIndex
+    SparseOctree<T>::appendChildIndex(NodeIndex parent, NodeIndex child) const {
+        parent <<= 3;
+        parent |= child;
+        return parent;
+    }
 
-        mTraversalStack.push(StackFrame(rootNodeIndex, rootDepth, rootT1, rootT2));
+    template<typename T>
+    uint8_t
+    SparseOctree<T>::depth(NodeIndex nodeIndex) const {
+        uint8_t depth = 0;
+        while (nodeIndex > RootNodeIndex) {
+            nodeIndex >>= 3;
+            depth++;
+        }
+        return depth;
+    }
+
+    template<typename T>
+    AxisAlignedBox3D
+    SparseOctree<T>::nodeBoundingBox(NodeIndex nodeIndex) const {
+        AxisAlignedBox3D boundingBox = mBoundingBox;
+        for (int32_t level = depth(nodeIndex) - 1; level >= 0; level--) {
+            BitMask childIndex = (nodeIndex >> (level * 3)) & 0b111;
+            boundingBox = boundingBox.octet()[ChildToOctet[childIndex]];
+        }
+        return boundingBox;
     }
 
     template<typename T>
     typename SparseOctree<T>::NodeIndex
-    SparseOctree<T>::appendChildIndex(NodeIndex parent, NodeIndex child) {
-        parent <<= 3;
-        parent |= child;
-        return parent;
+    SparseOctree<T>::locate(const T &object) const {
+        NodeIndex nodeIndex = RootNodeIndex;
+        AxisAlignedBox3D boundingBox = mBoundingBox;
+
+        // Objects descend as long as they fit into a child entirely.
+        // Nodes of the deepest level are never populated, their parents are the leaves.
+        for (size_t depth = 1; depth < mMaximumDepth; depth++) {
+            std::array<AxisAlignedBox3D, 8> childBoxes = boundingBox.octet();
+
+            bool anyChildContainsObject = false;
+            for (size_t i = 0; i < 8; i++) {
+                if (mContainmentDetector(object, childBoxes[i])) {
+                    nodeIndex = appendChildIndex(nodeIndex, OctetToChild[i]);
+                    boundingBox = childBoxes[i];
+                    anyChildContainsObject = true;
+                    break;
+                }
+            }
+
+            if (!anyChildContainsObject) {
+                break;
+            }
+        }
+
+        return nodeIndex;
     }
 
     template<typename T>
@@ -112,151 +161,214 @@ namespace EARenderer {
 
     template<typename T>
     void
-    SparseOctree<T>::pushChildNodes(const StackFrame &currentFrame,
+    SparseOctree<T>::pushChild(TraversalStack &stack,
+            const StackFrame &currentFrame,
+            BitMask childIndex,
+            float t_in,
+            float t_out) const {
+        const Node &node = mNodes[currentFrame.linearIndex];
+
+        // Absent children have nothing to offer
+        if (!node.isChildPresent(childIndex)) {
+            return;
+        }
+
+        stack.push(StackFrame(appendChildIndex(currentFrame.nodeIndex, childIndex),
+                node.childLinearIndex(childIndex),
+                currentFrame.depth + 1,
+                t_in,
+                t_out));
+    }
+
+    template<typename T>
+    void
+    SparseOctree<T>::pushChildNodes(TraversalStack &stack,
+            const StackFrame &currentFrame,
             const glm::vec3 &t,
             BitMask signMaskA,
             BitMask signMaskB,
             BitMask p_first,
             BitMask p_last,
-            size_t planeIntersectionCounter) {
-        NodeIndex parentIndex = currentFrame.nodeIndex;
-        NodeIndex childIndex = 0;
+            size_t planeIntersectionCounter) const {
+
+        // Children are pushed in reverse order of traversal.
+        // Consecutive duplicates appear when the ray crosses several cutting planes at once.
+        BitMask previousChild = signMaskB;
 
         if (planeIntersectionCounter == 3) {
-            // TODO: check for node presense
 
-            childIndex = appendChildIndex(parentIndex, signMaskB);
-            mTraversalStack.push(StackFrame(childIndex, currentFrame.depth + 1, t.x, currentFrame.t_out));
+            pushChild(stack, currentFrame, signMaskB, t.x, currentFrame.t_out);
 
-            childIndex = appendChildIndex(parentIndex, signMaskB ^ p_last);
-            if (mTraversalStack.top().nodeIndex != childIndex) {
-                mTraversalStack.push(StackFrame(childIndex, currentFrame.depth + 1, t.y, t.x));
+            BitMask child = signMaskB ^ p_last;
+            if (child != previousChild) {
+                pushChild(stack, currentFrame, child, t.y, t.x);
+                previousChild = child;
             }
 
-            childIndex = appendChildIndex(parentIndex, signMaskA ^ p_first);
-            if (mTraversalStack.top().nodeIndex != childIndex) {
-                mTraversalStack.push(StackFrame(childIndex, currentFrame.depth + 1, t.z, t.y));
+            child = signMaskA ^ p_first;
+            if (child != previousChild) {
+                pushChild(stack, currentFrame, child, t.z, t.y);
+                previousChild = child;
             }
 
-            childIndex = appendChildIndex(parentIndex, signMaskA);
-            if (mTraversalStack.top().nodeIndex != childIndex) {
-                mTraversalStack.push(StackFrame(childIndex, currentFrame.depth + 1, currentFrame.t_in, t.z));
+            child = signMaskA;
+            if (child != previousChild) {
+                pushChild(stack, currentFrame, child, currentFrame.t_in, t.z);
             }
 
         } else if (planeIntersectionCounter == 2) {
 
-            childIndex = appendChildIndex(parentIndex, signMaskB);
-            mTraversalStack.push(StackFrame(childIndex, currentFrame.depth + 1, t.y, currentFrame.t_out));
+            pushChild(stack, currentFrame, signMaskB, t.y, currentFrame.t_out);
 
-            childIndex = appendChildIndex(parentIndex, signMaskA ^ p_first);
-            if (mTraversalStack.top().nodeIndex != childIndex) {
-                mTraversalStack.push(StackFrame(childIndex, currentFrame.depth + 1, t.z, t.y));
+            BitMask child = signMaskA ^ p_first;
+            if (child != previousChild) {
+                pushChild(stack, currentFrame, child, t.z, t.y);
+                previousChild = child;
             }
 
-            childIndex = appendChildIndex(parentIndex, signMaskA);
-            if (mTraversalStack.top().nodeIndex != childIndex) {
-                mTraversalStack.push(StackFrame(childIndex, currentFrame.depth + 1, currentFrame.t_in, t.z));
+            child = signMaskA;
+            if (child != previousChild) {
+                pushChild(stack, currentFrame, child, currentFrame.t_in, t.z);
             }
 
         } else if (planeIntersectionCounter == 1) {
 
-            childIndex = appendChildIndex(parentIndex, signMaskB);
-            mTraversalStack.push(StackFrame(childIndex, currentFrame.depth + 1, t.z, currentFrame.t_out));
-
-            childIndex = appendChildIndex(parentIndex, signMaskA);
-            mTraversalStack.push(StackFrame(childIndex, currentFrame.depth + 1, currentFrame.t_in, t.z));
+            pushChild(stack, currentFrame, signMaskB, t.z, currentFrame.t_out);
+            pushChild(stack, currentFrame, signMaskA, currentFrame.t_in, t.z);
 
         } else {
 
-            childIndex = appendChildIndex(parentIndex, signMaskA);
-            mTraversalStack.push(StackFrame(childIndex, currentFrame.depth + 1, currentFrame.t_in, currentFrame.t_out));
+            pushChild(stack, currentFrame, signMaskA, currentFrame.t_in, currentFrame.t_out);
 
         }
     }
 
-#pragma mark - Building
-
     template<typename T>
+    template<typename Func>
     void
-    SparseOctree<T>::insert(const T &object) {
-        std::unordered_map<uint8_t, BitMask> childBoxChildNodeCorrespondenceMap({
-                std::make_pair(0, 7),
-                std::make_pair(1, 3),
-                std::make_pair(2, 6),
-                std::make_pair(3, 2),
-                std::make_pair(4, 5),
-                std::make_pair(5, 1),
-                std::make_pair(6, 4),
-                std::make_pair(7, 0),
+    SparseOctree<T>::parallelFor(size_t count, bool multithreaded, Func &&func) const {
+        if (!multithreaded || count == 0) {
+            for (size_t i = 0; i < count; i++) {
+                func(i);
+            }
+            return;
+        }
+
+        ThreadPool::Default().parallelFor(0, count, 0, [&func](size_t chunkBegin, size_t chunkEnd) {
+            for (size_t i = chunkBegin; i < chunkEnd; i++) {
+                func(i);
+            }
         });
+    }
 
-        StackFrame stackFrame(RootNodeIndex, 0);
-        AxisAlignedBox3D nodeBoundingBox = mBoundingBox;
+#pragma mark - Building
 
-//        printf("Inserting object in the octree\n");
+    template<typename T>
+    void
+    SparseOctree<T>::insert(const T &object) {
+        mPendingObjects.emplace_back(object);
+    }
 
-        while (true) {
-//            printf("Traversing through node %d\n", stackFrame.nodeIndex);
+    template<typename T>
+    void
+    SparseOctree<T>::build(bool multithreaded) {
+        std::vector<T> objects = std::move(mObjects);
+        objects.insert(objects.end(), std::make_move_iterator(mPendingObjects.begin()), std::make_move_iterator(mPendingObjects.end()));
+        mObjects.clear();
+        mPendingObjects.clear();
+
+        // Find target node of every object
+        std::vector<ObjectPlacement> placements(objects.size());
+        parallelFor(objects.size(), multithreaded, [&](size_t i) {
+            placements[i] = {locate(objects[i]), (uint32_t) i};
+        });
 
-            Node &node = mNodes[stackFrame.nodeIndex];
-            node.mBoundingBox = nodeBoundingBox;
-            std::array<AxisAlignedBox3D, 8> childBoxes = node.mBoundingBox.octet();
+        // Node indices encode depth in their bit length, therefore sorting them
+        // numerically yields breadth-first order, with siblings adjacent to each other
+        std::vector<NodeIndex> nodeIndices{RootNodeIndex};
+        for (const ObjectPlacement &placement : placements) {
+            for (NodeIndex index = placement.nodeIndex; index > RootNodeIndex; index >>= 3) {
+                nodeIndices.push_back(index);
+            }
+        }
+        std::sort(nodeIndices.begin(), nodeIndices.end());
+        nodeIndices.erase(std::unique(nodeIndices.begin(), nodeIndices.end()), nodeIndices.end());
+
+        auto linearIndex = [&](NodeIndex nodeIndex) {
+            return (uint32_t) (std::lower_bound(nodeIndices.begin(), nodeIndices.end(), nodeIndex) - nodeIndices.begin());
+        };
+
+        mNodes.assign(nodeIndices.size(), Node());
+        parallelFor(nodeIndices.size(), multithreaded, [&](size_t i) {
+            Node &node = mNodes[i];
+            node.mIndex = nodeIndices[i];
+            node.mDepth = depth(nodeIndices[i]);
+            node.mBoundingBox = nodeBoundingBox(nodeIndices[i]);
+        });
 
-            bool anyChildContainsObject = false;
-            BitMask childNodeMask = 0;
+        // Link children, first child of every node is the first one encountered in breadth-first order
+        for (uint32_t i = 1; i < mNodes.size(); i++) {
+            Node &parent = mNodes[linearIndex(mNodes[i].mIndex >> 3)];
+            parent.setChildPresent(mNodes[i].mIndex & 0b111, true);
+            parent.mFirstChild = std::min(parent.mFirstChild, i);
+        }
 
-            for (size_t i = 0; i < 8; i++) {
-                bool boxContainsObject = mContainmentDetector(object, childBoxes[i]);
-                if (boxContainsObject) {
-                    childNodeMask = childBoxChildNodeCorrespondenceMap[i];
-                    nodeBoundingBox = childBoxes[i];
-                    node.setChildPresent(childNodeMask, true);
-                    NodeIndex childIndex = appendChildIndex(stackFrame.nodeIndex, childNodeMask);
-                    stackFrame = StackFrame(childIndex, stackFrame.depth + 1);
-                    anyChildContainsObject = true;
-                    break;
-                }
-            }
+        // Pack objects node by node, preserving insertion order within a node
+        std::stable_sort(placements.begin(), placements.end(), [](const ObjectPlacement &lhs, const ObjectPlacement &rhs) {
+            return lhs.nodeIndex < rhs.nodeIndex;
+        });
 
-            if (!anyChildContainsObject || stackFrame.depth >= mMaximumDepth) {
-                node.mObjects.emplace_back(object);
-                break;
+        mObjects.reserve(objects.size());
+        for (const ObjectPlacement &placement : placements) {
+            Node &node = mNodes[linearIndex(placement.nodeIndex)];
+            if (node.mObjectsCount == 0) {
+                node.mObjectsOffset = (uint32_t) mObjects.size();
             }
+            node.mObjectsCount++;
+            mObjects.emplace_back(std::move(objects[placement.objectIndex]));
         }
     }
 
+    template<typename T>
+    bool
+    SparseOctree<T>::isBuilt() const {
+        return mPendingObjects.empty();
+    }
+
 #pragma mark - Traversal
 
     template<typename T>
     bool
-    SparseOctree<T>::raymarch(const glm::vec3 &p0, const glm::vec3 &p1) {
-        glm::mat4 localSpaceMat = localNormalizedSpaceMatrix();
+    SparseOctree<T>::raymarch(const glm::vec3 &p0, const glm::vec3 &p1) const {
+        if (!isBuilt()) {
+            throw std::logic_error("Octree must be built before traversal");
+        }
 
         // Transform to voxelspace
-        glm::vec3 a = localSpaceMat * glm::vec4(p0, 1.0);
-        glm::vec3 b = localSpaceMat * glm::vec4(p1, 1.0);
+        glm::vec3 a = mLocalNormalizedSpaceMatrix * glm::vec4(p0, 1.0);
+        glm::vec3 b = mLocalNormalizedSpaceMatrix * glm::vec4(p1, 1.0);
 
         glm::vec3 ab = b - a;
 
         glm::vec3 invA = 1.f / a;
         glm::vec3 a_ab = a / ab;
 
-        pushRootNode();
+        Ray3D ray(p0, p1 - p0);
+
+        TraversalStack stack;
+        stack.push(StackFrame(RootNodeIndex, 0, 0, 0.0, 1.0));
 
-        while (!mTraversalStack.empty()) {
-            StackFrame stackFrame = mTraversalStack.top();
-            mTraversalStack.pop();
+        while (!stack.empty()) {
+            StackFrame stackFrame = stack.pop();
+            const Node &node = mNodes[stackFrame.linearIndex];
 
-            Node &node = mNodes[stackFrame.nodeIndex];
-            for (T &object : node.mObjects) {
-                bool collisionDetected = mCollisionDetector(object, Ray3D(p0, p1 - p0));
-                if (collisionDetected) {
-                    mTraversalStack = std::stack<StackFrame>();
+            for (const T &object : objects(node)) {
+                if (mCollisionDetector(object, ray)) {
                     return true;
                 }
             }
 
-            if (stackFrame.depth >= mMaximumDepth) {
+            if (stackFrame.depth >= mMaximumDepth || node.mChildMask == 0) {
                 continue;
             }
 
@@ -293,7 +405,7 @@ namespace EARenderer {
             BitMask p_first = sortMaskByMinimum(t);
             BitMask p_last = sortMaskByMaximum(t);
 
-            pushChildNodes(stackFrame, t, signMaskA, signMaskB, p_first, p_last, planeIntersectionCounter);
+            pushChildNodes(stack, stackFrame, t, signMaskA, signMaskB, p_first, p_last, planeIntersectionCounter);
         }
 
         return false;
@@ -301,7 +413,7 @@ namespace EARenderer {
 
     template<typename T>
     bool
-    SparseOctree<T>::raymarch(const Ray3D &ray) {
+    SparseOctree<T>::raymarch(const Ray3D &ray) const {
         // Extend ray's end point to ensure that it reaches all across the bounding box
         float t1 = mBoundingBox.diagonal();
         glm::vec3 a = ray.origin;
@@ -310,18 +422,38 @@ namespace EARenderer {
         return raymarch(a, b);
     }
 
+    template<typename T>
+    void
+    SparseOctree<T>::raymarch(const std::vector<Ray3D> &rays, std::vector<bool> &hits, bool multithreaded) const {
+        // std::vector<bool> packs flags into shared words, so workers write to a byte array instead
+        std::vector<uint8_t> hitFlags(rays.size(), 0);
+
+        parallelFor(rays.size(), multithreaded, [&](size_t i) {
+            hitFlags[i] = raymarch(rays[i]);
+        });
+
+        hits.assign(hitFlags.begin(), hitFlags.end());
+    }
+
 #pragma mark Iteration
 
+    template<typename T>
+    typename SparseOctree<T>::ObjectRange
+    SparseOctree<T>::objects(const Node &node) const {
+        const T *begin = mObjects.data() + node.mObjectsOffset;
+        return ObjectRange(begin, begin + node.mObjectsCount);
+    }
+
     template<typename T>
     typename SparseOctree<T>::Iterator
-    SparseOctree<T>::begin() {
+    SparseOctree<T>::begin() const {
         return Iterator(mNodes.begin(), mNodes.end());
     }
 
     template<typename T>
     typename SparseOctree<T>::Iterator
-    SparseOctree<T>::end() {
-        return Iterator(mNodes.end());
+    SparseOctree<T>::end() const {
+        return Iterator(mNodes.end(), mNodes.end());
     }
 
 }
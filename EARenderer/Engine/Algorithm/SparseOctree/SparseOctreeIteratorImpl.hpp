@@ -14,19 +14,12 @@ namespace EARenderer {
 #pragma mark - Lifecycle
 
     template<typename T>
-    SparseOctree<T>::Iterator::Iterator(MapIterator i, MapIterator endIterator)
+    SparseOctree<T>::Iterator::Iterator(VectorIterator i, VectorIterator endIterator)
             :
             mNodesIterator(i),
             mNodesEndIterator(endIterator) {
     }
 
-    template<typename T>
-    SparseOctree<T>::Iterator::Iterator(MapIterator endIterator)
-            :
-            mNodesIterator(endIterator),
-            mNodesEndIterator(endIterator) {
-    }
-
 #pragma mark - Operators
 
     template<typename T>
@@ -44,13 +37,13 @@ namespace EARenderer {
     template<typename T>
     const typename SparseOctree<T>::Node &
     SparseOctree<T>::Iterator::operator*() const {
-        return mNodesIterator->second;
+        return *mNodesIterator;
     }
 
     template<typename T>
     const typename SparseOctree<T>::Node *
     SparseOctree<T>::Iterator::operator->() const {
-        return &(mNodesIterator->second);
+        return &(*mNodesIterator);
     }
 
     template<typename T>
@@ -14,39 +14,28 @@ namespace EARenderer {
     template<typename T>
     void
     SparseOctree<T>::Node::setChildPresent(BitMask childIndex, bool isPresent) {
-        uint16_t mask = 1 << (childIndex + 8);
+        BitMask mask = 1 << childIndex;
 
         if (isPresent) {
-            mChildInfo |= mask;
+            mChildMask |= mask;
         } else {
-            mChildInfo &= ~mask;
-        }
-    }
-
-    template<typename T>
-    void
-    SparseOctree<T>::Node::setChildLeaf(BitMask childIndex, bool isLeaf) {
-        uint16_t mask = 1 << childIndex;
-
-        if (isLeaf) {
-            mChildInfo |= mask;
-        } else {
-            mChildInfo &= ~mask;
+            mChildMask &= ~mask;
         }
     }
 
     template<typename T>
     bool
     SparseOctree<T>::Node::isChildPresent(BitMask childIndex) const {
-        uint16_t mask = 1 << (childIndex + 8);
-        return mChildInfo & mask;
+        BitMask mask = 1 << childIndex;
+        return mChildMask & mask;
     }
 
     template<typename T>
-    bool
-    SparseOctree<T>::Node::isChildLeaf(BitMask childIndex) const {
-        uint16_t mask = 1 << childIndex;
-        return mChildInfo & mask;
+    uint32_t
+    SparseOctree<T>::Node::childLinearIndex(BitMask childIndex) const {
+        // Present children are stored contiguously in the order of their indices
+        BitMask precedingChildrenMask = mChildMask & ((1 << childIndex) - 1);
+        return mFirstChild + __builtin_popcount(precedingChildrenMask);
     }
 
     template<typename T>
@@ -56,9 +45,36 @@ namespace EARenderer {
     }
 
     template<typename T>
-    const std::vector<T> &
-    SparseOctree<T>::Node::objects() const {
-        return mObjects;
+    uint8_t
+    SparseOctree<T>::Node::depth() const {
+        return mDepth;
+    }
+
+    template<typename T>
+    size_t
+    SparseOctree<T>::Node::objectsCount() const {
+        return mObjectsCount;
+    }
+
+#pragma mark - Object range
+
+    template<typename T>
+    SparseOctree<T>::ObjectRange::ObjectRange(const T *begin, const T *end)
+            :
+            mBegin(begin),
+            mEnd(end) {
+    }
+
+    template<typename T>
+    const T *
+    SparseOctree<T>::ObjectRange::begin() const {
+        return mBegin;
+    }
+
+    template<typename T>
+    const T *
+    SparseOctree<T>::ObjectRange::end() const {
+        return mEnd;
     }
 
 }
@@ -12,21 +12,35 @@
 namespace EARenderer {
 
     template<typename T>
-    SparseOctree<T>::StackFrame::StackFrame(NodeIndex nodeIndex, uint8_t nodeDepth)
+    SparseOctree<T>::StackFrame::StackFrame(NodeIndex nodeIndex, uint32_t linearIndex, uint8_t nodeDepth, float t_in, float t_out)
             :
             nodeIndex(nodeIndex),
+            linearIndex(linearIndex),
             depth(nodeDepth),
-            t_in(0.0),
-            t_out(0.0) {
+            t_in(t_in),
+            t_out(t_out) {
     }
 
+#pragma mark - Traversal stack
+
     template<typename T>
-    SparseOctree<T>::StackFrame::StackFrame(NodeIndex nodeIndex, uint8_t nodeDepth, float t_in, float t_out)
-            :
-            nodeIndex(nodeIndex),
-            depth(nodeDepth),
-            t_in(t_in),
-            t_out(t_out) {
+    void
+    SparseOctree<T>::TraversalStack::push(const StackFrame &frame) {
+        frames[size] = frame;
+        size++;
+    }
+
+    template<typename T>
+    typename SparseOctree<T>::StackFrame
+    SparseOctree<T>::TraversalStack::pop() {
+        size--;
+        return frames[size];
+    }
+
+    template<typename T>
+    bool
+    SparseOctree<T>::TraversalStack::empty() const {
+        return size == 0;
     }
 
 }
@@ -25,7 +25,7 @@ namespace EARenderer {
     template<typename T>
     typename SpatialHash<T>::Cell
     SpatialHash<T>::Cell::InvalidCell() {
-        static Cell c;
+        Cell c;
         c.mHash = -1;
         return c;
     }
@@ -57,7 +57,7 @@ namespace EARenderer {
         uint16_t cy = cell.decodeY();
         uint16_t cz = cell.decodeZ();
 
-        int32_t neighbourIndex = -1;
+        size_t neighbourCount = 0;
 
         for (int8_t x = -1; x <= 1; ++x) {
             for (int8_t y = -1; y <= 1; ++y) {
@@ -72,16 +72,16 @@ namespace EARenderer {
                         Cell neighbour(newX, newY, newZ);
                         bool present = mObjects.find(neighbour.hash()) != mObjects.end();
                         if (present) {
-                            neighbours[neighbourIndex] = neighbour;
-                            neighbourIndex++;
+                            neighbours[neighbourCount] = neighbour;
+                            neighbourCount++;
                         }
                     }
                 }
             }
         }
 
-        if (neighbourIndex < (int32_t) neighbours.max_size() - 1) {
-            neighbours[neighbourIndex + 1] = Cell::InvalidCell();
+        if (neighbourCount < neighbours.max_size()) {
+            neighbours[neighbourCount] = Cell::InvalidCell();
         }
 
         return neighbours;
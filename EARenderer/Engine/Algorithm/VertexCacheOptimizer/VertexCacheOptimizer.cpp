@@ -0,0 +1,208 @@
+//
+//  VertexCacheOptimizer.cpp
+//  EARenderer
+//
+//  Created by Pavlo Muratov on 17.10.2026.
+//  Copyright © 2026 MPO. All rights reserved.
+//
+
+#include "VertexCacheOptimizer.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+namespace EARenderer {
+
+    // Tuning constants from the original paper
+    static constexpr float CacheDecayPower = 1.5f;
+    static constexpr float LastTriangleScore = 0.75f;
+    static constexpr float ValenceBoostScale = 2.0f;
+    static constexpr float ValenceBoostPower = 0.5f;
+
+#pragma mark - Private helpers
+
+    float VertexCacheOptimizer::VertexScore(int32_t cachePosition, uint32_t activeTriangleCount) {
+        if (activeTriangleCount == 0) {
+            // Vertex is not used by any remaining triangle
+            return -1.0f;
+        }
+
+        float score = 0.0f;
+
+        if (cachePosition >= 0) {
+            if (cachePosition < 3) {
+                // Vertices of the last emitted triangle get a fixed score, so that
+                // strip-like orders don't become preferable over fan-like ones
+                score = LastTriangleScore;
+            } else {
+                float scaler = 1.0f / (SimulatedCacheSize - 3);
+                score = powf(1.0f - (cachePosition - 3) * scaler, CacheDecayPower);
+            }
+        }
+
+        // Boost vertices with few remaining triangles to get rid of them sooner
+        score += ValenceBoostScale * powf(float(activeTriangleCount), -ValenceBoostPower);
+
+        return score;
+    }
+
+#pragma mark - Public interface
+
+    std::vector<uint32_t> VertexCacheOptimizer::OptimizeTriangleOrder(const std::vector<uint32_t> &indices, size_t vertexCount) {
+        size_t triangleCount = indices.size() / 3;
+
+        // Vertex -> triangles adjacency, active triangles of a vertex are kept at the front of its range
+        std::vector<uint32_t> activeTriangleCounts(vertexCount, 0);
+        for (uint32_t index : indices) {
+            activeTriangleCounts[index]++;
+        }
+
+        std::vector<uint32_t> adjacencyOffsets(vertexCount + 1, 0);
+        for (size_t v = 0; v < vertexCount; v++) {
+            adjacencyOffsets[v + 1] = adjacencyOffsets[v] + activeTriangleCounts[v];
+        }
+
+        std::vector<uint32_t> adjacency(indices.size());
+        std::vector<uint32_t> fillCounts(vertexCount, 0);
+        for (uint32_t triangle = 0; triangle < triangleCount; triangle++) {
+            for (size_t corner = 0; corner < 3; corner++) {
+                uint32_t vertex = indices[triangle * 3 + corner];
+                adjacency[adjacencyOffsets[vertex] + fillCounts[vertex]++] = triangle;
+            }
+        }
+
+        std::vector<int32_t> cachePositions(vertexCount, -1);
+        std::vector<float> vertexScores(vertexCount);
+        for (size_t v = 0; v < vertexCount; v++) {
+            vertexScores[v] = VertexScore(-1, activeTriangleCounts[v]);
+        }
+
+        std::vector<float> triangleScores(triangleCount);
+        std::vector<bool> emitted(triangleCount, false);
+
+        int64_t bestTriangle = -1;
+        float bestScore = std::numeric_limits<float>::lowest();
+
+        for (uint32_t triangle = 0; triangle < triangleCount; triangle++) {
+            const uint32_t *corners = &indices[triangle * 3];
+            triangleScores[triangle] = vertexScores[corners[0]] + vertexScores[corners[1]] + vertexScores[corners[2]];
+            if (triangleScores[triangle] > bestScore) {
+                bestScore = triangleScores[triangle];
+                bestTriangle = triangle;
+            }
+        }
+
+        std::vector<uint32_t> cache;
+        std::vector<uint32_t> updatedCache;
+        cache.reserve(SimulatedCacheSize + 3);
+        updatedCache.reserve(SimulatedCacheSize + 3);
+
+        std::vector<uint32_t> optimizedIndices;
+        optimizedIndices.reserve(indices.size());
+
+        size_t scanPosition = 0;
+
+        for (size_t emittedCount = 0; emittedCount < triangleCount; emittedCount++) {
+            // No cached vertex has remaining triangles, pick up from where the mesh was left off
+            if (bestTriangle < 0) {
+                while (emitted[scanPosition]) {
+                    scanPosition++;
+                }
+                bestTriangle = scanPosition;
+            }
+
+            uint32_t triangle = static_cast<uint32_t>(bestTriangle);
+            const uint32_t *corners = &indices[triangle * 3];
+            emitted[triangle] = true;
+
+            updatedCache.clear();
+
+            for (size_t corner = 0; corner < 3; corner++) {
+                uint32_t vertex = corners[corner];
+                optimizedIndices.push_back(vertex);
+                updatedCache.push_back(vertex);
+
+                // Swap the emitted triangle out of the vertex's active range
+                uint32_t *begin = &adjacency[adjacencyOffsets[vertex]];
+                uint32_t *end = begin + activeTriangleCounts[vertex];
+                std::iter_swap(std::find(begin, end, triangle), end - 1);
+                activeTriangleCounts[vertex]--;
+            }
+
+            for (uint32_t vertex : cache) {
+                if (vertex != corners[0] && vertex != corners[1] && vertex != corners[2]) {
+                    updatedCache.push_back(vertex);
+                }
+            }
+
+            // Vertices pushed out of the cache are rescored too
+            for (size_t position = 0; position < updatedCache.size(); position++) {
+                uint32_t vertex = updatedCache[position];
+                cachePositions[vertex] = position < SimulatedCacheSize ? static_cast<int32_t>(position) : -1;
+                vertexScores[vertex] = VertexScore(cachePositions[vertex], activeTriangleCounts[vertex]);
+            }
+
+            bestTriangle = -1;
+            bestScore = std::numeric_limits<float>::lowest();
+
+            for (uint32_t vertex : updatedCache) {
+                uint32_t *begin = &adjacency[adjacencyOffsets[vertex]];
+                uint32_t *end = begin + activeTriangleCounts[vertex];
+
+                for (uint32_t *adjacent = begin; adjacent != end; ++adjacent) {
+                    const uint32_t *adjacentCorners = &indices[*adjacent * 3];
+                    float score = vertexScores[adjacentCorners[0]] + vertexScores[adjacentCorners[1]] + vertexScores[adjacentCorners[2]];
+                    triangleScores[*adjacent] = score;
+
+                    if (score > bestScore) {
+                        bestScore = score;
+                        bestTriangle = *adjacent;
+                    }
+                }
+            }
+
+            updatedCache.resize(std::min(updatedCache.size(), SimulatedCacheSize));
+            std::swap(cache, updatedCache);
+        }
+
+        return optimizedIndices;
+    }
+
+    std::vector<uint32_t> VertexCacheOptimizer::OptimizeVertexOrder(std::vector<uint32_t> &indices, size_t vertexCount) {
+        constexpr uint32_t Unused = std::numeric_limits<uint32_t>::max();
+
+        std::vector<uint32_t> remap(vertexCount, Unused);
+        uint32_t nextIndex = 0;
+
+        for (uint32_t &index : indices) {
+            if (remap[index] == Unused) {
+                remap[index] = nextIndex++;
+            }
+            index = remap[index];
+        }
+
+        return remap;
+    }
+
+    float VertexCacheOptimizer::AverageCacheMissRatio(const std::vector<uint32_t> &indices, size_t cacheSize) {
+        if (indices.size() < 3) {
+            return 0.0f;
+        }
+
+        std::vector<uint32_t> fifo(cacheSize, std::numeric_limits<uint32_t>::max());
+        size_t head = 0;
+        size_t misses = 0;
+
+        for (uint32_t index : indices) {
+            if (std::find(fifo.begin(), fifo.end(), index) == fifo.end()) {
+                fifo[head] = index;
+                head = (head + 1) % cacheSize;
+                misses++;
+            }
+        }
+
+        return float(misses) / (indices.size() / 3);
+    }
+
+}
@@ -0,0 +1,64 @@
+//
+//  VertexCacheOptimizer.hpp
+//  EARenderer
+//
+//  Created by Pavlo Muratov on 17.10.2026.
+//  Copyright © 2026 MPO. All rights reserved.
+//
+
+#ifndef VertexCacheOptimizer_hpp
+#define VertexCacheOptimizer_hpp
+
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+
+namespace EARenderer {
+
+    // Reorders indexed triangle lists for post-transform vertex cache efficiency.
+    //
+    // Implements Tom Forsyth's "Linear-Speed Vertex Cache Optimisation": every vertex is scored
+    // by its position in a simulated LRU cache and by the number of triangles still using it,
+    // and the triangle with the highest sum of vertex scores is emitted next.
+    // The algorithm doesn't depend on the exact cache size of the hardware and runs in linear time.
+
+    class VertexCacheOptimizer {
+    public:
+        static constexpr size_t SimulatedCacheSize = 32;
+
+    private:
+        static float VertexScore(int32_t cachePosition, uint32_t activeTriangleCount);
+
+    public:
+        /**
+         Reorders triangles for vertex cache locality. Winding of every triangle is preserved.
+
+         @param indices 3 indices per triangle
+         @param vertexCount number of vertices referenced by indices
+         @return reordered indices
+         */
+        static std::vector<uint32_t> OptimizeTriangleOrder(const std::vector<uint32_t> &indices, size_t vertexCount);
+
+        /**
+         Builds a vertex permutation in which vertices appear in the order of their first use by indices,
+         which improves pre-transform (memory fetch) locality after triangles are reordered
+
+         @param indices 3 indices per triangle, remapped in place
+         @param vertexCount number of vertices referenced by indices
+         @return new vertex index for every old vertex index. Vertices unused by any triangle map to UINT32_MAX
+         */
+        static std::vector<uint32_t> OptimizeVertexOrder(std::vector<uint32_t> &indices, size_t vertexCount);
+
+        /**
+         Simulates a FIFO post-transform cache
+
+         @param indices 3 indices per triangle
+         @param cacheSize number of cache entries
+         @return average number of vertex shader invocations per triangle (0.5 is ideal, 3.0 is the worst)
+         */
+        static float AverageCacheMissRatio(const std::vector<uint32_t> &indices, size_t cacheSize = 16);
+    };
+
+}
+
+#endif /* VertexCacheOptimizer_hpp */
@@ -12,3 +12,12 @@ uint32_t ctcrc32(std::string const &str) {
     size_t len = str.size() + 1;
     return detail::crc32(len - 2, str.c_str()) ^ 0xFFFFFFFF;
 }
+
+uint32_t crc32(const void *data, size_t length, uint32_t previous) {
+    const uint8_t *bytes = reinterpret_cast<const uint8_t *>(data);
+    uint32_t crc = previous ^ 0xFFFFFFFF;
+    for (size_t i = 0; i < length; i++) {
+        crc = (crc >> 8) ^ detail::crc_table[(crc ^ bytes[i]) & 0x000000FF];
+    }
+    return crc ^ 0xFFFFFFFF;
+}
@@ -79,4 +79,14 @@ constexpr uint32_t ctcrc32(const char (&str)[len]) {
 
 uint32_t ctcrc32(std::string const& str);
 
+/**
+ Runtime CRC32 of an arbitrary byte range, compatible with ctcrc32() for strings
+
+ @param data bytes to be checksummed
+ @param length number of bytes
+ @param previous checksum of preceding data when checksumming in several steps
+ @return CRC32 checksum
+ */
+uint32_t crc32(const void *data, size_t length, uint32_t previous = 0);
+
 #endif /* PrecomputedStringHash_hpp */
@@ -10,6 +10,7 @@
 #define GaussianFunction_hpp
 
 #include <vector>
+#include <cstddef>
 
 namespace EARenderer {
 
@@ -38,7 +38,7 @@ namespace EARenderer {
         using ClickEvent = Event<Input, std::string, void(const Input *)>;
 
         enum class Key : KeyCode {
-            W = 13, S = 1, A = 0, D = 2
+            W = 13, S = 1, A = 0, D = 2, G = 5, P = 35
         };
 
     private:
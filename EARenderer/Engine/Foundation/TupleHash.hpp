@@ -10,6 +10,7 @@
 #define TupleHash_hpp
 
 #include <tuple>
+#include <functional>
 
 // https://stackoverflow.com/a/21439212/4308277
 
@@ -10,6 +10,7 @@
 #include "AxisAlignedBox3D.hpp"
 
 #include <limits>
+#include <cmath>
 #include <glm/detail/func_geometric.hpp>
 #include <glm/gtc/matrix_transform.hpp>
 #include <glm/vec4.hpp>
@@ -81,13 +82,13 @@ namespace EARenderer {
     }
 
     float AxisAlignedBox3D::smallestDimensionLength() const {
-        float minXY = std::min(fabs(max.x - min.x), fabs(max.y - min.y));
-        return std::min(fabs(max.z - min.z), minXY);
+        float minXY = std::min(std::fabs(max.x - min.x), std::fabs(max.y - min.y));
+        return std::min(std::fabs(max.z - min.z), minXY);
     }
 
     float AxisAlignedBox3D::largestDimensionLength() const {
-        float maxXY = std::max(fabs(max.x - min.x), fabs(max.y - min.y));
-        return std::max(fabs(max.z - min.z), maxXY);
+        float maxXY = std::max(std::fabs(max.x - min.x), std::fabs(max.y - min.y));
+        return std::max(std::fabs(max.z - min.z), maxXY);
     }
 
     glm::vec3 AxisAlignedBox3D::center() const {
@@ -12,6 +12,7 @@
 #include <vector>
 #include <algorithm>
 #include <cmath>
+#include <cstring>
 
 #include "GLNamedObject.hpp"
 #include "GLBufferWritingSession.hpp"
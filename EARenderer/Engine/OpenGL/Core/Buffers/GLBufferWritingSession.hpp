@@ -10,6 +10,7 @@
 #define GLBufferWriter_hpp
 
 #include <stdlib.h>
+#include <functional>
 #include "MemoryUtils.hpp"
 #include "StringUtils.hpp"
 #include "LogUtils.hpp"
@@ -14,15 +14,15 @@
 
 namespace EARenderer {
 
-    class GLElementArrayBuffer : public GLBuffer<GLushort> {
+    class GLElementArrayBuffer : public GLBuffer<GLuint> {
     public:
         template<template<class...> class ContinuousContainer>
-        static auto Create(const ContinuousContainer<GLushort> &indices) {
+        static auto Create(const ContinuousContainer<GLuint> &indices) {
             return GLElementArrayBuffer(indices.data(), indices.size());
         }
 
-        GLElementArrayBuffer(const GLushort *indices, uint64_t count)
-                : GLBuffer<GLushort>(indices, count, GL_ELEMENT_ARRAY_BUFFER, GL_STATIC_DRAW) {}
+        GLElementArrayBuffer(const GLuint *indices, uint64_t count)
+                : GLBuffer<GLuint>(indices, count, GL_ELEMENT_ARRAY_BUFFER, GL_STATIC_DRAW) {}
     };
 
 }
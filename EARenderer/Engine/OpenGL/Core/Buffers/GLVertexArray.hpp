@@ -62,7 +62,7 @@ namespace EARenderer {
                 template<class...> class IndexContainer,
                 template<class...> class AttributeContainer
         >
-        static auto Create(const VertexContainer<Vertex> &vertices, const IndexContainer<GLushort> &indices, const AttributeContainer<GLVertexAttribute> &attributes) {
+        static auto Create(const VertexContainer<Vertex> &vertices, const IndexContainer<GLuint> &indices, const AttributeContainer<GLVertexAttribute> &attributes) {
             return GLVertexArray(vertices.data(), vertices.size(), indices.data(), indices.size(), attributes.data(), attributes.size());
         }
 
@@ -73,7 +73,7 @@ namespace EARenderer {
             hookUpBuffers(attributes, attributeCount);
         }
 
-        GLVertexArray(const Vertex *vertices, size_t vertexCount, const GLushort *indices, size_t indexCount, const GLVertexAttribute *attributes, size_t attributeCount)
+        GLVertexArray(const Vertex *vertices, size_t vertexCount, const GLuint *indices, size_t indexCount, const GLVertexAttribute *attributes, size_t attributeCount)
                 : mVertexBuffer(std::make_unique<GLVertexArrayBuffer<Vertex>>(vertices, vertexCount)),
                   mIndexBuffer(std::make_unique<GLElementArrayBuffer>(indices, indexCount)) {
 
@@ -17,6 +17,11 @@ namespace EARenderer {
     struct GLVBODataLocation {
         size_t offset;
         size_t vertexCount;
+
+        /// Range in the element array buffer. Indices are relative to offset.
+        /// Locations with zero index count are drawn as non-indexed triangle lists.
+        size_t indexOffset = 0;
+        size_t indexCount = 0;
     };
 
     template<typename Vertex>
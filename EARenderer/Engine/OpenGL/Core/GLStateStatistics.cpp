@@ -0,0 +1,53 @@
+//
+//  GLStateStatistics.cpp
+//  EARenderer
+//
+//  Created by Pavlo Muratov on 17.10.2026.
+//  Copyright © 2026 MPO. All rights reserved.
+//
+
+#include "GLStateStatistics.hpp"
+#include "StringUtils.hpp"
+
+namespace EARenderer {
+
+#pragma mark - Counters
+
+    std::string GLStateStatistics::Counters::description() const {
+        return string_format(
+                "Uniform uploads: %u issued, %u skipped\n"
+                "Texture binds: %u issued, %u skipped\n"
+                "Sampler binds: %u issued, %u skipped\n"
+                "Texture unit activations: %u issued, %u skipped",
+                uniformUploads, redundantUniformUploads,
+                textureBinds, redundantTextureBinds,
+                samplerBinds, redundantSamplerBinds,
+                textureUnitActivations, redundantTextureUnitActivations
+        );
+    }
+
+#pragma mark - Lifecycle
+
+    GLStateStatistics &GLStateStatistics::Shared() {
+        static GLStateStatistics statistics;
+        return statistics;
+    }
+
+#pragma mark - Getters
+
+    GLStateStatistics::Counters &GLStateStatistics::currentFrame() {
+        return mCurrentFrame;
+    }
+
+    const GLStateStatistics::Counters &GLStateStatistics::previousFrame() const {
+        return mPreviousFrame;
+    }
+
+#pragma mark - Frame
+
+    void GLStateStatistics::finishFrame() {
+        mPreviousFrame = mCurrentFrame;
+        mCurrentFrame = Counters();
+    }
+
+}
@@ -0,0 +1,69 @@
+//
+//  GLStateStatistics.hpp
+//  EARenderer
+//
+//  Created by Pavlo Muratov on 17.10.2026.
+//  Copyright © 2026 MPO. All rights reserved.
+//
+
+#ifndef GLStateStatistics_hpp
+#define GLStateStatistics_hpp
+
+#include <cstdint>
+#include <string>
+
+namespace EARenderer {
+
+    // Counts state changes issued to the driver and the ones skipped because the
+    // requested state was already current. Counters are accumulated over a frame.
+
+    class GLStateStatistics {
+    public:
+        struct Counters {
+            uint32_t uniformUploads = 0;
+            uint32_t redundantUniformUploads = 0;
+            uint32_t textureBinds = 0;
+            uint32_t redundantTextureBinds = 0;
+            uint32_t samplerBinds = 0;
+            uint32_t redundantSamplerBinds = 0;
+            uint32_t textureUnitActivations = 0;
+            uint32_t redundantTextureUnitActivations = 0;
+
+            /**
+             @return human readable multi line summary of issued and skipped calls
+             */
+            std::string description() const;
+        };
+
+    private:
+        Counters mCurrentFrame;
+        Counters mPreviousFrame;
+
+        GLStateStatistics() = default;
+
+    public:
+        static GLStateStatistics &Shared();
+
+        GLStateStatistics(const GLStateStatistics &that) = delete;
+
+        GLStateStatistics &operator=(const GLStateStatistics &rhs) = delete;
+
+        /**
+         @return counters of the frame that is currently being rendered
+         */
+        Counters &currentFrame();
+
+        /**
+         @return counters of the last finished frame
+         */
+        const Counters &previousFrame() const;
+
+        /**
+         Publishes counters of the current frame and starts counting from zero
+         */
+        void finishFrame();
+    };
+
+}
+
+#endif /* GLStateStatistics_hpp */
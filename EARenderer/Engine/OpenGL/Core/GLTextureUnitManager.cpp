@@ -7,6 +7,7 @@
 //
 
 #include "GLTextureUnitManager.hpp"
+#include "GLStateStatistics.hpp"
 #include "StringUtils.hpp"
 
 namespace EARenderer {
@@ -20,6 +21,17 @@ namespace EARenderer {
 
     GLTextureUnitManager::GLTextureUnitManager() {
         glGetIntegerv(GL_MAX_TEXTURE_IMAGE_UNITS, &mMaximumTextureUnits);
+        mBoundTextures.resize(mMaximumTextureUnits);
+        mBoundSamplers.resize(mMaximumTextureUnits, 0);
+        mSamplerBindingPasses.resize(mMaximumTextureUnits, 0);
+    }
+
+#pragma mark - Private helpers
+
+    void GLTextureUnitManager::validateUnit(TextureUnit unit) const {
+        if (unit >= mMaximumTextureUnits) {
+            throw std::invalid_argument(string_format("Texture unit %d exceeds maximum texture unit index %d", unit, mMaximumTextureUnits - 1));
+        }
     }
 
 #pragma mark - Getters
@@ -35,60 +47,124 @@ namespace EARenderer {
 #pragma mark - Bindings
 
     void GLTextureUnitManager::bindTextureToUnit(const GLTexture &texture, GLTextureUnitManager::TextureUnit unit) {
-        if (unit >= mMaximumTextureUnits) {
-            throw std::invalid_argument(string_format("Texture unit %d exceeds maximum texture unit index %d", unit, mMaximumTextureUnits - 1));
-        }
+        validateUnit(unit);
 
-        if (mActiveTextureUnit != unit) {
-            activateUnit(unit);
+        // Binding to a particular unit doesn't require that unit to stay active,
+        // so there's no need to switch units at all if the texture is already there
+        const TextureBinding &binding = mBoundTextures[unit];
+        if (binding.name == texture.name() && binding.bindingPoint == texture.bindingPoint()) {
+            GLStateStatistics::Shared().currentFrame().redundantTextureBinds++;
+            return;
         }
 
+        activateUnit(unit);
         bindTextureToActiveUnit(texture);
     }
 
     void GLTextureUnitManager::bindSamplerToUnit(const GLSampler &sampler, GLTextureUnitManager::TextureUnit unit) {
-        if (unit >= mMaximumTextureUnits) {
-            throw std::invalid_argument(string_format("Texture unit %d exceeds maximum texture unit index %d", unit, mMaximumTextureUnits - 1));
-        }
+        validateUnit(unit);
+
+        mSamplerBindingPasses[unit] = mSamplerBindingPass;
+
+        GLStateStatistics::Counters &counters = GLStateStatistics::Shared().currentFrame();
 
-        auto it = mBoundSamplers.find(unit);
-        if (it != mBoundSamplers.end() && it->second == sampler.name()) {
+        if (mBoundSamplers[unit] == sampler.name()) {
+            counters.redundantSamplerBinds++;
             return;
         }
 
         glBindSampler(unit, sampler.name());
         mBoundSamplers[unit] = sampler.name();
+        counters.samplerBinds++;
     }
 
     void GLTextureUnitManager::activateUnit(TextureUnit unit) {
+        GLStateStatistics::Counters &counters = GLStateStatistics::Shared().currentFrame();
+
+        if (mActiveTextureUnit == unit) {
+            counters.redundantTextureUnitActivations++;
+            return;
+        }
+
         glActiveTexture(GL_TEXTURE0 + unit);
         mActiveTextureUnit = unit;
+        counters.textureUnitActivations++;
     }
 
     void GLTextureUnitManager::bindTextureToActiveUnit(const GLTexture &texture) {
-        auto boundTextureInfo = mBoundTextures[mActiveTextureUnit];
-        auto name = boundTextureInfo.first;
-        auto bindingPoint = boundTextureInfo.second;
+        bindTextureToActiveUnit(texture.name(), texture.bindingPoint());
+    }
 
-        if (name == texture.name() && bindingPoint == texture.bindingPoint()) {
+    void GLTextureUnitManager::bindTextureToActiveUnit(ObjectName name, BindingPoint bindingPoint) {
+        TextureBinding &binding = mBoundTextures[mActiveTextureUnit];
+        GLStateStatistics::Counters &counters = GLStateStatistics::Shared().currentFrame();
+
+        if (binding.name == name && binding.bindingPoint == bindingPoint) {
+            counters.redundantTextureBinds++;
             return;
         }
 
-        if (name > 0 && bindingPoint != texture.bindingPoint()) {
+        if (binding.name > 0 && binding.bindingPoint != bindingPoint) {
             // Unbind previous texture
-            glBindTexture(bindingPoint, 0);
+            glBindTexture(binding.bindingPoint, 0);
         }
 
-        glBindTexture(texture.bindingPoint(), texture.name());
-        mBoundTextures[mActiveTextureUnit] = std::make_pair(texture.name(), texture.bindingPoint());
+        glBindTexture(bindingPoint, name);
+        binding.name = name;
+        binding.bindingPoint = bindingPoint;
+        counters.textureBinds++;
     }
 
     void GLTextureUnitManager::unbindAllSamplers() {
-        for (auto &unitSamplerPair : mBoundSamplers) {
-            TextureUnit unit = unitSamplerPair.first;
-            glBindSampler(unit, 0);
+        for (TextureUnit unit = 0; unit < mBoundSamplers.size(); unit++) {
+            if (mBoundSamplers[unit] != 0) {
+                glBindSampler(unit, 0);
+                mBoundSamplers[unit] = 0;
+            }
+        }
+    }
+
+#pragma mark - Sampler binding passes
+
+    void GLTextureUnitManager::beginSamplerBindingPass() {
+        mSamplerBindingPass++;
+    }
+
+    void GLTextureUnitManager::endSamplerBindingPass() {
+        for (TextureUnit unit = 0; unit < mBoundSamplers.size(); unit++) {
+            if (mBoundSamplers[unit] != 0 && mSamplerBindingPasses[unit] != mSamplerBindingPass) {
+                glBindSampler(unit, 0);
+                mBoundSamplers[unit] = 0;
+                GLStateStatistics::Shared().currentFrame().samplerBinds++;
+            }
+        }
+    }
+
+#pragma mark - Deletion
+
+    void GLTextureUnitManager::textureWillBeDeleted(ObjectName name) {
+        if (name == 0) {
+            return;
+        }
+
+        // Driver reverts bindings of deleted textures to zero
+        for (TextureBinding &binding : mBoundTextures) {
+            if (binding.name == name) {
+                binding = TextureBinding();
+            }
+        }
+    }
+
+    void GLTextureUnitManager::samplerWillBeDeleted(ObjectName name) {
+        if (name == 0) {
+            return;
+        }
+
+        for (ObjectName &boundName : mBoundSamplers) {
+            if (boundName == name) {
+                boundName = 0;
+            }
         }
-        mBoundSamplers.clear();
     }
 
 }
@@ -10,23 +10,37 @@
 #define GLTextureUnitManager_hpp
 
 #include <OpenGL/OpenGL.h>
-#include <unordered_map>
+#include <vector>
 
 #include "GLTexture.hpp"
 #include "GLSampler.hpp"
 
 namespace EARenderer {
 
+    // Shadows texture unit state, so that binding calls are only issued
+    // when they actually change what is bound.
+
     class GLTextureUnitManager {
     public:
         using TextureUnit = uint16_t;
-        using ObjectName = GLint;
+        using ObjectName = GLuint;
         using BindingPoint = GLenum;
 
     private:
-        std::unordered_map<TextureUnit, std::pair<ObjectName, BindingPoint>> mBoundTextures;
-        std::unordered_map<ObjectName, std::pair<TextureUnit, BindingPoint>> mBoundTexturesReverse;
-        std::unordered_map<TextureUnit, ObjectName> mBoundSamplers;
+        struct TextureBinding {
+            ObjectName name = 0;
+            BindingPoint bindingPoint = 0;
+        };
+
+        std::vector<TextureBinding> mBoundTextures;
+        std::vector<ObjectName> mBoundSamplers;
+
+        /**
+         Sampler binding pass in which every unit had its sampler bound last time.
+         Units that were not touched during the latest pass are unbound when it ends.
+         */
+        std::vector<uint32_t> mSamplerBindingPasses;
+        uint32_t mSamplerBindingPass = 0;
 
         GLint mMaximumTextureUnits = 0;
         TextureUnit mActiveTextureUnit = 0;
@@ -37,6 +51,8 @@ namespace EARenderer {
 
         GLTextureUnitManager &operator=(const GLTextureUnitManager &rhs) = delete;
 
+        void validateUnit(TextureUnit unit) const;
+
     public:
         static GLTextureUnitManager &Shared();
 
@@ -52,7 +68,27 @@ namespace EARenderer {
 
         void bindTextureToActiveUnit(const GLTexture &texture);
 
+        void bindTextureToActiveUnit(ObjectName name, BindingPoint bindingPoint);
+
         void unbindAllSamplers();
+
+        /**
+         Starts a pass in which samplers for a set of units are going to be bound.
+         Samplers that stay the same are not rebound.
+         */
+        void beginSamplerBindingPass();
+
+        /**
+         Unbinds samplers from units that were not bound to during the current pass
+         */
+        void endSamplerBindingPass();
+
+        /**
+         Forgets bindings of a texture that is about to be deleted, so that its name can be safely reused by the driver
+         */
+        void textureWillBeDeleted(ObjectName name);
+
+        void samplerWillBeDeleted(ObjectName name);
     };
 
 }
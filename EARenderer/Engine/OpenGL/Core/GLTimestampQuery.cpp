@@ -0,0 +1,47 @@
+//
+//  GLTimestampQuery.cpp
+//  EARenderer
+//
+//  Created by Pavlo Muratov on 17.10.2026.
+//  Copyright © 2026 MPO. All rights reserved.
+//
+
+#include "GLTimestampQuery.hpp"
+
+namespace EARenderer {
+
+#pragma mark - Lifecycle
+
+    GLTimestampQuery::GLTimestampQuery() {
+        glGenQueries(1, &mName);
+    }
+
+    GLTimestampQuery::~GLTimestampQuery() {
+        glDeleteQueries(1, &mName);
+    }
+
+#pragma mark - Timing
+
+    uint64_t GLTimestampQuery::CurrentTimestamp() {
+        GLint64 timestamp = 0;
+        glGetInteger64v(GL_TIMESTAMP, &timestamp);
+        return static_cast<uint64_t>(timestamp);
+    }
+
+    void GLTimestampQuery::record() {
+        glQueryCounter(mName, GL_TIMESTAMP);
+    }
+
+    bool GLTimestampQuery::isResultAvailable() const {
+        GLint isAvailable = GL_FALSE;
+        glGetQueryObjectiv(mName, GL_QUERY_RESULT_AVAILABLE, &isAvailable);
+        return isAvailable == GL_TRUE;
+    }
+
+    uint64_t GLTimestampQuery::result() const {
+        GLuint64 timestamp = 0;
+        glGetQueryObjectui64v(mName, GL_QUERY_RESULT, &timestamp);
+        return timestamp;
+    }
+
+}
@@ -0,0 +1,50 @@
+//
+//  GLTimestampQuery.hpp
+//  EARenderer
+//
+//  Created by Pavlo Muratov on 17.10.2026.
+//  Copyright © 2026 MPO. All rights reserved.
+//
+
+#ifndef GLTimestampQuery_hpp
+#define GLTimestampQuery_hpp
+
+#include "GLNamedObject.hpp"
+
+#include <cstdint>
+
+namespace EARenderer {
+
+    // Records GPU time at the point in the command stream where it was issued.
+    // Unlike GL_TIME_ELAPSED queries, timestamps can be freely nested and interleaved.
+
+    class GLTimestampQuery : public GLNamedObject {
+    public:
+        GLTimestampQuery();
+
+        GLTimestampQuery(GLTimestampQuery &&that) = default;
+
+        GLTimestampQuery &operator=(GLTimestampQuery &&rhs) = default;
+
+        ~GLTimestampQuery() override;
+
+        /**
+         @return current GPU time in nanoseconds, obtained without waiting for queued commands to finish
+         */
+        static uint64_t CurrentTimestamp();
+
+        void record();
+
+        bool isResultAvailable() const;
+
+        /**
+         Blocks if the result is not available yet
+
+         @return GPU time in nanoseconds
+         */
+        uint64_t result() const;
+    };
+
+}
+
+#endif /* GLTimestampQuery_hpp */
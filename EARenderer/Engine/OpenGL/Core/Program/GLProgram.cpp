@@ -10,6 +10,7 @@
 #include "FileManager.hpp"
 #include "StringUtils.hpp"
 #include "GLTextureUnitManager.hpp"
+#include "GLStateStatistics.hpp"
 
 #include <sstream>
 #include <regex>
@@ -21,16 +22,45 @@ namespace EARenderer {
 #pragma mark - Lifecycle
 
     GLProgram::GLProgram(const std::string &vertexSourceName, const std::string &fragmentSourceName, const std::string &geometrySourceName)
-            : GLNamedObject(glCreateProgram()),
-              mVertexShader(vertexSourceName.empty() ? nullptr : new GLShader(FileManager::shared().resourceRootPath() + vertexSourceName, GL_VERTEX_SHADER)),
-              mFragmentShader(fragmentSourceName.empty() ? nullptr : new GLShader(FileManager::shared().resourceRootPath() + fragmentSourceName, GL_FRAGMENT_SHADER)),
-              mGeometryShader(geometrySourceName.empty() ? nullptr : new GLShader(FileManager::shared().resourceRootPath() + geometrySourceName, GL_GEOMETRY_SHADER)) {
+            : GLNamedObject(glCreateProgram()) {
+
+        auto assemble = [](const std::string &sourceName) -> std::shared_ptr<const GLSLPreprocessor::AssembledSource> {
+            if (sourceName.empty()) {
+                return nullptr;
+            }
+            return GLSLPreprocessor::Shared().assembleSource(FileManager::shared().resourceRootPath() + sourceName);
+        };
+
+        auto vertexSource = assemble(vertexSourceName);
+        auto fragmentSource = assemble(fragmentSourceName);
+        auto geometrySource = assemble(geometrySourceName);
+
+        auto text = [](const auto &source) {
+            return source ? &source->text : nullptr;
+        };
+
+        GLProgramBinaryCache &binaryCache = GLProgramBinaryCache::Shared();
+        GLProgramBinaryCache::Key key = binaryCache.key({text(vertexSource), text(fragmentSource), text(geometrySource)});
+
+        if (loadBinary(key)) {
+            return;
+        }
+
+        mVertexShader = vertexSource ? new GLShader(vertexSource, GL_VERTEX_SHADER) : nullptr;
+        mFragmentShader = fragmentSource ? new GLShader(fragmentSource, GL_FRAGMENT_SHADER) : nullptr;
+        mGeometryShader = geometrySource ? new GLShader(geometrySource, GL_GEOMETRY_SHADER) : nullptr;
+
+        if (binaryCache.isSupported()) {
+            glProgramParameteri(mName, GL_PROGRAM_BINARY_RETRIEVABLE_HINT, GL_TRUE);
+        }
 
         link();
         bind();
         obtainVertexAttributes();
         obtainUniforms();
         obtainUniformBlocks();
+
+        storeBinary(key);
     }
 
     GLProgram::~GLProgram() {
@@ -76,6 +106,50 @@ namespace EARenderer {
         }
     }
 
+    bool GLProgram::loadBinary(const GLProgramBinaryCache::Key &key) {
+        GLProgramBinaryCache::Entry entry;
+        if (!GLProgramBinaryCache::Shared().load(key, entry)) {
+            return false;
+        }
+
+        glProgramBinary(mName, entry.binaryFormat, entry.binary.data(), static_cast<GLsizei>(entry.binary.size()));
+
+        GLint isLinked = 0;
+        glGetProgramiv(mName, GL_LINK_STATUS, &isLinked);
+
+        if (!isLinked) {
+            return false;
+        }
+
+        // Locations are only guaranteed for the program the binary was retrieved from,
+        // and uniform values and block bindings are not a part of the binary, so reflect the same way a fresh link does
+        bind();
+        obtainVertexAttributes();
+        obtainUniforms();
+        obtainUniformBlocks();
+
+        return true;
+    }
+
+    void GLProgram::storeBinary(const GLProgramBinaryCache::Key &key) const {
+        GLProgramBinaryCache &binaryCache = GLProgramBinaryCache::Shared();
+        if (!binaryCache.isSupported()) {
+            return;
+        }
+
+        GLint binaryLength = 0;
+        glGetProgramiv(mName, GL_PROGRAM_BINARY_LENGTH, &binaryLength);
+        if (binaryLength <= 0) {
+            return;
+        }
+
+        GLProgramBinaryCache::Entry entry;
+        entry.binary.resize(binaryLength);
+        glGetProgramBinary(mName, binaryLength, nullptr, &entry.binaryFormat, entry.binary.data());
+
+        binaryCache.store(key, entry);
+    }
+
     void GLProgram::obtainVertexAttributes() {
         GLint count = 0;
         glGetProgramiv(mName, GL_ACTIVE_ATTRIBUTES, &count);
@@ -163,6 +237,23 @@ namespace EARenderer {
         return nameHash % maximumUBOBindings;
     }
 
+    GLint GLProgram::uniformLocationForUpload(CRC32 uniformNameCRC32, const void *value, size_t byteSize) {
+        auto it = mUniforms.find(uniformNameCRC32);
+        if (it == mUniforms.end()) {
+            throw std::invalid_argument("Uniform couldn't be found");
+        }
+
+        GLStateStatistics::Counters &counters = GLStateStatistics::Shared().currentFrame();
+
+        if (!it->second.updateCachedValue(value, byteSize)) {
+            counters.redundantUniformUploads++;
+            return -1;
+        }
+
+        counters.uniformUploads++;
+        return it->second.location();
+    }
+
 #pragma mark - Swap
 
     void GLProgram::swap(GLProgram &that) {
@@ -232,12 +323,81 @@ namespace EARenderer {
         glBindBufferRange(GL_UNIFORM_BUFFER, block.binding(), UBO.name(), location.offset, location.dataSize);
     }
 
+#pragma mark - Uniform setters
+
+    void GLProgram::setUniform1i(CRC32 uniformNameCRC32, GLint value) {
+        GLint location = uniformLocationForUpload(uniformNameCRC32, &value, sizeof(value));
+        if (location != -1) {
+            glUniform1i(location, value);
+        }
+    }
+
+    void GLProgram::setUniform1ui(CRC32 uniformNameCRC32, GLuint value) {
+        GLint location = uniformLocationForUpload(uniformNameCRC32, &value, sizeof(value));
+        if (location != -1) {
+            glUniform1ui(location, value);
+        }
+    }
+
+    void GLProgram::setUniform1f(CRC32 uniformNameCRC32, GLfloat value) {
+        GLint location = uniformLocationForUpload(uniformNameCRC32, &value, sizeof(value));
+        if (location != -1) {
+            glUniform1f(location, value);
+        }
+    }
+
+    void GLProgram::setUniform1fv(CRC32 uniformNameCRC32, GLsizei count, const GLfloat *values) {
+        GLint location = uniformLocationForUpload(uniformNameCRC32, values, sizeof(GLfloat) * count);
+        if (location != -1) {
+            glUniform1fv(location, count, values);
+        }
+    }
+
+    void GLProgram::setUniform2fv(CRC32 uniformNameCRC32, GLsizei count, const GLfloat *values) {
+        GLint location = uniformLocationForUpload(uniformNameCRC32, values, sizeof(GLfloat) * 2 * count);
+        if (location != -1) {
+            glUniform2fv(location, count, values);
+        }
+    }
+
+    void GLProgram::setUniform3fv(CRC32 uniformNameCRC32, GLsizei count, const GLfloat *values) {
+        GLint location = uniformLocationForUpload(uniformNameCRC32, values, sizeof(GLfloat) * 3 * count);
+        if (location != -1) {
+            glUniform3fv(location, count, values);
+        }
+    }
+
+    void GLProgram::setUniform4fv(CRC32 uniformNameCRC32, GLsizei count, const GLfloat *values) {
+        GLint location = uniformLocationForUpload(uniformNameCRC32, values, sizeof(GLfloat) * 4 * count);
+        if (location != -1) {
+            glUniform4fv(location, count, values);
+        }
+    }
+
+    void GLProgram::setUniform3iv(CRC32 uniformNameCRC32, GLsizei count, const GLint *values) {
+        GLint location = uniformLocationForUpload(uniformNameCRC32, values, sizeof(GLint) * 3 * count);
+        if (location != -1) {
+            glUniform3iv(location, count, values);
+        }
+    }
+
+    void GLProgram::setUniformMatrix4fv(CRC32 uniformNameCRC32, GLsizei count, const GLfloat *values) {
+        GLint location = uniformLocationForUpload(uniformNameCRC32, values, sizeof(GLfloat) * 16 * count);
+        if (location != -1) {
+            glUniformMatrix4fv(location, count, GL_FALSE, values);
+        }
+    }
+
 #pragma mark - Public
 
     void GLProgram::ensureSamplerValidity(UniformModifierClosure closure) {
         isModifyingUniforms = true;
-        GLTextureUnitManager::Shared().unbindAllSamplers();
+
+        // Samplers that are bound again inside the closure are left untouched,
+        // only the ones that the closure didn't bind are reset
+        GLTextureUnitManager::Shared().beginSamplerBindingPass();
         closure();
+        GLTextureUnitManager::Shared().endSamplerBindingPass();
 
         // For some reason this is sometimes necessary to make GLSL sampler not return Black
         GLTextureUnitManager::Shared().activateUnit(GLTextureUnitManager::Shared().maximumTextureUnits() - 1);
@@ -17,6 +17,7 @@
 #include <type_traits>
 #include <stdexcept>
 #include <memory>
+#include <functional>
 
 #include <glm/mat4x4.hpp>
 #include <glm/gtc/type_ptr.hpp>
@@ -26,6 +27,7 @@
 #include "GLUniform.hpp"
 #include "GLUniformBlock.hpp"
 #include "GLShader.hpp"
+#include "GLProgramBinaryCache.hpp"
 #include "GLSampler.hpp"
 #include "GLTexture2D.hpp"
 #include "GLTextureCubemap.hpp"
@@ -33,6 +35,7 @@
 #include "GLTexture2DArray.hpp"
 #include "GLBufferTexture.hpp"
 #include "GLUniformBuffer.hpp"
+#include "GLTextureUnitManager.hpp"
 #include "CRC32.hpp"
 
 namespace EARenderer {
@@ -57,6 +60,15 @@ namespace EARenderer {
 
         void link();
 
+        /**
+         Recreates the program from a cached binary and queries its attributes, uniforms and uniform blocks
+
+         @return false if there is no cached binary or the driver rejected it
+         */
+        bool loadBinary(const GLProgramBinaryCache::Key &key);
+
+        void storeBinary(const GLProgramBinaryCache::Key &key) const;
+
         void obtainVertexAttributes();
 
         void obtainUniforms();
@@ -65,6 +77,13 @@ namespace EARenderer {
 
         GLuint uniformBlockBinding(const std::string& UBOName, GLint maximumUBOBindings);
 
+        /**
+         Compares the value with the one last uploaded to the uniform
+
+         @return uniform location or -1 if the uniform already holds the same value and the upload should be skipped
+         */
+        GLint uniformLocationForUpload(CRC32 uniformNameCRC32, const void *value, size_t byteSize);
+
     protected:
         GLProgram(const std::string &vertexSourceName, const std::string &fragmentSourceName, const std::string &geometrySourceName);
 
@@ -82,11 +101,35 @@ namespace EARenderer {
                 throw std::runtime_error("Passing empty texture buffer to a uniform is not allowed");
             }
 
-            GLUniform sampler = uniformByNameCRC32(uniformNameCRC32);
-            glActiveTexture(GL_TEXTURE0 + sampler.textureUnit());
-            bufferTexture.bind();
+            const GLUniform &sampler = uniformByNameCRC32(uniformNameCRC32);
+            GLTextureUnitManager &unitManager = GLTextureUnitManager::Shared();
+
+            // Texture buffer attachment is made through the active unit, so the unit is always activated
+            unitManager.activateUnit(sampler.textureUnit());
+            unitManager.bindTextureToActiveUnit(bufferTexture.name(), GL_TEXTURE_BUFFER);
+            bufferTexture.buffer().bind();
         }
 
+        // Uniform setters skip uploads of values that the program already holds
+
+        void setUniform1i(CRC32 uniformNameCRC32, GLint value);
+
+        void setUniform1ui(CRC32 uniformNameCRC32, GLuint value);
+
+        void setUniform1f(CRC32 uniformNameCRC32, GLfloat value);
+
+        void setUniform1fv(CRC32 uniformNameCRC32, GLsizei count, const GLfloat *values);
+
+        void setUniform2fv(CRC32 uniformNameCRC32, GLsizei count, const GLfloat *values);
+
+        void setUniform3fv(CRC32 uniformNameCRC32, GLsizei count, const GLfloat *values);
+
+        void setUniform4fv(CRC32 uniformNameCRC32, GLsizei count, const GLfloat *values);
+
+        void setUniform3iv(CRC32 uniformNameCRC32, GLsizei count, const GLint *values);
+
+        void setUniformMatrix4fv(CRC32 uniformNameCRC32, GLsizei count, const GLfloat *values);
+
     public:
         using UniformModifierClosure = const std::function<void()> &;
 
@@ -0,0 +1,139 @@
+//
+//  GLProgramBinaryCache.cpp
+//  EARenderer
+//
+//  Created by Pavlo Muratov on 17.10.2026.
+//  Copyright © 2026 MPO. All rights reserved.
+//
+
+#include "GLProgramBinaryCache.hpp"
+#include "BakeContainer.hpp"
+#include "FileManager.hpp"
+#include "StringUtils.hpp"
+#include "CRC32.hpp"
+
+#include <stdexcept>
+
+namespace EARenderer {
+
+    static constexpr uint32_t ProgramBinaryContentTag = ctcrc32("ProgramBinary");
+    static constexpr uint32_t ProgramRecordSectionTag = ctcrc32("ProgramRecord");
+    static constexpr uint32_t BinarySectionTag = ctcrc32("Binary");
+
+    /// Bumped whenever the file layout changes. Version 1 also stored uniform reflection data.
+    static constexpr uint32_t ProgramBinaryFormatVersion = 2;
+
+    struct ProgramRecord {
+        uint32_t formatVersion;
+        uint32_t checksum;
+        uint64_t sourceLength;
+        uint32_t rendererChecksum;
+        uint32_t binaryFormat;
+    };
+
+    static std::string GLString(GLenum name) {
+        const GLubyte *string = glGetString(name);
+        return string ? reinterpret_cast<const char *>(string) : "";
+    }
+
+#pragma mark - Lifecycle
+
+    GLProgramBinaryCache::GLProgramBinaryCache() {
+        GLint formatCount = 0;
+        glGetIntegerv(GL_NUM_PROGRAM_BINARY_FORMATS, &formatCount);
+        mIsSupported = formatCount > 0;
+
+        std::string renderer = GLString(GL_VENDOR) + GLString(GL_RENDERER) + GLString(GL_VERSION);
+        mRendererChecksum = crc32(renderer.data(), renderer.size());
+    }
+
+    GLProgramBinaryCache &GLProgramBinaryCache::Shared() {
+        static GLProgramBinaryCache cache;
+        return cache;
+    }
+
+#pragma mark - Private helpers
+
+    std::string GLProgramBinaryCache::filePath(const Key &key) const {
+        return string_format("%sprogram_%08x.eaprogram", FileManager::shared().resourceRootPath().c_str(), key.checksum);
+    }
+
+#pragma mark - Getters
+
+    bool GLProgramBinaryCache::isSupported() const {
+        return mIsSupported;
+    }
+
+    GLProgramBinaryCache::Key GLProgramBinaryCache::key(const std::vector<const std::string *> &stageSources) const {
+        Key key;
+        key.checksum = mRendererChecksum;
+
+        for (const std::string *source : stageSources) {
+            // Length prefix keeps sources of different stages from being shifted into one another
+            uint64_t length = source ? source->size() : 0;
+            key.checksum = crc32(&length, sizeof(length), key.checksum);
+            if (source) {
+                key.checksum = crc32(source->data(), source->size(), key.checksum);
+            }
+            key.sourceLength += length;
+        }
+
+        return key;
+    }
+
+#pragma mark - Loading & storing
+
+    bool GLProgramBinaryCache::load(const Key &key, Entry &entry) const {
+        std::string path = filePath(key);
+
+        if (!mIsSupported || !BakeContainer::HasSignature(path)) {
+            return false;
+        }
+
+        try {
+            BakeContainer container(path, ProgramBinaryContentTag);
+
+            auto programRecords = container.section<ProgramRecord>(ProgramRecordSectionTag);
+            auto binary = container.section<uint8_t>(BinarySectionTag);
+
+            if (programRecords.size() != 1) {
+                return false;
+            }
+
+            const ProgramRecord &record = *programRecords.begin();
+
+            if (record.formatVersion != ProgramBinaryFormatVersion ||
+                    record.checksum != key.checksum ||
+                    record.sourceLength != key.sourceLength ||
+                    record.rendererChecksum != mRendererChecksum) {
+                return false;
+            }
+
+            entry.binaryFormat = record.binaryFormat;
+            entry.binary.assign(binary.begin(), binary.end());
+
+            return true;
+        } catch (const std::runtime_error &) {
+            return false;
+        }
+    }
+
+    void GLProgramBinaryCache::store(const Key &key, const Entry &entry) const {
+        if (!mIsSupported || entry.binary.empty()) {
+            return;
+        }
+
+        ProgramRecord record{ProgramBinaryFormatVersion, key.checksum, key.sourceLength, mRendererChecksum, entry.binaryFormat};
+
+        BakeContainer::Writer writer(ProgramBinaryContentTag);
+        writer.addSection(ProgramRecordSectionTag, &record, sizeof(ProgramRecord), 1);
+        writer.addSection(BinarySectionTag, entry.binary);
+
+        try {
+            writer.write(filePath(key));
+        } catch (const std::runtime_error &) {
+            // Resource directory may be read-only
+        }
+    }
+
+}
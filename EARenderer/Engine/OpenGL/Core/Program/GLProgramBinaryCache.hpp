@@ -0,0 +1,77 @@
+//
+//  GLProgramBinaryCache.hpp
+//  EARenderer
+//
+//  Created by Pavlo Muratov on 17.10.2026.
+//  Copyright © 2026 MPO. All rights reserved.
+//
+
+#ifndef GLProgramBinaryCache_hpp
+#define GLProgramBinaryCache_hpp
+
+#include <OpenGL/gl3.h>
+
+#include <string>
+#include <vector>
+#include <cstdint>
+
+namespace EARenderer {
+
+    // Stores linked program binaries.
+    //
+    // Entries are keyed by a checksum of the assembled sources of all stages and of the renderer
+    // and driver version strings, so that a driver update or any edit of a shader or its includes
+    // produces a new entry instead of loading an incompatible binary.
+    // Some drivers expose no binary formats at all, in which case the cache is disabled.
+
+    class GLProgramBinaryCache {
+    public:
+        struct Key {
+            uint32_t checksum = 0;
+            uint64_t sourceLength = 0;
+        };
+
+        struct Entry {
+            GLenum binaryFormat = 0;
+            std::vector<uint8_t> binary;
+        };
+
+    private:
+        bool mIsSupported = false;
+        uint32_t mRendererChecksum = 0;
+
+        GLProgramBinaryCache();
+
+        std::string filePath(const Key &key) const;
+
+    public:
+        static GLProgramBinaryCache &Shared();
+
+        GLProgramBinaryCache(const GLProgramBinaryCache &that) = delete;
+
+        GLProgramBinaryCache &operator=(const GLProgramBinaryCache &rhs) = delete;
+
+        bool isSupported() const;
+
+        /**
+         @param stageSources assembled source of every stage of the program, empty for missing stages
+         @return key identifying the program on the current renderer
+         */
+        Key key(const std::vector<const std::string *> &stageSources) const;
+
+        /**
+         @param key program key
+         @param entry receives the stored binary
+         @return false if there is no valid entry for the key
+         */
+        bool load(const Key &key, Entry &entry) const;
+
+        /**
+         Persists an entry. Failures to write are ignored, the program will simply be compiled again next time.
+         */
+        void store(const Key &key, const Entry &entry) const;
+    };
+
+}
+
+#endif /* GLProgramBinaryCache_hpp */
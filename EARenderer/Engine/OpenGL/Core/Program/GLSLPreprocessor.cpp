@@ -0,0 +1,154 @@
+//
+//  GLSLPreprocessor.cpp
+//  EARenderer
+//
+//  Created by Pavlo Muratov on 17.10.2026.
+//  Copyright © 2026 MPO. All rights reserved.
+//
+
+#include "GLSLPreprocessor.hpp"
+#include "StringUtils.hpp"
+
+#include <fstream>
+#include <sstream>
+#include <stdexcept>
+
+#include <filesystem/path.h>
+
+namespace EARenderer {
+
+#pragma mark - Lifecycle
+
+    GLSLPreprocessor &GLSLPreprocessor::Shared() {
+        static GLSLPreprocessor preprocessor;
+        return preprocessor;
+    }
+
+#pragma mark - Private helpers
+
+    bool GLSLPreprocessor::ParseIncludeDirective(std::string_view line, std::string_view &includePath) {
+        static constexpr std::string_view Directive = "#include \"";
+
+        if (line.substr(0, Directive.size()) != Directive) {
+            return false;
+        }
+
+        size_t closingQuote = line.find_last_of('"');
+        if (closingQuote < Directive.size()) {
+            return false;
+        }
+
+        for (size_t i = closingQuote + 1; i < line.size(); i++) {
+            if (line[i] != ' ' && line[i] != '\t') {
+                return false;
+            }
+        }
+
+        includePath = line.substr(Directive.size(), closingQuote - Directive.size());
+        return true;
+    }
+
+    const std::string &GLSLPreprocessor::fileContent(const std::string &filePath) {
+        auto it = mFileContents.find(filePath);
+        if (it != mFileContents.end()) {
+            return it->second;
+        }
+
+        std::ifstream stream(filePath);
+        if (!stream.is_open()) {
+            throw std::invalid_argument(string_format("Can't read shader file: %s", filePath.c_str()));
+        }
+
+        std::stringstream buffer;
+        buffer << stream.rdbuf();
+        return mFileContents.emplace(filePath, buffer.str()).first->second;
+    }
+
+    void GLSLPreprocessor::assemble(const std::string &filePath, AssembledSource &source, int32_t &lineCount, std::unordered_set<std::string> &processedIncludes) {
+        const std::string &content = fileContent(filePath);
+
+        filesystem::path sourcePath(filePath);
+
+        // Allocate a new pair of indices for the new source code piece that will be read from 'filePath'
+        std::vector<IndexPair> &sourceChunkIndicesArray = source.includeLineIndices[sourcePath.filename()];
+        sourceChunkIndicesArray.emplace_back();
+        size_t currentChunk = sourceChunkIndicesArray.size() - 1;
+        // Remember the staring line of the current source code chunk
+        sourceChunkIndicesArray[currentChunk].first = lineCount;
+
+        size_t lineStart = 0;
+
+        while (lineStart < content.size()) {
+            size_t lineEnd = content.find('\n', lineStart);
+            if (lineEnd == std::string::npos) {
+                lineEnd = content.size();
+            }
+
+            std::string_view line(content.data() + lineStart, lineEnd - lineStart);
+            lineStart = lineEnd + 1;
+
+            // If no #include directives are found, just add the line to the assembled source code as-is
+            std::string_view quotelessPath;
+            if (!ParseIncludeDirective(line, quotelessPath)) {
+                source.text.append(line);
+                source.text.push_back('\n');
+                lineCount++;
+                continue;
+            }
+
+            filesystem::path includePath{std::string(quotelessPath)};
+            filesystem::path fullIncludePath = sourcePath.parent_path() / includePath;
+
+            if (!fullIncludePath.is_file()) {
+                throw std::runtime_error(string_format("glsl #include directive (%s) does not reference a real file", std::string(line).c_str()));
+            }
+
+            // Skip duplicated includes
+            if (!processedIncludes.insert(includePath.filename()).second) {
+                continue;
+            }
+
+            // Remember the end of the current source chunk before including the next one
+            sourceChunkIndicesArray[currentChunk].second = lineCount - 1;
+
+            // Recursion may add chunks to the same array, so chunks are referred to by index
+            assemble(fullIncludePath.str(), source, lineCount, processedIncludes);
+
+            // After including another file, allocate new pair of indices to
+            // indicate a starting line where the rest of the current file is inserted until
+            // the next #include or EOF is reached
+            //
+            sourceChunkIndicesArray.emplace_back();
+            currentChunk = sourceChunkIndicesArray.size() - 1;
+            sourceChunkIndicesArray[currentChunk].first = lineCount;
+        }
+
+        // Mark the end of the current source chunk
+        if (sourceChunkIndicesArray[currentChunk].second == 0) {
+            sourceChunkIndicesArray[currentChunk].second = lineCount - 1;
+        }
+    }
+
+#pragma mark - Public interface
+
+    std::shared_ptr<const GLSLPreprocessor::AssembledSource> GLSLPreprocessor::assembleSource(const std::string &filePath) {
+        auto it = mAssembledSources.find(filePath);
+        if (it != mAssembledSources.end()) {
+            return it->second;
+        }
+
+        auto source = std::make_shared<AssembledSource>();
+        int32_t lineCount = 0;
+        std::unordered_set<std::string> processedIncludes;
+        assemble(filePath, *source, lineCount, processedIncludes);
+
+        mAssembledSources.emplace(filePath, source);
+        return source;
+    }
+
+    void GLSLPreprocessor::clearCache() {
+        mFileContents.clear();
+        mAssembledSources.clear();
+    }
+
+}
@@ -0,0 +1,84 @@
+//
+//  GLSLPreprocessor.hpp
+//  EARenderer
+//
+//  Created by Pavlo Muratov on 17.10.2026.
+//  Copyright © 2026 MPO. All rights reserved.
+//
+
+#ifndef GLSLPreprocessor_hpp
+#define GLSLPreprocessor_hpp
+
+#include <string>
+#include <string_view>
+#include <vector>
+#include <memory>
+#include <unordered_map>
+#include <unordered_set>
+
+namespace EARenderer {
+
+    // Expands #include directives of GLSL source files.
+    //
+    // Files are read once per process and every assembled root file is cached, so that
+    // programs sharing shader stages or include files don't hit the disk again.
+
+    class GLSLPreprocessor {
+    public:
+        using IncludePath = std::string;
+        using IndexPair = std::pair<int32_t, int32_t>;
+
+        struct AssembledSource {
+            std::string text;
+
+            /**
+             First and last line of every chunk that was taken from a particular file, keyed by file name.
+             Used to map lines reported by the GLSL compiler back to source files.
+             */
+            std::unordered_map<IncludePath, std::vector<IndexPair>> includeLineIndices;
+        };
+
+    private:
+        std::unordered_map<std::string, std::string> mFileContents;
+        std::unordered_map<std::string, std::shared_ptr<const AssembledSource>> mAssembledSources;
+
+        GLSLPreprocessor() = default;
+
+        /**
+         Matches lines of exactly the form: #include "path" followed by optional spaces or tabs
+
+         @param line single source line
+         @param includePath path between the quotes
+         @return true if the line is an include directive
+         */
+        static bool ParseIncludeDirective(std::string_view line, std::string_view &includePath);
+
+        const std::string &fileContent(const std::string &filePath);
+
+        void assemble(const std::string &filePath, AssembledSource &source, int32_t &lineCount, std::unordered_set<std::string> &processedIncludes);
+
+    public:
+        static GLSLPreprocessor &Shared();
+
+        GLSLPreprocessor(const GLSLPreprocessor &that) = delete;
+
+        GLSLPreprocessor &operator=(const GLSLPreprocessor &rhs) = delete;
+
+        /**
+         Parses #include tree and composes a single source file.
+         Included files are expected to be referenced relative to the including file. Repeated includes are skipped.
+
+         @param filePath path to the root GLSL source file
+         @return source composed from the root file and its includes
+         */
+        std::shared_ptr<const AssembledSource> assembleSource(const std::string &filePath);
+
+        /**
+         Forgets all file contents and assembled sources, so that edited shader files are picked up
+         */
+        void clearCache();
+    };
+
+}
+
+#endif /* GLSLPreprocessor_hpp */
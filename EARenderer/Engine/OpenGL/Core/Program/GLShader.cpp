@@ -9,12 +9,8 @@
 #include "GLShader.hpp"
 #include "StringUtils.hpp"
 
-#include <fstream>
 #include <vector>
 #include <regex>
-#include <sstream>
-
-#include <filesystem/path.h>
 
 namespace EARenderer {
 
@@ -22,9 +18,15 @@ namespace EARenderer {
 
     GLShader::GLShader(const std::string &sourcePath, GLenum type)
             :
-            mType(type) {
+            GLShader(GLSLPreprocessor::Shared().assembleSource(sourcePath), type) {
+    }
+
+    GLShader::GLShader(std::shared_ptr<const GLSLPreprocessor::AssembledSource> source, GLenum type)
+            :
+            mType(type),
+            mSource(std::move(source)) {
         mName = glCreateShader(type);
-        compile(assembleSource(sourcePath));
+        compile();
     }
 
     GLShader::~GLShader() {
@@ -33,87 +35,6 @@ namespace EARenderer {
 
 #pragma mark - Private helper methods
 
-    std::string GLShader::assembleSource(const std::string &filePath) {
-        std::ifstream stream(filePath);
-        if (!stream.is_open()) {
-            throw std::invalid_argument(string_format("Can't read shader file: %s", filePath.c_str()));
-        }
-
-        filesystem::path sourcePath(filePath);
-
-        // Allocate a new pair of indices for the new source code piece that will be read from 'filePath'
-        std::vector<IndexPair> &sourceChunkIndicesArray = mIncludeLineIndices[sourcePath.filename()];
-        IndexPair *currentChunkIndices = &sourceChunkIndicesArray.emplace_back();
-        // Remember the staring line of the current source code chunk
-        currentChunkIndices->first = mNumberOfLines;
-
-        // Search for #include directives
-        std::regex includeExpression("^#include \".*\"[ \t]*$");
-        std::regex filePathExpression("\".*\"");
-
-        std::string source;
-        std::string line;
-
-        // Read source file line by line
-        while (std::getline(stream, line)) {
-
-            // If no #include directives are found, just add the line to the assembled source code as-is
-
-            // Check for include directives
-            if (!std::regex_match(line, includeExpression)) {
-                source.append(string_format("%s\n", line.c_str()));
-                mNumberOfLines++;
-                continue;
-            }
-
-            // Extract file path from the include directive
-            std::smatch match;
-            if (!std::regex_search(line, match, filePathExpression)) {
-                source.append(string_format("%s\n", line.c_str()));
-                mNumberOfLines++;
-                continue;
-            }
-
-            // Extracting included file and it's path from the #inculde directive
-            std::string stringMatch(match[0]);
-            std::string quotelessPath(std::string(stringMatch.begin() + 1, stringMatch.end() - 1));
-
-            filesystem::path includePath(quotelessPath);
-            filesystem::path fullIncludePath = sourcePath.parent_path() / includePath;
-
-            if (!fullIncludePath.is_file()) {
-                throw std::runtime_error(string_format("glsl #include directive (%s) does not reference a real file", line.c_str()));
-            }
-
-            // Skip duplicated includes
-            if (mProcessedIncludes.find(includePath.filename()) != mProcessedIncludes.end()) {
-                continue;
-            }
-
-            mProcessedIncludes.insert(includePath.filename());
-
-            // Remember the end of the current source chunk before including the next one
-            currentChunkIndices->second = mNumberOfLines - 1;
-
-            std::string includedFileContent = assembleSource(fullIncludePath.str());
-            source.append(includedFileContent);
-
-            // After including another file, allocate new pair of indices to
-            // indicate a starting line where the rest of the current file is inserted until
-            // the next #include or EOF is reached
-            //
-            currentChunkIndices = &sourceChunkIndicesArray.emplace_back();
-            currentChunkIndices->first = mNumberOfLines;
-        }
-
-        // Mark the end of the current source chunk
-        if (currentChunkIndices->second == 0) {
-            currentChunkIndices->second = mNumberOfLines - 1;
-        }
-
-        return source;
-    }
-
     int32_t GLShader::errorLine(const std::string &infoLog) {
         std::regex regex("\\d+:\\d+");
         std::smatch match;
@@ -133,14 +54,14 @@ namespace EARenderer {
 
     std::string GLShader::errorHeader(int32_t errorLine) {
         // Iterate over arrays of chunks where each array belongs to 1 source file
-        for (const auto &it : mIncludeLineIndices) {
+        for (const auto &it : mSource->includeLineIndices) {
             const auto &fileName = it.first;
             const auto &indexPairArray = it.second;
 
             // Iterate over chunks of 1 particular source file
             int32_t linesInSourceFile = 0;
 
-            for (const IndexPair &sourceChunkIndices : indexPairArray) {
+            for (const GLSLPreprocessor::IndexPair &sourceChunkIndices : indexPairArray) {
                 // Check to see whether error line is located in the current chunk,
                 // if not, move to the next one
                 if (errorLine >= sourceChunkIndices.first && errorLine <= sourceChunkIndices.second) {
@@ -159,8 +80,8 @@ namespace EARenderer {
         return "Unknown shader compilation error\n";
     }
 
-    void GLShader::compile(const std::string &source) {
-        const char *cStr = source.c_str();
+    void GLShader::compile() {
+        const char *cStr = mSource->text.c_str();
         glShaderSource(mName, 1, &cStr, nullptr);
         glCompileShader(mName);
 
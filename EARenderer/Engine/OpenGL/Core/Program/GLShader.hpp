@@ -10,33 +10,18 @@
 #define GLShader_hpp
 
 #include <string>
-#include <vector>
-#include <unordered_map>
-#include <unordered_set>
+#include <memory>
 
 #include "GLNamedObject.hpp"
+#include "GLSLPreprocessor.hpp"
 #include "Range.hpp"
 
 namespace EARenderer {
 
     class GLShader : public GLNamedObject {
     private:
-        using IncludePath = std::string;
-        using IndexPair = std::pair<int32_t, int32_t>;
-
         GLenum mType;
-        int32_t mNumberOfLines = 0;
-        std::unordered_map<IncludePath, std::vector<IndexPair>> mIncludeLineIndices;
-        std::unordered_set<std::string> mProcessedIncludes;
-
-        /**
-         Parses #include tree and composes a single source file.
-         Current implementation expects all included files to be in the same folder as the root file.
-
-         @param filePath path to the root GLSL source file
-         @return source string composed from all files: root and it's includes
-         */
-        std::string assembleSource(const std::string &filePath);
+        std::shared_ptr<const GLSLPreprocessor::AssembledSource> mSource;
 
         /**
          Retrieves an error line number from info log message provided by OpenGL API
@@ -57,17 +42,17 @@ namespace EARenderer {
         std::string errorHeader(int32_t errorLine);
 
         /**
-         Compiles an OpenGL shader from a string
-
-         @param source source code
+         Compiles an OpenGL shader from the assembled source
          */
-        void compile(const std::string &source);
+        void compile();
 
     public:
         using GLNamedObject::GLNamedObject;
 
         GLShader(const std::string &sourcePath, GLenum type);
 
+        GLShader(std::shared_ptr<const GLSLPreprocessor::AssembledSource> source, GLenum type);
+
         GLShader(const GLShader &) = delete;
 
         GLShader &operator=(const GLShader &) = delete;
@@ -8,6 +8,8 @@
 
 #include "GLUniform.hpp"
 
+#include <cstring>
+
 namespace EARenderer {
 
 #pragma mark - Lifecycle
@@ -46,6 +48,18 @@ namespace EARenderer {
         mTextureUnit = unit;
     }
 
+#pragma mark - Value cache
+
+    bool GLUniform::updateCachedValue(const void *value, size_t byteSize) {
+        if (mCachedValue.size() == byteSize && std::memcmp(mCachedValue.data(), value, byteSize) == 0) {
+            return false;
+        }
+
+        const uint8_t *bytes = reinterpret_cast<const uint8_t *>(value);
+        mCachedValue.assign(bytes, bytes + byteSize);
+        return true;
+    }
+
 #pragma mark - Utility
 
     bool GLUniform::isValid() const {
@@ -11,6 +11,8 @@
 
 #include <OpenGL/gl3.h>
 #include <string>
+#include <vector>
+#include <cstdint>
 
 namespace EARenderer {
 
@@ -22,6 +24,12 @@ namespace EARenderer {
         GLint mTextureUnit = -1;
         std::string mName = "";
 
+        /**
+         Bytes of the last value uploaded to this uniform. Uniform values are a part of program state,
+         so identical uploads can be skipped as long as the program isn't modified behind the uniform's back.
+         */
+        std::vector<uint8_t> mCachedValue;
+
     public:
         GLUniform() = default;
 
@@ -44,6 +52,15 @@ namespace EARenderer {
         bool isValid() const;
 
         bool isSampler() const;
+
+        /**
+         Remembers the value that is about to be uploaded
+
+         @param value value bytes
+         @param byteSize size of the value in bytes
+         @return false if the value is identical to the previously uploaded one and the upload can be skipped
+         */
+        bool updateCachedValue(const void *value, size_t byteSize);
     };
 
 }
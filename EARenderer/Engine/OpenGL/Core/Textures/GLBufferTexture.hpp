@@ -12,6 +12,7 @@
 #include "GLNamedObject.hpp"
 #include "GLTextureBuffer.hpp"
 #include "GLTexture.hpp"
+#include "GLTextureUnitManager.hpp"
 
 namespace EARenderer {
 
@@ -44,6 +45,7 @@ namespace EARenderer {
 
     template<typename TextureFormat, TextureFormat Format, typename BufferDataType>
     GLBufferTexture<TextureFormat, Format, BufferDataType>::~GLBufferTexture() {
+        GLTextureUnitManager::Shared().textureWillBeDeleted(this->mName);
         glDeleteTextures(1, &mName);
     }
 
@@ -7,6 +7,7 @@
 //
 
 #include "GLSampler.hpp"
+#include "GLTextureUnitManager.hpp"
 
 #include <OpenGL/gl3ext.h>
 
@@ -22,6 +23,7 @@ namespace EARenderer {
     }
 
     GLSampler::~GLSampler() {
+        GLTextureUnitManager::Shared().samplerWillBeDeleted(mName);
         glDeleteSamplers(1, &mName);
     }
 
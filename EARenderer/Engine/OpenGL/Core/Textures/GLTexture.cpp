@@ -25,6 +25,7 @@ namespace EARenderer {
     }
 
     GLTexture::~GLTexture() {
+        GLTextureUnitManager::Shared().textureWillBeDeleted(mName);
         glDeleteTextures(1, &mName);
     }
 
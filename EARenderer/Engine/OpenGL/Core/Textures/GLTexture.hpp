@@ -40,6 +40,15 @@ namespace EARenderer {
             Default
         };
 
+        /**
+         Block compressed data of a single mip level
+         */
+        struct CompressedLevel {
+            Size2D size;
+            const void *data;
+            size_t byteSize;
+        };
+
     private:
         GLenum mBindingPoint;
 
@@ -12,6 +12,8 @@
 #include "GLTexture.hpp"
 #include "GLTexture2DSampler.hpp"
 
+#include <vector>
+
 namespace EARenderer {
 
     template<class TextureFormat, TextureFormat Format>
@@ -31,6 +33,27 @@ namespace EARenderer {
             setWrapMode(wrapMode);
         }
 
+        void initialize(GLenum compressedFormat, const std::vector<CompressedLevel> &levels, Sampling::Filter filter, Sampling::WrapMode wrapMode) {
+            if (levels.empty()) {
+                throw std::invalid_argument("Compressed texture must have at least one level");
+            }
+
+            mSize = levels.front().size;
+
+            for (size_t level = 0; level < levels.size(); level++) {
+                const CompressedLevel &compressedLevel = levels[level];
+                glCompressedTexImage2D(GL_TEXTURE_2D, GLint(level), compressedFormat,
+                        compressedLevel.size.width, compressedLevel.size.height, 0,
+                        GLsizei(compressedLevel.byteSize), compressedLevel.data);
+            }
+
+            glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAX_LEVEL, GLint(levels.size() - 1));
+            mMipMapsCount = uint16_t(levels.size() - 1);
+
+            setFilter(filter);
+            setWrapMode(wrapMode);
+        }
+
     public:
         GLTexture2D() : GLTexture(GL_TEXTURE_2D) {};
 
@@ -55,6 +78,19 @@ namespace EARenderer {
             this->initialize(size, filter, wrapMode, data);
         }
 
+        /**
+         Creates a texture from precomputed, block compressed mip levels
+
+         @param compressedFormat GL's internal format of the blocks
+         @param levels complete mip chain starting with the largest level
+         */
+        GLNormalizedTexture2D(GLenum compressedFormat,
+                const std::vector<GLTexture::CompressedLevel> &levels,
+                Sampling::Filter filter = Sampling::Filter::Bilinear,
+                Sampling::WrapMode wrapMode = Sampling::WrapMode::ClampToEdge) {
+            this->initialize(compressedFormat, levels, filter, wrapMode);
+        }
+
         ~GLNormalizedTexture2D() = default;
     };
 
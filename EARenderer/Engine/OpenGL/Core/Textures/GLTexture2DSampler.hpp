@@ -12,6 +12,8 @@
 #include "GLTextureFetcher.hpp"
 #include "GLTextureDataInterpreter.hpp"
 
+#include <memory>
+
 namespace EARenderer {
 
     template<class T, T U>
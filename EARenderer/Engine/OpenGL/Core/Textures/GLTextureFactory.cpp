@@ -11,3 +11,40 @@
 #define STB_IMAGE_IMPLEMENTATION
 
 #include "stb_image.h"
+
+#include <stdexcept>
+
+// S3TC is exposed through EXT_texture_compression_s3tc, which core profile headers don't declare
+#ifndef GL_COMPRESSED_RGB_S3TC_DXT1_EXT
+#define GL_COMPRESSED_RGB_S3TC_DXT1_EXT 0x83F0
+#endif
+
+#ifndef GL_COMPRESSED_RGBA_S3TC_DXT5_EXT
+#define GL_COMPRESSED_RGBA_S3TC_DXT5_EXT 0x83F3
+#endif
+
+namespace EARenderer {
+
+    // Flip flag is global state in stb_image (thread local one only appears in later versions).
+    // All images are loaded bottom row first, so the flag is set once before main() instead of
+    // being written on the main thread while workers are decoding.
+    static const bool ImagesFlippedOnLoad = [] {
+        stbi_set_flip_vertically_on_load(true);
+        return true;
+    }();
+
+    GLenum GLTextureFactory::GLBlockFormat(BlockCompressor::Format format) {
+        switch (format) {
+            case BlockCompressor::Format::BC1:
+                return GL_COMPRESSED_RGB_S3TC_DXT1_EXT;
+            case BlockCompressor::Format::BC3:
+                return GL_COMPRESSED_RGBA_S3TC_DXT5_EXT;
+            case BlockCompressor::Format::BC4:
+                return GL_COMPRESSED_RED_RGTC1;
+            case BlockCompressor::Format::BC5:
+                return GL_COMPRESSED_RG_RGTC2;
+        }
+        throw std::invalid_argument("Unknown block compression format");
+    }
+
+}
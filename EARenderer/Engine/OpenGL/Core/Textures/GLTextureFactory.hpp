@@ -12,6 +12,7 @@
 #include "GLTexture2D.hpp"
 #include "GLTextureCubemap.hpp"
 #include "StringUtils.hpp"
+#include "CompressedImage.hpp"
 
 #include <string>
 #include <memory>
@@ -30,7 +31,6 @@ namespace EARenderer {
             int32_t width = 0;
             int32_t height = 0;
             int32_t components = 0;
-            stbi_set_flip_vertically_on_load(true);
             stbi_uc *pixelData = stbi_load(imagePath.c_str(), &width, &height, &components, STBI_rgb_alpha);
 
             if (!pixelData) {
@@ -44,13 +44,65 @@ namespace EARenderer {
             return texture;
         }
 
+        /**
+         @return Block compression format used for offline compression of textures with the given format
+         */
+        static constexpr BlockCompressor::Format BlockFormat(GLTexture::Normalized format) {
+            switch (format) {
+                case GLTexture::Normalized::RCompressedRGBAInput:
+                    return BlockCompressor::Format::BC4;
+                case GLTexture::Normalized::RGCompressedRGBAInput:
+                    return BlockCompressor::Format::BC5;
+                case GLTexture::Normalized::RGBCompressedRGBAInput:
+                    return BlockCompressor::Format::BC1;
+                case GLTexture::Normalized::RGBACompressedRGBAInput:
+                    return BlockCompressor::Format::BC3;
+                default:
+                    throw std::invalid_argument("Only compressed texture formats have a block compressed representation");
+            }
+        }
+
+        static GLenum GLBlockFormat(BlockCompressor::Format format);
+
+        /**
+         Uploads all mip levels of a compressed image as they are, without runtime compression or mip generation
+         */
+        template<GLTexture::Normalized Format>
+        static std::unique_ptr<GLNormalizedTexture2D<Format>> MakeTexture(const CompressedImage &image) {
+            // Fails to compile for formats without a block compressed representation
+            constexpr BlockCompressor::Format blockFormat = BlockFormat(Format);
+
+            if (image.format() != blockFormat) {
+                throw std::invalid_argument("Compressed image format doesn't match texture format");
+            }
+
+            std::vector<GLTexture::CompressedLevel> levels;
+            for (size_t level = 0; level < image.mipLevels().size(); level++) {
+                const auto &mipLevel = image.mipLevels()[level];
+                levels.push_back({Size2D(mipLevel.width, mipLevel.height), image.levelData(level), mipLevel.byteSize});
+            }
+
+            return std::make_unique<GLNormalizedTexture2D<Format>>(GLBlockFormat(blockFormat), levels, Sampling::Filter::Anisotropic, Sampling::WrapMode::Repeat);
+        }
+
+        /**
+         Loads an image through its compiled, block compressed counterpart, compiling it on the first load
+
+         @param imagePath path to the source image
+         @throws std::invalid_argument if the source image can't be decoded
+         */
+        template<GLTexture::Normalized Format>
+        static std::unique_ptr<GLNormalizedTexture2D<Format>> LoadCompressedLDRImage(const std::string &imagePath) {
+            CompressedImage image(imagePath, BlockFormat(Format));
+            return MakeTexture<Format>(image);
+        }
+
         static std::unique_ptr<GLFloatTexture2D<GLTexture::Float::RGB16F>> LoadHDRImage(const std::string &imagePath) {
 
             int32_t width = 0;
             int32_t height = 0;
             int32_t components = 0;
 
-            stbi_set_flip_vertically_on_load(true);
             float *pixelData = stbi_loadf(imagePath.c_str(), &width, &height, &components, STBI_default);
 
             if (!pixelData) {
@@ -76,7 +128,6 @@ namespace EARenderer {
             int32_t width = 0;
             int32_t height = 0;
             int32_t components = 0;
-            stbi_set_flip_vertically_on_load(true);
 
             std::array<std::string, 6> imagePaths{
                     positiveXImagePath, negativeXImagePath, positiveYImagePath,
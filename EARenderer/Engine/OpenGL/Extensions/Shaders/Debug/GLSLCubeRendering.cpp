@@ -22,11 +22,11 @@ namespace EARenderer {
 #pragma mark - Setters
 
     void GLSLCubeRendering::setViewProjectionMatrix(const glm::mat4 &mvp) {
-        glUniformMatrix4fv(uniformByNameCRC32(ctcrc32("uViewProjectionMatrix")).location(), 1, GL_FALSE, glm::value_ptr(mvp));
+        setUniformMatrix4fv(ctcrc32("uViewProjectionMatrix"), 1, glm::value_ptr(mvp));
     }
 
     void GLSLCubeRendering::setColor(const Color &color) {
-        glUniform4fv(uniformByNameCRC32(ctcrc32("uColor")).location(), 1, reinterpret_cast<const float *>(&color));
+        setUniform4fv(ctcrc32("uColor"), 1, reinterpret_cast<const float *>(&color));
     }
 
 }
@@ -22,15 +22,15 @@ namespace EARenderer {
 #pragma mark - Setters
 
     void GLSLGenericGeometry::setModelViewProjectionMatrix(const glm::mat4 &mvp) {
-        glUniformMatrix4fv(uniformByNameCRC32(ctcrc32("uModelViewProjection")).location(), 1, GL_FALSE, glm::value_ptr(mvp));
+        setUniformMatrix4fv(ctcrc32("uModelViewProjection"), 1, glm::value_ptr(mvp));
     }
 
     void GLSLGenericGeometry::setColor(const Color &color) {
-        glUniform4fv(uniformByNameCRC32(ctcrc32("uColor")).location(), 1, reinterpret_cast<const float *>(&color));
+        setUniform4fv(ctcrc32("uColor"), 1, reinterpret_cast<const float *>(&color));
     }
 
     void GLSLGenericGeometry::setHighlightColor(const Color &color) {
-        glUniform4fv(uniformByNameCRC32(ctcrc32("uHighlightColor")).location(), 1, reinterpret_cast<const GLfloat *>(&color));
+        setUniform4fv(ctcrc32("uHighlightColor"), 1, reinterpret_cast<const GLfloat *>(&color));
     }
 
 }
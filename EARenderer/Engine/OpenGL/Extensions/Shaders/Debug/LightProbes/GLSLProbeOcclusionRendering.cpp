@@ -20,7 +20,7 @@ namespace EARenderer {
 #pragma mark - Setters
 
     void GLSLProbeOcclusionRendering::setCamera(const Camera &camera) {
-        glUniformMatrix4fv(uniformByNameCRC32(ctcrc32("uCameraSpaceMat")).location(), 1, GL_FALSE, glm::value_ptr(camera.viewProjectionMatrix()));
+        setUniformMatrix4fv(ctcrc32("uCameraSpaceMat"), 1, glm::value_ptr(camera.viewProjectionMatrix()));
     }
 
 //    void GLSLProbeOcclusionRendering::setDiffuseProbeOcclusionMapsAtlas(const GLHDRTexture2D& atlas) {
@@ -32,7 +32,7 @@ namespace EARenderer {
 //    }
 
     void GLSLProbeOcclusionRendering::setProbeIndex(size_t index) {
-        glUniform1i(uniformByNameCRC32(ctcrc32("uProbeIndex")).location(), (GLint) index);
+        setUniform1i(ctcrc32("uProbeIndex"), (GLint) index);
     }
 
 }
@@ -25,16 +25,16 @@ namespace EARenderer {
         template<class TextureFormat, TextureFormat Format>
         void setTexture(const GLTexture2D<TextureFormat, Format> &texture) {
             setUniformTexture(ctcrc32("uTexture"), texture);
-            glUniform1i(uniformByNameCRC32(ctcrc32("uShouldSampleArray")).location(), GL_FALSE);
-            glUniform1i(uniformByNameCRC32(ctcrc32("uShouldSample3DTexture")).location(), GL_FALSE);
+            setUniform1i(ctcrc32("uShouldSampleArray"), GL_FALSE);
+            setUniform1i(ctcrc32("uShouldSample3DTexture"), GL_FALSE);
         }
 
         template<class TextureFormat, TextureFormat Format>
         void setTexture(const GLTexture2DArray<TextureFormat, Format> &texture, size_t layer) {
             setUniformTexture(ctcrc32("uTextureArray"), texture);
-            glUniform1i(uniformByNameCRC32(ctcrc32("uIndex")).location(), (GLint) layer);
-            glUniform1i(uniformByNameCRC32(ctcrc32("uShouldSampleArray")).location(), GL_TRUE);
-            glUniform1i(uniformByNameCRC32(ctcrc32("uShouldSample3DTexture")).location(), GL_FALSE);
+            setUniform1i(ctcrc32("uIndex"), (GLint) layer);
+            setUniform1i(ctcrc32("uShouldSampleArray"), GL_TRUE);
+            setUniform1i(ctcrc32("uShouldSample3DTexture"), GL_FALSE);
         }
 
         void setTexture(const GLTexture3D &texture, float depth);
@@ -21,8 +21,8 @@ namespace EARenderer {
 #pragma mark - Setters
 
     void GLSLLightProbeEnvironmentCapture::setModelMatrix(const glm::mat4 &modelMatrix) {
-        glUniformMatrix4fv(uniformByNameCRC32(ctcrc32("uModelMat")).location(), 1, GL_FALSE, glm::value_ptr(modelMatrix));
-        glUniformMatrix4fv(uniformByNameCRC32(ctcrc32("uNormalMat")).location(), 1, GL_FALSE, glm::value_ptr(glm::transpose(glm::inverse(modelMatrix))));
+        setUniformMatrix4fv(ctcrc32("uModelMat"), 1, glm::value_ptr(modelMatrix));
+        setUniformMatrix4fv(ctcrc32("uNormalMat"), 1, glm::value_ptr(glm::transpose(glm::inverse(modelMatrix))));
     }
 
 //    void GLSLLightProbeEnvironmentCapture::setLightProbe(const LightProbe& probe) {
@@ -31,15 +31,15 @@ namespace EARenderer {
 //    }
 
     void GLSLLightProbeEnvironmentCapture::setLight(const PointLight &light) {
-        glUniform3fv(uniformByNameCRC32(ctcrc32("uPointLight.position")).location(), 1, glm::value_ptr(light.position()));
-        glUniform3fv(uniformByNameCRC32(ctcrc32("uPointLight.radiantFlux")).location(), 1, reinterpret_cast<const GLfloat *>(&light.color()));
-        glUniform1i(uniformByNameCRC32(ctcrc32("uLightType")).location(), 1);
+        setUniform3fv(ctcrc32("uPointLight.position"), 1, glm::value_ptr(light.position()));
+        setUniform3fv(ctcrc32("uPointLight.radiantFlux"), 1, reinterpret_cast<const GLfloat *>(&light.color()));
+        setUniform1i(ctcrc32("uLightType"), 1);
     }
 
     void GLSLLightProbeEnvironmentCapture::setLight(const DirectionalLight &light) {
-        glUniform3fv(uniformByNameCRC32(ctcrc32("uDirectionalLight.direction")).location(), 1, glm::value_ptr(light.direction()));
-        glUniform3fv(uniformByNameCRC32(ctcrc32("uDirectionalLight.radiantFlux")).location(), 1, reinterpret_cast<const GLfloat *>(&light.color()));
-        glUniform1i(uniformByNameCRC32(ctcrc32("uLightType")).location(), 0);
+        setUniform3fv(ctcrc32("uDirectionalLight.direction"), 1, glm::value_ptr(light.direction()));
+        setUniform3fv(ctcrc32("uDirectionalLight.radiantFlux"), 1, reinterpret_cast<const GLfloat *>(&light.color()));
+        setUniform1i(ctcrc32("uLightType"), 0);
     }
 
     void GLSLLightProbeEnvironmentCapture::setMaterial(const CookTorranceMaterial &material) {
@@ -26,7 +26,7 @@ namespace EARenderer {
     }
 
     void GLSLSpecularRadianceConvolution::setRoughness(float roughness) {
-        glUniform1f(uniformByNameCRC32(ctcrc32("uRoughness")).location(), roughness);
+        setUniform1f(ctcrc32("uRoughness"), roughness);
     }
 
 }
@@ -12,6 +12,13 @@
 const int kLightTypeDirectional = 0;
 const int kLightTypePoint       = 1;
 const int kLightTypeSpot        = 2;
+const int kLightTypeClusteredPoint = 3; // All unshadowed point lights at once
+
+// Must match ClusteredLightCuller
+const int kClusterTileCountX    = 16;
+const int kClusterTileCountY    = 9;
+const int kClusterSliceCount    = 24;
+const int kClusteredLightTexels = 3;
 
 // Output
 
@@ -27,6 +34,7 @@ uniform usampler2D uMaterialData;
 uniform sampler2D uGBufferHiZBuffer;
 
 uniform vec3 uCameraPosition;
+uniform mat4 uCameraView;
 uniform mat4 uCameraViewInverse;
 uniform mat4 uCameraProjectionInverse;
 
@@ -47,6 +55,12 @@ uniform sampler2DArrayShadow uDirectionalShadowMapsComparisonSampler;
 uniform samplerCubeShadow uOmnidirectionalShadowMapComparisonSampler;
 uniform sampler2D uPenumbra;
 
+// Clustered lights
+uniform vec2 uClusterDepthScaleBias;
+uniform samplerBuffer uClusteredPointLights;
+uniform usamplerBuffer uClusterLightRanges;
+uniform usamplerBuffer uClusterLightIndices;
+
 // Functions
 
 // Settings
@@ -77,6 +91,55 @@ bool isParallaxMappingEnabled()     { return bool((uSettingsBitmask >> 0u) & 1u)
 //    return diffuse + specular;
 //}
 
+////////////////////////////////////////////////////////////
+//////////////////// Clustered lights //////////////////////
+////////////////////////////////////////////////////////////
+
+int ClusterIndex(vec3 worldPosition) {
+    float viewDepth = -(uCameraView * vec4(worldPosition, 1.0)).z;
+    int slice = int(floor(log(max(viewDepth, 1e-4)) * uClusterDepthScaleBias.x - uClusterDepthScaleBias.y));
+    slice = clamp(slice, 0, kClusterSliceCount - 1);
+
+    ivec2 tile = ivec2(vTexCoords * vec2(kClusterTileCountX, kClusterTileCountY));
+    tile = clamp(tile, ivec2(0), ivec2(kClusterTileCountX - 1, kClusterTileCountY - 1));
+
+    return (slice * kClusterTileCountY + tile.y) * kClusterTileCountX + tile.x;
+}
+
+vec3 ClusteredPointLightsRadiance(vec3 N, vec3 V, vec3 worldPosition, float roughness2, vec3 albedo, float metallic) {
+    uvec2 range = texelFetch(uClusterLightRanges, ClusterIndex(worldPosition)).xy;
+    vec3 result = vec3(0.0);
+
+    for (uint i = 0u; i < range.y; i++) {
+        int lightTexel = int(texelFetch(uClusterLightIndices, int(range.x + i)).r) * kClusteredLightTexels;
+
+        vec4 positionAndRadius = texelFetch(uClusteredPointLights, lightTexel);
+        vec3 radiantFlux = texelFetch(uClusteredPointLights, lightTexel + 1).rgb;
+        vec3 attenuation = texelFetch(uClusteredPointLights, lightTexel + 2).xyz;
+
+        vec3 toLight = positionAndRadius.xyz - worldPosition;
+        float lightDistance = length(toLight);
+
+        // Fades the light out towards its radius so that cluster boundaries don't show up as seams
+        float window = clamp(1.0 - pow(lightDistance / positionAndRadius.w, 4.0), 0.0, 1.0);
+        window *= window;
+
+        if (window <= 0.0) {
+            continue;
+        }
+
+        PointLight light = PointLight(mat4(1.0), mat4(1.0), vec4(radiantFlux, 1.0), vec4(positionAndRadius.xyz, 1.0),
+                                      0.0, 0.0, 0.0, attenuation.x, attenuation.y, attenuation.z, 0.0);
+        vec3 radiance = PointLightRadiance(light, worldPosition) * window;
+
+        vec3 L = toLight / lightDistance;
+        vec3 H = normalize(L + V);
+        result += CookTorranceBRDF(N, V, H, L, roughness2, albedo, metallic, radiance, 1.0);
+    }
+
+    return result;
+}
+
 ////////////////////////////////////////////////////////////
 ////////////////////////// Main ////////////////////////////
 ////////////////////////////////////////////////////////////
@@ -106,6 +169,10 @@ vec4 ProcessCookTorranceMaterial(uvec4 materialData, vec3 worldPosition) {
         metallic = 0.0;
     }
 
+    if (uLightType == kLightTypeClusteredPoint) {
+        return vec4(ClusteredPointLightsRadiance(N, V, worldPosition, roughness2, albedo, metallic), 1.0);
+    }
+
     switch (uLightType) {
         case kLightTypeDirectional: {
             radiance = DirectionalLightRadiance(uDirectionalLight);
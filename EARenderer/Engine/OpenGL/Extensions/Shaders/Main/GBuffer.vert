@@ -16,8 +16,10 @@ layout (location = 5) in vec3 iBitangent;
 
 // Uniforms
 
-uniform mat4 uModelMat;
-uniform mat4 uNormalMat;
+// Model and normal matrices of every instance, 8 texels per instance
+uniform samplerBuffer uInstanceMatrices;
+uniform int uBaseInstance;
+
 uniform mat4 uCameraViewMat;
 uniform mat4 uCameraProjectionMat;
 uniform mat4 uCSMSplitSpaceMat;
@@ -34,17 +36,24 @@ out vec3 vCameraPosInTangentSpace;
 
 // Functions
 
+mat4 InstanceMatrix(int firstTexel) {
+    return mat4(texelFetch(uInstanceMatrices, firstTexel),
+                texelFetch(uInstanceMatrices, firstTexel + 1),
+                texelFetch(uInstanceMatrices, firstTexel + 2),
+                texelFetch(uInstanceMatrices, firstTexel + 3));
+}
+
 // Build TBN matrix as-is
-mat3 TBN() {
-    vec3 T = normalize(uNormalMat * vec4(iTangent, 0.0)).xyz;
-    vec3 B = normalize(uNormalMat * vec4(iBitangent, 0.0)).xyz;
-    vec3 N = normalize(uNormalMat * vec4(iNormal, 0.0)).xyz;
+mat3 TBN(mat4 normalMat) {
+    vec3 T = normalize(normalMat * vec4(iTangent, 0.0)).xyz;
+    vec3 B = normalize(normalMat * vec4(iBitangent, 0.0)).xyz;
+    vec3 N = normalize(normalMat * vec4(iNormal, 0.0)).xyz;
     return mat3(T, B, N);
 }
 
-mat3 OrthogonalTBN() {
-    vec3 T = normalize(uNormalMat * vec4(iTangent, 0.0)).xyz;
-    vec3 N = normalize(uNormalMat * vec4(iNormal, 0.0)).xyz;
+mat3 OrthogonalTBN(mat4 normalMat) {
+    vec3 T = normalize(normalMat * vec4(iTangent, 0.0)).xyz;
+    vec3 N = normalize(normalMat * vec4(iNormal, 0.0)).xyz;
     // re-orthogonalize T with respect to N
     T = normalize(T - dot(T, N) * N);
     vec3 B = cross(N, T);
@@ -52,9 +61,13 @@ mat3 OrthogonalTBN() {
 }
 
 void main() {
-    vec4 worldPosition = uModelMat * iPosition;
+    int firstTexel = (uBaseInstance + gl_InstanceID) * 8;
+    mat4 modelMat = InstanceMatrix(firstTexel);
+    mat4 normalMat = InstanceMatrix(firstTexel + 4);
+
+    vec4 worldPosition = modelMat * iPosition;
 
-    mat3 TBN = TBN();
+    mat3 TBN = TBN(normalMat);
 
     vTexCoords = vec3(iTexCoords.s, iTexCoords.t, iTexCoords.r);
     vWorldPosition = worldPosition.xyz;
@@ -23,6 +23,7 @@
 #include "AxisAlignedBox3D.hpp"
 #include "RenderingSettings.hpp"
 #include "SceneGBuffer.hpp"
+#include "ClusteredLightCuller.hpp"
 
 #include <glm/vec3.hpp>
 #include <glm/mat4x4.hpp>
@@ -54,6 +55,14 @@ namespace EARenderer {
         void setPenumbra(const GLFloatTexture2D<GLTexture::Float::R16F> &penumbra);
 
         void setSettings(const RenderingSettings &settings);
+
+        /**
+         Provides lights of the culler's clusters, which are shaded in a single pass with LightType::ClusteredPoint.
+         Clustered lights are unshadowed. Binds buffer textures, so has to be called inside ensureSamplerValidity().
+
+         @param culler culler that has already been built for the current camera
+         */
+        void setClusteredPointLights(const ClusteredLightCuller &culler);
     };
 
 }
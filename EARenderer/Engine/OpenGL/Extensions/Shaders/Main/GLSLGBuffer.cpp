@@ -19,14 +19,17 @@ namespace EARenderer {
 #pragma mark - Setters
 
     void GLSLGBuffer::setCamera(const Camera &camera) {
-        glUniform3fv(uniformByNameCRC32(ctcrc32("uCameraPosition")).location(), 1, glm::value_ptr(camera.position()));
-        glUniformMatrix4fv(uniformByNameCRC32(ctcrc32("uCameraViewMat")).location(), 1, GL_FALSE, glm::value_ptr(camera.viewMatrix()));
-        glUniformMatrix4fv(uniformByNameCRC32(ctcrc32("uCameraProjectionMat")).location(), 1, GL_FALSE, glm::value_ptr(camera.projectionMatrix()));
+        setUniform3fv(ctcrc32("uCameraPosition"), 1, glm::value_ptr(camera.position()));
+        setUniformMatrix4fv(ctcrc32("uCameraViewMat"), 1, glm::value_ptr(camera.viewMatrix()));
+        setUniformMatrix4fv(ctcrc32("uCameraProjectionMat"), 1, glm::value_ptr(camera.projectionMatrix()));
     }
 
-    void GLSLGBuffer::setModelMatrix(const glm::mat4 &matrix) {
-        glUniformMatrix4fv(uniformByNameCRC32(ctcrc32("uModelMat")).location(), 1, GL_FALSE, glm::value_ptr(matrix));
-        glUniformMatrix4fv(uniformByNameCRC32(ctcrc32("uNormalMat")).location(), 1, GL_FALSE, glm::value_ptr(glm::transpose(glm::inverse(matrix))));
+    void GLSLGBuffer::setInstanceMatrices(const GLFloatBufferTexture<GLTexture::Float::RGBA32F, glm::vec4> &matrices) {
+        setBufferTexture(ctcrc32("uInstanceMatrices"), matrices);
+    }
+
+    void GLSLGBuffer::setBaseInstance(uint32_t baseInstance) {
+        setUniform1i(ctcrc32("uBaseInstance"), static_cast<GLint>(baseInstance));
     }
 
     void GLSLGBuffer::setMaterial(const CookTorranceMaterial &material) {
@@ -37,16 +40,16 @@ namespace EARenderer {
         if (material.ambientOcclusionMap()) {setUniformTexture(ctcrc32("uMaterialCookTorrance.AOMap"), *material.ambientOcclusionMap());}
         if (material.displacementMap()) {setUniformTexture(ctcrc32("uMaterialCookTorrance.displacementMap"), *material.displacementMap());}
 
-        glUniform1i(uniformByNameCRC32(ctcrc32("uMaterialType")).location(), std::underlying_type<MaterialType>::type(MaterialType::CookTorrance));
+        setUniform1i(ctcrc32("uMaterialType"), std::underlying_type<MaterialType>::type(MaterialType::CookTorrance));
     }
 
     void GLSLGBuffer::setMaterial(const EmissiveMaterial &material) {
-        glUniform3fv(uniformByNameCRC32(ctcrc32("uMaterialEmissive.emission")).location(), 1, glm::value_ptr(material.emissionColor.rgb()));
-        glUniform1i(uniformByNameCRC32(ctcrc32("uMaterialType")).location(), std::underlying_type<MaterialType>::type(MaterialType::Emissive));
+        setUniform3fv(ctcrc32("uMaterialEmissive.emission"), 1, glm::value_ptr(material.emissionColor.rgb()));
+        setUniform1i(ctcrc32("uMaterialType"), std::underlying_type<MaterialType>::type(MaterialType::Emissive));
     }
 
     void GLSLGBuffer::setSettings(const RenderingSettings &settings) {
-        glUniform1f(uniformByNameCRC32(ctcrc32("uPOMStrength")).location(), settings.meshSettings.parallaxMappingStrength);
+        setUniform1f(ctcrc32("uPOMStrength"), settings.meshSettings.parallaxMappingStrength);
     }
 
 }
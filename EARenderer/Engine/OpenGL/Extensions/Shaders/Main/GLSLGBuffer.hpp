@@ -14,6 +14,7 @@
 #include "EmissiveMaterial.hpp"
 #include "Camera.hpp"
 #include "RenderingSettings.hpp"
+#include "GLBufferTexture.hpp"
 
 namespace EARenderer {
 
@@ -25,7 +26,12 @@ namespace EARenderer {
 
         void setCamera(const Camera &camera);
 
-        void setModelMatrix(const glm::mat4 &matrix);
+        /**
+         @param matrices Model and normal matrices of all instances, 8 texels per instance
+         */
+        void setInstanceMatrices(const GLFloatBufferTexture<GLTexture::Float::RGBA32F, glm::vec4> &matrices);
+
+        void setBaseInstance(uint32_t baseInstance);
 
         void setMaterial(const CookTorranceMaterial &material);
 
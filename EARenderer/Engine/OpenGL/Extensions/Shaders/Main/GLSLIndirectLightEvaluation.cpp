@@ -18,11 +18,9 @@ namespace EARenderer {
 #pragma mark - Setters
 
     void GLSLIndirectLightEvaluation::setCamera(const Camera &camera) {
-        glUniform3fv(uniformByNameCRC32(ctcrc32("uCameraPosition")).location(), 1, glm::value_ptr(camera.position()));
-        glUniformMatrix4fv(uniformByNameCRC32(ctcrc32("uCameraViewInverse")).location(), 1, GL_FALSE,
-                glm::value_ptr(camera.inverseViewMatrix()));
-        glUniformMatrix4fv(uniformByNameCRC32(ctcrc32("uCameraProjectionInverse")).location(), 1, GL_FALSE,
-                glm::value_ptr(camera.inverseProjectionMatrix()));
+        setUniform3fv(ctcrc32("uCameraPosition"), 1, glm::value_ptr(camera.position()));
+        setUniformMatrix4fv(ctcrc32("uCameraViewInverse"), 1, glm::value_ptr(camera.inverseViewMatrix()));
+        setUniformMatrix4fv(ctcrc32("uCameraProjectionInverse"), 1, glm::value_ptr(camera.inverseProjectionMatrix()));
     }
 
     void GLSLIndirectLightEvaluation::setGBuffer(const SceneGBuffer &GBuffer) {
@@ -38,7 +36,7 @@ namespace EARenderer {
     }
 
     void GLSLIndirectLightEvaluation::setWorldBoundingBox(const AxisAlignedBox3D &box) {
-        glUniformMatrix4fv(uniformByNameCRC32(ctcrc32("uWorldBoudningBoxTransform")).location(), 1, GL_FALSE, glm::value_ptr(box.localSpaceMatrix()));
+        setUniformMatrix4fv(ctcrc32("uWorldBoudningBoxTransform"), 1, glm::value_ptr(box.localSpaceMatrix()));
     }
 
     void GLSLIndirectLightEvaluation::setProbePositions(const GLFloatBufferTexture<GLTexture::Float::RGB32F, glm::vec3> &positions) {
@@ -46,7 +44,7 @@ namespace EARenderer {
     }
 
     void GLSLIndirectLightEvaluation::setSettings(const RenderingSettings &settings) {
-        glUniform1ui(uniformByNameCRC32(ctcrc32("uSettingsBitmask")).location(), settings.meshSettings.booleanBitmask());
+        setUniform1ui(ctcrc32("uSettingsBitmask"), settings.meshSettings.booleanBitmask());
     }
 
 }
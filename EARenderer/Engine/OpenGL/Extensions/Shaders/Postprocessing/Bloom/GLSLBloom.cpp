@@ -27,9 +27,9 @@ namespace EARenderer {
     }
 
     void GLSLBloom::setTextureWeights(float smallBlurWeight, float mediumBlurWeight, float largeBlurWeight) {
-        glUniform1f(uniformByNameCRC32(ctcrc32("uSmallBlurWeight")).location(), smallBlurWeight);
-        glUniform1f(uniformByNameCRC32(ctcrc32("uMediumBlurWeight")).location(), mediumBlurWeight);
-        glUniform1f(uniformByNameCRC32(ctcrc32("uLargeBlurWeight")).location(), largeBlurWeight);
+        setUniform1f(ctcrc32("uSmallBlurWeight"), smallBlurWeight);
+        setUniform1f(ctcrc32("uMediumBlurWeight"), mediumBlurWeight);
+        setUniform1f(ctcrc32("uLargeBlurWeight"), largeBlurWeight);
     }
 
 }
@@ -30,7 +30,7 @@ namespace EARenderer {
         template<GLTexture::Float Format>
         void setTexture(const GLFloatTexture2D<Format> &texture, size_t mipLevel) {
             setUniformTexture(ctcrc32("uTexture"), texture);
-            glUniform1i(uniformByNameCRC32(ctcrc32("uMipLevel")).location(), GLint(mipLevel));
+            setUniform1i(ctcrc32("uMipLevel"), GLint(mipLevel));
         }
 
         void setBlurDirection(BlurDirection direction);
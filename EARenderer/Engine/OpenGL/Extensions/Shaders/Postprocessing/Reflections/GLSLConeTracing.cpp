@@ -18,11 +18,9 @@ namespace EARenderer {
 #pragma mark - Lifecycle
 
     void GLSLConeTracing::setCamera(const Camera &camera) {
-        glUniform3fv(uniformByNameCRC32(ctcrc32("uCameraPosition")).location(), 1, glm::value_ptr(camera.position()));
-        glUniformMatrix4fv(uniformByNameCRC32(ctcrc32("uCameraViewInverse")).location(), 1, GL_FALSE,
-                glm::value_ptr(camera.inverseViewMatrix()));
-        glUniformMatrix4fv(uniformByNameCRC32(ctcrc32("uCameraProjectionInverse")).location(), 1, GL_FALSE,
-                glm::value_ptr(camera.inverseProjectionMatrix()));
+        setUniform3fv(ctcrc32("uCameraPosition"), 1, glm::value_ptr(camera.position()));
+        setUniformMatrix4fv(ctcrc32("uCameraViewInverse"), 1, glm::value_ptr(camera.inverseViewMatrix()));
+        setUniformMatrix4fv(ctcrc32("uCameraProjectionInverse"), 1, glm::value_ptr(camera.inverseProjectionMatrix()));
     }
 
     void GLSLConeTracing::setGBuffer(const SceneGBuffer &GBuffer) {
@@ -32,7 +30,7 @@ namespace EARenderer {
 
     void GLSLConeTracing::setReflections(const GLFloatTexture2D<GLTexture::Float::RGBA16F> &reflections) {
         setUniformTexture(ctcrc32("uReflections"), reflections);
-        glUniform1i(uniformByNameCRC32(ctcrc32("uMipCount")).location(), int32_t(reflections.mipMapCount()));
+        setUniform1i(ctcrc32("uMipCount"), int32_t(reflections.mipMapCount()));
     }
 
     void GLSLConeTracing::setRayHitInfo(const GLFloatTexture2D<GLTexture::Float::RGBA16F> &rayHitInfo) {
@@ -42,11 +40,11 @@ namespace EARenderer {
     void GLSLConeTracing::setIBLProbe(const ImageBasedLightProbe &probe) {
         setUniformTexture(ctcrc32("uIBLProbe.specularIrradiance"), probe.specularIrradiance());
         setUniformTexture(ctcrc32("uIBLProbe.BRDFIntegrationMap"), probe.BRDFIntegrationMap());
-        glUniform1i(uniformByNameCRC32(ctcrc32("uIBLProbe.specularIrradianceMipCount")).location(), GLint(probe.specularIrradianceMipCount()));
+        setUniform1i(ctcrc32("uIBLProbe.specularIrradianceMipCount"), GLint(probe.specularIrradianceMipCount()));
     }
 
     void GLSLConeTracing::setDebugRoughness(float r) {
-        glUniform1f(uniformByNameCRC32(ctcrc32("uDebugRoughness")).location(), r);
+        setUniform1f(ctcrc32("uDebugRoughness"), r);
     }
 
 }
@@ -20,22 +20,18 @@ namespace EARenderer {
 #pragma mark - Lifecycle
 
     void GLSLScreenSpaceReflections::setCamera(const Camera &camera) {
-        glUniform3fv(uniformByNameCRC32(ctcrc32("uCameraPosition")).location(), 1, glm::value_ptr(camera.position()));
-        glUniformMatrix4fv(uniformByNameCRC32(ctcrc32("uCameraViewMat")).location(), 1, GL_FALSE,
-                glm::value_ptr(camera.viewMatrix()));
-        glUniformMatrix4fv(uniformByNameCRC32(ctcrc32("uCameraProjectionMat")).location(), 1, GL_FALSE,
-                glm::value_ptr(camera.projectionMatrix()));
-        glUniformMatrix4fv(uniformByNameCRC32(ctcrc32("uCameraViewInverse")).location(), 1, GL_FALSE,
-                glm::value_ptr(camera.inverseViewMatrix()));
-        glUniformMatrix4fv(uniformByNameCRC32(ctcrc32("uCameraProjectionInverse")).location(), 1, GL_FALSE,
-                glm::value_ptr(camera.inverseProjectionMatrix()));
+        setUniform3fv(ctcrc32("uCameraPosition"), 1, glm::value_ptr(camera.position()));
+        setUniformMatrix4fv(ctcrc32("uCameraViewMat"), 1, glm::value_ptr(camera.viewMatrix()));
+        setUniformMatrix4fv(ctcrc32("uCameraProjectionMat"), 1, glm::value_ptr(camera.projectionMatrix()));
+        setUniformMatrix4fv(ctcrc32("uCameraViewInverse"), 1, glm::value_ptr(camera.inverseViewMatrix()));
+        setUniformMatrix4fv(ctcrc32("uCameraProjectionInverse"), 1, glm::value_ptr(camera.inverseProjectionMatrix()));
     }
 
     void GLSLScreenSpaceReflections::setGBuffer(const SceneGBuffer &GBuffer) {
         setUniformTexture(ctcrc32("uMaterialData"), GBuffer.materialData);
 //        setUniformTexture(ctcrc32("uGBufferHiZBuffer"), GBuffer.HiZBuffer);
         setUniformTexture(ctcrc32("uGBufferHiZBuffer"), GBuffer.depthBuffer);
-        glUniform1i(uniformByNameCRC32(ctcrc32("uHiZBufferMipCount")).location(), int32_t(GBuffer.HiZBufferMipCount));
+        setUniform1i(ctcrc32("uHiZBufferMipCount"), int32_t(GBuffer.HiZBufferMipCount));
     }
 
 }
@@ -21,11 +21,11 @@ namespace EARenderer {
 
     void GLSLLuminanceHistogram::setLuminance(const GLFloatTexture2D<GLTexture::Float::RG16F> &luminance) {
         setUniformTexture(ctcrc32("uLuminance"), luminance);
-        glUniform1i(uniformByNameCRC32(ctcrc32("uLuminanceMaxLOD")).location(), (GLint) luminance.mipMapCount());
+        setUniform1i(ctcrc32("uLuminanceMaxLOD"), (GLint) luminance.mipMapCount());
     }
 
     void GLSLLuminanceHistogram::setHistogramWidth(size_t width) {
-        glUniform1i(uniformByNameCRC32(ctcrc32("uHistogramWidth")).location(), (GLint) width);
+        setUniform1i(ctcrc32("uHistogramWidth"), (GLint) width);
     }
 
 }
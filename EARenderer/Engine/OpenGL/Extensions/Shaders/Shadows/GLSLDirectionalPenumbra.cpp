@@ -19,10 +19,8 @@ namespace EARenderer {
 #pragma mark - Setters
 
     void GLSLDirectionalPenumbra::setCamera(const Camera &camera) {
-        glUniformMatrix4fv(uniformByNameCRC32(ctcrc32("uCameraViewInverse")).location(), 1, GL_FALSE,
-                glm::value_ptr(camera.inverseViewMatrix()));
-        glUniformMatrix4fv(uniformByNameCRC32(ctcrc32("uCameraProjectionInverse")).location(), 1, GL_FALSE,
-                glm::value_ptr(camera.inverseProjectionMatrix()));
+        setUniformMatrix4fv(ctcrc32("uCameraViewInverse"), 1, glm::value_ptr(camera.inverseViewMatrix()));
+        setUniformMatrix4fv(ctcrc32("uCameraProjectionInverse"), 1, glm::value_ptr(camera.inverseProjectionMatrix()));
     }
 
     void GLSLDirectionalPenumbra::setGBuffer(const SceneGBuffer &GBuffer) {
@@ -30,23 +28,23 @@ namespace EARenderer {
     }
 
     void GLSLDirectionalPenumbra::setFrustumCascades(const FrustumCascades &cascades) {
-        glUniformMatrix4fv(uniformByNameCRC32(ctcrc32("uLightSpaceMatrices[0]")).location(),
-                static_cast<GLsizei>(cascades.lightViewProjections.size()), GL_FALSE,
+        setUniformMatrix4fv(ctcrc32("uLightSpaceMatrices[0]"),
+                static_cast<GLsizei>(cascades.lightViewProjections.size()),
                 reinterpret_cast<const GLfloat *>(cascades.lightViewProjections.data()));
 
-        glUniform1i(uniformByNameCRC32(ctcrc32("uDepthSplitsAxis")).location(), static_cast<GLint>(cascades.splitAxis));
+        setUniform1i(ctcrc32("uDepthSplitsAxis"), static_cast<GLint>(cascades.splitAxis));
 
-        glUniform1fv(uniformByNameCRC32(ctcrc32("uDepthSplits[0]")).location(),
+        setUniform1fv(ctcrc32("uDepthSplits[0]"),
                 static_cast<GLsizei>(cascades.splits.size()),
                 reinterpret_cast<const GLfloat *>(cascades.splits.data()));
 
-        glUniformMatrix4fv(uniformByNameCRC32(ctcrc32("uCSMSplitSpaceMat")).location(), 1, GL_FALSE, glm::value_ptr(cascades.splitSpaceMatrix));
+        setUniformMatrix4fv(ctcrc32("uCSMSplitSpaceMat"), 1, glm::value_ptr(cascades.splitSpaceMatrix));
     }
 
     void GLSLDirectionalPenumbra::setLight(const DirectionalLight &light) {
-        glUniform3fv(uniformByNameCRC32(ctcrc32("uDirectionalLight.direction")).location(), 1, glm::value_ptr(light.direction()));
-        glUniform3fv(uniformByNameCRC32(ctcrc32("uDirectionalLight.radiantFlux")).location(), 1, reinterpret_cast<const GLfloat *>(&light.color()));
-        glUniform1f(uniformByNameCRC32(ctcrc32("uDirectionalLight.area")).location(), light.area());
+        setUniform3fv(ctcrc32("uDirectionalLight.direction"), 1, glm::value_ptr(light.direction()));
+        setUniform3fv(ctcrc32("uDirectionalLight.radiantFlux"), 1, reinterpret_cast<const GLfloat *>(&light.color()));
+        setUniform1f(ctcrc32("uDirectionalLight.area"), light.area());
     }
 
     void GLSLDirectionalPenumbra::setDirectionalShadowMapArray(const GLDepthTexture2DArray &array, const GLSampler &bilinearSampler) {
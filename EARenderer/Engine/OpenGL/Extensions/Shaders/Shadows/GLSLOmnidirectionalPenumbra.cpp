@@ -13,10 +13,8 @@ namespace EARenderer {
     }
 
     void GLSLOmnidirectionalPenumbra::setCamera(const Camera &camera) {
-        glUniformMatrix4fv(uniformByNameCRC32(ctcrc32("uCameraViewInverse")).location(), 1, GL_FALSE,
-                glm::value_ptr(camera.inverseViewMatrix()));
-        glUniformMatrix4fv(uniformByNameCRC32(ctcrc32("uCameraProjectionInverse")).location(), 1, GL_FALSE,
-                glm::value_ptr(camera.inverseProjectionMatrix()));
+        setUniformMatrix4fv(ctcrc32("uCameraViewInverse"), 1, glm::value_ptr(camera.inverseViewMatrix()));
+        setUniformMatrix4fv(ctcrc32("uCameraProjectionInverse"), 1, glm::value_ptr(camera.inverseProjectionMatrix()));
     }
 
     void GLSLOmnidirectionalPenumbra::setGBuffer(const SceneGBuffer &GBuffer) {
@@ -29,14 +27,14 @@ namespace EARenderer {
     }
 
     void GLSLOmnidirectionalPenumbra::setLight(const PointLight &light) {
-        glUniform4fv(uniformByNameCRC32(ctcrc32("uPointLight.position")).location(), 1, glm::value_ptr(light.position()));
-        glUniform4fv(uniformByNameCRC32(ctcrc32("uPointLight.radiantFlux")).location(), 1, reinterpret_cast<const GLfloat *>(&light.color()));
-        glUniform1f(uniformByNameCRC32(ctcrc32("uPointLight.nearPlane")).location(), light.nearClipPlane());
-        glUniform1f(uniformByNameCRC32(ctcrc32("uPointLight.farPlane")).location(), light.farClipPlane());
-        glUniform1f(uniformByNameCRC32(ctcrc32("uPointLight.constant")).location(), light.attenuation.constant);
-        glUniform1f(uniformByNameCRC32(ctcrc32("uPointLight.linear")).location(), light.attenuation.linear);
-        glUniform1f(uniformByNameCRC32(ctcrc32("uPointLight.quadratic")).location(), light.attenuation.quadratic);
-        glUniform1f(uniformByNameCRC32(ctcrc32("uPointLight.area")).location(), light.area());
+        setUniform4fv(ctcrc32("uPointLight.position"), 1, glm::value_ptr(light.position()));
+        setUniform4fv(ctcrc32("uPointLight.radiantFlux"), 1, reinterpret_cast<const GLfloat *>(&light.color()));
+        setUniform1f(ctcrc32("uPointLight.nearPlane"), light.nearClipPlane());
+        setUniform1f(ctcrc32("uPointLight.farPlane"), light.farClipPlane());
+        setUniform1f(ctcrc32("uPointLight.constant"), light.attenuation.constant);
+        setUniform1f(ctcrc32("uPointLight.linear"), light.attenuation.linear);
+        setUniform1f(ctcrc32("uPointLight.quadratic"), light.attenuation.quadratic);
+        setUniform1f(ctcrc32("uPointLight.area"), light.area());
     }
 
 }
\ No newline at end of file
@@ -21,14 +21,21 @@ namespace EARenderer {
 
 #pragma mark - Setters
 
-    void GLSLShadowMap::setModelMatrix(const glm::mat4 &modelMatrix) {
-        glUniformMatrix4fv(uniformByNameCRC32(ctcrc32("uModelMatrix")).location(), 1, GL_FALSE, glm::value_ptr(modelMatrix));
+    void GLSLShadowMap::setInstanceMatrices(const GLFloatBufferTexture<GLTexture::Float::RGBA32F, glm::vec4> &matrices) {
+        setBufferTexture(ctcrc32("uInstanceMatrices"), matrices);
+    }
+
+    void GLSLShadowMap::setBaseInstance(uint32_t baseInstance) {
+        setUniform1i(ctcrc32("uBaseInstance"), static_cast<GLint>(baseInstance));
+    }
+
+    void GLSLShadowMap::setLayerCount(size_t layerCount) {
+        setUniform1i(ctcrc32("uLayerCount"), static_cast<GLint>(layerCount));
     }
 
     void GLSLShadowMap::setViewProjectionMatrices(const std::vector<glm::mat4> &matrices) {
-        glUniformMatrix4fv(uniformByNameCRC32(ctcrc32("uLightSpaceMatrices[0]")).location(),
+        setUniformMatrix4fv(ctcrc32("uLightSpaceMatrices[0]"),
                 (GLsizei) matrices.size(),
-                GL_FALSE,
                 (GLfloat *) matrices.data());
     }
 
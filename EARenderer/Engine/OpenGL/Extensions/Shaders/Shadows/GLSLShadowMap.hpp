@@ -13,6 +13,7 @@
 #include "FrustumCascades.hpp"
 #include "Camera.hpp"
 #include "PointLight.hpp"
+#include "GLBufferTexture.hpp"
 
 #include <glm/mat4x4.hpp>
 
@@ -22,7 +23,17 @@ namespace EARenderer {
     public:
         GLSLShadowMap();
 
-        void setModelMatrix(const glm::mat4 &modelMatrix);
+        /**
+         @param matrices Model matrices of all instances, 4 texels per instance
+         */
+        void setInstanceMatrices(const GLFloatBufferTexture<GLTexture::Float::RGBA32F, glm::vec4> &matrices);
+
+        void setBaseInstance(uint32_t baseInstance);
+
+        /**
+         @param layerCount Number of cascades or cube faces every instance is rendered into
+         */
+        void setLayerCount(size_t layerCount);
 
         void setViewProjectionMatrices(const std::vector<glm::mat4> &matrices);
     };
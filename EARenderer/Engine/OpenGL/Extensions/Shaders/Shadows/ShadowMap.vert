@@ -6,15 +6,31 @@
 
 layout (location = 0) in vec4 iPosition;
 
+// Uniforms
+
+// Model matrices of every instance, 4 texels per instance
+uniform samplerBuffer uInstanceMatrices;
+uniform int uBaseInstance;
+
+// Number of layers (cascades or cube faces) every instance is rendered into
+uniform int uLayerCount;
+
 // Outputs
 
 out InterfaceBlock {
-    int instanceID;
+    int layer;
 } vs_out;
 
 // Functions
 
 void main() {
-    vs_out.instanceID = gl_InstanceID;
-    gl_Position = iPosition;
+    // Instances are laid out as [instance 0: layer 0, layer 1, ...][instance 1: layer 0, ...]
+    int firstTexel = (uBaseInstance + gl_InstanceID / uLayerCount) * 4;
+    mat4 modelMatrix = mat4(texelFetch(uInstanceMatrices, firstTexel),
+                            texelFetch(uInstanceMatrices, firstTexel + 1),
+                            texelFetch(uInstanceMatrices, firstTexel + 2),
+                            texelFetch(uInstanceMatrices, firstTexel + 3));
+
+    vs_out.layer = gl_InstanceID % uLayerCount;
+    gl_Position = modelMatrix * iPosition;
 }
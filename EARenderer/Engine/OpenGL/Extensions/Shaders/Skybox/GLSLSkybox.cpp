@@ -19,20 +19,20 @@ namespace EARenderer {
 #pragma mark - Setters
 
     void GLSLSkybox::setViewMatrix(const glm::mat4 &matrix) {
-        glUniformMatrix4fv(uniformByNameCRC32(ctcrc32("uProjectionMatrix")).location(), 1, GL_FALSE, glm::value_ptr(matrix));
+        setUniformMatrix4fv(ctcrc32("uProjectionMatrix"), 1, glm::value_ptr(matrix));
     }
 
     void GLSLSkybox::setProjectionMatrix(const glm::mat4 &matrix) {
-        glUniformMatrix4fv(uniformByNameCRC32(ctcrc32("uViewMatrix")).location(), 1, GL_FALSE, glm::value_ptr(matrix));
+        setUniformMatrix4fv(ctcrc32("uViewMatrix"), 1, glm::value_ptr(matrix));
     }
 
     void GLSLSkybox::setExposure(float exposure) {
-        glUniform1f(uniformByNameCRC32(ctcrc32("uExposure")).location(), exposure);
+        setUniform1f(ctcrc32("uExposure"), exposure);
     }
 
     void GLSLSkybox::setEquirectangularMap(const GLFloatTexture2D<GLTexture::Float::RGB16F> &equireqMap) {
         setUniformTexture(ctcrc32("uEquirectangularMap"), equireqMap);
-        glUniform1i(uniformByNameCRC32(ctcrc32("uIsCube")).location(), GL_FALSE);
+        setUniform1i(ctcrc32("uIsCube"), GL_FALSE);
     }
 
 }
@@ -0,0 +1,80 @@
+//
+//  AlbedoSampler.cpp
+//  EARenderer
+//
+//  Created by Pavlo Muratov on 17.10.2026.
+//  Copyright © 2026 MPO. All rights reserved.
+//
+
+#include "AlbedoSampler.hpp"
+#include "CompressedImage.hpp"
+#include "StringUtils.hpp"
+
+#include "stb_image.h"
+
+#include <stdexcept>
+#include <cmath>
+
+namespace EARenderer {
+
+#pragma mark - Lifecycle
+
+    AlbedoSampler::AlbedoSampler(const std::variant<std::string, Color> &albedo, float mipLevelFraction) {
+        if (std::holds_alternative<Color>(albedo)) {
+            mTexels.push_back(std::get_if<Color>(&albedo)->rgb());
+            return;
+        }
+
+        const std::string &imagePath = *std::get_if<std::string>(&albedo);
+
+        int32_t width = 0;
+        int32_t height = 0;
+        int32_t components = 0;
+        stbi_uc *pixelData = stbi_load(imagePath.c_str(), &width, &height, &components, STBI_rgb_alpha);
+
+        if (!pixelData) {
+            throw std::invalid_argument(string_format("Failed to load albedo image (%s)", imagePath.c_str()));
+        }
+
+        std::vector<uint8_t> texels(pixelData, pixelData + size_t(width) * height * 4);
+        stbi_image_free(pixelData);
+
+        mWidth = width;
+        mHeight = height;
+
+        // Same level count as a GPU mip chain that goes down to 1x1
+        uint32_t mipCount = uint32_t(std::log2(std::max(mWidth, mHeight))) + 1;
+        uint32_t mipLevel = std::min(uint32_t(mipCount * mipLevelFraction), mipCount - 1);
+
+        for (uint32_t level = 0; level < mipLevel; level++) {
+            texels = CompressedImage::Downsample(texels, mWidth, mHeight);
+            mWidth = std::max(mWidth / 2, 1u);
+            mHeight = std::max(mHeight / 2, 1u);
+        }
+
+        mTexels.reserve(size_t(mWidth) * mHeight);
+        for (size_t i = 0; i < size_t(mWidth) * mHeight; i++) {
+            mTexels.emplace_back(texels[i * 4] / 255.0, texels[i * 4 + 1] / 255.0, texels[i * 4 + 2] / 255.0);
+        }
+    }
+
+#pragma mark - Getters
+
+    uint32_t AlbedoSampler::width() const {
+        return mWidth;
+    }
+
+    uint32_t AlbedoSampler::height() const {
+        return mHeight;
+    }
+
+#pragma mark - Sampling
+
+    Color AlbedoSampler::sample(const glm::vec2 &uv) const {
+        uint32_t x = uv.x * (mWidth - 1);
+        uint32_t y = uv.y * (mHeight - 1);
+        const glm::vec3 &texel = mTexels[size_t(y) * mWidth + x];
+        return Color(texel.r, texel.g, texel.b);
+    }
+
+}
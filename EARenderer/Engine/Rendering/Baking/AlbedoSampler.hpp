@@ -0,0 +1,57 @@
+//
+//  AlbedoSampler.hpp
+//  EARenderer
+//
+//  Created by Pavlo Muratov on 17.10.2026.
+//  Copyright © 2026 MPO. All rights reserved.
+//
+
+#ifndef AlbedoSampler_hpp
+#define AlbedoSampler_hpp
+
+#include "Color.hpp"
+
+#include <string>
+#include <vector>
+#include <variant>
+#include <glm/vec2.hpp>
+#include <glm/vec3.hpp>
+
+namespace EARenderer {
+
+    // CPU copy of a single, blurred mip level of a material's albedo.
+    //
+    // Images are decoded and box filtered straight from their source files,
+    // so surfels can be generated without an OpenGL context and without reading textures back from the GPU.
+
+    class AlbedoSampler {
+    private:
+        uint32_t mWidth = 1;
+        uint32_t mHeight = 1;
+        std::vector<glm::vec3> mTexels;
+
+    public:
+        /**
+         @param albedo image path or constant color, see CookTorranceMaterial::albedoSource()
+         @param mipLevelFraction fraction of the full mip chain to descend before sampling,
+         0 samples the original image, 1 samples the 1x1 level
+         @throws std::invalid_argument if the image can't be decoded
+         */
+        AlbedoSampler(const std::variant<std::string, Color> &albedo, float mipLevelFraction);
+
+        uint32_t width() const;
+
+        uint32_t height() const;
+
+        /**
+         Nearest texel lookup
+
+         @param uv texture coordinates already wrapped into [0, 1]
+         @return Color of the texel
+         */
+        Color sample(const glm::vec2 &uv) const;
+    };
+
+}
+
+#endif /* AlbedoSampler_hpp */
@@ -9,6 +9,7 @@
 #include "DiffuseLightProbeData.hpp"
 #include "StringUtils.hpp"
 #include "Serializers.hpp"
+#include "CRC32.hpp"
 
 #include <bitsery/bitsery.h>
 #include <bitsery/traits/vector.h>
@@ -17,54 +18,76 @@
 
 namespace EARenderer {
 
-#pragma mark - Data
+    static constexpr uint32_t ContentTag = ctcrc32("DiffuseLightProbeData");
+    static constexpr uint32_t ProbesSectionTag = ctcrc32("DiffuseLightProbes");
+    static constexpr uint32_t ProjectionsSectionTag = ctcrc32("SurfelClusterProjections");
+    static constexpr uint32_t GridResolutionSectionTag = ctcrc32("GridResolution");
+    static constexpr uint32_t ProjectionSHsSectionTag = ctcrc32("ProjectionSphericalHarmonics");
+    static constexpr uint32_t ProjectionClusterIndicesSectionTag = ctcrc32("ProjectionClusterIndices");
+    static constexpr uint32_t SkySHsSectionTag = ctcrc32("SkySphericalHarmonics");
+    static constexpr uint32_t ProbeMetadataSectionTag = ctcrc32("ProbeMetadata");
+    static constexpr uint32_t ProbePositionsSectionTag = ctcrc32("ProbePositions");
 
-    void DiffuseLightProbeData::initializeBuffers() {
-        // Transfer spherical harmonics coefficients to the GPU via buffer texture
-        std::vector<SphericalHarmonics> shs;
-        for (auto &projection : mSurfelClusterProjections) {
-            shs.push_back(projection.sphericalHarmonics);
-        }
+#pragma mark - Private helpers
 
-        // Transfer surfel cluster indices to the GPU via buffer texture
-        std::vector<uint32_t> indices;
+    DiffuseLightProbeData::BufferData DiffuseLightProbeData::bufferData() const {
+        BufferData data;
+
+        // Spherical harmonics coefficients and surfel cluster indices of every projection
         for (auto &projection : mSurfelClusterProjections) {
-            indices.push_back(static_cast<uint32_t>(projection.surfelClusterIndex));
+            data.projectionSHs.push_back(projection.sphericalHarmonics);
+            data.projectionClusterIndices.push_back(projection.surfelClusterIndex);
         }
 
-        // Transfer surfel cluster projection group offsets, sizes and probe positions to the GPU via buffer texture
-        std::vector<SphericalHarmonics> skySHs;
-        std::vector<uint32_t> metadata;
-        std::vector<glm::vec3> positions;
-
+        // Surfel cluster projection group offsets, sizes, sky SHs and probe positions
         for (auto &probe : mProbes) {
-            metadata.push_back((uint32_t) probe.surfelClusterProjectionGroupOffset);
-            metadata.push_back((uint32_t) probe.surfelClusterProjectionGroupSize);
-            positions.push_back(probe.position);
-            skySHs.push_back(probe.skySphericalHarmonics);
+            data.probeMetadata.push_back(probe.surfelClusterProjectionGroupOffset);
+            data.probeMetadata.push_back(probe.surfelClusterProjectionGroupSize);
+            data.probePositions.push_back(probe.position);
+            data.skySHs.push_back(probe.skySphericalHarmonics);
         }
 
-        mProjectionClusterSHsBufferTexture = std::make_shared<GLFloatBufferTexture<GLTexture::Float::RGB32F, SphericalHarmonics>>(shs.data(), shs.size());
-        mSkySHsBufferTexture = std::make_shared<GLFloatBufferTexture<GLTexture::Float::RGB32F, SphericalHarmonics>>(skySHs.data(), skySHs.size());
-        mProjectionClusterIndicesBufferTexture = std::make_shared<GLIntegerBufferTexture<GLTexture::Integer::R32UI, uint32_t>>(indices.data(), indices.size());
-        mProbeClusterProjectionsMetadataBufferTexture = std::make_shared<GLIntegerBufferTexture<GLTexture::Integer::R32UI, uint32_t>>(metadata.data(), metadata.size());
-        mProbePositionsBufferTexture = std::make_shared<GLFloatBufferTexture<GLTexture::Float::RGB32F, glm::vec3>>(positions.data(), positions.size());
+        return data;
     }
 
-    void DiffuseLightProbeData::serialize(const std::string &filePath) {
-        std::ofstream stream(filePath, std::ios::trunc | std::ios::binary);
-        if (!stream.is_open()) {
-            throw std::runtime_error(string_format("Unable to serialize light probes: %s", filePath.c_str()));
+    void DiffuseLightProbeData::uploadBuffers(const SphericalHarmonics *projectionSHs, const uint32_t *projectionClusterIndices,
+                                              const SphericalHarmonics *skySHs, const uint32_t *probeMetadata, const glm::vec3 *probePositions) {
+        size_t projectionCount = mSurfelClusterProjections.size();
+        size_t probeCount = mProbes.size();
+
+        mProjectionClusterSHsBufferTexture = std::make_shared<GLFloatBufferTexture<GLTexture::Float::RGB32F, SphericalHarmonics>>(projectionSHs, projectionCount);
+        mSkySHsBufferTexture = std::make_shared<GLFloatBufferTexture<GLTexture::Float::RGB32F, SphericalHarmonics>>(skySHs, probeCount);
+        mProjectionClusterIndicesBufferTexture = std::make_shared<GLIntegerBufferTexture<GLTexture::Integer::R32UI, uint32_t>>(projectionClusterIndices, projectionCount);
+        mProbeClusterProjectionsMetadataBufferTexture = std::make_shared<GLIntegerBufferTexture<GLTexture::Integer::R32UI, uint32_t>>(probeMetadata, probeCount * 2);
+        mProbePositionsBufferTexture = std::make_shared<GLFloatBufferTexture<GLTexture::Float::RGB32F, glm::vec3>>(probePositions, probeCount);
+    }
+
+    void DiffuseLightProbeData::deserialize(const BakeContainer &container, bool gpuUploadEnabled) {
+        auto probes = container.section<DiffuseLightProbe>(ProbesSectionTag);
+        auto projections = container.section<SurfelClusterProjection>(ProjectionsSectionTag);
+        auto gridResolution = container.section<glm::ivec3>(GridResolutionSectionTag);
+        auto projectionSHs = container.section<SphericalHarmonics>(ProjectionSHsSectionTag);
+        auto projectionClusterIndices = container.section<uint32_t>(ProjectionClusterIndicesSectionTag);
+        auto skySHs = container.section<SphericalHarmonics>(SkySHsSectionTag);
+        auto probeMetadata = container.section<uint32_t>(ProbeMetadataSectionTag);
+        auto probePositions = container.section<glm::vec3>(ProbePositionsSectionTag);
+
+        if (gridResolution.size() != 1 ||
+                projectionSHs.size() != projections.size() || projectionClusterIndices.size() != projections.size() ||
+                skySHs.size() != probes.size() || probeMetadata.size() != probes.size() * 2 || probePositions.size() != probes.size()) {
+            throw std::runtime_error("Light probe bake container sections are inconsistent");
         }
 
-        bitsery::Serializer<bitsery::OutputBufferedStreamAdapter> serializer(stream);
-        serializer.container(mProbes, mProbes.size());
-        serializer.container(mSurfelClusterProjections, mSurfelClusterProjections.size());
-        serializer.object(mGridResolution);
-        bitsery::AdapterAccess::getWriter(serializer).flush();
+        mProbes.assign(probes.begin(), probes.end());
+        mSurfelClusterProjections.assign(projections.begin(), projections.end());
+        mGridResolution = *gridResolution.data();
+
+        if (gpuUploadEnabled) {
+            uploadBuffers(projectionSHs.data(), projectionClusterIndices.data(), skySHs.data(), probeMetadata.data(), probePositions.data());
+        }
     }
 
-    bool DiffuseLightProbeData::deserialize(const std::string &filePath) {
+    bool DiffuseLightProbeData::deserializeLegacy(const std::string &filePath, bool gpuUploadEnabled) {
         std::ifstream stream(filePath);
         if (!stream.is_open()) {
             return false;
@@ -77,13 +100,51 @@ namespace EARenderer {
 
         auto &reader = bitsery::AdapterAccess::getReader(deserializer);
 
-        if (reader.isCompletedSuccessfully()) {
+        if (reader.isCompletedSuccessfully() && gpuUploadEnabled) {
             initializeBuffers();
         }
 
         return reader.isCompletedSuccessfully();
     }
 
+#pragma mark - Data
+
+    void DiffuseLightProbeData::initializeBuffers() {
+        BufferData data = bufferData();
+        uploadBuffers(data.projectionSHs.data(), data.projectionClusterIndices.data(),
+                data.skySHs.data(), data.probeMetadata.data(), data.probePositions.data());
+    }
+
+    void DiffuseLightProbeData::serialize(const std::string &filePath) {
+        BufferData data = bufferData();
+        std::vector<glm::ivec3> gridResolution{mGridResolution};
+
+        BakeContainer::Writer writer(ContentTag);
+        writer.addSection(ProbesSectionTag, mProbes);
+        writer.addSection(ProjectionsSectionTag, mSurfelClusterProjections);
+        writer.addSection(GridResolutionSectionTag, gridResolution);
+        writer.addSection(ProjectionSHsSectionTag, data.projectionSHs);
+        writer.addSection(ProjectionClusterIndicesSectionTag, data.projectionClusterIndices);
+        writer.addSection(SkySHsSectionTag, data.skySHs);
+        writer.addSection(ProbeMetadataSectionTag, data.probeMetadata);
+        writer.addSection(ProbePositionsSectionTag, data.probePositions);
+        writer.write(filePath);
+    }
+
+    bool DiffuseLightProbeData::deserialize(const std::string &filePath, bool gpuUploadEnabled) {
+        if (!BakeContainer::HasSignature(filePath)) {
+            return deserializeLegacy(filePath, gpuUploadEnabled);
+        }
+
+        try {
+            BakeContainer container(filePath, ContentTag);
+            deserialize(container, gpuUploadEnabled);
+            return true;
+        } catch (const std::runtime_error &) {
+            return false;
+        }
+    }
+
 #pragma mark - Getters
 
     const std::vector<DiffuseLightProbe> &DiffuseLightProbeData::probes() const {
@@ -14,6 +14,7 @@
 #include "GLBufferTexture.hpp"
 #include "SphericalHarmonics.hpp"
 #include "GLTexture2D.hpp"
+#include "BakeContainer.hpp"
 
 #include <vector>
 #include <memory>
@@ -26,6 +27,15 @@ namespace EARenderer {
     private:
         friend DiffuseLightProbeGenerator;
 
+        // Probe data in the exact form it is uploaded to the GPU
+        struct BufferData {
+            std::vector<SphericalHarmonics> projectionSHs;
+            std::vector<uint32_t> projectionClusterIndices;
+            std::vector<SphericalHarmonics> skySHs;
+            std::vector<uint32_t> probeMetadata;
+            std::vector<glm::vec3> probePositions;
+        };
+
         std::vector<DiffuseLightProbe> mProbes;
         std::vector<SurfelClusterProjection> mSurfelClusterProjections;
         glm::ivec3 mGridResolution;
@@ -36,12 +46,37 @@ namespace EARenderer {
         std::shared_ptr<GLIntegerBufferTexture<GLTexture::Integer::R32UI, uint32_t>> mProbeClusterProjectionsMetadataBufferTexture;
         std::shared_ptr<GLFloatBufferTexture<GLTexture::Float::RGB32F, glm::vec3>> mProbePositionsBufferTexture;
 
+        BufferData bufferData() const;
+
+        void uploadBuffers(const SphericalHarmonics *projectionSHs, const uint32_t *projectionClusterIndices,
+                           const SphericalHarmonics *skySHs, const uint32_t *probeMetadata, const glm::vec3 *probePositions);
+
+        void deserialize(const BakeContainer &container, bool gpuUploadEnabled);
+
+        bool deserializeLegacy(const std::string &filePath, bool gpuUploadEnabled);
+
     public:
+        /**
+         Uploads data to the GPU, requires current OpenGL context
+         */
         void initializeBuffers();
 
+        /**
+         Writes probes and their surfel cluster projections into a bake container
+
+         @param filePath destination file
+         */
         void serialize(const std::string &filePath);
 
-        bool deserialize(const std::string &filePath);
+        /**
+         Loads probes from a bake container and uploads them to the GPU
+         directly from the mapped file. Falls back to the older bitsery-encoded files.
+
+         @param filePath source file
+         @param gpuUploadEnabled false skips GPU upload, e.g. when there is no OpenGL context
+         @return false if the file is missing or damaged
+         */
+        bool deserialize(const std::string &filePath, bool gpuUploadEnabled = true);
 
         const std::vector<DiffuseLightProbe> &probes() const;
 
@@ -8,12 +8,27 @@
 
 #include "DiffuseLightProbeGenerator.hpp"
 #include "Measurement.hpp"
+#include "ThreadPool.hpp"
+
+#include <limits>
 
 namespace EARenderer {
 
+#pragma mark - Getters
+
+    bool DiffuseLightProbeGenerator::isMultithreadingEnabled() const {
+        return mMultithreadingEnabled;
+    }
+
+#pragma mark - Setters
+
+    void DiffuseLightProbeGenerator::setMultithreadingEnabled(bool enabled) {
+        mMultithreadingEnabled = enabled;
+    }
+
 #pragma mark - Protected
 
-    float DiffuseLightProbeGenerator::surfelSolidAngle(const Surfel &surfel, const DiffuseLightProbe &probe, const Scene &scene) {
+    float DiffuseLightProbeGenerator::surfelSolidAngle(const Surfel &surfel, const DiffuseLightProbe &probe) const {
         glm::vec3 Wps = surfel.position - probe.position;
         float distance2 = glm::length2(Wps);
         Wps = glm::normalize(Wps);
@@ -22,58 +37,89 @@ namespace EARenderer {
 
         float visibilityTerm = std::max(glm::dot(-surfel.normal, Wps), 0.f);
 
-        float visibilityTest = 0.0;
-
-        // Save ray casts if surfel's facing away from the standpoint
-        if (visibilityTerm > 0.0) {
-            constexpr float p0Offset = 0.01; // Offset line segment points to avoid erroneous collision detections at surfel positions,
-            constexpr float p1Offset = 0.01; // which will happen a lot since the're located exactly on the surface of geometry
-            visibilityTest = scene.rayTracer()->lineSegmentOccluded(probe.position, surfel.position, p0Offset, p1Offset) ? 0.0f : 1.0f;
-        }
-
-        return distanceTerm * visibilityTerm * visibilityTest;
+        return distanceTerm * visibilityTerm;
     }
 
-    SurfelClusterProjection DiffuseLightProbeGenerator::projectSurfelCluster(const SurfelCluster &cluster, const DiffuseLightProbe &probe, const SurfelData& surfelData, const Scene &scene) {
+    SurfelClusterProjection DiffuseLightProbeGenerator::projectSurfelCluster(const SurfelCluster &cluster, const DiffuseLightProbe &probe, const SurfelData& surfelData,
+                                                                             const Scene &scene, RayQueryScratch &scratch) const {
         SurfelClusterProjection projection;
 
+        scratch.segments.clear();
+        scratch.surfelIndices.clear();
+        scratch.solidAngles.clear();
+
         for (size_t i = cluster.surfelOffset; i < cluster.surfelOffset + cluster.surfelCount; i++) {
             const Surfel &surfel = surfelData.surfels()[i];
-            glm::vec3 Wps_norm = glm::normalize(surfel.position - probe.position);
-            float solidAngle = surfelSolidAngle(surfel, probe, scene);
+            float solidAngle = surfelSolidAngle(surfel, probe);
 
+            // Save ray casts if surfel's facing away from the standpoint
             if (solidAngle > 0.0) {
-                // Accumulating in YCoCg space to enable compression possibilities
-                auto ycocg = surfel.albedo.convertedTo(Color::Space::YCoCg).rgb();
-                projection.sphericalHarmonics.contribute(Wps_norm, ycocg, solidAngle);
+                scratch.segments.push_back({probe.position, surfel.position});
+                scratch.surfelIndices.push_back(i);
+                scratch.solidAngles.push_back(solidAngle);
+            }
+        }
+
+        constexpr float p0Offset = 0.01; // Offset line segment points to avoid erroneous collision detections at surfel positions,
+        constexpr float p1Offset = 0.01; // which will happen a lot since the're located exactly on the surface of geometry
+        scene.rayTracer()->lineSegmentsOccluded(scratch.segments, scratch.occluded, p0Offset, p1Offset);
+
+        for (size_t i = 0; i < scratch.surfelIndices.size(); i++) {
+            if (scratch.occluded[i]) {
+                continue;
             }
+
+            const Surfel &surfel = surfelData.surfels()[scratch.surfelIndices[i]];
+            glm::vec3 Wps_norm = glm::normalize(surfel.position - probe.position);
+
+            // Accumulating in YCoCg space to enable compression possibilities
+            auto ycocg = surfel.albedo.convertedTo(Color::Space::YCoCg).rgb();
+            projection.sphericalHarmonics.contribute(Wps_norm, ycocg, scratch.solidAngles[i]);
         }
+
         projection.sphericalHarmonics.convolve();
         projection.sphericalHarmonics.scale(glm::vec3(1.0f / (4.0f * M_PI)));
 
         return projection;
     }
 
-    void DiffuseLightProbeGenerator::projectSurfelClustersOnProbe(DiffuseLightProbe &probe, const SurfelData& surfelData, const Scene &scene) {
-        probe.surfelClusterProjectionGroupOffset = (uint32_t) mProbeData->mSurfelClusterProjections.size();
-
-        for (size_t i = 0; i < surfelData.surfelClusters().size(); i++) {
+    void DiffuseLightProbeGenerator::projectSurfelClustersOnProbe(DiffuseLightProbe &probe, std::vector<SurfelClusterProjection> &projections, const SurfelData& surfelData,
+                                                                  const Scene &scene, RayQueryScratch &scratch, size_t firstCluster) const {
+        for (size_t i = firstCluster; i < surfelData.surfelClusters().size(); i++) {
             const SurfelCluster &cluster = surfelData.surfelClusters()[i];
-            SurfelClusterProjection projection = projectSurfelCluster(cluster, probe, surfelData, scene);
+            SurfelClusterProjection projection = projectSurfelCluster(cluster, probe, surfelData, scene, scratch);
 
             // Only accept projections with non-zero SH
             if (projection.sphericalHarmonics.magnitude() > 10e-7) {
                 projection.surfelClusterIndex = (uint32_t) i;
-                mProbeData->mSurfelClusterProjections.push_back(projection);
+                projections.push_back(projection);
                 probe.surfelClusterProjectionGroupSize++;
             }
         }
     }
 
-    void DiffuseLightProbeGenerator::projectSkyOnProbe(DiffuseLightProbe &probe, const Scene &scene) {
+    void DiffuseLightProbeGenerator::reuseProbe(DiffuseLightProbe &probe, size_t probeIndex, std::vector<SurfelClusterProjection> &projections,
+                                                const IncrementalBakeInput &incrementalInput) const {
+        const DiffuseLightProbe &previousProbe = incrementalInput.previousData->probes()[probeIndex];
+        const auto &previousProjections = incrementalInput.previousData->surfelClusterProjections();
+        const auto &clusterIndices = incrementalInput.clusterChanges->previousToCurrentClusterIndices;
+
+        probe.skySphericalHarmonics = previousProbe.skySphericalHarmonics;
+
+        // Kept clusters preserve their order, so projections stay sorted by cluster index
+        for (size_t i = previousProbe.surfelClusterProjectionGroupOffset;
+             i < previousProbe.surfelClusterProjectionGroupOffset + previousProbe.surfelClusterProjectionGroupSize; i++) {
+            SurfelClusterProjection projection = previousProjections[i];
+            projection.surfelClusterIndex = clusterIndices[projection.surfelClusterIndex];
+            projections.push_back(projection);
+            probe.surfelClusterProjectionGroupSize++;
+        }
+    }
+
+    void DiffuseLightProbeGenerator::buildSkySamples() {
+        mSkySamples.clear();
 
         float sampleDelta = 0.025;
-        int32_t iterationCount = 0;
 
         // Phi - azimuth (horizontal) angle
         for (float phi = 0.0; phi < M_PI * 2.0; phi += sampleDelta) {
@@ -87,50 +133,186 @@ namespace EARenderer {
                 float sinTheta = sin(theta);
                 float cosTheta = cos(theta);
 
-                glm::vec3 sampleVector(sinTheta * cosPhi, sinTheta * sinPhi, cosTheta);
+                // Scale by sin(theta) to account for the smaller sample areas in the higher hemisphere areas
+                mSkySamples.push_back({glm::vec3(sinTheta * cosPhi, sinTheta * sinPhi, cosTheta), sinTheta});
+            }
+        }
+    }
 
-                float distance = 0;
-                Ray3D sampleRay(probe.position, sampleVector);
+    void DiffuseLightProbeGenerator::projectSkyOnProbe(DiffuseLightProbe &probe, const Scene &scene, RayQueryScratch &scratch) const {
+        scratch.rays.clear();
+        for (const SkySample &sample : mSkySamples) {
+            scratch.rays.emplace_back(probe.position, sample.direction);
+        }
 
-                // If sky is visible (not obstructed by geometry) contribute to the spherical harmonics in that direction
-                if (!scene.rayTracer()->rayHit(sampleRay, distance)) {
-                    // Scale by sin(theta) to account for the smaller sample areas in the higher hemisphere areas
-                    probe.skySphericalHarmonics.contribute(sampleVector, glm::vec3(1.0), sinTheta);
-                }
+        scene.rayTracer()->raysHit(scratch.rays, scratch.distances);
 
-                iterationCount++;
+        for (size_t i = 0; i < mSkySamples.size(); i++) {
+            // If sky is visible (not obstructed by geometry) contribute to the spherical harmonics in that direction
+            if (scratch.distances[i] == std::numeric_limits<float>::max()) {
+                probe.skySphericalHarmonics.contribute(mSkySamples[i].direction, glm::vec3(1.0), mSkySamples[i].weight);
             }
         }
 
-        probe.skySphericalHarmonics.scale(glm::vec3(1.0 / iterationCount));
+        probe.skySphericalHarmonics.scale(glm::vec3(1.0 / mSkySamples.size()));
         probe.skySphericalHarmonics.convolve();
     }
 
-#pragma mark - Public interface
-
-    std::unique_ptr<DiffuseLightProbeData> DiffuseLightProbeGenerator::generateProbes(const Scene &scene, const SurfelData& surfelData) {
-        mProbeData = std::make_unique<DiffuseLightProbeData>();
-
+    std::vector<DiffuseLightProbe> DiffuseLightProbeGenerator::placeProbes(const Scene &scene, glm::vec3 &gridResolution) const {
         AxisAlignedBox3D bb = scene.lightBakingVolume();
         glm::vec3 bbLengths = bb.max - bb.min;
-        glm::vec3 resolution = glm::max(glm::vec3(1.0), glm::round(bbLengths / scene.difuseProbesSpacing()));
-        glm::vec3 step = bbLengths / (resolution - 1.0f);
+        // At least two probes per axis, a single one would make the step infinite and never end the loops below
+        gridResolution = glm::max(glm::vec3(2.0), glm::round(bbLengths / scene.difuseProbesSpacing()));
+        glm::vec3 step = bbLengths / (gridResolution - 1.0f);
 
+        std::vector<DiffuseLightProbe> probes;
         for (float z = bb.min.z; z <= bb.max.z + step.z / 2.0; z += step.z) {
             for (float y = bb.min.y; y <= bb.max.y + step.y / 2.0; y += step.y) {
                 for (float x = bb.min.x; x <= bb.max.x + step.x / 2.0; x += step.x) {
-                    DiffuseLightProbe probe({x, y, z});
-                    projectSurfelClustersOnProbe(probe, surfelData, scene);
-                    projectSkyOnProbe(probe, scene);
-                    mProbeData->mProbes.push_back(probe);
+                    probes.emplace_back(glm::vec3(x, y, z));
                 }
             }
         }
 
-        mProbeData->mGridResolution = resolution;
-        mProbeData->initializeBuffers();
+        return probes;
+    }
+
+    void DiffuseLightProbeGenerator::bakeBatch(ProbeBakingBatch &batch, const SurfelData& surfelData, const Scene &scene,
+                                               const IncrementalBakeInput *incrementalInput) const {
+        RayQueryScratch scratch;
+        for (size_t i = 0; i < batch.probes.size(); i++) {
+            DiffuseLightProbe &probe = batch.probes[i];
+            size_t probeIndex = batch.firstProbeIndex + i;
+
+            probe.surfelClusterProjectionGroupOffset = (uint32_t) batch.surfelClusterProjections.size();
+
+            if (incrementalInput && !incrementalInput->staleProbes[probeIndex]) {
+                reuseProbe(probe, probeIndex, batch.surfelClusterProjections, *incrementalInput);
+                projectSurfelClustersOnProbe(probe, batch.surfelClusterProjections, surfelData, scene, scratch,
+                        incrementalInput->clusterChanges->firstAddedCluster);
+            } else {
+                projectSurfelClustersOnProbe(probe, batch.surfelClusterProjections, surfelData, scene, scratch, 0);
+                projectSkyOnProbe(probe, scene, scratch);
+            }
+        }
+    }
+
+    void DiffuseLightProbeGenerator::mergeBatches(std::vector<ProbeBakingBatch> &batches) {
+        for (ProbeBakingBatch &batch : batches) {
+            uint32_t projectionsOffset = (uint32_t) mProbeData->mSurfelClusterProjections.size();
+
+            for (DiffuseLightProbe &probe : batch.probes) {
+                probe.surfelClusterProjectionGroupOffset += projectionsOffset;
+                mProbeData->mProbes.push_back(probe);
+            }
+
+            mProbeData->mSurfelClusterProjections.insert(mProbeData->mSurfelClusterProjections.end(),
+                    batch.surfelClusterProjections.begin(), batch.surfelClusterProjections.end());
+
+            batch = ProbeBakingBatch();
+        }
+    }
+
+    std::unique_ptr<DiffuseLightProbeData> DiffuseLightProbeGenerator::bakeProbes(const Scene &scene, const SurfelData& surfelData, std::vector<DiffuseLightProbe> &probes,
+                                                                                  const glm::vec3 &gridResolution, const IncrementalBakeInput *incrementalInput) {
+        mProbeData = std::make_unique<DiffuseLightProbeData>();
+
+        buildSkySamples();
+
+        // Several batches per worker to even out the load, since probe cost varies a lot with occlusion
+        size_t batchCount = mMultithreadingEnabled ? ThreadPool::Default().threadCount() * 4 : 1;
+        size_t batchSize = std::max(probes.size() / batchCount, size_t(1));
+
+        std::vector<ProbeBakingBatch> batches;
+        for (size_t i = 0; i < probes.size(); i += batchSize) {
+            ProbeBakingBatch batch;
+            batch.probes.assign(probes.begin() + i, probes.begin() + std::min(i + batchSize, probes.size()));
+            batch.firstProbeIndex = i;
+            batches.emplace_back(std::move(batch));
+        }
+
+        if (mMultithreadingEnabled) {
+            ThreadPool::Default().parallelFor(0, batches.size(), 1, [&](size_t begin, size_t end) {
+                for (size_t i = begin; i < end; i++) {
+                    bakeBatch(batches[i], surfelData, scene, incrementalInput);
+                }
+            });
+        } else {
+            for (auto &batch : batches) {
+                bakeBatch(batch, surfelData, scene, incrementalInput);
+            }
+        }
+
+        mergeBatches(batches);
+
+        mProbeData->mGridResolution = gridResolution;
 
         return std::move(mProbeData);
     }
 
+#pragma mark - Public interface
+
+    std::unique_ptr<DiffuseLightProbeData> DiffuseLightProbeGenerator::generateProbes(const Scene &scene, const SurfelData& surfelData) {
+        glm::vec3 gridResolution;
+        std::vector<DiffuseLightProbe> probes = placeProbes(scene, gridResolution);
+        return bakeProbes(scene, surfelData, probes, gridResolution, nullptr);
+    }
+
+    std::unique_ptr<DiffuseLightProbeData> DiffuseLightProbeGenerator::updateProbes(const Scene &scene, const SurfelData& surfelData,
+                                                                                    const DiffuseLightProbeData &previousData, const SurfelClusterChangeSet &clusterChanges) {
+        glm::vec3 gridResolution;
+        std::vector<DiffuseLightProbe> probes = placeProbes(scene, gridResolution);
+
+        const auto &previousProbes = previousData.probes();
+        const auto &previousProjections = previousData.surfelClusterProjections();
+        const auto &clusterIndices = clusterChanges.previousToCurrentClusterIndices;
+
+        bool gridMatches = glm::ivec3(gridResolution) == previousData.gridResolution() && probes.size() == previousProbes.size();
+        for (size_t i = 0; gridMatches && i < probes.size(); i++) {
+            gridMatches = probes[i].position == previousProbes[i].position;
+        }
+
+        if (!gridMatches) {
+            return generateProbes(scene, surfelData);
+        }
+
+        IncrementalBakeInput incrementalInput;
+        incrementalInput.previousData = &previousData;
+        incrementalInput.clusterChanges = &clusterChanges;
+        incrementalInput.staleProbes.assign(probes.size(), false);
+
+        // Sky visibility and occlusion of kept clusters are reused as is, which only holds for probes
+        // far enough from geometry that appeared, disappeared or moved
+        std::vector<AxisAlignedBox3D> changedRegions;
+        glm::vec3 margin(scene.difuseProbesSpacing());
+        for (const AxisAlignedBox3D &bounds : clusterChanges.changedGeometryBounds) {
+            changedRegions.emplace_back(bounds.min - margin, bounds.max + margin);
+        }
+
+        for (size_t probeIndex = 0; probeIndex < previousProbes.size(); probeIndex++) {
+            const DiffuseLightProbe &probe = previousProbes[probeIndex];
+
+            for (const AxisAlignedBox3D &region : changedRegions) {
+                if (region.contains(probe.position)) {
+                    incrementalInput.staleProbes[probeIndex] = true;
+                    break;
+                }
+            }
+
+            if (incrementalInput.staleProbes[probeIndex]) {
+                continue;
+            }
+
+            for (size_t i = probe.surfelClusterProjectionGroupOffset; i < probe.surfelClusterProjectionGroupOffset + probe.surfelClusterProjectionGroupSize; i++) {
+                uint32_t clusterIndex = previousProjections[i].surfelClusterIndex;
+                if (clusterIndex >= clusterIndices.size() || clusterIndices[clusterIndex] == SurfelClusterChangeSet::RemovedCluster) {
+                    incrementalInput.staleProbes[probeIndex] = true;
+                    break;
+                }
+            }
+        }
+
+        return bakeProbes(scene, surfelData, probes, gridResolution, &incrementalInput);
+    }
+
 }
@@ -12,26 +12,147 @@
 #include "Scene.hpp"
 #include "DiffuseLightProbeData.hpp"
 #include "SurfelData.hpp"
+#include "EmbreeRayTracer.hpp"
+#include "Ray3D.hpp"
 
 #include <memory>
+#include <vector>
 #include <glm/vec2.hpp>
+#include <glm/vec3.hpp>
 
 namespace EARenderer {
 
     class DiffuseLightProbeGenerator {
     private:
+
+#pragma mark - Nested types
+
+        struct SkySample {
+            glm::vec3 direction;
+            float weight;
+        };
+
+        /**
+         Range of probes baked by a single task along with the task's private output.
+         Cluster projection group offsets of the probes are relative to the batch's own projection list
+         until the batch is merged into the resulting probe data.
+         */
+        struct ProbeBakingBatch {
+            std::vector<DiffuseLightProbe> probes;
+            std::vector<SurfelClusterProjection> surfelClusterProjections;
+
+            /// Index of the batch's first probe in the probe grid
+            size_t firstProbeIndex = 0;
+        };
+
+        /**
+         Previous bake along with the changes surfel clusters went through since then
+         */
+        struct IncrementalBakeInput {
+            const DiffuseLightProbeData *previousData = nullptr;
+            const SurfelClusterChangeSet *clusterChanges = nullptr;
+
+            /// Probes that saw any of the removed clusters or are close to changed geometry, baked from scratch
+            std::vector<bool> staleProbes;
+        };
+
+        /**
+         Buffers for batched ray queries, reused from probe to probe to avoid allocations
+         */
+        struct RayQueryScratch {
+            std::vector<EmbreeRayTracer::LineSegment> segments;
+            std::vector<bool> occluded;
+            std::vector<size_t> surfelIndices;
+            std::vector<float> solidAngles;
+            std::vector<Ray3D> rays;
+            std::vector<float> distances;
+        };
+
+#pragma mark - Member variables
+
         std::unique_ptr<DiffuseLightProbeData> mProbeData;
+        std::vector<SkySample> mSkySamples;
+        bool mMultithreadingEnabled = true;
+
+#pragma mark - Member functions
+
+        /**
+         @return Solid angle subtended by the surfel as seen from the probe, not accounting for occlusion
+         */
+        float surfelSolidAngle(const Surfel &surfel, const DiffuseLightProbe &probe) const;
 
-        float surfelSolidAngle(const Surfel &surfel, const DiffuseLightProbe &probe, const Scene &scene);
+        SurfelClusterProjection projectSurfelCluster(const SurfelCluster &cluster, const DiffuseLightProbe &probe, const SurfelData& surfelData,
+                                                     const Scene &scene, RayQueryScratch &scratch) const;
 
-        SurfelClusterProjection projectSurfelCluster(const SurfelCluster &cluster, const DiffuseLightProbe &probe, const SurfelData& surfelData, const Scene &scene);
+        /**
+         Appends projections of surfel clusters starting from firstCluster to the probe's projection group
+         */
+        void projectSurfelClustersOnProbe(DiffuseLightProbe &probe, std::vector<SurfelClusterProjection> &projections, const SurfelData& surfelData,
+                                          const Scene &scene, RayQueryScratch &scratch, size_t firstCluster) const;
 
-        void projectSurfelClustersOnProbe(DiffuseLightProbe &probe, const SurfelData& surfelData, const Scene &scene);
+        /**
+         Copies sky projection and surfel cluster projections of a probe from the previous bake,
+         pointing the latter to updated cluster indices
+         */
+        void reuseProbe(DiffuseLightProbe &probe, size_t probeIndex, std::vector<SurfelClusterProjection> &projections, const IncrementalBakeInput &incrementalInput) const;
 
-        void projectSkyOnProbe(DiffuseLightProbe &probe, const Scene &scene);
+        void projectSkyOnProbe(DiffuseLightProbe &probe, const Scene &scene, RayQueryScratch &scratch) const;
+
+        /**
+         Precomputes sky sampling directions shared by all probes
+         */
+        void buildSkySamples();
+
+        /**
+         Places probes on a regular grid spanning light baking volume
+
+         @param gridResolution Receives the number of probes along each axis
+         */
+        std::vector<DiffuseLightProbe> placeProbes(const Scene &scene, glm::vec3 &gridResolution) const;
+
+        /**
+         Bakes all probes of a batch. Touches nothing but the batch itself,
+         therefore batches can be processed concurrently.
+
+         @param incrementalInput Previous bake to reuse up-to-date probe data from, or nullptr to bake every probe from scratch
+         */
+        void bakeBatch(ProbeBakingBatch &batch, const SurfelData& surfelData, const Scene &scene, const IncrementalBakeInput *incrementalInput) const;
+
+        /**
+         Splits probes into batches and bakes them
+         */
+        std::unique_ptr<DiffuseLightProbeData> bakeProbes(const Scene &scene, const SurfelData& surfelData, std::vector<DiffuseLightProbe> &probes,
+                                                          const glm::vec3 &gridResolution, const IncrementalBakeInput *incrementalInput);
+
+        /**
+         Appends baked batches to the probe data in probe order, rebasing projection group offsets
+         */
+        void mergeBatches(std::vector<ProbeBakingBatch> &batches);
 
     public:
+        bool isMultithreadingEnabled() const;
+
+        /**
+         Enables distribution of probe baking across ThreadPool::Default() workers.
+         Resulting probe data is identical in both modes.
+         */
+        void setMultithreadingEnabled(bool enabled);
+
         std::unique_ptr<DiffuseLightProbeData> generateProbes(const Scene &scene, const SurfelData& surfelData);
+
+        /**
+         Rebakes probes affected by an incremental surfel update.
+         Probes that saw any of the removed surfel clusters or lie within a probe spacing of changed geometry
+         are baked from scratch, other probes keep their projections and only receive projections of the added clusters.
+         Falls back to a complete bake if the probe grid has changed.
+
+         @param surfelData Incrementally updated surfels
+         @param previousData Probes baked against the previous version of surfel data
+         @param clusterChanges Changes reported by SurfelGenerator::updateStaticGeometrySurfels()
+         @return Updated probe data
+         */
+        std::unique_ptr<DiffuseLightProbeData> updateProbes(const Scene &scene, const SurfelData& surfelData,
+                                                            const DiffuseLightProbeData &previousData, const SurfelClusterChangeSet &clusterChanges);
     };
 
 }
@@ -0,0 +1,143 @@
+//
+//  SceneBaker.cpp
+//  EARenderer
+//
+//  Created by Pavlo Muratov on 17.10.2026.
+//  Copyright © 2026 MPO. All rights reserved.
+//
+
+#include "SceneBaker.hpp"
+#include "SurfelGenerator.hpp"
+#include "DiffuseLightProbeGenerator.hpp"
+#include "ThreadPool.hpp"
+#include "StringUtils.hpp"
+
+#include <chrono>
+
+namespace EARenderer {
+
+    static uint64_t MicrosecondsSince(std::chrono::steady_clock::time_point start) {
+        return std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start).count();
+    }
+
+#pragma mark - Report
+
+    std::string SceneBaker::Report::description() const {
+        return string_format(
+                "Surfels: %s %zu surfels in %zu clusters in %.1f ms\n"
+                "Diffuse light probes: %s %zu probes in %.1f ms\n"
+                "Worker threads: %zu\n"
+                "Seed: %u",
+                ActionName(surfels.action), surfels.itemCount, surfelClusterCount, surfels.time / 1000.0,
+                ActionName(diffuseProbes.action), diffuseProbes.itemCount, diffuseProbes.time / 1000.0,
+                workerThreadCount,
+                seed
+        );
+    }
+
+#pragma mark - Lifecycle
+
+    SceneBaker::SceneBaker(const SharedResourceStorage *resourceStorage, const Scene *scene)
+            : SceneBaker(resourceStorage, scene, Settings()) {}
+
+    SceneBaker::SceneBaker(const SharedResourceStorage *resourceStorage, const Scene *scene, const Settings &settings)
+            : mResourceStorage(resourceStorage), mScene(scene), mSettings(settings) {}
+
+#pragma mark - Private helpers
+
+    const char *SceneBaker::ActionName(Action action) {
+        switch (action) {
+            case Action::Loaded: return "loaded";
+            case Action::Updated: return "updated";
+            case Action::Generated: return "generated";
+        }
+        return "";
+    }
+
+    template<class Data>
+    void SceneBaker::uploadIfEnabled(Data &data) const {
+        if (mSettings.gpuUploadEnabled) {
+            data.initializeBuffers();
+        }
+    }
+
+#pragma mark - Getters
+
+    const SceneBaker::Report &SceneBaker::report() const {
+        return mReport;
+    }
+
+    std::string SceneBaker::surfelStorageFileName() const {
+        return "surfels_" + mScene->name();
+    }
+
+    std::string SceneBaker::diffuseProbeStorageFileName() const {
+        return "diffuse_light_probes_" + mScene->name();
+    }
+
+#pragma mark - Baking
+
+    SceneBaker::Result SceneBaker::bake() {
+        mReport = Report();
+        mReport.workerThreadCount = mSettings.multithreadingEnabled ? ThreadPool::Default().threadCount() : 0;
+
+        Result result;
+
+        // Static instances could have been moved since the ray tracer was built.
+        // Their new transformations are what the incremental rebake compares checksums against.
+        mScene->updateStaticGeometryRaytracerTransforms();
+
+        SurfelGenerator surfelGenerator = mSettings.seed ?
+                SurfelGenerator(mResourceStorage, mScene, *mSettings.seed) :
+                SurfelGenerator(mResourceStorage, mScene);
+        surfelGenerator.setMultithreadingEnabled(mSettings.multithreadingEnabled);
+        mReport.seed = surfelGenerator.seed();
+
+        SurfelClusterChangeSet surfelClusterChanges;
+        auto surfelsStart = std::chrono::steady_clock::now();
+
+        result.surfelData = std::make_unique<SurfelData>();
+
+        if (mSettings.forceRebake || !result.surfelData->deserialize(surfelStorageFileName(), mSettings.gpuUploadEnabled)) {
+            result.surfelData = surfelGenerator.generateStaticGeometrySurfels();
+            result.surfelData->serialize(surfelStorageFileName());
+            uploadIfEnabled(*result.surfelData);
+            mReport.surfels.action = Action::Generated;
+        } else if (!surfelGenerator.isUpToDate(*result.surfelData)) {
+            result.surfelData = surfelGenerator.updateStaticGeometrySurfels(*result.surfelData, surfelClusterChanges);
+            result.surfelData->serialize(surfelStorageFileName());
+            uploadIfEnabled(*result.surfelData);
+            mReport.surfels.action = Action::Updated;
+        }
+
+        mReport.surfels.time = MicrosecondsSince(surfelsStart);
+        mReport.surfels.itemCount = result.surfelData->surfels().size();
+        mReport.surfelClusterCount = result.surfelData->surfelClusters().size();
+
+        DiffuseLightProbeGenerator lightProbeGenerator;
+        lightProbeGenerator.setMultithreadingEnabled(mSettings.multithreadingEnabled);
+
+        auto probesStart = std::chrono::steady_clock::now();
+
+        result.diffuseProbeData = std::make_unique<DiffuseLightProbeData>();
+
+        // Probes reference surfel clusters by index, so regenerated surfels invalidate them entirely
+        if (mReport.surfels.action == Action::Generated || !result.diffuseProbeData->deserialize(diffuseProbeStorageFileName(), mSettings.gpuUploadEnabled)) {
+            result.diffuseProbeData = lightProbeGenerator.generateProbes(*mScene, *result.surfelData);
+            result.diffuseProbeData->serialize(diffuseProbeStorageFileName());
+            uploadIfEnabled(*result.diffuseProbeData);
+            mReport.diffuseProbes.action = Action::Generated;
+        } else if (mReport.surfels.action == Action::Updated) {
+            result.diffuseProbeData = lightProbeGenerator.updateProbes(*mScene, *result.surfelData, *result.diffuseProbeData, surfelClusterChanges);
+            result.diffuseProbeData->serialize(diffuseProbeStorageFileName());
+            uploadIfEnabled(*result.diffuseProbeData);
+            mReport.diffuseProbes.action = Action::Updated;
+        }
+
+        mReport.diffuseProbes.time = MicrosecondsSince(probesStart);
+        mReport.diffuseProbes.itemCount = result.diffuseProbeData->probes().size();
+
+        return result;
+    }
+
+}
@@ -0,0 +1,113 @@
+//
+//  SceneBaker.hpp
+//  EARenderer
+//
+//  Created by Pavlo Muratov on 17.10.2026.
+//  Copyright © 2026 MPO. All rights reserved.
+//
+
+#ifndef SceneBaker_hpp
+#define SceneBaker_hpp
+
+#include "Scene.hpp"
+#include "SharedResourceStorage.hpp"
+#include "SurfelData.hpp"
+#include "DiffuseLightProbeData.hpp"
+
+#include <memory>
+#include <string>
+#include <optional>
+
+namespace EARenderer {
+
+    // Produces surfels and diffuse light probes for a composed scene.
+    //
+    // Bakes stored by previous runs are loaded when they are still valid, updated incrementally
+    // when only some static geometry changed and regenerated otherwise. Doesn't depend on any
+    // particular front end, so the same bake can be driven by the editor or a command-line tool.
+
+    class SceneBaker {
+    public:
+        enum class Action {
+            Loaded, Updated, Generated
+        };
+
+        struct Settings {
+            /// Distributes work across ThreadPool::Default() workers
+            bool multithreadingEnabled = true;
+
+            /// Ignores bakes stored on disk and regenerates everything
+            bool forceRebake = false;
+
+            /// Uploads baked data to the GPU, requires current OpenGL context. Headless bakes turn it off.
+            bool gpuUploadEnabled = true;
+
+            /// Seeds surfel generation to make bakes reproducible, a random seed is used when empty
+            std::optional<uint32_t> seed;
+        };
+
+        struct StageReport {
+            Action action = Action::Loaded;
+
+            /// Time spent on loading or baking, in microseconds
+            uint64_t time = 0;
+
+            size_t itemCount = 0;
+        };
+
+        struct Report {
+            StageReport surfels;
+            StageReport diffuseProbes;
+            size_t surfelClusterCount = 0;
+            size_t workerThreadCount = 0;
+
+            /// Seed surfel generator was created with, whether surfels were generated or not
+            uint32_t seed = 0;
+
+            /**
+             @return human readable multi line summary of the bake
+             */
+            std::string description() const;
+        };
+
+        struct Result {
+            std::unique_ptr<SurfelData> surfelData;
+            std::unique_ptr<DiffuseLightProbeData> diffuseProbeData;
+        };
+
+    private:
+        const SharedResourceStorage *mResourceStorage = nullptr;
+        const Scene *mScene = nullptr;
+        Settings mSettings;
+        Report mReport;
+
+        static const char *ActionName(Action action);
+
+        template<class Data>
+        void uploadIfEnabled(Data &data) const;
+
+    public:
+        SceneBaker(const SharedResourceStorage *resourceStorage, const Scene *scene);
+
+        SceneBaker(const SharedResourceStorage *resourceStorage, const Scene *scene, const Settings &settings);
+
+        /**
+         @return Report of the last bake() invocation
+         */
+        const Report &report() const;
+
+        std::string surfelStorageFileName() const;
+
+        std::string diffuseProbeStorageFileName() const;
+
+        /**
+         Loads, updates or generates bake data and writes whatever was changed back to disk
+
+         @return surfels and diffuse light probes of the scene
+         */
+        Result bake();
+    };
+
+}
+
+#endif /* SceneBaker_hpp */
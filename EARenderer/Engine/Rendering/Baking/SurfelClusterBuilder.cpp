@@ -0,0 +1,258 @@
+//
+//  SurfelClusterBuilder.cpp
+//  EARenderer
+//
+//  Created by Pavlo Muratov on 17.10.2026.
+//  Copyright © 2026 MPO. All rights reserved.
+//
+
+#include "SurfelClusterBuilder.hpp"
+#include "ThreadPool.hpp"
+#include "StringUtils.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <limits>
+#include <stdexcept>
+
+#include <glm/gtx/norm.hpp>
+
+namespace EARenderer {
+
+#pragma mark - Lifecycle
+
+    SurfelClusterBuilder::SurfelClusterBuilder(const Scene *scene, size_t maximumClusterSize)
+            :
+            mScene(scene),
+            mMaximumClusterSize(maximumClusterSize) {
+        if (maximumClusterSize == 0 || maximumClusterSize > SurfelCluster::MaximumSurfelCount) {
+            throw std::invalid_argument(string_format("Maximum surfel cluster size must be in [1, %u] range, got %zu",
+                                                      SurfelCluster::MaximumSurfelCount, maximumClusterSize));
+        }
+
+        float extent = scene->lightBakingVolume().largestDimensionLength();
+        mWorkingVolumeMaximumExtent2 = extent * extent;
+        mMaximumSurfelDistance = sqrtf(Cb) * extent;
+    }
+
+#pragma mark - Getters
+
+    bool SurfelClusterBuilder::isMultithreadingEnabled() const {
+        return mMultithreadingEnabled;
+    }
+
+    const SurfelClusterBuilder::Statistics &SurfelClusterBuilder::statistics() const {
+        return mStatistics;
+    }
+
+#pragma mark - Setters
+
+    void SurfelClusterBuilder::setMultithreadingEnabled(bool enabled) {
+        mMultithreadingEnabled = enabled;
+    }
+
+#pragma mark - Private helpers
+
+    bool SurfelClusterBuilder::surfelsGeometricallyAlike(const Surfel &first, const Surfel &second) const {
+        float normDistance2 = glm::length2(first.position - second.position) / mWorkingVolumeMaximumExtent2;
+        float normalDeviation = glm::dot(first.normal, second.normal);
+        return normDistance2 <= Cb && normalDeviation > Cn;
+    }
+
+    bool SurfelClusterBuilder::surfelVisibleFromCluster(const Surfel &candidate, const std::vector<uint32_t> &cluster, const std::vector<Surfel> &surfels,
+                                                        std::vector<EmbreeRayTracer::LineSegment> &segments, std::vector<bool> &occluded) const {
+        auto offsetEnd = candidate.position + candidate.normal * mWorkingVolumeMaximumExtent2 * 0.001f;
+
+        segments.clear();
+        for (uint32_t memberIndex : cluster) {
+            const Surfel &member = surfels[memberIndex];
+            auto offsetStart = member.position + member.normal * mWorkingVolumeMaximumExtent2 * 0.001f;
+            segments.push_back({offsetStart, offsetEnd});
+        }
+
+        mScene->rayTracer()->lineSegmentsOccluded(segments, occluded);
+
+        return std::none_of(occluded.begin(), occluded.end(), [](bool flag) { return flag; });
+    }
+
+    glm::ivec3 SurfelClusterBuilder::cellPosition(const glm::vec3 &position) const {
+        // Degenerate volume collapses into a single cell
+        float cellsPerUnit = mMaximumSurfelDistance > 0.0 ? 1.0 / mMaximumSurfelDistance : 0.0;
+        glm::vec3 cell = glm::floor((position - mScene->lightBakingVolume().min) * cellsPerUnit);
+        return glm::ivec3(glm::clamp(cell, glm::vec3(-MaximumCellCoordinate), glm::vec3(MaximumCellCoordinate)));
+    }
+
+    uint64_t SurfelClusterBuilder::cellKey(const glm::ivec3 &cellPosition) {
+        // 21 bits per biased coordinate
+        glm::ivec3 biased = cellPosition + CellCoordinateBias;
+        return uint64_t(biased.x) | (uint64_t(biased.y) << 21) | (uint64_t(biased.z) << 42);
+    }
+
+    SurfelClusterBuilder::CellMap SurfelClusterBuilder::partition(const std::vector<Surfel> &surfels) const {
+        CellMap cellMap;
+
+        for (uint32_t i = 0; i < surfels.size(); i++) {
+            glm::ivec3 position = cellPosition(surfels[i].position);
+            auto insertion = cellMap.cellIndices.emplace(cellKey(position), (uint32_t) cellMap.cells.size());
+
+            if (insertion.second) {
+                cellMap.cells.emplace_back();
+                cellMap.cells.back().position = position;
+            }
+
+            cellMap.cells[insertion.first->second].surfelIndices.push_back(i);
+        }
+
+        for (auto &cell : cellMap.cells) {
+            for (int32_t z = -1; z <= 1; z++) {
+                for (int32_t y = -1; y <= 1; y++) {
+                    for (int32_t x = -1; x <= 1; x++) {
+                        auto it = cellMap.cellIndices.find(cellKey(cell.position + glm::ivec3(x, y, z)));
+                        if (it != cellMap.cellIndices.end()) {
+                            cell.neighbourIndices.push_back(it->second);
+                        }
+                    }
+                }
+            }
+        }
+
+        return cellMap;
+    }
+
+    void SurfelClusterBuilder::clusterizeCell(uint32_t cellIndex, CellMap &cellMap, const std::vector<Surfel> &surfels, std::vector<uint8_t> &clustered) const {
+        Cell &cell = cellMap.cells[cellIndex];
+
+        std::vector<std::pair<float, uint32_t>> candidates;
+        std::vector<EmbreeRayTracer::LineSegment> segments;
+        std::vector<bool> occluded;
+
+        for (uint32_t seedIndex : cell.surfelIndices) {
+            // Claimed by a cluster of this cell or of a neighbouring cell processed earlier
+            if (clustered[seedIndex]) {
+                continue;
+            }
+
+            const Surfel &seed = surfels[seedIndex];
+            std::vector<uint32_t> cluster{seedIndex};
+            clustered[seedIndex] = true;
+
+            // Cells are as wide as the distance bound, so the neighbourhood holds every surfel
+            // close enough to the seed
+            candidates.clear();
+            for (uint32_t neighbourIndex : cell.neighbourIndices) {
+                for (uint32_t candidateIndex : cellMap.cells[neighbourIndex].surfelIndices) {
+                    if (!clustered[candidateIndex] && surfelsGeometricallyAlike(seed, surfels[candidateIndex])) {
+                        candidates.emplace_back(glm::length2(surfels[candidateIndex].position - seed.position), candidateIndex);
+                    }
+                }
+            }
+
+            // Closest candidates first to produce compact clusters when size limit is reached
+            std::sort(candidates.begin(), candidates.end());
+
+            for (auto &distanceIndexPair : candidates) {
+                if (cluster.size() == mMaximumClusterSize) {
+                    break;
+                }
+
+                uint32_t candidateIndex = distanceIndexPair.second;
+                const Surfel &candidate = surfels[candidateIndex];
+                cell.candidateTestCount++;
+
+                // Run cheap tests against all cluster members before casting any rays
+                bool alikeToAllSurfelsInCluster = std::all_of(cluster.begin() + 1, cluster.end(), [&](uint32_t memberIndex) {
+                    return surfelsGeometricallyAlike(surfels[memberIndex], candidate);
+                });
+
+                if (!alikeToAllSurfelsInCluster) {
+                    continue;
+                }
+
+                cell.occlusionTestCount += cluster.size();
+
+                if (surfelVisibleFromCluster(candidate, cluster, surfels, segments, occluded)) {
+                    cluster.push_back(candidateIndex);
+                    clustered[candidateIndex] = true;
+                }
+            }
+
+            cell.clusters.emplace_back(std::move(cluster));
+        }
+    }
+
+#pragma mark - Public interface
+
+    void SurfelClusterBuilder::buildClusters(const std::vector<Surfel> &surfels, std::vector<Surfel> &clusteredSurfels, std::vector<SurfelCluster> &clusters,
+                                             std::vector<uint32_t> *sourceSurfelIndices) {
+        mStatistics = Statistics();
+        mStatistics.surfelCount = surfels.size();
+
+        auto indexingStart = std::chrono::steady_clock::now();
+        CellMap cellMap = partition(surfels);
+
+        std::vector<std::vector<uint32_t>> colourCellIndices(ColourStride * ColourStride * ColourStride);
+        for (uint32_t i = 0; i < cellMap.cells.size(); i++) {
+            glm::ivec3 colour = (cellMap.cells[i].position % ColourStride + ColourStride) % ColourStride;
+            colourCellIndices[(colour.z * ColourStride + colour.y) * ColourStride + colour.x].push_back(i);
+        }
+
+        auto clusteringStart = std::chrono::steady_clock::now();
+
+        // Written concurrently, so bytes instead of packed bits
+        std::vector<uint8_t> clustered(surfels.size(), false);
+
+        for (auto &cellIndices : colourCellIndices) {
+            if (mMultithreadingEnabled) {
+                ThreadPool::Default().parallelFor(0, cellIndices.size(), 1, [&](size_t begin, size_t end) {
+                    for (size_t i = begin; i < end; i++) {
+                        clusterizeCell(cellIndices[i], cellMap, surfels, clustered);
+                    }
+                });
+            } else {
+                for (uint32_t cellIndex : cellIndices) {
+                    clusterizeCell(cellIndex, cellMap, surfels, clustered);
+                }
+            }
+        }
+
+        auto clusteringEnd = std::chrono::steady_clock::now();
+
+        // Gather clusters in a fixed order to keep the result independent of scheduling
+        mStatistics.smallestClusterSize = std::numeric_limits<size_t>::max();
+
+        for (auto &cell : cellMap.cells) {
+            for (auto &cluster : cell.clusters) {
+                SurfelCluster surfelCluster(clusteredSurfels.size(), cluster.size());
+                surfelCluster.center = surfels[cluster.front()].position;
+
+                for (uint32_t surfelIndex : cluster) {
+                    clusteredSurfels.push_back(surfels[surfelIndex]);
+                }
+
+                if (sourceSurfelIndices) {
+                    sourceSurfelIndices->insert(sourceSurfelIndices->end(), cluster.begin(), cluster.end());
+                }
+
+                clusters.push_back(surfelCluster);
+
+                mStatistics.smallestClusterSize = std::min(mStatistics.smallestClusterSize, cluster.size());
+                mStatistics.largestClusterSize = std::max(mStatistics.largestClusterSize, cluster.size());
+                mStatistics.clusterCount++;
+            }
+
+            mStatistics.candidateTestCount += cell.candidateTestCount;
+            mStatistics.occlusionTestCount += cell.occlusionTestCount;
+        }
+
+        if (mStatistics.clusterCount == 0) {
+            mStatistics.smallestClusterSize = 0;
+        } else {
+            mStatistics.averageClusterSize = float(mStatistics.surfelCount) / mStatistics.clusterCount;
+        }
+
+        mStatistics.cellCount = cellMap.cells.size();
+        mStatistics.indexingTime = std::chrono::duration_cast<std::chrono::microseconds>(clusteringStart - indexingStart).count();
+        mStatistics.clusteringTime = std::chrono::duration_cast<std::chrono::microseconds>(clusteringEnd - clusteringStart).count();
+    }
+
+}
@@ -0,0 +1,174 @@
+//
+//  SurfelClusterBuilder.hpp
+//  EARenderer
+//
+//  Created by Pavlo Muratov on 17.10.2026.
+//  Copyright © 2026 MPO. All rights reserved.
+//
+
+#ifndef SurfelClusterBuilder_hpp
+#define SurfelClusterBuilder_hpp
+
+#include "Scene.hpp"
+#include "Surfel.hpp"
+#include "SurfelCluster.hpp"
+#include "AxisAlignedBox3D.hpp"
+#include "EmbreeRayTracer.hpp"
+
+#include <vector>
+#include <unordered_map>
+#include <glm/vec3.hpp>
+
+namespace EARenderer {
+
+    // Gathers similar surfels into clusters.
+    // Surfels are bucketed into a sparse map of cubic cells as wide as the cluster distance bound,
+    // so every surfel that can join a cluster lies in the 3x3x3 cell neighbourhood of cluster's seed.
+    // Cells are coloured by their coordinates modulo 3. Neighbourhoods of cells sharing a colour don't overlap,
+    // so cells of one colour are clusterized in parallel, one colour after another.
+    // Every surfel is claimed by whichever cell reaches it first in that fixed order,
+    // so the result doesn't depend on scheduling.
+
+    class SurfelClusterBuilder {
+    public:
+
+#pragma mark - Nested types
+
+        struct Statistics {
+            size_t surfelCount = 0;
+            size_t clusterCount = 0;
+            size_t cellCount = 0;
+            size_t smallestClusterSize = 0;
+            size_t largestClusterSize = 0;
+            float averageClusterSize = 0.0f;
+            size_t candidateTestCount = 0;
+            size_t occlusionTestCount = 0;
+
+            /// Time spent on bucketing surfels into cells, in microseconds
+            uint64_t indexingTime = 0;
+
+            /// Time spent on actual clustering, in microseconds
+            uint64_t clusteringTime = 0;
+        };
+
+    private:
+        struct Cell {
+            glm::ivec3 position;
+            std::vector<uint32_t> surfelIndices;
+
+            // Indices of non-empty cells in the 3x3x3 neighbourhood, including the cell itself
+            std::vector<uint32_t> neighbourIndices;
+
+            std::vector<std::vector<uint32_t>> clusters;
+            size_t candidateTestCount = 0;
+            size_t occlusionTestCount = 0;
+        };
+
+        struct CellMap {
+            // Non-empty cells in order of their first surfel
+            std::vector<Cell> cells;
+            std::unordered_map<uint64_t, uint32_t> cellIndices;
+        };
+
+#pragma mark - Member variables
+
+        // Minimum cosine between normals of surfels in the same cluster
+        static constexpr float Cn = -0.3;
+
+        // Maximum squared distance between surfels in the same cluster,
+        // normalized by squared largest dimension of light baking volume
+        static constexpr float Cb = 0.04;
+
+        // Neighbourhoods of distinct cells with equal coordinates modulo this value never overlap
+        static constexpr int32_t ColourStride = 3;
+
+        // Cell coordinates are biased to fit 21 bits of a cell key,
+        // clamping leaves room for coordinates of neighbouring cells
+        static constexpr int32_t CellCoordinateBias = 1 << 20;
+        static constexpr int32_t MaximumCellCoordinate = CellCoordinateBias - 2;
+
+        const Scene *mScene = nullptr;
+        size_t mMaximumClusterSize = SurfelCluster::MaximumSurfelCount;
+        bool mMultithreadingEnabled = true;
+        float mWorkingVolumeMaximumExtent2 = 0.0;
+        float mMaximumSurfelDistance = 0.0;
+        Statistics mStatistics;
+
+#pragma mark - Member functions
+
+        /**
+         Cheap part of the similarity test: distance bound and normal deviation
+
+         @param first surfel one
+         @param second surfel two
+         @return true if surfels are close enough and their normals are not deviating too much
+         */
+        bool surfelsGeometricallyAlike(const Surfel &first, const Surfel &second) const;
+
+        /**
+         Expensive part of the similarity test: checks whether a candidate surfel can be seen from every cluster member
+
+         @param candidate Surfel to be tested
+         @param cluster Indices of surfels already in the cluster
+         @param surfels Complete surfel set
+         @param segments Scratch storage for line segments, reused between calls to avoid allocations
+         @param occluded Scratch storage for occlusion flags, reused between calls to avoid allocations
+         @return true if nothing blocks the line of sight between the candidate and any of the cluster members
+         */
+        bool surfelVisibleFromCluster(const Surfel &candidate, const std::vector<uint32_t> &cluster, const std::vector<Surfel> &surfels,
+                                      std::vector<EmbreeRayTracer::LineSegment> &segments, std::vector<bool> &occluded) const;
+
+        /**
+         @param position Position in world space
+         @return Coordinates of the cell containing the position
+         */
+        glm::ivec3 cellPosition(const glm::vec3 &position) const;
+
+        static uint64_t cellKey(const glm::ivec3 &cellPosition);
+
+        /**
+         Buckets surfels into cells and links every cell to its neighbours
+
+         @param surfels Complete surfel set
+         @return Map of non-empty cells
+         */
+        CellMap partition(const std::vector<Surfel> &surfels) const;
+
+        /**
+         Forms clusters seeded by unclustered surfels of a single cell, taking members from the cell's neighbourhood.
+         Safe to be called concurrently for cells whose neighbourhoods don't overlap.
+
+         @param cellIndex Index of the cell to be clusterized. Resulting clusters are written to it.
+         @param cellMap Map of all cells
+         @param surfels Complete surfel set
+         @param clustered Flag for every surfel telling whether it's already taken by a cluster
+         */
+        void clusterizeCell(uint32_t cellIndex, CellMap &cellMap, const std::vector<Surfel> &surfels, std::vector<uint8_t> &clustered) const;
+
+    public:
+        SurfelClusterBuilder(const Scene *scene, size_t maximumClusterSize);
+
+        bool isMultithreadingEnabled() const;
+
+        void setMultithreadingEnabled(bool enabled);
+
+        /**
+         @return Statistics of the last buildClusters() invocation
+         */
+        const Statistics &statistics() const;
+
+        /**
+         Gathers similar surfels into clusters
+
+         @param surfels Surfels to be clusterized
+         @param clusteredSurfels Receives surfels reordered so that every cluster occupies a contiguous range
+         @param clusters Receives clusters referencing ranges in clusteredSurfels
+         @param sourceSurfelIndices Optionally receives the index in surfels of every surfel appended to clusteredSurfels
+         */
+        void buildClusters(const std::vector<Surfel> &surfels, std::vector<Surfel> &clusteredSurfels, std::vector<SurfelCluster> &clusters,
+                           std::vector<uint32_t> *sourceSurfelIndices = nullptr);
+    };
+
+}
+
+#endif /* SurfelClusterBuilder_hpp */
@@ -8,6 +8,7 @@
 
 #include "SurfelData.hpp"
 #include "StringUtils.hpp"
+#include "CRC32.hpp"
 
 #include <bitsery/bitsery.h>
 #include <bitsery/traits/vector.h>
@@ -16,56 +17,155 @@
 
 namespace EARenderer {
 
-#pragma mark - Data
+    static constexpr uint32_t ContentTag = ctcrc32("SurfelData");
+    static constexpr uint32_t SurfelsSectionTag = ctcrc32("Surfels");
+    static constexpr uint32_t SurfelClustersSectionTag = ctcrc32("SurfelClusters");
+    static constexpr uint32_t SurfelPositionsSectionTag = ctcrc32("SurfelPositions");
+    static constexpr uint32_t SurfelNormalsSectionTag = ctcrc32("SurfelNormals");
+    static constexpr uint32_t SurfelAlbedosSectionTag = ctcrc32("SurfelAlbedos");
+    static constexpr uint32_t EncodedClustersSectionTag = ctcrc32("EncodedSurfelClusters");
+    static constexpr uint32_t ClusterCentersSectionTag = ctcrc32("SurfelClusterCenters");
+    static constexpr uint32_t SurfelInstanceIndicesSectionTag = ctcrc32("SurfelInstanceIndices");
+    static constexpr uint32_t InstanceRecordsSectionTag = ctcrc32("SurfelInstanceRecords");
 
-    void SurfelData::initializeBuffers() {
-        std::vector<std::vector<glm::vec3>> surfelGBufferData;
-        surfelGBufferData.emplace_back();
-        surfelGBufferData.emplace_back();
-        surfelGBufferData.emplace_back();
+    template<class Clusters>
+    static bool ClusterRangesValid(const Clusters &clusters, size_t surfelCount) {
+        for (const SurfelCluster &cluster : clusters) {
+            if (cluster.surfelCount == 0 || cluster.surfelCount > SurfelCluster::MaximumSurfelCount ||
+                    uint64_t(cluster.surfelOffset) + cluster.surfelCount > surfelCount) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    // Every surfel has to belong to an existing record, and every record has to own exactly as many surfels as it claims
+    template<class Indices, class Records>
+    static bool InstanceIndicesValid(const Indices &instanceIndices, const Records &instanceRecords, size_t surfelCount) {
+        if (instanceIndices.size() != surfelCount) {
+            return false;
+        }
+
+        std::vector<uint32_t> ownedSurfelCounts(instanceRecords.size(), 0);
+        for (uint32_t recordIndex : instanceIndices) {
+            if (recordIndex >= ownedSurfelCounts.size()) {
+                return false;
+            }
+            ownedSurfelCounts[recordIndex]++;
+        }
+
+        size_t recordIndex = 0;
+        for (const SurfelData::InstanceRecord &record : instanceRecords) {
+            if (record.surfelCount != ownedSurfelCounts[recordIndex++]) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+#pragma mark - Private helpers
+
+    SurfelData::BufferData SurfelData::bufferData() const {
+        BufferData data;
+
+        // 2D textures are uploaded as a whole, so arrays must cover every texel
+        Size2D surfelGBufferSize = GLTexture::EstimatedSize(mSurfels.size());
+        size_t surfelTexelCount = surfelGBufferSize.width * surfelGBufferSize.height;
+
+        data.surfelPositions.reserve(surfelTexelCount);
+        data.surfelNormals.reserve(surfelTexelCount);
+        data.surfelAlbedos.reserve(surfelTexelCount);
 
         for (auto &surfel : mSurfels) {
-            surfelGBufferData[0].emplace_back(surfel.position);
-            surfelGBufferData[1].emplace_back(surfel.normal);
-            surfelGBufferData[2].emplace_back(surfel.albedo.rgb());
+            data.surfelPositions.emplace_back(surfel.position);
+            data.surfelNormals.emplace_back(surfel.normal);
+            data.surfelAlbedos.emplace_back(surfel.albedo.rgb());
         }
 
-        std::vector<uint32_t> surfelClusterGBufferData;
+        data.surfelPositions.resize(surfelTexelCount, glm::vec3(0.0));
+        data.surfelNormals.resize(surfelTexelCount, glm::vec3(0.0));
+        data.surfelAlbedos.resize(surfelTexelCount, glm::vec3(0.0));
+
+        Size2D clusterGBufferSize = GLTexture::EstimatedSize(mSurfelClusters.size());
+        data.encodedClusters.reserve(clusterGBufferSize.width * clusterGBufferSize.height);
+
         for (auto &cluster : mSurfelClusters) {
+            // Averaging shader divides by the packed count, a wrapped count would turn into a division by zero
+            if (cluster.surfelCount == 0 || cluster.surfelCount > SurfelCluster::MaximumSurfelCount) {
+                throw std::logic_error(string_format("Surfel cluster holds %u surfels, GPU record fits 1 to %u",
+                                                     cluster.surfelCount, SurfelCluster::MaximumSurfelCount));
+            }
+
             uint32_t encoded = 0;
             encoded |= cluster.surfelOffset << 8;
             encoded |= cluster.surfelCount & 0xFF;
-            surfelClusterGBufferData.push_back(encoded);
+            data.encodedClusters.push_back(encoded);
+            data.clusterCenters.push_back(cluster.center);
         }
 
-        std::vector<glm::vec3> clusterCenters;
-        for (auto &cluster : mSurfelClusters) {
-            clusterCenters.push_back(cluster.center);
-        }
+        data.encodedClusters.resize(clusterGBufferSize.width * clusterGBufferSize.height, 0);
+
+        return data;
+    }
 
-        auto surfelGBufferSize = GLTexture::EstimatedSize(surfelGBufferData.back().size());
-        std::vector<const void *> surfelGbufferPointers{surfelGBufferData[0].data(), surfelGBufferData[1].data(), surfelGBufferData[2].data()};
+    void SurfelData::uploadBuffers(const glm::vec3 *surfelPositions, const glm::vec3 *surfelNormals, const glm::vec3 *surfelAlbedos,
+                                   const uint32_t *encodedClusters, const glm::vec3 *clusterCenters) {
+        auto surfelGBufferSize = GLTexture::EstimatedSize(mSurfels.size());
+        std::vector<const void *> surfelGbufferPointers{surfelPositions, surfelNormals, surfelAlbedos};
         mSurfelsGBuffer = std::make_shared<GLFloatTexture2DArray<GLTexture::Float::RGB32F>>(surfelGBufferSize, 3, surfelGbufferPointers, Sampling::Filter::None);
 
-        auto clusterGBufferSize = GLTexture::EstimatedSize(surfelClusterGBufferData.size());
-        mSurfelClustersGBuffer = std::make_shared<GLIntegerTexture2D<GLTexture::Integer::R32UI>>(clusterGBufferSize, surfelClusterGBufferData.data());
+        auto clusterGBufferSize = GLTexture::EstimatedSize(mSurfelClusters.size());
+        mSurfelClustersGBuffer = std::make_shared<GLIntegerTexture2D<GLTexture::Integer::R32UI>>(clusterGBufferSize, encodedClusters);
 
-        mSurfelClusterCentersBufferTexture = std::make_shared<GLFloatBufferTexture<GLTexture::Float::RGB32F, glm::vec3>>(clusterCenters.data(), clusterCenters.size());
+        mSurfelClusterCentersBufferTexture = std::make_shared<GLFloatBufferTexture<GLTexture::Float::RGB32F, glm::vec3>>(clusterCenters, mSurfelClusters.size());
     }
 
-    void SurfelData::serialize(const std::string &filePath) {
-        std::ofstream stream(filePath, std::ios::trunc | std::ios::binary);
-        if (!stream.is_open()) {
-            throw std::runtime_error(string_format("Unable to serialize surfels: %s", filePath.c_str()));
+    void SurfelData::deserialize(const BakeContainer &container, bool gpuUploadEnabled) {
+        auto surfels = container.section<Surfel>(SurfelsSectionTag);
+        auto clusters = container.section<SurfelCluster>(SurfelClustersSectionTag);
+        auto positions = container.section<glm::vec3>(SurfelPositionsSectionTag);
+        auto normals = container.section<glm::vec3>(SurfelNormalsSectionTag);
+        auto albedos = container.section<glm::vec3>(SurfelAlbedosSectionTag);
+        auto encodedClusters = container.section<uint32_t>(EncodedClustersSectionTag);
+        auto clusterCenters = container.section<glm::vec3>(ClusterCentersSectionTag);
+
+        Size2D surfelGBufferSize = GLTexture::EstimatedSize(surfels.size());
+        Size2D clusterGBufferSize = GLTexture::EstimatedSize(clusters.size());
+        size_t surfelTexelCount = surfelGBufferSize.width * surfelGBufferSize.height;
+        size_t clusterTexelCount = clusterGBufferSize.width * clusterGBufferSize.height;
+
+        if (positions.size() != surfelTexelCount || normals.size() != surfelTexelCount || albedos.size() != surfelTexelCount ||
+                encodedClusters.size() != clusterTexelCount || clusterCenters.size() != clusters.size()) {
+            throw std::runtime_error("Surfel bake container sections are inconsistent");
         }
 
-        bitsery::Serializer<bitsery::OutputBufferedStreamAdapter> serializer(stream);
-        serializer.container(mSurfels, mSurfels.size());
-        serializer.container(mSurfelClusters, mSurfelClusters.size());
-        bitsery::AdapterAccess::getWriter(serializer).flush();
+        if (!ClusterRangesValid(clusters, surfels.size())) {
+            throw std::runtime_error("Surfel bake container has clusters referencing surfels out of range");
+        }
+
+        mSurfels.assign(surfels.begin(), surfels.end());
+        mSurfelClusters.assign(clusters.begin(), clusters.end());
+
+        // Instance tracking is optional, bakes without it can only be regenerated from scratch
+        if (container.hasSection(SurfelInstanceIndicesSectionTag) && container.hasSection(InstanceRecordsSectionTag)) {
+            auto instanceIndices = container.section<uint32_t>(SurfelInstanceIndicesSectionTag);
+            auto instanceRecords = container.section<InstanceRecord>(InstanceRecordsSectionTag);
+
+            // Incremental rebake indexes surfels and records with these, a stale or damaged bake is regenerated instead
+            if (!InstanceIndicesValid(instanceIndices, instanceRecords, surfels.size())) {
+                throw std::runtime_error("Surfel bake container has inconsistent instance records");
+            }
+
+            mSurfelInstanceIndices.assign(instanceIndices.begin(), instanceIndices.end());
+            mInstanceRecords.assign(instanceRecords.begin(), instanceRecords.end());
+        }
+
+        if (gpuUploadEnabled) {
+            uploadBuffers(positions.data(), normals.data(), albedos.data(), encodedClusters.data(), clusterCenters.data());
+        }
     }
 
-    bool SurfelData::deserialize(const std::string &filePath) {
+    bool SurfelData::deserializeLegacy(const std::string &filePath, bool gpuUploadEnabled) {
         std::ifstream stream(filePath);
         if (!stream.is_open()) {
             return false;
@@ -77,11 +177,56 @@ namespace EARenderer {
 
         auto &reader = bitsery::AdapterAccess::getReader(deserializer);
 
-        if (reader.isCompletedSuccessfully()) {
+        if (!reader.isCompletedSuccessfully() || !ClusterRangesValid(mSurfelClusters, mSurfels.size())) {
+            return false;
+        }
+
+        if (gpuUploadEnabled) {
             initializeBuffers();
         }
 
-        return reader.isCompletedSuccessfully();
+        return true;
+    }
+
+#pragma mark - Data
+
+    void SurfelData::initializeBuffers() {
+        BufferData data = bufferData();
+        uploadBuffers(data.surfelPositions.data(), data.surfelNormals.data(), data.surfelAlbedos.data(),
+                data.encodedClusters.data(), data.clusterCenters.data());
+    }
+
+    void SurfelData::serialize(const std::string &filePath) {
+        BufferData data = bufferData();
+
+        BakeContainer::Writer writer(ContentTag);
+        writer.addSection(SurfelsSectionTag, mSurfels);
+        writer.addSection(SurfelClustersSectionTag, mSurfelClusters);
+        writer.addSection(SurfelPositionsSectionTag, data.surfelPositions);
+        writer.addSection(SurfelNormalsSectionTag, data.surfelNormals);
+        writer.addSection(SurfelAlbedosSectionTag, data.surfelAlbedos);
+        writer.addSection(EncodedClustersSectionTag, data.encodedClusters);
+        writer.addSection(ClusterCentersSectionTag, data.clusterCenters);
+
+        if (!mInstanceRecords.empty()) {
+            writer.addSection(SurfelInstanceIndicesSectionTag, mSurfelInstanceIndices);
+            writer.addSection(InstanceRecordsSectionTag, mInstanceRecords);
+        }
+        writer.write(filePath);
+    }
+
+    bool SurfelData::deserialize(const std::string &filePath, bool gpuUploadEnabled) {
+        if (!BakeContainer::HasSignature(filePath)) {
+            return deserializeLegacy(filePath, gpuUploadEnabled);
+        }
+
+        try {
+            BakeContainer container(filePath, ContentTag);
+            deserialize(container, gpuUploadEnabled);
+            return true;
+        } catch (const std::runtime_error &) {
+            return false;
+        }
     }
 
 #pragma mark - Getters
@@ -94,6 +239,14 @@ namespace EARenderer {
         return mSurfelClusters;
     }
 
+    const std::vector<uint32_t> &SurfelData::surfelInstanceIndices() const {
+        return mSurfelInstanceIndices;
+    }
+
+    const std::vector<SurfelData::InstanceRecord> &SurfelData::instanceRecords() const {
+        return mInstanceRecords;
+    }
+
     std::shared_ptr<GLFloatTexture2DArray<GLTexture::Float::RGB32F>> SurfelData::surfelsGBuffer() const {
         return mSurfelsGBuffer;
     }
@@ -14,36 +14,113 @@
 #include "GLTexture2D.hpp"
 #include "GLTexture2DArray.hpp"
 #include "GLBufferTexture.hpp"
+#include "BakeContainer.hpp"
+#include "PackedLookupTable.hpp"
+#include "AxisAlignedBox3D.hpp"
 
 #include <vector>
 #include <memory>
+#include <limits>
 
 namespace EARenderer {
 
     class SurfelGenerator;
 
+    /**
+     Describes how surfel clusters of a previous bake map onto clusters of an incrementally updated one.
+     Kept clusters preserve their relative order, clusters starting from firstAddedCluster are new.
+     */
+    struct SurfelClusterChangeSet {
+        static constexpr uint32_t RemovedCluster = std::numeric_limits<uint32_t>::max();
+
+        /// Index of every previous cluster in the updated cluster list, or RemovedCluster
+        std::vector<uint32_t> previousToCurrentClusterIndices;
+
+        uint32_t firstAddedCluster = 0;
+
+        /// Bounds of geometry that changed since the previous bake, both where it was and where it is now
+        std::vector<AxisAlignedBox3D> changedGeometryBounds;
+    };
+
     class SurfelData {
+    public:
+
+        /**
+         Surfel generation inputs of a single static mesh instance
+         */
+        struct InstanceRecord {
+            ID instanceID = 0;
+
+            /// CRC32 of instance's geometry, transformation, materials and surfel generation settings
+            uint32_t checksum = 0;
+
+            uint32_t surfelCount = 0;
+        };
+
     private:
         friend SurfelGenerator;
 
+        // Surfel and cluster data in the exact form it is uploaded to the GPU.
+        // Texture-backed arrays are padded with zeros to cover every texel.
+        struct BufferData {
+            std::vector<glm::vec3> surfelPositions;
+            std::vector<glm::vec3> surfelNormals;
+            std::vector<glm::vec3> surfelAlbedos;
+            std::vector<uint32_t> encodedClusters;
+            std::vector<glm::vec3> clusterCenters;
+        };
+
         std::vector<Surfel> mSurfels;
         std::vector<SurfelCluster> mSurfelClusters;
 
+        // Index of the owning instance record for every surfel, empty if the bake predates instance tracking
+        std::vector<uint32_t> mSurfelInstanceIndices;
+        std::vector<InstanceRecord> mInstanceRecords;
+
         std::shared_ptr<GLFloatTexture2DArray<GLTexture::Float::RGB32F>> mSurfelsGBuffer;
         std::shared_ptr<GLIntegerTexture2D<GLTexture::Integer::R32UI>> mSurfelClustersGBuffer;
         std::shared_ptr<GLFloatBufferTexture<GLTexture::Float::RGB32F, glm::vec3>> mSurfelClusterCentersBufferTexture;
 
+        BufferData bufferData() const;
+
+        void uploadBuffers(const glm::vec3 *surfelPositions, const glm::vec3 *surfelNormals, const glm::vec3 *surfelAlbedos,
+                           const uint32_t *encodedClusters, const glm::vec3 *clusterCenters);
+
+        void deserialize(const BakeContainer &container, bool gpuUploadEnabled);
+
+        bool deserializeLegacy(const std::string &filePath, bool gpuUploadEnabled);
+
     public:
+        /**
+         Uploads data to the GPU, requires current OpenGL context
+         */
         void initializeBuffers();
 
+        /**
+         Writes surfels and clusters into a bake container
+
+         @param filePath destination file
+         */
         void serialize(const std::string &filePath);
 
-        bool deserialize(const std::string &filePath);
+        /**
+         Loads surfels and clusters from a bake container and uploads them to the GPU
+         directly from the mapped file. Falls back to the older bitsery-encoded files.
+
+         @param filePath source file
+         @param gpuUploadEnabled false skips GPU upload, e.g. when there is no OpenGL context
+         @return false if the file is missing or damaged
+         */
+        bool deserialize(const std::string &filePath, bool gpuUploadEnabled = true);
 
         const std::vector<Surfel> &surfels() const;
 
         const std::vector<SurfelCluster> &surfelClusters() const;
 
+        const std::vector<uint32_t> &surfelInstanceIndices() const;
+
+        const std::vector<InstanceRecord> &instanceRecords() const;
+
         std::shared_ptr<GLFloatTexture2DArray<GLTexture::Float::RGB32F>> surfelsGBuffer() const;
 
         std::shared_ptr<GLIntegerTexture2D<GLTexture::Integer::R32UI>> surfelClustersGBuffer() const;
@@ -15,9 +15,11 @@
 #include "ThreadPool.hpp"
 #include "SparseOctree.hpp"
 #include "GaussianFunction.hpp"
+#include "CRC32.hpp"
 
 #include <random>
 #include <limits>
+#include <unordered_set>
 
 #include <glm/detail/func_exponential.hpp>
 
@@ -42,13 +44,36 @@ namespace EARenderer {
 
     SurfelGenerator::SurfelGenerator(const SharedResourceStorage *resourcePool, const Scene *scene)
             :
-            mEngine(std::random_device()()),
-            mDistribution(0.0f, 1.0f),
-            mResourcePool(resourcePool),
-            mScene(scene),
+            SurfelGenerator(resourcePool, scene, std::random_device()()) {
+    }
+
+    SurfelGenerator::SurfelGenerator(const SharedResourceStorage *resourcePool, const Scene *scene, uint32_t seed)
+            :
+            mSurfelSpacing(scene->surfelSpacing()),
+            mSeed(seed),
             mSurfelSpatialHash(AxisAlignedBox3D::Zero(), 1),
-            mSurfelFlatStorage(10000),
-            mSurfelSpacing(scene->surfelSpacing()) {
+            mResourcePool(resourcePool),
+            mScene(scene) {
+    }
+
+#pragma mark - Getters
+
+    uint32_t SurfelGenerator::seed() const {
+        return mSeed;
+    }
+
+    bool SurfelGenerator::isMultithreadingEnabled() const {
+        return mMultithreadingEnabled;
+    }
+
+    const SurfelClusterBuilder::Statistics &SurfelGenerator::clusteringStatistics() const {
+        return mClusteringStatistics;
+    }
+
+#pragma mark - Setters
+
+    void SurfelGenerator::setMultithreadingEnabled(bool enabled) {
+        mMultithreadingEnabled = enabled;
     }
 
 #pragma mark - Private helpers
@@ -66,13 +91,66 @@ namespace EARenderer {
         };
     }
 
+    uint32_t SurfelGenerator::instanceChecksum(ID instanceID, std::unordered_map<ID, uint32_t> &meshChecksums) const {
+        const auto &instance = mScene->meshInstances()[instanceID];
+        const auto &mesh = mResourcePool->mesh(instance.meshID());
+
+        auto meshChecksumIt = meshChecksums.find(instance.meshID());
+        if (meshChecksumIt == meshChecksums.end()) {
+            uint32_t meshChecksum = 0;
+            for (ID subMeshID : mesh.subMeshes()) {
+                auto &vertices = mesh.subMeshes()[subMeshID].vertices();
+                auto &indices = mesh.subMeshes()[subMeshID].indices();
+                meshChecksum = crc32(vertices.data(), vertices.size() * sizeof(Vertex1P1N2UV1T1BT), meshChecksum);
+                meshChecksum = crc32(indices.data(), indices.size() * sizeof(uint32_t), meshChecksum);
+            }
+            meshChecksumIt = meshChecksums.emplace(instance.meshID(), meshChecksum).first;
+        }
+
+        // Generation settings affect surfels of every instance
+        const AxisAlignedBox3D &bakingVolume = mScene->lightBakingVolume();
+        uint32_t checksum = crc32(&mSurfelSpacing, sizeof(mSurfelSpacing), meshChecksumIt->second);
+        checksum = crc32(&bakingVolume.min, sizeof(bakingVolume.min), checksum);
+        checksum = crc32(&bakingVolume.max, sizeof(bakingVolume.max), checksum);
+
+        glm::mat4 modelMatrix = instance.transformation().modelMatrix();
+        checksum = crc32(&modelMatrix, sizeof(modelMatrix), checksum);
+
+        for (ID subMeshID : mesh.subMeshes()) {
+            auto materialRef = instance.materialReference;
+            if (!materialRef) {
+                materialRef = instance.materialReferenceForSubMeshID(subMeshID);
+            }
+
+            if (!materialRef.has_value() || materialRef->first != MaterialType::CookTorrance) {
+                continue;
+            }
+
+            uint32_t albedoChecksum = mResourcePool->cookTorranceMaterial(materialRef->second).albedoChecksum();
+            checksum = crc32(&subMeshID, sizeof(subMeshID), checksum);
+            checksum = crc32(&albedoChecksum, sizeof(albedoChecksum), checksum);
+        }
+
+        return checksum;
+    }
+
+    std::unordered_map<ID, uint32_t> SurfelGenerator::staticInstanceChecksums() const {
+        std::unordered_map<ID, uint32_t> meshChecksums;
+        std::unordered_map<ID, uint32_t> checksums;
+        for (ID meshInstanceID : mScene->staticMeshInstanceIDs()) {
+            checksums[meshInstanceID] = instanceChecksum(meshInstanceID, meshChecksums);
+        }
+        return checksums;
+    }
+
     float SurfelGenerator::optimalMinimumSubdivisionArea() const {
         return M_PI * mSurfelSpacing * mSurfelSpacing / 4.0;
     }
 
-    glm::vec3 SurfelGenerator::randomBarycentricCoordinates() {
-        float r = mDistribution(mEngine);
-        float s = mDistribution(mEngine);
+    glm::vec3 SurfelGenerator::randomBarycentricCoordinates(std::mt19937 &engine) const {
+        std::uniform_real_distribution<float> distribution(0.0f, 1.0f);
+        float r = distribution(engine);
+        float s = distribution(engine);
 
         if (r + s >= 1.0f) {
             r = 1.0f - r;
@@ -91,7 +169,8 @@ namespace EARenderer {
         return std::max(spaceDivisionResolution, (uint32_t) 1);
     }
 
-    LogarithmicBin<SurfelGenerator::TransformedTriangleData> SurfelGenerator::constructSubMeshVertexDataBin(const SubMesh &subMesh, const MeshInstance &containingInstance) {
+    LogarithmicBin<SurfelGenerator::TransformedTriangleData> SurfelGenerator::constructSubMeshVertexDataBin(const SubMesh &subMesh, const MeshInstance &containingInstance,
+            uint32_t seed, const std::vector<glm::vec3> *vacatedPositions) const {
         glm::mat4 modelMatrix = containingInstance.transformation().modelMatrix();
         glm::mat4 normalMatrix = containingInstance.transformation().normalMatrix();
 
@@ -102,10 +181,13 @@ namespace EARenderer {
 
         // Calculate triangle areas, transform positions and normals using
         // mesh instance's model transformation
-        for (size_t i = 0; i < subMesh.vertices().size(); i += 3) {
-            auto &vertex0 = subMesh.vertices()[i];
-            auto &vertex1 = subMesh.vertices()[i + 1];
-            auto &vertex2 = subMesh.vertices()[i + 2];
+        auto &vertices = subMesh.vertices();
+        auto &indices = subMesh.indices();
+
+        for (size_t i = 0; i < indices.size(); i += 3) {
+            auto &vertex0 = vertices[indices[i]];
+            auto &vertex1 = vertices[indices[i + 1]];
+            auto &vertex2 = vertices[indices[i + 2]];
 
             // Transform positions
             Triangle3D triangle(modelMatrix * vertex0.position,
@@ -119,6 +201,10 @@ namespace EARenderer {
                 continue;
             }
 
+            if (vacatedPositions && !triangleNearAnyPosition(triangle, *vacatedPositions)) {
+                continue;
+            }
+
             // Transform normals
             Triangle3D normals(normalMatrix * glm::vec4(vertex0.normal, 0.0),
                     normalMatrix * glm::vec4(vertex1.normal, 0.0),
@@ -143,7 +229,7 @@ namespace EARenderer {
         // Also truncate maximum area if it's smaller than optimal one.
         maximumArea = std::max(maximumArea, optimalArea);
 
-        LogarithmicBin<TransformedTriangleData> bin(minimumArea, maximumArea);
+        LogarithmicBin<TransformedTriangleData> bin(minimumArea, maximumArea, seed);
 
         for (auto &transformedTriangle : transformedTriangleProperties) {
             bin.insert(transformedTriangle, minimumAreaTruncated ? minimumArea : transformedTriangle.positions.area());
@@ -152,9 +238,27 @@ namespace EARenderer {
         return bin;
     }
 
-    bool SurfelGenerator::triangleCompletelyCovered(Triangle3D &triangle) {
+    bool SurfelGenerator::triangleNearAnyPosition(const Triangle3D &triangle, const std::vector<glm::vec3> &positions) const {
+        AxisAlignedBox3D bounds = triangle.boundingBox();
+        float spacing2 = mSurfelSpacing * mSurfelSpacing;
+
+        auto it = std::lower_bound(positions.begin(), positions.end(), bounds.min.x - mSurfelSpacing, [](const glm::vec3 &position, float x) {
+            return position.x < x;
+        });
+
+        for (; it != positions.end() && it->x <= bounds.max.x + mSurfelSpacing; ++it) {
+            glm::vec3 closestPoint = glm::clamp(*it, bounds.min, bounds.max);
+            if (glm::length2(*it - closestPoint) <= spacing2) {
+                return true;
+            }
+        }
+
+        return false;
+    }
+
+    bool SurfelGenerator::triangleCompletelyCovered(Triangle3D &triangle, const CompactSpatialHash<Surfel> &surfels) const {
         bool triangleCoveredCompletely = false;
-        for (auto &surfel : mSurfelSpatialHash.neighbours(triangle.p2)) {
+        for (auto &surfel : surfels.neighbours(triangle.p2)) {
             Sphere enclosingSphere(surfel.position, mSurfelSpacing);
             if (enclosingSphere.contains(triangle)) {
                 triangleCoveredCompletely = true;
@@ -164,16 +268,16 @@ namespace EARenderer {
         return triangleCoveredCompletely;
     }
 
-    bool SurfelGenerator::surfelCandidateMeetsMinimumDistanceRequirement(SurfelCandidate &candidate) {
+    bool SurfelGenerator::meetsMinimumDistanceRequirement(const glm::vec3 &position, const glm::vec3 &normal, const CompactSpatialHash<Surfel> &surfels) const {
         bool minimumDistanceRequirementMet = true;
-        for (auto &surfel : mSurfelSpatialHash.neighbours(candidate.position)) {
+        for (auto &surfel : surfels.neighbours(position)) {
             // Ignore surfel/candidate looking in the opposite directions to avoid tests
             // with surfels located on another side of a thin mesh (a wall for example)
-            if (glm::dot(surfel.normal, candidate.normal) < 0.0) {
+            if (glm::dot(surfel.normal, normal) < 0.0) {
                 continue;
             }
 
-            float length2 = glm::length2(surfel.position - candidate.position);
+            float length2 = glm::length2(surfel.position - position);
             float minimumDistance2 = mSurfelSpacing * mSurfelSpacing;
 
             if (length2 < minimumDistance2) {
@@ -184,8 +288,8 @@ namespace EARenderer {
         return minimumDistanceRequirementMet;
     }
 
-    SurfelGenerator::SurfelCandidate SurfelGenerator::generateSurfelCandidate(const SubMesh &subMesh, LogarithmicBin<TransformedTriangleData> &transformedVerticesBin) {
-        auto &&it = transformedVerticesBin.random();
+    SurfelGenerator::SurfelCandidate SurfelGenerator::generateSurfelCandidate(LogarithmicBin<TransformedTriangleData> &transformedVerticesBin, std::mt19937 &engine) const {
+        auto &&it = transformedVerticesBin.random(engine);
         auto &randomTriangleData = *it;
 
         auto ab = randomTriangleData.positions.b - randomTriangleData.positions.a;
@@ -194,17 +298,14 @@ namespace EARenderer {
         auto Nab = randomTriangleData.normals.b - randomTriangleData.normals.a;
         auto Nac = randomTriangleData.normals.c - randomTriangleData.normals.a;
 
-        glm::vec3 barycentric = randomBarycentricCoordinates();
+        glm::vec3 barycentric = randomBarycentricCoordinates(engine);
         glm::vec3 position = randomTriangleData.positions.a + ((ab * barycentric.x) + (ac * barycentric.y));
         glm::vec3 normal = glm::normalize(randomTriangleData.normals.a + ((Nab * barycentric.x) + (Nac * barycentric.y)));
 
         return {position, normal, barycentric, it};
     }
 
-    template<class TextureFormat, TextureFormat Format>
-    Surfel SurfelGenerator::generateSurfel(SurfelCandidate &surfelCandidate,
-            LogarithmicBin<TransformedTriangleData> &transformedVerticesBin,
-            const GLTexture2DSampler<TextureFormat, Format> &albedoMapSampler) {
+    Surfel SurfelGenerator::generateSurfel(SurfelCandidate &surfelCandidate, const AlbedoSampler &albedoSampler) const {
         TransformedTriangleData &triangleData = *surfelCandidate.logarithmicBinIterator;
 
         glm::vec2 p1p2 = triangleData.UVs.p2 - triangleData.UVs.p1;
@@ -216,15 +317,15 @@ namespace EARenderer {
 
         uv = GLTexture::WrapCoordinates(uv);
 
-        auto texel = albedoMapSampler.sample(uv);
-        Color albedoLinear = Color(texel.r, texel.g, texel.b).convertedTo(Color::Space::Linear);
+        Color albedoLinear = albedoSampler.sample(uv).convertedTo(Color::Space::Linear);
 
         float singleSurfelArea = M_PI * mSurfelSpacing * mSurfelSpacing;
 
         return Surfel(surfelCandidate.position, surfelCandidate.normal, albedoLinear, singleSurfelArea);
     }
 
-    void SurfelGenerator::generateSurflesOnMeshInstance(const MeshInstance &instance) {
+    void SurfelGenerator::prepareWorkItems(ID instanceID, std::vector<SurfelGenerationWorkItem> &workItems) const {
+        const auto &instance = mScene->meshInstances()[instanceID];
         const auto &mesh = mResourcePool->mesh(instance.meshID());
 
         for (ID subMeshID : mesh.subMeshes()) {
@@ -240,160 +341,381 @@ namespace EARenderer {
                 continue;
             }
 
-            auto &material = mResourcePool->cookTorranceMaterial(materialRef->second);
+            // Derive work item's random stream from generator's seed and work item's identity,
+            // so that it doesn't depend on the order in which work items are processed
+            std::seed_seq seedSequence{mSeed, (uint32_t) instanceID, (uint32_t) subMeshID};
+            uint32_t workItemSeed = 0;
+            seedSequence.generate(&workItemSeed, &workItemSeed + 1);
+
+            SurfelGenerationWorkItem workItem;
+            workItem.instanceID = instanceID;
+            workItem.instance = &instance;
+            workItem.subMesh = &subMesh;
+            workItem.materialID = materialRef->second;
+            workItem.seed = workItemSeed;
+            workItems.emplace_back(std::move(workItem));
+        }
+    }
+
+    void SurfelGenerator::distributeSurfels(LogarithmicBin<TransformedTriangleData> &bin, std::mt19937 &engine,
+            CompactSpatialHash<Surfel> &spatialHash, const AlbedoSampler &albedoSampler, std::vector<Surfel> &surfels) const {
+        const auto &bakingVolume = mScene->lightBakingVolume();
+
+        // Actual algorithm that uniformly distributes surfels on geometry
+        while (!bin.empty()) {
+            // Algorithm selects an active triangle F with probability proportional to its area.
+            // It then chooses a random point p on the triangle and makes it a surfel candidate.
+            SurfelCandidate surfelCandidate = generateSurfelCandidate(bin, engine);
+
+            // Get rid of triangles that lie outside of scene's baking volume
+            if (!bakingVolume.contains(surfelCandidate.position)) {
+                bin.erase(surfelCandidate.logarithmicBinIterator);
+                continue;
+            }
+
+            // Checks to see if surfel candidate meets the minimum distance requirement with respect to the current surfel set
 
-            auto bin = constructSubMeshVertexDataBin(subMesh, instance);
+            // If the minimum distance requirement is met, the algorithm computes all missing information
+            // for the surfel candidate and then adds the resultant surfel to the surfel set
+            if (meetsMinimumDistanceRequirement(surfelCandidate.position, surfelCandidate.normal, spatialHash)) {
+                auto surfel = generateSurfel(surfelCandidate, albedoSampler);
+                spatialHash.insert(surfel, surfelCandidate.position);
+                surfels.push_back(surfel);
+            }
 
-            // Sample higher mip level to get rid of high frequency color information
-            // It will be better to use low-frequency, blurred albedo texture since this algorithm is all about diffuse GI
-            int32_t mipLevel = material.albedoMap()->mipMapCount() * 0.6;
-            GLTexture2DSampler sampler = material.albedoMap()->sampleTexels(mipLevel);
+            // In any case, the algorithm then checks to see whether triangle is completely covered by any surfel from the surfel set
+            auto &surfelPositionTriangle = surfelCandidate.logarithmicBinIterator->positions;
+            float triangleArea = surfelPositionTriangle.area();
+            float subTriangleArea = triangleArea / 4.0f;
 
-            // Actual algorithm that uniformly distributes surfels on geometry
-            while (!bin.empty()) {
-                // Algorithm selects an active triangle F with probability proportional to its area.
-                // It then chooses a random point p on the triangle and makes it a surfel candidate.
-                SurfelCandidate surfelCandidate = generateSurfelCandidate(subMesh, bin);
+            if (triangleCompletelyCovered(surfelPositionTriangle, spatialHash)) {
+                // If triangle is covered, it is discarded
+                bin.erase(surfelCandidate.logarithmicBinIterator);
+            } else {
+                // Otherwise, we split it into a number of child triangles and
+                // add the uncovered triangles back to the list of active triangles
 
-                // Get rid of triangles that lie outside of scene's baking volume
-                if (!mScene->lightBakingVolume().contains(surfelCandidate.position)) {
+                // Discard triangles that are too small
+                if (subTriangleArea < bin.minWeight()) {
                     bin.erase(surfelCandidate.logarithmicBinIterator);
                     continue;
                 }
 
-                // Checks to see if surfel candidate meets the minimum distance requirement with respect to the current surfel set
+                // Access first, only then erase!!
+                auto subTriangles = surfelCandidate.logarithmicBinIterator->split();
+                bin.erase(surfelCandidate.logarithmicBinIterator);
 
-                // If the minimum distance requirement is met, the algorithm computes all missing information
-                // for the surfel candidate and then adds the resultant surfel to the surfel set
-                if (surfelCandidateMeetsMinimumDistanceRequirement(surfelCandidate)) {
-                    auto surfel = generateSurfel(surfelCandidate, bin, sampler);
-                    mSurfelSpatialHash.insert(surfel, surfelCandidate.position);
-                    mSurfelFlatStorage.insert(surfel);
+                for (auto &subTriangle : subTriangles) {
+                    // Uncovered triangle goes back to the bin
+                    if (!triangleCompletelyCovered(subTriangle.positions, spatialHash)) {
+                        bin.insert(subTriangle, subTriangleArea);
+                    }
                 }
+            }
+        }
+    }
 
-                // In any case, the algorithm then checks to see whether triangle is completely covered by any surfel from the surfel set
-                auto &surfelPositionTriangle = surfelCandidate.logarithmicBinIterator->positions;
-                float triangleArea = surfelPositionTriangle.area();
-                float subTriangleArea = triangleArea / 4.0f;
+    void SurfelGenerator::generateSurfelsForWorkItem(SurfelGenerationWorkItem &workItem) const {
+        const auto &bakingVolume = mScene->lightBakingVolume();
 
-                if (triangleCompletelyCovered(surfelPositionTriangle)) {
-                    // If triangle is covered, it is discarded
-                    bin.erase(surfelCandidate.logarithmicBinIterator);
+        std::mt19937 engine(workItem.seed);
+        CompactSpatialHash<Surfel> spatialHash(bakingVolume, spaceDivisionResolution(1.5, bakingVolume));
+
+        auto bin = constructSubMeshVertexDataBin(*workItem.subMesh, *workItem.instance, engine());
+        distributeSurfels(bin, engine, spatialHash, *workItem.albedoSampler, workItem.surfels);
+    }
+
+    void SurfelGenerator::mergeWorkItems(std::vector<SurfelGenerationWorkItem> &workItems) {
+        // Surfels within a single work item already satisfy minimum distance requirement.
+        // Only surfels lying close to the borders of adjacent sub meshes can conflict,
+        // and since work items are merged in a fixed order, the outcome is deterministic.
+        for (auto &workItem : workItems) {
+            for (auto &surfel : workItem.surfels) {
+                if (meetsMinimumDistanceRequirement(surfel.position, surfel.normal, mSurfelSpatialHash)) {
+                    mSurfelSpatialHash.insert(surfel, surfel.position);
+                    mSurfelFlatStorage.push_back(surfel);
+                    mSurfelFlatStorageOwners.push_back(workItem.instanceID);
                 } else {
-                    // Otherwise, we split it into a number of child triangles and
-                    // add the uncovered triangles back to the list of active triangles
+                    workItem.vacatedPositions.push_back(surfel.position);
+                }
+            }
+            workItem.surfels.clear();
+            workItem.surfels.shrink_to_fit();
 
-                    // Discard triangles that are too small
-                    if (subTriangleArea < bin.minWeight()) {
-                        bin.erase(surfelCandidate.logarithmicBinIterator);
-                        continue;
-                    }
+            std::sort(workItem.vacatedPositions.begin(), workItem.vacatedPositions.end(), [](const glm::vec3 &lhs, const glm::vec3 &rhs) {
+                return lhs.x < rhs.x;
+            });
+        }
+    }
 
-                    // Access first, only then erase!!
-                    auto subTriangles = surfelCandidate.logarithmicBinIterator->split();
-                    bin.erase(surfelCandidate.logarithmicBinIterator);
+    void SurfelGenerator::refillVacatedAreas(std::vector<SurfelGenerationWorkItem> &workItems) {
+        std::vector<Surfel> surfels;
 
-                    for (auto &subTriangle : subTriangles) {
-                        // Uncovered triangle goes back to the bin
-                        if (!triangleCompletelyCovered(subTriangle.positions)) {
-                            bin.insert(subTriangle, subTriangleArea);
-                        }
-                    }
-                }
+        for (auto &workItem : workItems) {
+            if (!workItem.vacatedPositions.empty()) {
+                // A stream of its own keeps refill independent of how many numbers the first pass consumed
+                std::seed_seq seedSequence{workItem.seed, 1u};
+                uint32_t refillSeed = 0;
+                seedSequence.generate(&refillSeed, &refillSeed + 1);
+                std::mt19937 engine(refillSeed);
+
+                auto bin = constructSubMeshVertexDataBin(*workItem.subMesh, *workItem.instance, engine(), &workItem.vacatedPositions);
+
+                surfels.clear();
+                distributeSurfels(bin, engine, mSurfelSpatialHash, *workItem.albedoSampler, surfels);
+
+                mSurfelFlatStorage.insert(mSurfelFlatStorage.end(), surfels.begin(), surfels.end());
+                mSurfelFlatStorageOwners.insert(mSurfelFlatStorageOwners.end(), surfels.size(), workItem.instanceID);
+
+                workItem.vacatedPositions.clear();
+                workItem.vacatedPositions.shrink_to_fit();
             }
         }
     }
 
-    bool SurfelGenerator::surfelsAlike(const Surfel &first, const Surfel &second, float workingVolumeMaximumExtent2) {
-        float normDistance2 = glm::length2(first.position - second.position) / workingVolumeMaximumExtent2;
-        float normalDeviation = glm::dot(first.normal, second.normal);
+    std::unordered_map<ID, std::unique_ptr<AlbedoSampler>> SurfelGenerator::createAlbedoSamplers(std::vector<SurfelGenerationWorkItem> &workItems) const {
+        std::vector<ID> materialIDs;
+        std::unordered_set<ID> uniqueMaterialIDs;
 
-        const float Cn = -0.3;
-        const float Cb = 0.04;
+        for (auto &workItem : workItems) {
+            if (uniqueMaterialIDs.insert(workItem.materialID).second) {
+                materialIDs.push_back(workItem.materialID);
+            }
+        }
 
-        auto offsetStart = first.position + first.normal * workingVolumeMaximumExtent2 * 0.001f;
-        auto offsetEnd = second.position + second.normal * workingVolumeMaximumExtent2 * 0.001f;
+        std::vector<std::unique_ptr<AlbedoSampler>> samplers(materialIDs.size());
 
-        if (mScene->rayTracer()->lineSegmentOccluded(offsetStart, offsetEnd)) {
-            return false;
+        auto createSamplers = [&](size_t begin, size_t end) {
+            for (size_t i = begin; i < end; i++) {
+                auto &material = mResourcePool->cookTorranceMaterial(materialIDs[i]);
+                samplers[i] = std::make_unique<AlbedoSampler>(material.albedoSource(), AlbedoMipLevelFraction);
+            }
+        };
+
+        if (mMultithreadingEnabled) {
+            ThreadPool::Default().parallelFor(0, materialIDs.size(), 1, createSamplers);
+        } else {
+            createSamplers(0, materialIDs.size());
+        }
+
+        std::unordered_map<ID, std::unique_ptr<AlbedoSampler>> samplerMap;
+        for (size_t i = 0; i < materialIDs.size(); i++) {
+            samplerMap[materialIDs[i]] = std::move(samplers[i]);
         }
 
-        return normDistance2 <= Cb && normalDeviation > Cn;
+        for (auto &workItem : workItems) {
+            workItem.albedoSampler = samplerMap.at(workItem.materialID).get();
+        }
+
+        return samplerMap;
     }
 
-    void SurfelGenerator::formClusters() {
-        std::vector<ID> idsToDelete;
-        float extent2 = mScene->lightBakingVolume().largestDimensionLength() * mScene->lightBakingVolume().largestDimensionLength();
-
-        while (mSurfelFlatStorage.size()) {
-            // Allocate cluster with count of 1 since we're immediately inserting 1 surfel
-            SurfelCluster cluster(mSurfelDataContainer->mSurfels.size(), 1);
-
-            // Push random surfel to a cluster
-            ID firstSurfelID = *mSurfelFlatStorage.begin();
-            Surfel &firstSurfel = mSurfelFlatStorage[firstSurfelID];
-            mSurfelDataContainer->mSurfels.push_back(firstSurfel);
-            cluster.center = firstSurfel.position;
-            mSurfelFlatStorage.erase(firstSurfelID);
-
-            // Iterate over all left surfels
-            for (auto it = mSurfelFlatStorage.begin(); it != mSurfelFlatStorage.end(); ++it) {
-                auto &nextSurfel = mSurfelFlatStorage[*it];
-
-                bool alikeToAllSurfelsInCluster = true;
-
-                // Determine if the surfel is similar to all the surfels in the current cluster
-                for (size_t i = cluster.surfelOffset; i < cluster.surfelOffset + cluster.surfelCount; i++) {
-                    auto &surfel = mSurfelDataContainer->mSurfels[i];
-                    if (!surfelsAlike(surfel, nextSurfel, extent2)) {
-                        alikeToAllSurfelsInCluster = false;
-                        break;
-                    }
-                }
+    void SurfelGenerator::prepareSurfelStorage() {
+        mSurfelDataContainer = std::make_unique<SurfelData>();
+        mSurfelSpatialHash = CompactSpatialHash<Surfel>(mScene->lightBakingVolume(), spaceDivisionResolution(1.5, mScene->lightBakingVolume()));
+        mSurfelFlatStorage.clear();
+        mSurfelFlatStorageOwners.clear();
+        mClusteredSurfelOwners.clear();
+    }
 
-                // If surfel meets similarity criteria
-                // we push it to the cluster and remove from surfel list
-                if (alikeToAllSurfelsInCluster) {
-                    mSurfelDataContainer->mSurfels.push_back(nextSurfel);
-                    idsToDelete.push_back(*it);
-                    cluster.surfelCount++;
+    void SurfelGenerator::generateSurfels(const std::vector<ID> &instanceIDs) {
+        std::vector<SurfelGenerationWorkItem> workItems;
+        for (ID meshInstanceID : instanceIDs) {
+            prepareWorkItems(meshInstanceID, workItems);
+        }
 
-                    // Limit the amount of surfels int cluster
-                    if (cluster.surfelCount == mMaximumSurfelClusterSize) {
-                        continue;
-                    }
+        auto albedoSamplers = createAlbedoSamplers(workItems);
+
+        if (mMultithreadingEnabled) {
+            ThreadPool::Default().parallelFor(0, workItems.size(), 1, [&](size_t begin, size_t end) {
+                for (size_t i = begin; i < end; i++) {
+                    generateSurfelsForWorkItem(workItems[i]);
                 }
+            });
+        } else {
+            for (auto &workItem : workItems) {
+                generateSurfelsForWorkItem(workItem);
             }
+        }
 
-            // Remove all clustered surfels from surfel list
-            for (ID id : idsToDelete) {
-                mSurfelFlatStorage.erase(id);
-            }
+        mergeWorkItems(workItems);
+        refillVacatedAreas(workItems);
+    }
 
-            idsToDelete.clear();
+    void SurfelGenerator::formClusters() {
+        SurfelClusterBuilder clusterBuilder(mScene, mMaximumSurfelClusterSize);
+        clusterBuilder.setMultithreadingEnabled(mMultithreadingEnabled);
 
-            // Push cluster to cluster list
-            mSurfelDataContainer->mSurfelClusters.push_back(cluster);
+        std::vector<uint32_t> sourceSurfelIndices;
+        clusterBuilder.buildClusters(mSurfelFlatStorage, mSurfelDataContainer->mSurfels, mSurfelDataContainer->mSurfelClusters, &sourceSurfelIndices);
+        mClusteringStatistics = clusterBuilder.statistics();
 
-            // Then repear until all surfels are asigned to clusters
+        for (uint32_t surfelIndex : sourceSurfelIndices) {
+            mClusteredSurfelOwners.push_back(mSurfelFlatStorageOwners[surfelIndex]);
         }
+
+        mSurfelFlatStorage.clear();
+        mSurfelFlatStorage.shrink_to_fit();
+        mSurfelFlatStorageOwners.clear();
+        mSurfelFlatStorageOwners.shrink_to_fit();
+    }
+
+    void SurfelGenerator::recordInstances(const std::unordered_map<ID, uint32_t> &checksums) {
+        auto &records = mSurfelDataContainer->mInstanceRecords;
+        std::unordered_map<ID, uint32_t> recordIndices;
+
+        for (ID meshInstanceID : mScene->staticMeshInstanceIDs()) {
+            recordIndices[meshInstanceID] = (uint32_t) records.size();
+            records.push_back({meshInstanceID, checksums.at(meshInstanceID), 0});
+        }
+
+        auto &instanceIndices = mSurfelDataContainer->mSurfelInstanceIndices;
+        instanceIndices.reserve(mClusteredSurfelOwners.size());
+
+        for (ID owner : mClusteredSurfelOwners) {
+            uint32_t recordIndex = recordIndices.at(owner);
+            records[recordIndex].surfelCount++;
+            instanceIndices.push_back(recordIndex);
+        }
+
+        mClusteredSurfelOwners.clear();
+        mClusteredSurfelOwners.shrink_to_fit();
     }
 
 #pragma mark - Public interface
 
     std::unique_ptr<SurfelData> SurfelGenerator::generateStaticGeometrySurfels() {
-        mSurfelDataContainer = std::make_unique<SurfelData>();
-        mSurfelSpatialHash = SpatialHash<Surfel>(mScene->lightBakingVolume(), spaceDivisionResolution(1.5, mScene->lightBakingVolume()));
-        mSurfelFlatStorage = PackedLookupTable<Surfel>(10000);
+        prepareSurfelStorage();
+
+        auto checksums = staticInstanceChecksums();
+        std::vector<ID> instanceIDs(mScene->staticMeshInstanceIDs().begin(), mScene->staticMeshInstanceIDs().end());
+
+        generateSurfels(instanceIDs);
+        formClusters();
+        recordInstances(checksums);
+
+        return std::move(mSurfelDataContainer);
+    }
+
+    bool SurfelGenerator::isUpToDate(const SurfelData &previousData) const {
+        auto checksums = staticInstanceChecksums();
+
+        if (checksums.size() != previousData.instanceRecords().size()) {
+            return false;
+        }
 
+        for (auto &record : previousData.instanceRecords()) {
+            auto it = checksums.find(record.instanceID);
+            if (it == checksums.end() || it->second != record.checksum) {
+                return false;
+            }
+        }
+
+        return true;
+    }
+
+    std::unique_ptr<SurfelData> SurfelGenerator::updateStaticGeometrySurfels(const SurfelData &previousData, SurfelClusterChangeSet &clusterChanges) {
+        const auto &previousSurfels = previousData.surfels();
+        const auto &previousClusters = previousData.surfelClusters();
+        const auto &previousInstanceIndices = previousData.surfelInstanceIndices();
+        const auto &previousRecords = previousData.instanceRecords();
+
+        clusterChanges = SurfelClusterChangeSet();
+        clusterChanges.previousToCurrentClusterIndices.assign(previousClusters.size(), SurfelClusterChangeSet::RemovedCluster);
+
+        // Without instance records there is no way to tell which surfels are still valid
+        if (previousRecords.empty() && !previousSurfels.empty()) {
+            return generateStaticGeometrySurfels();
+        }
+
+        auto checksums = staticInstanceChecksums();
+
+        std::vector<bool> recordReusable(previousRecords.size(), false);
+        std::unordered_set<ID> reusedInstanceIDs;
+
+        for (size_t i = 0; i < previousRecords.size(); i++) {
+            auto it = checksums.find(previousRecords[i].instanceID);
+            if (it != checksums.end() && it->second == previousRecords[i].checksum) {
+                recordReusable[i] = true;
+                reusedInstanceIDs.insert(previousRecords[i].instanceID);
+            }
+        }
+
+        // Surfels of stale instances outline where their geometry used to be
+        std::vector<AxisAlignedBox3D> previousBounds(previousRecords.size(), AxisAlignedBox3D::MaximumReversed());
+        for (size_t i = 0; i < previousSurfels.size(); i++) {
+            uint32_t recordIndex = previousInstanceIndices[i];
+            if (!recordReusable[recordIndex]) {
+                previousBounds[recordIndex].min = glm::min(previousBounds[recordIndex].min, previousSurfels[i].position);
+                previousBounds[recordIndex].max = glm::max(previousBounds[recordIndex].max, previousSurfels[i].position);
+            }
+        }
+
+        for (size_t i = 0; i < previousRecords.size(); i++) {
+            if (!recordReusable[i] && previousRecords[i].surfelCount > 0) {
+                clusterChanges.changedGeometryBounds.push_back(previousBounds[i]);
+            }
+        }
+
+        prepareSurfelStorage();
+
+        auto &surfels = mSurfelDataContainer->mSurfels;
+        auto &clusters = mSurfelDataContainer->mSurfelClusters;
+
+        // Clusters made exclusively of reusable surfels are kept along with their surfels.
+        // Reusable surfels of other clusters go to the flat storage to be clustered again.
+        // All reusable surfels participate in minimum distance tests of newly generated ones.
+        for (size_t clusterIndex = 0; clusterIndex < previousClusters.size(); clusterIndex++) {
+            const SurfelCluster &cluster = previousClusters[clusterIndex];
+            size_t begin = cluster.surfelOffset;
+            size_t end = cluster.surfelOffset + cluster.surfelCount;
+
+            bool keepCluster = true;
+            for (size_t i = begin; i < end; i++) {
+                keepCluster &= recordReusable[previousInstanceIndices[i]];
+            }
+
+            if (keepCluster) {
+                clusterChanges.previousToCurrentClusterIndices[clusterIndex] = (uint32_t) clusters.size();
+                SurfelCluster keptCluster = cluster;
+                keptCluster.surfelOffset = (uint32_t) surfels.size();
+                clusters.push_back(keptCluster);
+            }
+
+            for (size_t i = begin; i < end; i++) {
+                uint32_t recordIndex = previousInstanceIndices[i];
+                if (!recordReusable[recordIndex]) {
+                    continue;
+                }
+
+                const Surfel &surfel = previousSurfels[i];
+                mSurfelSpatialHash.insert(surfel, surfel.position);
+
+                if (keepCluster) {
+                    surfels.push_back(surfel);
+                    mClusteredSurfelOwners.push_back(previousRecords[recordIndex].instanceID);
+                } else {
+                    mSurfelFlatStorage.push_back(surfel);
+                    mSurfelFlatStorageOwners.push_back(previousRecords[recordIndex].instanceID);
+                }
+            }
+        }
+
+        clusterChanges.firstAddedCluster = (uint32_t) clusters.size();
+
+        std::vector<ID> staleInstanceIDs;
         for (ID meshInstanceID : mScene->staticMeshInstanceIDs()) {
-            const auto &meshInstance = mScene->meshInstances()[meshInstanceID];
-            generateSurflesOnMeshInstance(meshInstance);
+            if (reusedInstanceIDs.find(meshInstanceID) == reusedInstanceIDs.end()) {
+                staleInstanceIDs.push_back(meshInstanceID);
+
+                const auto &instance = mScene->meshInstances()[meshInstanceID];
+                clusterChanges.changedGeometryBounds.push_back(instance.boundingBox(mResourcePool->mesh(instance.meshID())));
+            }
         }
 
+        generateSurfels(staleInstanceIDs);
         formClusters();
-
-        mSurfelDataContainer->initializeBuffers();
+        recordInstances(checksums);
 
         return std::move(mSurfelDataContainer);
     }
@@ -15,13 +15,16 @@
 #include "LogarithmicBin.hpp"
 #include "Triangle2D.hpp"
 #include "Triangle3D.hpp"
-#include "SpatialHash.hpp"
+#include "CompactSpatialHash.hpp"
 #include "SparseOctree.hpp"
 #include "SurfelData.hpp"
+#include "SurfelClusterBuilder.hpp"
+#include "AlbedoSampler.hpp"
 
 #include <vector>
 #include <unordered_map>
 #include <random>
+#include <memory>
 #include <glm/vec3.hpp>
 
 namespace EARenderer {
@@ -56,21 +59,61 @@ namespace EARenderer {
             SurfelCandidate(const glm::vec3 &position, const glm::vec3 &normal, const glm::vec3 &barycentric, BinIterator iterator);
         };
 
+        /**
+         An independent unit of surfel generation work: a single sub mesh of a single static mesh instance.
+         Every work item owns its RNG stream and spatial hash, so it can be processed on any thread
+         and still produce the same surfels for a given seed.
+         */
+        struct SurfelGenerationWorkItem {
+            ID instanceID = 0;
+            const MeshInstance *instance = nullptr;
+            const SubMesh *subMesh = nullptr;
+            ID materialID = 0;
+            const AlbedoSampler *albedoSampler = nullptr;
+            uint32_t seed = 0;
+            std::vector<Surfel> surfels;
+
+            // Positions of surfels discarded during merge, sorted along X axis
+            std::vector<glm::vec3> vacatedPositions;
+        };
+
 #pragma mark - Member variables
 
-        float mSurfelSpacing;
-        size_t mMaximumSurfelClusterSize = 256;
+        // Sample higher mip level to get rid of high frequency color information
+        // It will be better to use low-frequency, blurred albedo texture since this algorithm is all about diffuse GI
+        static constexpr float AlbedoMipLevelFraction = 0.6;
 
-        std::mt19937 mEngine;
-        std::uniform_real_distribution<float> mDistribution;
-        PackedLookupTable<Surfel> mSurfelFlatStorage;
-        SpatialHash<Surfel> mSurfelSpatialHash;
+        float mSurfelSpacing;
+        size_t mMaximumSurfelClusterSize = SurfelCluster::MaximumSurfelCount;
+        uint32_t mSeed;
+        bool mMultithreadingEnabled = true;
+
+        std::vector<Surfel> mSurfelFlatStorage;
+        std::vector<ID> mSurfelFlatStorageOwners;
+        std::vector<ID> mClusteredSurfelOwners;
+        CompactSpatialHash<Surfel> mSurfelSpatialHash;
         std::unique_ptr<SurfelData> mSurfelDataContainer;
+        SurfelClusterBuilder::Statistics mClusteringStatistics;
         const SharedResourceStorage *mResourcePool = nullptr;
         const Scene *mScene = nullptr;
 
 #pragma mark - Member functions
 
+        /**
+         Calculates a checksum of everything surfels of a mesh instance depend on:
+         geometry, transformation, albedo of its materials and generation settings
+
+         @param instanceID ID of a static mesh instance
+         @param meshChecksums Cache of geometry checksums shared by instances of the same mesh
+         @return CRC32 checksum
+         */
+        uint32_t instanceChecksum(ID instanceID, std::unordered_map<ID, uint32_t> &meshChecksums) const;
+
+        /**
+         @return Checksums of all static mesh instances of the scene
+         */
+        std::unordered_map<ID, uint32_t> staticInstanceChecksums() const;
+
         /**
          Calculates an optimal minimum area of subdivided triangles based on the minimum desired distance between surfels
 
@@ -90,83 +133,193 @@ namespace EARenderer {
         /**
          Generates 3 random numbers between 0 and 1
 
+         @param engine Random number engine of the work item being processed
          @return Normalized triple of random numbers
          */
-        glm::vec3 randomBarycentricCoordinates();
+        glm::vec3 randomBarycentricCoordinates(std::mt19937 &engine) const;
 
         /**
          Creates LogarithmicBin data structure and fills it with sub mesh's transformed triangle data
 
          @param subMesh Sub mesh object holding geometry data
          @param containingInstance Mesh instance that applies transformation and materials to underlying sub mesh
+         @param seed Seed for the bin's internal random number engine
+         @param vacatedPositions If not null, only triangles lying within surfel spacing from any of these positions
+         (sorted along X axis) are put into the bin
          @return A logarithmic bin containing sub mesh's triangle data (positions, normals, albedo values and texture coordinates)
          */
-        LogarithmicBin<TransformedTriangleData> constructSubMeshVertexDataBin(const SubMesh &subMesh, const MeshInstance &containingInstance);
+        LogarithmicBin<TransformedTriangleData> constructSubMeshVertexDataBin(const SubMesh &subMesh, const MeshInstance &containingInstance,
+                uint32_t seed, const std::vector<glm::vec3> *vacatedPositions = nullptr) const;
+
+        /**
+         Checks to see whether triangle's bounding box lies within surfel spacing from any of the positions
+
+         @param triangle Test subject
+         @param positions Positions sorted along X axis
+         @return Bool value indicating whether triangle is close to any of the positions
+         */
+        bool triangleNearAnyPosition(const Triangle3D &triangle, const std::vector<glm::vec3> &positions) const;
 
         /**
          Checks to see whether triangle is completely covered by any surfel from existing surfel set
 
          @param triangle Test subject
+         @param surfels Spatial hash holding existing surfel set
          @return Bool value indicating whether triangle is covered
          */
-        bool triangleCompletelyCovered(Triangle3D &triangle);
+        bool triangleCompletelyCovered(Triangle3D &triangle, const CompactSpatialHash<Surfel> &surfels) const;
 
         /**
-         Checks to see whether surfel candidate is far enough from all the already generated surfels
+         Checks to see whether a point with a normal is far enough from all the already generated surfels
 
-         @param candidate Test subject
-         @return Bool value indicating whether surfel candidate is far enough to be accepted as a full-fledged surfel
+         @param position Position of the test subject
+         @param normal Normal of the test subject
+         @param surfels Spatial hash holding existing surfel set
+         @return Bool value indicating whether test subject is far enough to be accepted as a full-fledged surfel
          */
-        bool surfelCandidateMeetsMinimumDistanceRequirement(SurfelCandidate &candidate);
+        bool meetsMinimumDistanceRequirement(const glm::vec3 &position, const glm::vec3 &normal, const CompactSpatialHash<Surfel> &surfels) const;
 
         /**
          Generates a surfel candidate with minimum amount of data required to perform routines deciding
          whether this candidate is worthy to be added to a full-fledged surfel set
 
-         @param subMesh A sub mesh on which candidate is generated
          @param transformedVerticesBin Bin that holds all transformed triangle data of the sub mesh
+         @param engine Random number engine of the work item being processed
          @return A surfel candidate ready to participate in validity tests
          */
-        SurfelCandidate generateSurfelCandidate(const SubMesh &subMesh, LogarithmicBin<TransformedTriangleData> &transformedVerticesBin);
+        SurfelCandidate generateSurfelCandidate(LogarithmicBin<TransformedTriangleData> &transformedVerticesBin, std::mt19937 &engine) const;
 
         /**
          Computes all necessary data for a surfel candidate (normal, albedo, uv and an area) to transform it into a full-fledged surfel
 
          @param surfelCandidate Candidate to be transformed
-         @param transformedVerticesBin Bin that holds all transformed triangle data of the sub mesh on which candidate was generated on
+         @param albedoSampler Sampler of sub mesh's albedo
          @return Surfel ready to be added to a scene and participate in rendering
          */
-        template<class TextureFormat, TextureFormat Format>
-        Surfel generateSurfel(SurfelCandidate &surfelCandidate,
-                LogarithmicBin<TransformedTriangleData> &transformedVerticesBin,
-                const GLTexture2DSampler<TextureFormat, Format> &albedoMapSampler);
+        Surfel generateSurfel(SurfelCandidate &surfelCandidate, const AlbedoSampler &albedoSampler) const;
+
+        /**
+         Creates work items for every sub mesh of a mesh instance that surfels can be generated on
+
+         @param instanceID ID of an instance on which surfels will be generated on
+         @param workItems Container receiving created work items
+         */
+        void prepareWorkItems(ID instanceID, std::vector<SurfelGenerationWorkItem> &workItems) const;
+
+        /**
+         Decodes albedo of every material referenced by work items, one material per task, and points work items to the results
+
+         @param workItems Prepared work items
+         @return Samplers keyed by material ID, have to outlive work items' processing
+         */
+        std::unordered_map<ID, std::unique_ptr<AlbedoSampler>> createAlbedoSamplers(std::vector<SurfelGenerationWorkItem> &workItems) const;
+
+        /**
+         Samples surfels on triangles of the bin until every triangle is either covered or too small to be split
+
+         @param bin Triangles to sample, emptied by the end of sampling
+         @param engine Random number engine of the work item being processed
+         @param spatialHash Existing surfel set that candidates are tested against. Accepted surfels are inserted into it.
+         @param albedoSampler Sampler of sub mesh's albedo
+         @param surfels Container receiving accepted surfels
+         */
+        void distributeSurfels(LogarithmicBin<TransformedTriangleData> &bin, std::mt19937 &engine,
+                CompactSpatialHash<Surfel> &spatialHash, const AlbedoSampler &albedoSampler, std::vector<Surfel> &surfels) const;
+
+        /**
+         Distributes surfels on a single sub mesh using work item's own RNG stream and spatial hash.
+         Doesn't touch any shared state and is safe to be called concurrently for different work items.
+
+         @param workItem Work item to process. Generated surfels are written to it's surfel list.
+         */
+        void generateSurfelsForWorkItem(SurfelGenerationWorkItem &workItem) const;
+
+        /**
+         Merges work items' surfels into the final surfel set in work item order,
+         discarding surfels that violate minimum distance requirement with respect to
+         surfels of previously merged work items (ones located on the borders of sub meshes).
+         Positions of discarded surfels are recorded in work items for refillVacatedAreas().
+
+         @param workItems Processed work items
+         */
+        void mergeWorkItems(std::vector<SurfelGenerationWorkItem> &workItems);
 
         /**
-         Generates surfels for a single mesh instance
+         Samples areas of sub meshes around surfels discarded by mergeWorkItems() once again,
+         this time against the merged surfel set, so that gaps left on sub mesh borders are filled
+         the same way serial generation would fill them. Runs serially in work item order.
+
+         @param workItems Merged work items
+         */
+        void refillVacatedAreas(std::vector<SurfelGenerationWorkItem> &workItems);
 
-         @param instance An instance on which surfels will be generated on
+        /**
+         Creates an empty surfel data container and resets intermediate storage
          */
-        void generateSurflesOnMeshInstance(const MeshInstance &instance);
+        void prepareSurfelStorage();
 
         /**
-         Determines resemblance of two surfels to decide whether thay belong to the same cluster
+         Generates surfels on static mesh instances and merges them into the flat surfel storage
 
-         @param first surfel one
-         @param second surfel two
-         @param workingVolumeMaximumExtent2 squared largest length of scene's light baking volume
-         @return returns a true if surfels are alike and belong to the same surfel cluster
+         @param instanceIDs Instances to generate surfels on
          */
-        bool surfelsAlike(const Surfel &first, const Surfel &second, float workingVolumeMaximumExtent2);
+        void generateSurfels(const std::vector<ID> &instanceIDs);
 
         /**
-         Gathers similar surfels into clusters
+         Gathers similar surfels from the flat storage into clusters appended to the surfel data container
          */
         void formClusters();
 
+        /**
+         Stores instance checksums in the surfel data container and tags every surfel with its owning instance
+
+         @param checksums Checksums of all static mesh instances
+         */
+        void recordInstances(const std::unordered_map<ID, uint32_t> &checksums);
+
     public:
         SurfelGenerator(const SharedResourceStorage *resourcePool, const Scene *scene);
 
+        SurfelGenerator(const SharedResourceStorage *resourcePool, const Scene *scene, uint32_t seed);
+
+        /**
+         @return Seed from which random streams of all work items are derived.
+         Generation result is the same for the same seed regardless of whether multithreading is enabled or not.
+         */
+        uint32_t seed() const;
+
+        bool isMultithreadingEnabled() const;
+
+        /**
+         @return Clustering statistics of the last generateStaticGeometrySurfels() invocation
+         */
+        const SurfelClusterBuilder::Statistics &clusteringStatistics() const;
+
+        /**
+         Enables distribution of surfel generation work across ThreadPool::Default() workers
+         */
+        void setMultithreadingEnabled(bool enabled);
+
         std::unique_ptr<SurfelData> generateStaticGeometrySurfels();
+
+        /**
+         @param previousData Surfels baked earlier
+         @return true if none of the static mesh instances changed since previous data was baked
+         */
+        bool isUpToDate(const SurfelData &previousData) const;
+
+        /**
+         Rebakes surfels of changed static mesh instances only.
+         Surfel clusters made entirely of unchanged instances' surfels are kept as is,
+         the rest of unchanged surfels is clustered again together with newly generated ones.
+         Bakes lacking instance checksums are regenerated from scratch.
+
+         @param previousData Surfels baked earlier
+         @param clusterChanges Receives the mapping of previous clusters onto updated ones,
+         which lets DiffuseLightProbeGenerator update probes incrementally as well
+         @return Updated surfel data
+         */
+        std::unique_ptr<SurfelData> updateStaticGeometrySurfels(const SurfelData &previousData, SurfelClusterChangeSet &clusterChanges);
     };
 
 }
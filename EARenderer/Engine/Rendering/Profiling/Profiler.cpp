@@ -0,0 +1,319 @@
+//
+//  Profiler.cpp
+//  EARenderer
+//
+//  Created by Pavlo Muratov on 17.10.2026.
+//  Copyright © 2026 MPO. All rights reserved.
+//
+
+#include "Profiler.hpp"
+#include "CRC32.hpp"
+
+#include <fstream>
+#include <algorithm>
+#include <stdexcept>
+#include <cstring>
+
+namespace EARenderer {
+
+#pragma mark - Rolling window
+
+    void Profiler::RollingWindow::add(double sample) {
+        mSamples[mNextSample] = sample;
+        mNextSample = (mNextSample + 1) % RollingWindowSize;
+        mSampleCount = std::min(mSampleCount + 1, RollingWindowSize);
+    }
+
+    Profiler::Statistics Profiler::RollingWindow::statistics() const {
+        Statistics statistics;
+
+        if (mSampleCount == 0) {
+            return statistics;
+        }
+
+        statistics.minimum = mSamples[0];
+        statistics.maximum = mSamples[0];
+
+        double sum = 0.0;
+        for (size_t i = 0; i < mSampleCount; i++) {
+            statistics.minimum = std::min(statistics.minimum, mSamples[i]);
+            statistics.maximum = std::max(statistics.maximum, mSamples[i]);
+            sum += mSamples[i];
+        }
+
+        statistics.average = sum / mSampleCount;
+        return statistics;
+    }
+
+#pragma mark - Scope
+
+    Profiler::Scope::Scope(const char *name) {
+        Profiler &profiler = Profiler::Shared();
+        mIsActive = profiler.mIsFrameActive;
+        if (mIsActive) {
+            profiler.beginScope(name);
+        }
+    }
+
+    Profiler::Scope::~Scope() {
+        if (mIsActive) {
+            Profiler::Shared().endScope();
+        }
+    }
+
+#pragma mark - Lifecycle
+
+    Profiler::Profiler()
+            : mEpoch(Clock::now()) {}
+
+    Profiler &Profiler::Shared() {
+        static Profiler profiler;
+        return profiler;
+    }
+
+#pragma mark - Getters
+
+    uint64_t Profiler::droppedGPUFrameCount() const {
+        return mDroppedGPUFrameCount;
+    }
+
+    std::vector<Profiler::ScopeStatistics> Profiler::statistics() const {
+        std::vector<ScopeStatistics> statistics;
+        statistics.reserve(mNodes.size());
+
+        for (size_t node = 0; node < mNodes.size(); node++) {
+            if (mNodes[node].parent == NoParent) {
+                appendStatistics(node, statistics);
+            }
+        }
+
+        return statistics;
+    }
+
+#pragma mark - Private helpers
+
+    uint64_t Profiler::CPUTime() const {
+        return std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now() - mEpoch).count();
+    }
+
+    size_t Profiler::nodeIndex(const char *name, size_t parent) {
+        uint64_t key = (uint64_t(uint32_t(parent)) << 32) | crc32(name, std::strlen(name));
+
+        auto it = mNodeIndices.find(key);
+        if (it != mNodeIndices.end()) {
+            return it->second;
+        }
+
+        size_t index = mNodes.size();
+
+        mNodes.emplace_back();
+        Node &node = mNodes.back();
+        node.name = name;
+        node.parent = parent;
+
+        if (parent != NoParent) {
+            node.depth = mNodes[parent].depth + 1;
+            mNodes[parent].children.push_back(index);
+        }
+
+        mNodeIndices.emplace(key, index);
+        return index;
+    }
+
+    size_t Profiler::recordTimestamp(FrameSlot &slot) {
+        if (slot.usedQueryCount == slot.queries.size()) {
+            slot.queries.emplace_back();
+        }
+
+        slot.queries[slot.usedQueryCount].record();
+        return slot.usedQueryCount++;
+    }
+
+    bool Profiler::isCapturingFrame(uint64_t frameIndex) const {
+        return mIsCapturing && frameIndex >= mCaptureFirstFrame && frameIndex < mCaptureEndFrame;
+    }
+
+    void Profiler::resolveGPUTimings(FrameSlot &slot) {
+        if (!slot.isPending) {
+            return;
+        }
+
+        slot.isPending = false;
+
+        if (slot.usedQueryCount == 0) {
+            return;
+        }
+
+        // Timestamps complete in submission order, so the last one being ready means the whole frame is
+        if (!slot.queries[slot.usedQueryCount - 1].isResultAvailable()) {
+            mDroppedGPUFrameCount++;
+            return;
+        }
+
+        bool isCaptured = isCapturingFrame(slot.frameIndex);
+
+        for (const ScopeRecord &record : slot.records) {
+            uint64_t begin = slot.queries[record.beginQuery].result();
+            uint64_t end = slot.queries[record.endQuery].result();
+            uint64_t duration = end > begin ? end - begin : 0;
+
+            mNodes[record.node].GPUTime.add(duration / 1e6);
+
+            if (isCaptured) {
+                mTraceEvents.push_back({record.node, uint64_t(int64_t(begin) + slot.GPUToCPUOffset), duration, true});
+            }
+        }
+    }
+
+    void Profiler::finishCaptureIfNeeded() {
+        // The last captured frame is resolved FramesInFlight frames after it was submitted
+        if (!mIsCapturing || mFrameIndex + 1 < mCaptureEndFrame + FramesInFlight) {
+            return;
+        }
+
+        writeTrace();
+
+        mIsCapturing = false;
+        mTraceEvents.clear();
+    }
+
+    void Profiler::writeTrace() const {
+        std::ofstream stream(mCapturePath, std::ios::trunc);
+        if (!stream.is_open()) {
+            printf("Can't write profiler trace to %s\n", mCapturePath.c_str());
+            return;
+        }
+
+        auto escaped = [](const std::string &string) {
+            std::string result;
+            for (char c : string) {
+                if (c == '"' || c == '\\') {
+                    result.push_back('\\');
+                }
+                result.push_back(c);
+            }
+            return result;
+        };
+
+        stream << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n";
+        stream << "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":0,\"tid\":0,\"args\":{\"name\":\"CPU\"}},\n";
+        stream << "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":0,\"tid\":1,\"args\":{\"name\":\"GPU\"}}";
+
+        char buffer[128];
+
+        for (const TraceEvent &event : mTraceEvents) {
+            // Trace event timestamps are in microseconds
+            snprintf(buffer, sizeof(buffer), "\"ts\":%.3f,\"dur\":%.3f,\"pid\":0,\"tid\":%d}", event.begin / 1e3, event.duration / 1e3, event.isGPUEvent ? 1 : 0);
+
+            stream << ",\n{\"name\":\"" << escaped(mNodes[event.node].name) << "\",\"cat\":\"" << (event.isGPUEvent ? "GPU" : "CPU") << "\",\"ph\":\"X\"," << buffer;
+        }
+
+        stream << "\n]}\n";
+    }
+
+    void Profiler::appendStatistics(size_t node, std::vector<ScopeStatistics> &statistics) const {
+        const Node &scopeNode = mNodes[node];
+
+        ScopeStatistics scopeStatistics;
+        scopeStatistics.name = scopeNode.name;
+        scopeStatistics.depth = scopeNode.depth;
+        scopeStatistics.CPUTime = scopeNode.CPUTime.statistics();
+        scopeStatistics.GPUTime = scopeNode.GPUTime.statistics();
+        statistics.push_back(scopeStatistics);
+
+        for (size_t child : scopeNode.children) {
+            appendStatistics(child, statistics);
+        }
+    }
+
+#pragma mark - Frames
+
+    void Profiler::beginFrame() {
+        if (mIsFrameActive) {
+            throw std::logic_error("Profiler frame has already begun");
+        }
+
+        mCurrentSlot = mFrameIndex % FramesInFlight;
+        FrameSlot &slot = mFrameSlots[mCurrentSlot];
+
+        resolveGPUTimings(slot);
+        finishCaptureIfNeeded();
+
+        slot.usedQueryCount = 0;
+        slot.records.clear();
+        slot.frameIndex = mFrameIndex;
+        slot.GPUToCPUOffset = int64_t(CPUTime()) - int64_t(GLTimestampQuery::CurrentTimestamp());
+
+        mIsFrameActive = true;
+        beginScope("Frame");
+    }
+
+    void Profiler::endFrame() {
+        if (!mIsFrameActive) {
+            throw std::logic_error("Profiler frame has not begun");
+        }
+
+        // Closes the frame scope along with any scopes that were left open
+        while (!mOpenRecords.empty()) {
+            endScope();
+        }
+
+        mFrameSlots[mCurrentSlot].isPending = true;
+        mIsFrameActive = false;
+        mFrameIndex++;
+    }
+
+#pragma mark - Scopes
+
+    void Profiler::beginScope(const char *name) {
+        if (!mIsFrameActive) {
+            return;
+        }
+
+        FrameSlot &slot = mFrameSlots[mCurrentSlot];
+        size_t parent = mOpenRecords.empty() ? NoParent : slot.records[mOpenRecords.back()].node;
+
+        ScopeRecord record;
+        record.node = nodeIndex(name, parent);
+        record.beginQuery = recordTimestamp(slot);
+        record.CPUBegin = CPUTime();
+
+        mOpenRecords.push_back(slot.records.size());
+        slot.records.push_back(record);
+    }
+
+    void Profiler::endScope() {
+        if (!mIsFrameActive || mOpenRecords.empty()) {
+            return;
+        }
+
+        FrameSlot &slot = mFrameSlots[mCurrentSlot];
+        ScopeRecord &record = slot.records[mOpenRecords.back()];
+        mOpenRecords.pop_back();
+
+        record.CPUEnd = CPUTime();
+        record.endQuery = recordTimestamp(slot);
+
+        uint64_t duration = record.CPUEnd - record.CPUBegin;
+        mNodes[record.node].CPUTime.add(duration / 1e6);
+
+        if (isCapturingFrame(slot.frameIndex)) {
+            mTraceEvents.push_back({record.node, record.CPUBegin, duration, false});
+        }
+    }
+
+#pragma mark - Capturing
+
+    void Profiler::captureTrace(const std::string &filePath, size_t frameCount) {
+        if (frameCount == 0) {
+            throw std::invalid_argument("Trace capture should contain at least one frame");
+        }
+
+        mCapturePath = filePath;
+        mCaptureFirstFrame = mIsFrameActive ? mFrameIndex + 1 : mFrameIndex;
+        mCaptureEndFrame = mCaptureFirstFrame + frameCount;
+        mIsCapturing = true;
+        mTraceEvents.clear();
+    }
+
+}
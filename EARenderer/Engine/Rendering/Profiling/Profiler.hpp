@@ -0,0 +1,196 @@
+//
+//  Profiler.hpp
+//  EARenderer
+//
+//  Created by Pavlo Muratov on 17.10.2026.
+//  Copyright © 2026 MPO. All rights reserved.
+//
+
+#ifndef Profiler_hpp
+#define Profiler_hpp
+
+#include "GLTimestampQuery.hpp"
+
+#include <array>
+#include <vector>
+#include <string>
+#include <chrono>
+#include <unordered_map>
+
+namespace EARenderer {
+
+    // Hierarchical frame profiler measuring both CPU and GPU time of named scopes.
+    //
+    // Every scope records a pair of GPU timestamps in addition to CPU time. Queries of a frame
+    // are read back FramesInFlight frames later, when the GPU is expected to be done with them,
+    // so that profiling never stalls the pipeline. Frames whose results are still not available
+    // by then are dropped from GPU statistics.
+    //
+    // Scopes are identified by their name and the enclosing scope, so the same name can appear in
+    // different branches of the hierarchy. Must only be used on the thread owning the GL context.
+
+    class Profiler {
+    public:
+        struct Statistics {
+            double minimum = 0.0;
+            double average = 0.0;
+            double maximum = 0.0;
+        };
+
+        struct ScopeStatistics {
+            std::string name;
+            size_t depth = 0;
+
+            /// Milliseconds over the last RollingWindowSize frames
+            Statistics CPUTime;
+            Statistics GPUTime;
+        };
+
+        /**
+         Measures the time between its construction and destruction.
+         Does nothing when created outside of a frame.
+         */
+        class Scope {
+        private:
+            bool mIsActive = false;
+
+        public:
+            Scope(const char *name);
+
+            ~Scope();
+
+            Scope(const Scope &that) = delete;
+
+            Scope &operator=(const Scope &rhs) = delete;
+        };
+
+        static constexpr size_t FramesInFlight = 4;
+        static constexpr size_t RollingWindowSize = 120;
+
+    private:
+        using Clock = std::chrono::steady_clock;
+
+        static constexpr size_t NoParent = -1;
+
+        class RollingWindow {
+        private:
+            std::array<double, RollingWindowSize> mSamples;
+            size_t mSampleCount = 0;
+            size_t mNextSample = 0;
+
+        public:
+            void add(double sample);
+
+            Statistics statistics() const;
+        };
+
+        struct Node {
+            std::string name;
+            size_t parent = NoParent;
+            size_t depth = 0;
+            std::vector<size_t> children;
+            RollingWindow CPUTime;
+            RollingWindow GPUTime;
+        };
+
+        struct ScopeRecord {
+            size_t node = 0;
+            uint64_t CPUBegin = 0;
+            uint64_t CPUEnd = 0;
+            size_t beginQuery = 0;
+            size_t endQuery = 0;
+        };
+
+        struct FrameSlot {
+            std::vector<GLTimestampQuery> queries;
+            size_t usedQueryCount = 0;
+            std::vector<ScopeRecord> records;
+            uint64_t frameIndex = 0;
+
+            /// Translates GPU timestamps into CPU time, both in nanoseconds
+            int64_t GPUToCPUOffset = 0;
+
+            bool isPending = false;
+        };
+
+        struct TraceEvent {
+            size_t node = 0;
+            uint64_t begin = 0;
+            uint64_t duration = 0;
+            bool isGPUEvent = false;
+        };
+
+        std::vector<Node> mNodes;
+        std::unordered_map<uint64_t, size_t> mNodeIndices;
+        std::array<FrameSlot, FramesInFlight> mFrameSlots;
+        std::vector<size_t> mOpenRecords;
+
+        size_t mCurrentSlot = 0;
+        uint64_t mFrameIndex = 0;
+        uint64_t mDroppedGPUFrameCount = 0;
+        bool mIsFrameActive = false;
+        Clock::time_point mEpoch;
+
+        std::string mCapturePath;
+        uint64_t mCaptureFirstFrame = 0;
+        uint64_t mCaptureEndFrame = 0;
+        bool mIsCapturing = false;
+        std::vector<TraceEvent> mTraceEvents;
+
+        Profiler();
+
+        uint64_t CPUTime() const;
+
+        size_t nodeIndex(const char *name, size_t parent);
+
+        size_t recordTimestamp(FrameSlot &slot);
+
+        bool isCapturingFrame(uint64_t frameIndex) const;
+
+        void resolveGPUTimings(FrameSlot &slot);
+
+        void finishCaptureIfNeeded();
+
+        void writeTrace() const;
+
+        void appendStatistics(size_t node, std::vector<ScopeStatistics> &statistics) const;
+
+    public:
+        static Profiler &Shared();
+
+        Profiler(const Profiler &that) = delete;
+
+        Profiler &operator=(const Profiler &rhs) = delete;
+
+        /**
+         @return frames whose GPU timings weren't ready in time and were discarded
+         */
+        uint64_t droppedGPUFrameCount() const;
+
+        /**
+         @return statistics of every scope seen so far, in depth-first order
+         */
+        std::vector<ScopeStatistics> statistics() const;
+
+        void beginFrame();
+
+        void endFrame();
+
+        void beginScope(const char *name);
+
+        void endScope();
+
+        /**
+         Records the next frames and writes them out in Chrome trace event format
+         (viewable in chrome://tracing or Perfetto) once their GPU timings are resolved.
+         CPU and GPU scopes are reported as separate threads.
+
+         @param filePath destination JSON file
+         @param frameCount number of frames to capture
+         */
+        void captureTrace(const std::string &filePath, size_t frameCount);
+    };
+
+}
+
+#endif /* Profiler_hpp */
@@ -0,0 +1,314 @@
+//
+//  ClusteredLightCuller.cpp
+//  EARenderer
+//
+//  Created by Pavlo Muratov on 17.10.2026.
+//  Copyright © 2026 MPO. All rights reserved.
+//
+
+#include "ClusteredLightCuller.hpp"
+#include "ThreadPool.hpp"
+
+#include <algorithm>
+#include <cmath>
+
+namespace EARenderer {
+
+#pragma mark - Lifecycle
+
+    ClusteredLightCuller::ClusteredLightCuller()
+            :
+            mClusterRanges(ClusterCount),
+            mLightBuffer(std::make_unique<LightBufferTexture>(nullptr, 256 * TexelsPerLight)),
+            mClusterBuffer(std::make_unique<ClusterBufferTexture>(nullptr, ClusterCount + 1)),
+            mIndexBuffer(std::make_unique<IndexBufferTexture>(nullptr, 1024)) {
+    }
+
+#pragma mark - Getters
+
+    bool ClusteredLightCuller::isMultithreadingEnabled() const {
+        return mMultithreadingEnabled;
+    }
+
+    bool ClusteredLightCuller::hasLights() const {
+        return !mLightBounds.empty();
+    }
+
+    const ClusteredLightCuller::Statistics &ClusteredLightCuller::statistics() const {
+        return mStatistics;
+    }
+
+    const ClusteredLightCuller::LightBufferTexture &ClusteredLightCuller::lightBuffer() const {
+        return *mLightBuffer;
+    }
+
+    const ClusteredLightCuller::ClusterBufferTexture &ClusteredLightCuller::clusterBuffer() const {
+        return *mClusterBuffer;
+    }
+
+    const ClusteredLightCuller::IndexBufferTexture &ClusteredLightCuller::indexBuffer() const {
+        return *mIndexBuffer;
+    }
+
+    glm::vec2 ClusteredLightCuller::depthSliceScaleAndBias() const {
+        return {mDepthScale, mDepthBias};
+    }
+
+#pragma mark - Setters
+
+    void ClusteredLightCuller::setMultithreadingEnabled(bool enabled) {
+        mMultithreadingEnabled = enabled;
+    }
+
+#pragma mark - Private helpers
+
+    bool ClusteredLightCuller::SphereIntersectsBox(const glm::vec3 &center, float radius, const Box &box) {
+        glm::vec3 closestPoint = glm::clamp(center, box.min, box.max);
+        glm::vec3 delta = closestPoint - center;
+        return glm::dot(delta, delta) <= radius * radius;
+    }
+
+    void ClusteredLightCuller::updateClusterBounds(const Camera &camera) {
+        glm::mat4 projection = camera.projectionMatrix();
+        float nearPlane = camera.nearClipPlane();
+        float farPlane = camera.farClipPlane();
+
+        if (!mClusterBounds.empty() && projection == mClusterProjection && nearPlane == mClusterNearPlane && farPlane == mClusterFarPlane) {
+            return;
+        }
+
+        mClusterProjection = projection;
+        mClusterNearPlane = nearPlane;
+        mClusterFarPlane = farPlane;
+
+        float logDepthRange = std::log(farPlane / nearPlane);
+        mDepthScale = SliceCount / logDepthRange;
+        mDepthBias = SliceCount * std::log(nearPlane) / logDepthRange;
+
+        // View space directions through tile corners, scaled to unit depth
+        glm::mat4 inverseProjection = glm::inverse(projection);
+        std::vector<glm::vec3> cornerDirections((TileCountX + 1) * (TileCountY + 1));
+
+        for (uint32_t y = 0; y <= TileCountY; y++) {
+            for (uint32_t x = 0; x <= TileCountX; x++) {
+                glm::vec4 ndc(2.0f * x / TileCountX - 1.0f, 2.0f * y / TileCountY - 1.0f, -1.0f, 1.0f);
+                glm::vec4 point = inverseProjection * ndc;
+                glm::vec3 viewPoint = glm::vec3(point) / point.w;
+                cornerDirections[y * (TileCountX + 1) + x] = viewPoint / -viewPoint.z;
+            }
+        }
+
+        mClusterBounds.resize(ClusterCount);
+
+        for (uint32_t slice = 0; slice < SliceCount; slice++) {
+            float sliceNear = nearPlane * std::pow(farPlane / nearPlane, float(slice) / SliceCount);
+            float sliceFar = nearPlane * std::pow(farPlane / nearPlane, float(slice + 1) / SliceCount);
+
+            for (uint32_t y = 0; y < TileCountY; y++) {
+                for (uint32_t x = 0; x < TileCountX; x++) {
+                    Box &box = mClusterBounds[(slice * TileCountY + y) * TileCountX + x];
+                    box.min = glm::vec3(std::numeric_limits<float>::max());
+                    box.max = glm::vec3(std::numeric_limits<float>::lowest());
+
+                    for (uint32_t corner = 0; corner < 4; corner++) {
+                        const glm::vec3 &direction = cornerDirections[(y + corner / 2) * (TileCountX + 1) + x + corner % 2];
+                        for (float depth : {sliceNear, sliceFar}) {
+                            box.min = glm::min(box.min, direction * depth);
+                            box.max = glm::max(box.max, direction * depth);
+                        }
+                    }
+                }
+            }
+        }
+    }
+
+    uint32_t ClusteredLightCuller::sliceForDepth(float depth) const {
+        if (depth <= mClusterNearPlane) {
+            return 0;
+        }
+        float slice = std::floor(std::log(depth) * mDepthScale - mDepthBias);
+        return static_cast<uint32_t>(glm::clamp(slice, 0.0f, float(SliceCount - 1)));
+    }
+
+    ClusteredLightCuller::LightBounds
+    ClusteredLightCuller::lightBounds(const glm::vec3 &position, float radius, const glm::mat4 &view, const glm::mat4 &projection) const {
+        LightBounds bounds;
+        bounds.center = glm::vec3(view * glm::vec4(position, 1.0f));
+        bounds.radius = radius;
+
+        float depth = -bounds.center.z;
+        bounds.firstSlice = sliceForDepth(depth - bounds.radius);
+        bounds.lastSlice = sliceForDepth(depth + bounds.radius);
+
+        bounds.firstTileX = 0;
+        bounds.lastTileX = TileCountX - 1;
+        bounds.firstTileY = 0;
+        bounds.lastTileY = TileCountY - 1;
+
+        // Spheres crossing the near plane can cover any part of the screen
+        if (depth - bounds.radius <= mClusterNearPlane) {
+            return bounds;
+        }
+
+        // The sphere lies in front of the camera, so projected corners of its bounding box bound its projection
+        glm::vec2 ndcMin(std::numeric_limits<float>::max());
+        glm::vec2 ndcMax(std::numeric_limits<float>::lowest());
+
+        for (uint32_t corner = 0; corner < 8; corner++) {
+            glm::vec3 offset((corner & 1) ? bounds.radius : -bounds.radius,
+                    (corner & 2) ? bounds.radius : -bounds.radius,
+                    (corner & 4) ? bounds.radius : -bounds.radius);
+            glm::vec4 clip = projection * glm::vec4(bounds.center + offset, 1.0f);
+            glm::vec2 ndc = glm::vec2(clip) / clip.w;
+            ndcMin = glm::min(ndcMin, ndc);
+            ndcMax = glm::max(ndcMax, ndc);
+        }
+
+        auto tile = [](float ndc, uint32_t tileCount) {
+            float tile = std::floor((ndc * 0.5f + 0.5f) * tileCount);
+            return static_cast<uint32_t>(glm::clamp(tile, 0.0f, float(tileCount - 1)));
+        };
+
+        bounds.firstTileX = tile(ndcMin.x, TileCountX);
+        bounds.lastTileX = tile(ndcMax.x, TileCountX);
+        bounds.firstTileY = tile(ndcMin.y, TileCountY);
+        bounds.lastTileY = tile(ndcMax.y, TileCountY);
+
+        return bounds;
+    }
+
+    void ClusteredLightCuller::fillSlice(uint32_t slice) {
+        auto &indices = mSliceLightIndices[slice];
+        indices.clear();
+
+        std::vector<uint32_t> rowLights;
+        rowLights.reserve(mSliceLights[slice].size());
+
+        // Offsets are local to the slice until all slices are merged
+        for (uint32_t y = 0; y < TileCountY; y++) {
+            rowLights.clear();
+            for (uint32_t lightIndex : mSliceLights[slice]) {
+                const LightBounds &bounds = mLightBounds[lightIndex];
+                if (y >= bounds.firstTileY && y <= bounds.lastTileY) {
+                    rowLights.push_back(lightIndex);
+                }
+            }
+
+            for (uint32_t x = 0; x < TileCountX; x++) {
+                uint32_t cluster = (slice * TileCountY + y) * TileCountX + x;
+                size_t offset = indices.size();
+
+                for (uint32_t lightIndex : rowLights) {
+                    const LightBounds &bounds = mLightBounds[lightIndex];
+
+                    if (x >= bounds.firstTileX && x <= bounds.lastTileX &&
+                        SphereIntersectsBox(bounds.center, bounds.radius, mClusterBounds[cluster])) {
+                        indices.push_back(lightIndex);
+                    }
+                }
+
+                mClusterRanges[cluster] = glm::uvec2(offset, indices.size() - offset);
+            }
+        }
+    }
+
+    void ClusteredLightCuller::upload() {
+        // Writing session requires some spare room past the written range
+        if (mLightTexels.size() >= mLightBuffer->buffer().count()) {
+            mLightBuffer = std::make_unique<LightBufferTexture>(nullptr, mLightTexels.size() * 2);
+        }
+        if (mLightIndices.size() >= mIndexBuffer->buffer().count()) {
+            mIndexBuffer = std::make_unique<IndexBufferTexture>(nullptr, mLightIndices.size() * 2);
+        }
+
+        auto lightSession = mLightBuffer->buffer().createWritingSession();
+        lightSession.enqueueData(mLightTexels.data(), mLightTexels.size());
+        lightSession.flush();
+
+        auto clusterSession = mClusterBuffer->buffer().createWritingSession();
+        clusterSession.enqueueData(mClusterRanges.data(), mClusterRanges.size());
+        clusterSession.flush();
+
+        if (!mLightIndices.empty()) {
+            auto indexSession = mIndexBuffer->buffer().createWritingSession();
+            indexSession.enqueueData(mLightIndices.data(), mLightIndices.size());
+            indexSession.flush();
+        }
+    }
+
+#pragma mark - Building
+
+    void ClusteredLightCuller::clear() {
+        mLightTexels.clear();
+        mLightBounds.clear();
+    }
+
+    void ClusteredLightCuller::add(const PointLight &light) {
+        mLightTexels.emplace_back(light.position(), light.radius());
+        mLightTexels.emplace_back(light.color().rgb(), 0.0f);
+        mLightTexels.emplace_back(light.attenuation.constant, light.attenuation.linear, light.attenuation.quadratic, 0.0f);
+
+        // Bounds depend on the camera and are computed in build()
+        mLightBounds.emplace_back();
+    }
+
+    void ClusteredLightCuller::build(const Camera &camera) {
+        mStatistics = Statistics();
+        mStatistics.lightCount = mLightBounds.size();
+
+        updateClusterBounds(camera);
+
+        glm::mat4 view = camera.viewMatrix();
+        glm::mat4 projection = camera.projectionMatrix();
+
+        for (auto &lights : mSliceLights) {
+            lights.clear();
+        }
+
+        for (uint32_t i = 0; i < mLightBounds.size(); i++) {
+            const glm::vec4 &positionAndRadius = mLightTexels[i * TexelsPerLight];
+            mLightBounds[i] = lightBounds(glm::vec3(positionAndRadius), positionAndRadius.w, view, projection);
+
+            float depth = -mLightBounds[i].center.z;
+            if (depth + positionAndRadius.w < mClusterNearPlane || depth - positionAndRadius.w > mClusterFarPlane) {
+                continue;
+            }
+
+            for (uint32_t slice = mLightBounds[i].firstSlice; slice <= mLightBounds[i].lastSlice; slice++) {
+                mSliceLights[slice].push_back(i);
+            }
+        }
+
+        if (mMultithreadingEnabled) {
+            ThreadPool::Default().parallelFor(0, SliceCount, 1, [&](size_t begin, size_t end) {
+                for (size_t slice = begin; slice < end; slice++) {
+                    fillSlice(static_cast<uint32_t>(slice));
+                }
+            });
+        } else {
+            for (uint32_t slice = 0; slice < SliceCount; slice++) {
+                fillSlice(slice);
+            }
+        }
+
+        // Merge slices into a single index list
+        mLightIndices.clear();
+
+        for (uint32_t slice = 0; slice < SliceCount; slice++) {
+            uint32_t base = static_cast<uint32_t>(mLightIndices.size());
+            uint32_t firstCluster = slice * TileCountX * TileCountY;
+
+            for (uint32_t cluster = firstCluster; cluster < firstCluster + TileCountX * TileCountY; cluster++) {
+                mClusterRanges[cluster].x += base;
+                mStatistics.maximumLightsPerCluster = std::max<size_t>(mStatistics.maximumLightsPerCluster, mClusterRanges[cluster].y);
+            }
+
+            mLightIndices.insert(mLightIndices.end(), mSliceLightIndices[slice].begin(), mSliceLightIndices[slice].end());
+        }
+
+        mStatistics.lightIndexCount = mLightIndices.size();
+
+        upload();
+    }
+
+}
@@ -0,0 +1,170 @@
+//
+//  ClusteredLightCuller.hpp
+//  EARenderer
+//
+//  Created by Pavlo Muratov on 17.10.2026.
+//  Copyright © 2026 MPO. All rights reserved.
+//
+
+#ifndef ClusteredLightCuller_hpp
+#define ClusteredLightCuller_hpp
+
+#include "PointLight.hpp"
+#include "Camera.hpp"
+#include "GLBufferTexture.hpp"
+
+#include <array>
+#include <vector>
+#include <memory>
+#include <glm/mat4x4.hpp>
+#include <glm/vec2.hpp>
+#include <glm/vec4.hpp>
+
+namespace EARenderer {
+
+    // Assigns point lights to clusters (froxels) of the camera frustum, so that lighting shaders
+    // only loop over lights that can affect a pixel.
+    //
+    // The frustum is split into TileCountX x TileCountY screen tiles and SliceCount depth slices.
+    // Slices are spaced exponentially between the near and the far planes, so that clusters
+    // stay roughly cubical. Every cluster gets a range in a shared list of light indices.
+    // Slices are independent of each other and are filled in parallel.
+    //
+    // Results are uploaded to buffer textures:
+    // - cluster ranges (RG32UI): offset and count of cluster's lights in the index list,
+    //   cluster (x, y, z) lives at (z * TileCountY + y) * TileCountX + x
+    // - light indices (R32UI)
+    // - lights (RGBA32F, TexelsPerLight texels per light): world position and radius,
+    //   radiant flux, attenuation factors
+
+    class ClusteredLightCuller {
+    public:
+
+#pragma mark - Nested types
+
+        static constexpr uint32_t TileCountX = 16;
+        static constexpr uint32_t TileCountY = 9;
+        static constexpr uint32_t SliceCount = 24;
+        static constexpr uint32_t ClusterCount = TileCountX * TileCountY * SliceCount;
+        static constexpr size_t TexelsPerLight = 3;
+
+        using LightBufferTexture = GLFloatBufferTexture<GLTexture::Float::RGBA32F, glm::vec4>;
+        using ClusterBufferTexture = GLIntegerBufferTexture<GLTexture::Integer::RG32UI, glm::uvec2>;
+        using IndexBufferTexture = GLIntegerBufferTexture<GLTexture::Integer::R32UI, uint32_t>;
+
+        struct Statistics {
+            size_t lightCount = 0;
+            size_t lightIndexCount = 0;
+            size_t maximumLightsPerCluster = 0;
+        };
+
+    private:
+        struct Box {
+            glm::vec3 min;
+            glm::vec3 max;
+        };
+
+        /**
+         Light's view space sphere along with the clusters it may touch
+         */
+        struct LightBounds {
+            glm::vec3 center;
+            float radius;
+            uint32_t firstTileX, lastTileX;
+            uint32_t firstTileY, lastTileY;
+            uint32_t firstSlice, lastSlice;
+        };
+
+#pragma mark - Member variables
+
+        std::vector<glm::vec4> mLightTexels;
+        std::vector<LightBounds> mLightBounds;
+
+        glm::mat4 mClusterProjection;
+        float mClusterNearPlane = 0.0f;
+        float mClusterFarPlane = 0.0f;
+        std::vector<Box> mClusterBounds;
+
+        std::array<std::vector<uint32_t>, SliceCount> mSliceLights;
+        std::array<std::vector<uint32_t>, SliceCount> mSliceLightIndices;
+        std::vector<glm::uvec2> mClusterRanges;
+        std::vector<uint32_t> mLightIndices;
+
+        float mDepthScale = 0.0f;
+        float mDepthBias = 0.0f;
+        bool mMultithreadingEnabled = true;
+        Statistics mStatistics;
+
+        std::unique_ptr<LightBufferTexture> mLightBuffer;
+        std::unique_ptr<ClusterBufferTexture> mClusterBuffer;
+        std::unique_ptr<IndexBufferTexture> mIndexBuffer;
+
+#pragma mark - Member functions
+
+        static bool SphereIntersectsBox(const glm::vec3 &center, float radius, const Box &box);
+
+        /**
+         Recomputes view space bounds of all clusters if camera's projection has changed
+         */
+        void updateClusterBounds(const Camera &camera);
+
+        uint32_t sliceForDepth(float depth) const;
+
+        LightBounds lightBounds(const glm::vec3 &position, float radius, const glm::mat4 &view, const glm::mat4 &projection) const;
+
+        void fillSlice(uint32_t slice);
+
+        void upload();
+
+    public:
+
+#pragma mark - Lifecycle
+
+        ClusteredLightCuller();
+
+#pragma mark - Getters
+
+        bool isMultithreadingEnabled() const;
+
+        /**
+         @return whether any lights have been added since the last clear()
+         */
+        bool hasLights() const;
+
+        const Statistics &statistics() const;
+
+        const LightBufferTexture &lightBuffer() const;
+
+        const ClusterBufferTexture &clusterBuffer() const;
+
+        const IndexBufferTexture &indexBuffer() const;
+
+        /**
+         Slice of a view space depth d is floor(log(d) * scale - bias)
+
+         @return (scale, bias)
+         */
+        glm::vec2 depthSliceScaleAndBias() const;
+
+#pragma mark - Setters
+
+        void setMultithreadingEnabled(bool enabled);
+
+#pragma mark - Building
+
+        /**
+         Discards lights of the previous frame
+         */
+        void clear();
+
+        void add(const PointLight &light);
+
+        /**
+         Assigns added lights to clusters of camera's frustum and uploads the results to the GPU
+         */
+        void build(const Camera &camera);
+    };
+
+}
+
+#endif /* ClusteredLightCuller_hpp */
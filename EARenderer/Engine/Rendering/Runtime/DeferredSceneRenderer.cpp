@@ -13,6 +13,7 @@
 #include "Collision.hpp"
 #include "Measurement.hpp"
 #include "Drawable.hpp"
+#include "Profiler.hpp"
 
 #include <glm/gtc/type_ptr.hpp>
 #include <glm/gtc/matrix_transform.hpp>
@@ -127,8 +128,17 @@ namespace EARenderer {
 #pragma mark - Public interface
 
     void DeferredSceneRenderer::render(const DebugOpportunity &debugClosure) {
-        mShadowMapper.render();
-        mIndirectLightAccumulator.updateProbes();
+        Profiler::Scope renderScope("Deferred rendering");
+
+        {
+            Profiler::Scope scope("Shadow maps");
+            mShadowMapper.render();
+        }
+
+        {
+            Profiler::Scope scope("Probe update");
+            mIndirectLightAccumulator.updateProbes();
+        }
 
         // We're using depth buffer rendered during g-buffer construction.
         // Depth writes are disabled for the purpose of combining skybox
@@ -147,38 +157,67 @@ namespace EARenderer {
         glBlendFunc(GL_ONE, GL_ONE);
         glDisable(GL_DEPTH_TEST);
 
-        mDirectLightAccumulator.render();
-        mIndirectLightAccumulator.render();
+        {
+            Profiler::Scope scope("Direct light");
+            mDirectLightAccumulator.render();
+        }
+
+        {
+            Profiler::Scope scope("Indirect light");
+            mIndirectLightAccumulator.render();
+        }
 
         glDisable(GL_BLEND);
         glEnable(GL_DEPTH_TEST);
 
         if (mSettings.skyboxRenderingEnabled) {
+            Profiler::Scope scope("Skybox");
             renderSkybox();
         }
 
         auto ssrBaseOutputTexture = mPostprocessTexturePool.claim(); // Frame with reflections applied
         auto ssrBrightOutputTexture = mPostprocessTexturePool.claim(); // Frame filtered by luminosity threshold and suitable for bloom effect
 
-        mSSREffect.applyReflections(
-                *mScene->camera(), *mGBuffer, mScene->skybox()->lightProbe(),
-                *lightAccumulationTarget, *ssrBaseOutputTexture, *ssrBrightOutputTexture
-        );
+        {
+            Profiler::Scope scope("SSR");
+            mSSREffect.applyReflections(
+                    *mScene->camera(), *mGBuffer, mScene->skybox()->lightProbe(),
+                    *lightAccumulationTarget, *ssrBaseOutputTexture, *ssrBrightOutputTexture
+            );
+        }
 
         auto bloomOutputTexture = lightAccumulationTarget;
-        mBloomEffect.bloom(*ssrBaseOutputTexture, *ssrBrightOutputTexture, *bloomOutputTexture, mSettings.bloomSettings);
+
+        {
+            Profiler::Scope scope("Bloom");
+            mBloomEffect.bloom(*ssrBaseOutputTexture, *ssrBrightOutputTexture, *bloomOutputTexture, mSettings.bloomSettings);
+        }
 
         glDepthMask(GL_TRUE);
 
-        debugClosure();
+        {
+            Profiler::Scope scope("Debug");
+            debugClosure();
+        }
 
         auto toneMappingOutputTexture = ssrBaseOutputTexture;
-        mToneMappingEffect.toneMap(*bloomOutputTexture, *toneMappingOutputTexture);
+
+        {
+            Profiler::Scope scope("Tone mapping");
+            mToneMappingEffect.toneMap(*bloomOutputTexture, *toneMappingOutputTexture);
+        }
 
         auto smaaOutputTexture = ssrBrightOutputTexture;
-        mSMAAEffect.antialise(*toneMappingOutputTexture, *smaaOutputTexture);
 
-        renderFinalImage(*smaaOutputTexture);
+        {
+            Profiler::Scope scope("SMAA");
+            mSMAAEffect.antialise(*toneMappingOutputTexture, *smaaOutputTexture);
+        }
+
+        {
+            Profiler::Scope scope("Final image");
+            renderFinalImage(*smaaOutputTexture);
+        }
 
         mPostprocessTexturePool.putBack(lightAccumulationTarget);
         mPostprocessTexturePool.putBack(ssrBaseOutputTexture);
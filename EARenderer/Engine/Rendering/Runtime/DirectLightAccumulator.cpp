@@ -8,6 +8,7 @@
 
 #include "DirectLightAccumulator.hpp"
 #include "Drawable.hpp"
+#include "Profiler.hpp"
 
 namespace EARenderer {
 
@@ -45,6 +46,7 @@ namespace EARenderer {
 
     void DirectLightAccumulator::renderPointLights() {
         mLightEvaluationShader.setLightType(LightType::Point);
+        mClusteredLightCuller.clear();
 
         for (ID lightId : mScene->pointLights()) {
             const PointLight &light = mScene->pointLights()[lightId];
@@ -53,6 +55,12 @@ namespace EARenderer {
                 continue;
             }
 
+            // Lights without a shadow map are shaded all at once in renderClusteredPointLights()
+            if (!light.castsShadows() || !mShadowMapper->hasShadowMapForPointLight(lightId)) {
+                mClusteredLightCuller.add(light);
+                continue;
+            }
+
             mLightEvaluationShader.setUniformBuffer(
                     ctcrc32("PointLightUBO"),
                     *mGPUResourceController->uniformBuffer(),
@@ -67,8 +75,30 @@ namespace EARenderer {
         }
     }
 
+    void DirectLightAccumulator::renderClusteredPointLights() {
+        if (!mClusteredLightCuller.hasLights()) {
+            return;
+        }
+
+        {
+            Profiler::Scope scope("Light clustering");
+            mClusteredLightCuller.build(*mScene->camera());
+        }
+
+        mLightEvaluationShader.setLightType(LightType::ClusteredPoint);
+        mLightEvaluationShader.ensureSamplerValidity([&]() {
+            mLightEvaluationShader.setClusteredPointLights(mClusteredLightCuller);
+            mLightEvaluationShader.setGBuffer(*mGBuffer);
+        });
+        Drawable::TriangleStripQuad::Draw();
+    }
+
 #pragma mark - Getters / Setters
 
+    const ClusteredLightCuller &DirectLightAccumulator::clusteredLightCuller() const {
+        return mClusteredLightCuller;
+    }
+
     void DirectLightAccumulator::setRenderingSettings(const RenderingSettings &settings) {
         mSettings = settings;
     }
@@ -82,6 +112,7 @@ namespace EARenderer {
 
         renderDirectionalLights();
         renderPointLights();
+        renderClusteredPointLights();
     }
 
 }
@@ -17,6 +17,7 @@
 #include "GLFramebuffer.hpp"
 #include "GPUResourceController.hpp"
 #include "GLSLDirectLightEvaluation.hpp"
+#include "ClusteredLightCuller.hpp"
 
 #include <memory>
 
@@ -30,18 +31,23 @@ namespace EARenderer {
         const GPUResourceController *mGPUResourceController;
 
         GLSLDirectLightEvaluation mLightEvaluationShader;
+        ClusteredLightCuller mClusteredLightCuller;
         RenderingSettings mSettings;
 
         void renderDirectionalLights();
 
         void renderPointLights();
 
+        void renderClusteredPointLights();
+
     public:
         DirectLightAccumulator(
                 const Scene *scene, const SceneGBuffer *gBuffer,
                 const ShadowMapper *shadowMapper, const GPUResourceController *gpuResourceController
         );
 
+        const ClusteredLightCuller &clusteredLightCuller() const;
+
         void setRenderingSettings(const RenderingSettings &settings);
 
         void render();
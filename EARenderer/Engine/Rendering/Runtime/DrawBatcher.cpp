@@ -0,0 +1,130 @@
+//
+//  DrawBatcher.cpp
+//  EARenderer
+//
+//  Created by Pavlo Muratov on 17.10.2026.
+//  Copyright © 2026 MPO. All rights reserved.
+//
+
+#include "DrawBatcher.hpp"
+
+#include <algorithm>
+#include <numeric>
+#include <glm/gtc/matrix_inverse.hpp>
+
+namespace EARenderer {
+
+#pragma mark - Lifecycle
+
+    DrawBatcher::DrawBatcher(const GPUResourceController *gpuResourceController, InstanceData instanceData)
+            :
+            mGPUResourceController(gpuResourceController),
+            mInstanceData(instanceData),
+            mInstanceBuffer(std::make_unique<InstanceBufferTexture>(nullptr, 256)) {
+    }
+
+#pragma mark - Getters
+
+    const std::vector<DrawBatcher::Batch> &DrawBatcher::batches() const {
+        return mBatches;
+    }
+
+    const DrawBatcher::InstanceBufferTexture &DrawBatcher::instanceBuffer() const {
+        return *mInstanceBuffer;
+    }
+
+    size_t DrawBatcher::texelsPerInstance() const {
+        return mInstanceData == InstanceData::ModelMatrix ? 4 : 8;
+    }
+
+#pragma mark - Private helpers
+
+    bool DrawBatcher::SameBatch(const PendingDraw &lhs, const PendingDraw &rhs) {
+        return lhs.location.offset == rhs.location.offset &&
+               lhs.location.indexOffset == rhs.location.indexOffset &&
+               lhs.material == rhs.material;
+    }
+
+    void DrawBatcher::upload() {
+        if (mInstanceTexels.empty()) {
+            return;
+        }
+
+        // Writing session requires some spare room past the written range
+        if (mInstanceTexels.size() >= mInstanceBuffer->buffer().count()) {
+            mInstanceBuffer = std::make_unique<InstanceBufferTexture>(nullptr, mInstanceTexels.size() * 2);
+        }
+
+        auto session = mInstanceBuffer->buffer().createWritingSession();
+        session.enqueueData(mInstanceTexels.data(), mInstanceTexels.size());
+        session.flush();
+    }
+
+#pragma mark - Building
+
+    void DrawBatcher::clear() {
+        mPendingDraws.clear();
+        mBatches.clear();
+        mInstanceTexels.clear();
+    }
+
+    void DrawBatcher::add(ID meshID, ID subMeshID, const glm::mat4 &modelMatrix, const std::optional<MaterialReference> &material) {
+        mPendingDraws.push_back({mGPUResourceController->subMeshVBODataLocation(meshID, subMeshID), material, modelMatrix});
+    }
+
+    void DrawBatcher::build() {
+        mOrder.resize(mPendingDraws.size());
+        std::iota(mOrder.begin(), mOrder.end(), 0);
+
+        // Stable sort keeps instances of a batch in submission order
+        std::stable_sort(mOrder.begin(), mOrder.end(), [this](uint32_t lhs, uint32_t rhs) {
+            const PendingDraw &a = mPendingDraws[lhs];
+            const PendingDraw &b = mPendingDraws[rhs];
+            if (a.location.offset != b.location.offset) {
+                return a.location.offset < b.location.offset;
+            }
+            if (a.location.indexOffset != b.location.indexOffset) {
+                return a.location.indexOffset < b.location.indexOffset;
+            }
+            return a.material < b.material;
+        });
+
+        mBatches.clear();
+        mInstanceTexels.clear();
+        mInstanceTexels.reserve(mPendingDraws.size() * texelsPerInstance());
+
+        uint32_t instanceIndex = 0;
+
+        for (uint32_t drawIndex : mOrder) {
+            const PendingDraw &draw = mPendingDraws[drawIndex];
+
+            if (mBatches.empty() || !SameBatch(mPendingDraws[mOrder[mBatches.back().command.baseInstance]], draw)) {
+                Batch batch;
+                batch.material = draw.material;
+                batch.location = draw.location;
+                batch.command.count = static_cast<uint32_t>(draw.location.indexCount);
+                batch.command.firstIndex = static_cast<uint32_t>(draw.location.indexOffset);
+                batch.command.baseVertex = static_cast<int32_t>(draw.location.offset);
+                batch.command.baseInstance = instanceIndex;
+                mBatches.push_back(batch);
+            }
+
+            mBatches.back().command.instanceCount++;
+            instanceIndex++;
+
+            for (glm::length_t column = 0; column < 4; column++) {
+                mInstanceTexels.push_back(draw.modelMatrix[column]);
+            }
+
+            if (mInstanceData == InstanceData::ModelAndNormalMatrices) {
+                glm::mat4 normalMatrix = glm::inverseTranspose(draw.modelMatrix);
+                for (glm::length_t column = 0; column < 4; column++) {
+                    mInstanceTexels.push_back(normalMatrix[column]);
+                }
+            }
+        }
+
+        upload();
+    }
+
+}
@@ -0,0 +1,132 @@
+//
+//  DrawBatcher.hpp
+//  EARenderer
+//
+//  Created by Pavlo Muratov on 17.10.2026.
+//  Copyright © 2026 MPO. All rights reserved.
+//
+
+#ifndef DrawBatcher_hpp
+#define DrawBatcher_hpp
+
+#include "GPUResourceController.hpp"
+#include "GLBufferTexture.hpp"
+#include "MaterialType.hpp"
+
+#include <vector>
+#include <memory>
+#include <optional>
+#include <glm/mat4x4.hpp>
+#include <glm/vec4.hpp>
+
+namespace EARenderer {
+
+    // Groups draws of the same sub mesh (and optionally the same material) into instanced batches.
+    //
+    // Per-instance matrices of every batch are packed into a single buffer texture, so that
+    // a whole pass is submitted with one instanced draw per batch instead of one draw and
+    // a couple of uniform updates per sub mesh. Vertex shaders fetch their matrices
+    // from (baseInstance + instance index) * texelsPerInstance().
+    //
+    // Batches are described with the layout of GL's indirect draw commands. OpenGL 4.1,
+    // which is the ceiling on macOS, has neither glMultiDrawElementsIndirect nor base instance
+    // support, so commands are submitted one by one with baseInstance passed as a uniform.
+
+    class DrawBatcher {
+    public:
+
+#pragma mark - Nested types
+
+        /**
+         Same layout as DrawElementsIndirectCommand from ARB_draw_indirect
+         */
+        struct DrawElementsIndirectCommand {
+            uint32_t count = 0;
+            uint32_t instanceCount = 0;
+            uint32_t firstIndex = 0;
+            int32_t baseVertex = 0;
+            uint32_t baseInstance = 0;
+        };
+
+        struct Batch {
+            std::optional<MaterialReference> material;
+            GLVBODataLocation location;
+            DrawElementsIndirectCommand command;
+        };
+
+        enum class InstanceData {
+            ModelMatrix, ModelAndNormalMatrices
+        };
+
+        using InstanceBufferTexture = GLFloatBufferTexture<GLTexture::Float::RGBA32F, glm::vec4>;
+
+    private:
+        struct PendingDraw {
+            GLVBODataLocation location;
+            std::optional<MaterialReference> material;
+            glm::mat4 modelMatrix;
+        };
+
+#pragma mark - Member variables
+
+        const GPUResourceController *mGPUResourceController = nullptr;
+        InstanceData mInstanceData;
+
+        std::vector<PendingDraw> mPendingDraws;
+        std::vector<uint32_t> mOrder;
+        std::vector<Batch> mBatches;
+        std::vector<glm::vec4> mInstanceTexels;
+        std::unique_ptr<InstanceBufferTexture> mInstanceBuffer;
+
+#pragma mark - Member functions
+
+        static bool SameBatch(const PendingDraw &lhs, const PendingDraw &rhs);
+
+        void upload();
+
+    public:
+
+#pragma mark - Lifecycle
+
+        DrawBatcher(const GPUResourceController *gpuResourceController, InstanceData instanceData);
+
+#pragma mark - Getters
+
+        const std::vector<Batch> &batches() const;
+
+        /**
+         @return Buffer texture holding matrices of all batched instances. Valid after build()
+         */
+        const InstanceBufferTexture &instanceBuffer() const;
+
+        /**
+         @return Number of RGBA32F texels occupied by a single instance
+         */
+        size_t texelsPerInstance() const;
+
+#pragma mark - Building
+
+        /**
+         Discards draws and batches of the previous frame
+         */
+        void clear();
+
+        /**
+         Enqueues a single sub mesh draw
+
+         @param meshID mesh the sub mesh belongs to
+         @param subMeshID sub mesh to draw
+         @param modelMatrix transformation of the instance
+         @param material draws are only batched together if their materials match
+         */
+        void add(ID meshID, ID subMeshID, const glm::mat4 &modelMatrix, const std::optional<MaterialReference> &material = std::nullopt);
+
+        /**
+         Groups enqueued draws into batches and uploads instance matrices to the GPU
+         */
+        void build();
+    };
+
+}
+
+#endif /* DrawBatcher_hpp */
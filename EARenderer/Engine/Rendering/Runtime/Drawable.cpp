@@ -43,11 +43,22 @@ namespace EARenderer {
             }
 
             void TriangleMesh::Draw(const GLVBODataLocation &location) {
-                glDrawArrays(GL_TRIANGLES, location.offset, static_cast<GLsizei>(location.vertexCount));
+                if (location.indexCount) {
+                    glDrawElementsBaseVertex(GL_TRIANGLES, static_cast<GLsizei>(location.indexCount), GL_UNSIGNED_INT,
+                            reinterpret_cast<void *>(location.indexOffset * sizeof(GLuint)), static_cast<GLint>(location.offset));
+                } else {
+                    glDrawArrays(GL_TRIANGLES, location.offset, static_cast<GLsizei>(location.vertexCount));
+                }
             }
 
             void TriangleMesh::DrawInstanced(size_t instanceCount, const GLVBODataLocation &location) {
-                glDrawArraysInstanced(GL_TRIANGLES, location.offset, static_cast<GLsizei>(location.vertexCount), static_cast<GLsizei>(instanceCount));
+                if (location.indexCount) {
+                    glDrawElementsInstancedBaseVertex(GL_TRIANGLES, static_cast<GLsizei>(location.indexCount), GL_UNSIGNED_INT,
+                            reinterpret_cast<void *>(location.indexOffset * sizeof(GLuint)), static_cast<GLsizei>(instanceCount),
+                            static_cast<GLint>(location.offset));
+                } else {
+                    glDrawArraysInstanced(GL_TRIANGLES, location.offset, static_cast<GLsizei>(location.vertexCount), static_cast<GLsizei>(instanceCount));
+                }
             }
 
         }
@@ -100,7 +100,10 @@ namespace EARenderer {
         mSurfelLightingShader.setLightType(LightType::Point);
 
         for (ID lightID : mScene->pointLights()) {
-            const PointLight &light = mScene->pointLights()[lightID];
+            // Surfel lighting is shadowed, lights without a shadow map don't contribute to GI
+            if (!mShadowMapper->hasShadowMapForPointLight(lightID)) {
+                continue;
+            }
 
             mSurfelLightingShader.setUniformBuffer(
                     ctcrc32("PointLightUBO"),
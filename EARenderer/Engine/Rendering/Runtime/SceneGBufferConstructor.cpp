@@ -8,6 +8,7 @@
 
 #include "SceneGBufferConstructor.hpp"
 #include "Drawable.hpp"
+#include "Profiler.hpp"
 
 namespace EARenderer {
 
@@ -24,7 +25,9 @@ namespace EARenderer {
             mGPUResourceController(gpuResourceController),
             mFramebuffer(settings.displayedFrameResolution),
             mDepthRenderbuffer(settings.displayedFrameResolution),
-            mGBuffer(std::make_unique<SceneGBuffer>(settings.displayedFrameResolution)) {
+            mGBuffer(std::make_unique<SceneGBuffer>(settings.displayedFrameResolution)),
+            mCuller(scene, resourceStorage),
+            mBatcher(gpuResourceController, DrawBatcher::InstanceData::ModelAndNormalMatrices) {
 
         mFramebuffer.attachTexture(mGBuffer->materialData);
         mFramebuffer.attachTexture(mGBuffer->HiZBuffer);
@@ -40,6 +43,10 @@ namespace EARenderer {
         return mGBuffer.get();
     }
 
+    const VisibilityCuller::Statistics &SceneGBufferConstructor::cullingStatistics() const {
+        return mVisibleSet.statistics;
+    }
+
     void SceneGBufferConstructor::setRenderingSettings(const RenderingSettings &settings) {
         mSettings = settings;
     }
@@ -63,63 +70,85 @@ namespace EARenderer {
 
         mGPUResourceController->meshVAO()->bind();
 
-        for (ID instanceID : mScene->meshInstances()) {
-            auto &instance = mScene->meshInstances()[instanceID];
-            renderMeshInstance(instance);
+        {
+            Profiler::Scope scope("Culling");
+            mCuller.updateBounds();
+            mCuller.cullForCamera(*mScene->camera(), mVisibleSet);
         }
 
-        for (ID lightID : mScene->pointLights()) {
-            const PointLight &light = mScene->pointLights()[lightID];
+        {
+            Profiler::Scope scope("Batching");
 
-            if (!light.isEnabled()) {
-                continue;
+            mBatcher.clear();
+
+            for (auto &item : mVisibleSet.items) {
+                auto &instance = mScene->meshInstances()[item.meshInstanceID];
+                mBatcher.add(instance.meshID(), item.subMeshID, instance.transformation().modelMatrix(), MaterialReferenceForSubMesh(instance, item.subMeshID));
             }
 
-            if (light.meshInstance) {
-                Transformation lightBaseTransform(glm::vec3(1.0), light.position(), glm::quat());
-                renderMeshInstance(*light.meshInstance, &lightBaseTransform);
+            for (ID lightID : mScene->pointLights()) {
+                const PointLight &light = mScene->pointLights()[lightID];
+
+                if (!light.isEnabled()) {
+                    continue;
+                }
+
+                if (light.meshInstance) {
+                    Transformation lightBaseTransform(glm::vec3(1.0), light.position(), glm::quat());
+                    enqueueMeshInstance(*light.meshInstance, light.meshInstance->transformation().combinedWith(lightBaseTransform).modelMatrix());
+                }
             }
+
+            mBatcher.build();
         }
-    }
 
-    void SceneGBufferConstructor::renderMeshInstance(const MeshInstance &instance, const Transformation *baseTransform) {
-        auto &subMeshes = mResourceStorage->mesh(instance.meshID()).subMeshes();
+        Profiler::Scope scope("Draw submission");
 
-        if (baseTransform) {
-            mGBufferShader.setModelMatrix(instance.transformation().combinedWith(*baseTransform).modelMatrix());
-        } else {
-            mGBufferShader.setModelMatrix(instance.transformation().modelMatrix());
+        // One instanced draw per unique sub mesh and material pair
+        for (auto &batch : mBatcher.batches()) {
+            setMaterial(batch.material);
+            mGBufferShader.setBaseInstance(batch.command.baseInstance);
+            Drawable::TriangleMesh::DrawInstanced(batch.command.instanceCount, batch.location);
         }
+    }
 
-        for (ID subMeshID : subMeshes) {
-            auto &subMesh = subMeshes[subMeshID];
+    std::optional<MaterialReference> SceneGBufferConstructor::MaterialReferenceForSubMesh(const MeshInstance &instance, ID subMeshID) {
+        if (instance.materialReference) {
+            return instance.materialReference;
+        }
+        return instance.materialReferenceForSubMeshID(subMeshID);
+    }
 
-            mGBufferShader.ensureSamplerValidity([&] {
-                auto materialRef = instance.materialReference;
+    void SceneGBufferConstructor::enqueueMeshInstance(const MeshInstance &instance, const glm::mat4 &modelMatrix) {
+        auto &subMeshes = mResourceStorage->mesh(instance.meshID()).subMeshes();
 
-                if (!materialRef) {
-                    materialRef = instance.materialReferenceForSubMeshID(subMeshID);
-                }
+        for (ID subMeshID : subMeshes) {
+            mBatcher.add(instance.meshID(), subMeshID, modelMatrix, MaterialReferenceForSubMesh(instance, subMeshID));
+        }
+    }
 
-                if (!materialRef) {
-                    return;
-                }
+    void SceneGBufferConstructor::setMaterial(const std::optional<MaterialReference> &materialRef) {
+        mGBufferShader.ensureSamplerValidity([&] {
+            mGBufferShader.setInstanceMatrices(mBatcher.instanceBuffer());
 
-                switch (materialRef->first) {
-                    case MaterialType::CookTorrance:
-                        mGBufferShader.setMaterial(mResourceStorage->cookTorranceMaterial(materialRef->second));
-                        break;
-                    case MaterialType::Emissive:
-                        mGBufferShader.setMaterial(mResourceStorage->emissiveMaterial(materialRef->second));
-                        break;
-                }
-            });
+            if (!materialRef) {
+                return;
+            }
 
-            Drawable::TriangleMesh::Draw(mGPUResourceController->subMeshVBODataLocation(instance.meshID(), subMeshID));
-        }
+            switch (materialRef->first) {
+                case MaterialType::CookTorrance:
+                    mGBufferShader.setMaterial(mResourceStorage->cookTorranceMaterial(materialRef->second));
+                    break;
+                case MaterialType::Emissive:
+                    mGBufferShader.setMaterial(mResourceStorage->emissiveMaterial(materialRef->second));
+                    break;
+            }
+        });
     }
 
     void SceneGBufferConstructor::generateHiZBuffer() {
+        Profiler::Scope scope("HiZ buffer");
+
         // Disable depth writes to not pollute depth buffer with HIZ buffer quads
         glDepthMask(GL_FALSE);
 
@@ -150,6 +179,7 @@ namespace EARenderer {
 #pragma mark - Public Interface
 
     void SceneGBufferConstructor::render() {
+        Profiler::Scope scope("G-buffer");
         generateGBuffer();
 //        generateHiZBuffer();
     }
@@ -17,6 +17,8 @@
 #include "GLSLHiZBuffer.hpp"
 #include "RenderingSettings.hpp"
 #include "SceneGBuffer.hpp"
+#include "VisibilityCuller.hpp"
+#include "DrawBatcher.hpp"
 
 #include <memory>
 #include "GPUResourceController.hpp"
@@ -38,9 +40,17 @@ namespace EARenderer {
 
         std::unique_ptr<SceneGBuffer> mGBuffer;
 
+        VisibilityCuller mCuller;
+        VisibilityCuller::VisibleSet mVisibleSet;
+        DrawBatcher mBatcher;
+
+        static std::optional<MaterialReference> MaterialReferenceForSubMesh(const MeshInstance &instance, ID subMeshID);
+
         void generateGBuffer();
 
-        void renderMeshInstance(const MeshInstance &instance, const Transformation *baseTransform = nullptr);
+        void setMaterial(const std::optional<MaterialReference> &materialRef);
+
+        void enqueueMeshInstance(const MeshInstance &instance, const glm::mat4 &modelMatrix);
 
         void generateHiZBuffer();
 
@@ -54,6 +64,11 @@ namespace EARenderer {
 
         const SceneGBuffer *GBuffer() const;
 
+        /**
+         @return Sub mesh culling counters of the last rendered frame
+         */
+        const VisibilityCuller::Statistics &cullingStatistics() const;
+
         void setRenderingSettings(const RenderingSettings &settings);
 
         void render();
@@ -34,9 +34,16 @@ namespace EARenderer {
             mDirectionalPenumbra(mSettings.penumbraResolution),
             mDirectionalShadowMapArray(mSettings.directionalShadowMapResolution, std::min(cascadeCount, MaximumCascadeCount), Sampling::ComparisonMode::ReferenceToTexture),
             mBlurEffect(&mPenumbraFramebuffer, &mTexturePool),
-            mBilinearSampler(Sampling::Filter::Bilinear, Sampling::WrapMode::ClampToEdge, Sampling::ComparisonMode::None) {
+            mBilinearSampler(Sampling::Filter::Bilinear, Sampling::WrapMode::ClampToEdge, Sampling::ComparisonMode::None),
+            mCuller(scene, resourceStorage),
+            mBatcher(gpuResourceController, DrawBatcher::InstanceData::ModelMatrix) {
 
         for (ID pointLightID : scene->pointLights()) {
+            // Cubemaps for hundreds of unshadowed lights would exhaust video memory
+            if (!scene->pointLights()[pointLightID].castsShadows()) {
+                continue;
+            }
+
             mOmnidirectionalPenumbras.emplace(
                     std::piecewise_construct,
                     std::forward_as_tuple(pointLightID),
@@ -62,6 +69,18 @@ namespace EARenderer {
         return mShadowCascades;
     }
 
+    const VisibilityCuller::Statistics &ShadowMapper::directionalCullingStatistics() const {
+        return mDirectionalCullingStatistics;
+    }
+
+    const VisibilityCuller::Statistics &ShadowMapper::omnidirectionalCullingStatistics() const {
+        return mOmnidirectionalCullingStatistics;
+    }
+
+    bool ShadowMapper::hasShadowMapForPointLight(ID pointLightID) const {
+        return mOmnidirectionalShadowMaps.find(pointLightID) != mOmnidirectionalShadowMaps.end();
+    }
+
     const GLDepthTextureCubemap &ShadowMapper::shadowMapForPointLight(ID pointLightID) const {
         auto it = mOmnidirectionalShadowMaps.find(pointLightID);
         if (it == mOmnidirectionalShadowMaps.end()) {
@@ -88,7 +107,31 @@ namespace EARenderer {
 
 #pragma mark - Private Helpers
 
+    void ShadowMapper::drawVisibleSet(size_t viewCount) {
+        // Layered rendering draws every sub mesh into all views at once,
+        // so sub meshes visible in at least one view are drawn into all of them
+        mBatcher.clear();
+
+        for (auto &item : mVisibleSet.items) {
+            const auto &instance = mScene->meshInstances()[item.meshInstanceID];
+            mBatcher.add(instance.meshID(), item.subMeshID, instance.transformation().modelMatrix());
+        }
+
+        mBatcher.build();
+
+        mShadowMapShader.setInstanceMatrices(mBatcher.instanceBuffer());
+        mShadowMapShader.setLayerCount(viewCount);
+
+        // Every batch instance is expanded into viewCount GL instances, one per layer
+        for (auto &batch : mBatcher.batches()) {
+            mShadowMapShader.setBaseInstance(batch.command.baseInstance);
+            Drawable::TriangleMesh::DrawInstanced(batch.command.instanceCount * viewCount, batch.location);
+        }
+    }
+
     void ShadowMapper::renderDirectionalShadowMaps() {
+        mDirectionalCullingStatistics = VisibilityCuller::Statistics();
+
         if (!mScene->sun().isEnabled()) {
             return;
         }
@@ -101,21 +144,15 @@ namespace EARenderer {
         GLViewport(mSettings.directionalShadowMapResolution).apply();
         mShadowFramebuffer.clear(GLFramebuffer::UnderlyingBuffer::Depth);
 
-        for (ID meshInstanceID : mScene->meshInstances()) {
-            const auto &instance = mScene->meshInstances()[meshInstanceID];
-            const auto &subMeshes = mResourceStorage->mesh(instance.meshID()).subMeshes();
+        mCuller.cullForCascades(mShadowCascades, mVisibleSet);
+        mDirectionalCullingStatistics = mVisibleSet.statistics;
 
-            mShadowMapShader.setModelMatrix(instance.transformation().modelMatrix());
-
-            for (ID subMeshID : subMeshes) {
-                const auto &subMesh = subMeshes[subMeshID];
-                const auto &location = mGPUResourceController->subMeshVBODataLocation(instance.meshID(), subMeshID);
-                Drawable::TriangleMesh::DrawInstanced(mShadowCascades.amount, location);
-            }
-        }
+        drawVisibleSet(mShadowCascades.amount);
     }
 
     void ShadowMapper::renderOmnidirectionalShadowMaps() {
+        mOmnidirectionalCullingStatistics = VisibilityCuller::Statistics();
+
         mShadowMapShader.bind();
 
         mShadowFramebuffer.bind();
@@ -125,7 +162,7 @@ namespace EARenderer {
             // Setup 6 view-projection matrices to capture geometry from 6 perspectives
             const PointLight &light = mScene->pointLights()[pointLightID];
 
-            if (!light.isEnabled()) {
+            if (!light.isEnabled() || !light.castsShadows() || !hasShadowMapForPointLight(pointLightID)) {
                 continue;
             }
 
@@ -135,18 +172,11 @@ namespace EARenderer {
             auto matrices = light.viewProjectionMatrices();
             mShadowMapShader.setViewProjectionMatrices({matrices.begin(), matrices.end()});
 
-            for (ID meshInstanceID : mScene->meshInstances()) {
-                auto &instance = mScene->meshInstances()[meshInstanceID];
-                auto &subMeshes = mResourceStorage->mesh(instance.meshID()).subMeshes();
-
-                mShadowMapShader.setModelMatrix(instance.transformation().modelMatrix());
+            mCuller.cullForPointLight(light, mVisibleSet);
+            mOmnidirectionalCullingStatistics.visibleCount += mVisibleSet.statistics.visibleCount;
+            mOmnidirectionalCullingStatistics.culledCount += mVisibleSet.statistics.culledCount;
 
-                for (ID subMeshID : subMeshes) {
-                    const auto &subMesh = subMeshes[subMeshID];
-                    const auto &location = mGPUResourceController->subMeshVBODataLocation(instance.meshID(), subMeshID);
-                    Drawable::TriangleMesh::DrawInstanced(6, location); // 6 for 6 cubemap faces
-                }
-            }
+            drawVisibleSet(6); // 6 for 6 cubemap faces
         }
     }
 
@@ -176,7 +206,7 @@ namespace EARenderer {
         for (ID lightID : mScene->pointLights()) {
             const PointLight &light = mScene->pointLights()[lightID];
 
-            if (!light.isEnabled()) {
+            if (!light.isEnabled() || !light.castsShadows() || !hasShadowMapForPointLight(lightID)) {
                 continue;
             }
 
@@ -210,6 +240,7 @@ namespace EARenderer {
     void ShadowMapper::render() {
         mGPUResourceController->meshVAO()->bind();
         mShadowCascades = mScene->sun().cascadesForBoundingBox(mScene->boundingBox(), mCascadeCount);
+        mCuller.updateBounds();
 //        mShadowCascades = mScene->sun().cascadesForCamera(*mScene->camera(), 1);
 
         renderOmnidirectionalShadowMaps();
@@ -22,6 +22,8 @@
 #include "GLSLDirectionalPenumbra.hpp"
 #include "GLSLOmnidirectionalPenumbra.hpp"
 #include "GaussianBlurEffect.hpp"
+#include "VisibilityCuller.hpp"
+#include "DrawBatcher.hpp"
 
 #include <memory>
 #include <unordered_map>
@@ -60,6 +62,14 @@ namespace EARenderer {
         GaussianBlurEffect mBlurEffect;
         GLSampler mBilinearSampler;
 
+        VisibilityCuller mCuller;
+        VisibilityCuller::VisibleSet mVisibleSet;
+        VisibilityCuller::Statistics mDirectionalCullingStatistics;
+        VisibilityCuller::Statistics mOmnidirectionalCullingStatistics;
+        DrawBatcher mBatcher;
+
+        void drawVisibleSet(size_t viewCount);
+
         void renderDirectionalPenumbra();
 
         void renderOmnidirectionalPenumbras();
@@ -83,12 +93,27 @@ namespace EARenderer {
 
         const GLFloatTexture2D<GLTexture::Float::R16F> &directionalPenumbra() const;
 
+        /**
+         @return false for lights that didn't cast shadows when the mapper was created
+         */
+        bool hasShadowMapForPointLight(ID pointLightID) const;
+
         const GLDepthTextureCubemap &shadowMapForPointLight(ID pointLightID) const;
 
         const GLFloatTexture2D<GLTexture::Float::R16F> &penumbraForPointLight(ID pointLightID) const;
 
         const FrustumCascades &cascades() const;
 
+        /**
+         @return Sub mesh culling counters of the last directional shadow map rendering
+         */
+        const VisibilityCuller::Statistics &directionalCullingStatistics() const;
+
+        /**
+         @return Sub mesh culling counters of the last omnidirectional shadow maps rendering, summed over all point lights
+         */
+        const VisibilityCuller::Statistics &omnidirectionalCullingStatistics() const;
+
         void render();
     };
 
@@ -0,0 +1,220 @@
+//
+//  VisibilityCuller.cpp
+//  EARenderer
+//
+//  Created by Pavlo Muratov on 17.10.2026.
+//  Copyright © 2026 MPO. All rights reserved.
+//
+
+#include "VisibilityCuller.hpp"
+#include "ThreadPool.hpp"
+#include "StringUtils.hpp"
+
+#include <algorithm>
+#include <glm/mat3x3.hpp>
+
+namespace EARenderer {
+
+#pragma mark - Bounds
+
+    void VisibilityCuller::Bounds::resize(size_t size) {
+        minX.resize(size);
+        minY.resize(size);
+        minZ.resize(size);
+        maxX.resize(size);
+        maxY.resize(size);
+        maxZ.resize(size);
+    }
+
+    void VisibilityCuller::Bounds::set(size_t index, const glm::vec3 &min, const glm::vec3 &max) {
+        minX[index] = min.x;
+        minY[index] = min.y;
+        minZ[index] = min.z;
+        maxX[index] = max.x;
+        maxY[index] = max.y;
+        maxZ[index] = max.z;
+    }
+
+#pragma mark - Lifecycle
+
+    VisibilityCuller::VisibilityCuller(const Scene *scene, const SharedResourceStorage *resourceStorage)
+            :
+            mScene(scene),
+            mResourceStorage(resourceStorage) {
+    }
+
+#pragma mark - Getters
+
+    bool VisibilityCuller::isMultithreadingEnabled() const {
+        return mMultithreadingEnabled;
+    }
+
+#pragma mark - Setters
+
+    void VisibilityCuller::setMultithreadingEnabled(bool enabled) {
+        mMultithreadingEnabled = enabled;
+    }
+
+#pragma mark - Private helpers
+
+    std::array<glm::vec4, 6> VisibilityCuller::FrustumPlanes(const glm::mat4 &viewProjection) {
+        // Gribb & Hartmann, Fast Extraction of Viewing Frustum Planes from the World-View-Projection Matrix
+        auto row = [&](int32_t i) {
+            return glm::vec4(viewProjection[0][i], viewProjection[1][i], viewProjection[2][i], viewProjection[3][i]);
+        };
+
+        return {
+                row(3) + row(0), row(3) - row(0),
+                row(3) + row(1), row(3) - row(1),
+                row(3) + row(2), row(3) - row(2)
+        };
+    }
+
+    void VisibilityCuller::cullRange(const std::vector<std::array<glm::vec4, 6>> &views, const BoundingSphere *sphere, size_t begin, size_t end,
+                                     std::vector<uint32_t> &viewMasks) const {
+        size_t count = end - begin;
+
+        const float *minX = mBounds.minX.data() + begin;
+        const float *minY = mBounds.minY.data() + begin;
+        const float *minZ = mBounds.minZ.data() + begin;
+        const float *maxX = mBounds.maxX.data() + begin;
+        const float *maxY = mBounds.maxY.data() + begin;
+        const float *maxZ = mBounds.maxZ.data() + begin;
+
+        std::array<uint8_t, ItemsPerTask> inVolume;
+        std::array<uint8_t, ItemsPerTask> visible;
+        std::fill(inVolume.begin(), inVolume.begin() + count, 1);
+
+        if (sphere) {
+            glm::vec3 c = sphere->center;
+            float radius2 = sphere->radius * sphere->radius;
+
+            for (size_t i = 0; i < count; i++) {
+                float dx = std::max(std::max(minX[i] - c.x, c.x - maxX[i]), 0.0f);
+                float dy = std::max(std::max(minY[i] - c.y, c.y - maxY[i]), 0.0f);
+                float dz = std::max(std::max(minZ[i] - c.z, c.z - maxZ[i]), 0.0f);
+                inVolume[i] = dx * dx + dy * dy + dz * dz <= radius2;
+            }
+        }
+
+        uint32_t *masks = viewMasks.data() + begin;
+        std::fill(masks, masks + count, 0);
+
+        for (size_t view = 0; view < views.size(); view++) {
+            std::copy(inVolume.begin(), inVolume.begin() + count, visible.begin());
+
+            for (const glm::vec4 &plane : views[view]) {
+                // Box is outside if its corner lying furthest along plane's normal is behind the plane
+                const float *xs = plane.x >= 0.0f ? maxX : minX;
+                const float *ys = plane.y >= 0.0f ? maxY : minY;
+                const float *zs = plane.z >= 0.0f ? maxZ : minZ;
+
+                for (size_t i = 0; i < count; i++) {
+                    visible[i] &= plane.x * xs[i] + plane.y * ys[i] + plane.z * zs[i] + plane.w >= 0.0f;
+                }
+            }
+
+            for (size_t i = 0; i < count; i++) {
+                masks[i] |= uint32_t(visible[i]) << view;
+            }
+        }
+    }
+
+    void VisibilityCuller::cull(const std::vector<glm::mat4> &viewProjections, const BoundingSphere *sphere, VisibleSet &visibleSet) const {
+        if (viewProjections.size() > MaximumViewCount) {
+            throw std::invalid_argument(string_format("Culling supports up to %zu views at once", MaximumViewCount));
+        }
+
+        std::vector<std::array<glm::vec4, 6>> views;
+        for (auto &viewProjection : viewProjections) {
+            views.push_back(FrustumPlanes(viewProjection));
+        }
+
+        std::vector<uint32_t> &viewMasks = visibleSet.viewMasks;
+        viewMasks.resize(mItems.size());
+
+        if (mMultithreadingEnabled && mItems.size() > ItemsPerTask) {
+            ThreadPool::Default().parallelFor(0, mItems.size(), ItemsPerTask, [&](size_t begin, size_t end) {
+                cullRange(views, sphere, begin, end, viewMasks);
+            });
+        } else {
+            for (size_t begin = 0; begin < mItems.size(); begin += ItemsPerTask) {
+                cullRange(views, sphere, begin, std::min(begin + ItemsPerTask, mItems.size()), viewMasks);
+            }
+        }
+
+        visibleSet.items.clear();
+
+        for (size_t i = 0; i < mItems.size(); i++) {
+            if (viewMasks[i]) {
+                visibleSet.items.push_back(mItems[i]);
+                visibleSet.items.back().viewMask = viewMasks[i];
+            }
+        }
+
+        visibleSet.statistics.visibleCount = visibleSet.items.size();
+        visibleSet.statistics.culledCount = mItems.size() - visibleSet.items.size();
+    }
+
+#pragma mark - Culling
+
+    void VisibilityCuller::updateBounds() {
+        const auto &meshInstances = mScene->meshInstances();
+
+        // Every instance gets its own range of items, so that instances can be processed independently
+        std::vector<size_t> firstItemIndices(meshInstances.size() + 1, 0);
+        for (size_t i = 0; i < meshInstances.size(); i++) {
+            const auto &subMeshes = mResourceStorage->mesh(meshInstances.objectAt(i).meshID()).subMeshes();
+            firstItemIndices[i + 1] = firstItemIndices[i] + subMeshes.size();
+        }
+
+        mBounds.resize(firstItemIndices.back());
+        mItems.resize(firstItemIndices.back());
+
+        auto updateRange = [&](size_t begin, size_t end) {
+            for (size_t i = begin; i < end; i++) {
+                const auto &instance = meshInstances.objectAt(i);
+                const auto &subMeshes = mResourceStorage->mesh(instance.meshID()).subMeshes();
+
+                // Transform boxes by center and extents to keep them tight under rotation
+                glm::mat4 modelMatrix = instance.transformation().modelMatrix();
+                glm::mat3 absoluteLinearPart(glm::abs(glm::vec3(modelMatrix[0])),
+                        glm::abs(glm::vec3(modelMatrix[1])),
+                        glm::abs(glm::vec3(modelMatrix[2])));
+
+                size_t itemIndex = firstItemIndices[i];
+
+                for (ID subMeshID : subMeshes) {
+                    const AxisAlignedBox3D &box = subMeshes[subMeshID].boundingBox();
+                    glm::vec3 center(modelMatrix * glm::vec4(box.center(), 1.0));
+                    glm::vec3 extents = absoluteLinearPart * ((box.max - box.min) * 0.5f);
+
+                    mBounds.set(itemIndex, center - extents, center + extents);
+                    mItems[itemIndex] = {meshInstances.idAt(i), subMeshID, 0};
+                    itemIndex++;
+                }
+            }
+        };
+
+        if (mMultithreadingEnabled) {
+            meshInstances.parallelForEachRange(updateRange);
+        } else {
+            updateRange(0, meshInstances.size());
+        }
+    }
+
+    void VisibilityCuller::cullForCamera(const Camera &camera, VisibleSet &visibleSet) const {
+        cull({camera.viewProjectionMatrix()}, nullptr, visibleSet);
+    }
+
+    void VisibilityCuller::cullForCascades(const FrustumCascades &cascades, VisibleSet &visibleSet) const {
+        cull(cascades.lightViewProjections, nullptr, visibleSet);
+    }
+
+    void VisibilityCuller::cullForPointLight(const PointLight &light, VisibleSet &visibleSet) const {
+        auto matrices = light.viewProjectionMatrices();
+        BoundingSphere sphere{light.position(), light.farClipPlane()};
+        cull({matrices.begin(), matrices.end()}, &sphere, visibleSet);
+    }
+
+}
@@ -0,0 +1,146 @@
+//
+//  VisibilityCuller.hpp
+//  EARenderer
+//
+//  Created by Pavlo Muratov on 17.10.2026.
+//  Copyright © 2026 MPO. All rights reserved.
+//
+
+#ifndef VisibilityCuller_hpp
+#define VisibilityCuller_hpp
+
+#include "Scene.hpp"
+#include "SharedResourceStorage.hpp"
+#include "FrustumCascades.hpp"
+#include "PointLight.hpp"
+#include "Camera.hpp"
+
+#include <vector>
+#include <glm/mat4x4.hpp>
+#include <glm/vec4.hpp>
+
+namespace EARenderer {
+
+    // Culls sub meshes of scene's mesh instances against camera frustum,
+    // directional shadow cascades and point light volumes.
+    //
+    // World space bounding boxes are stored as a structure of arrays, and every frustum plane
+    // is tested against a whole range of boxes at once in a branchless loop which compilers
+    // are able to vectorize. Large scenes are split into ranges culled by ThreadPool workers.
+
+    class VisibilityCuller {
+    public:
+
+#pragma mark - Nested types
+
+        struct DrawItem {
+            ID meshInstanceID = 0;
+            ID subMeshID = 0;
+
+            /// Bit per view (cascade or cube face) in which the sub mesh is visible
+            uint32_t viewMask = 0;
+        };
+
+        struct Statistics {
+            size_t visibleCount = 0;
+            size_t culledCount = 0;
+        };
+
+        /**
+         Sub meshes that passed culling, in the order of mesh instances and their sub meshes
+         */
+        struct VisibleSet {
+            std::vector<DrawItem> items;
+            Statistics statistics;
+
+            /// Per-query scratch, kept with the set so that concurrent queries don't share it
+            std::vector<uint32_t> viewMasks;
+        };
+
+    private:
+        struct Bounds {
+            std::vector<float> minX, minY, minZ;
+            std::vector<float> maxX, maxY, maxZ;
+
+            void resize(size_t size);
+
+            void set(size_t index, const glm::vec3 &min, const glm::vec3 &max);
+        };
+
+        struct BoundingSphere {
+            glm::vec3 center;
+            float radius;
+        };
+
+#pragma mark - Member variables
+
+        static constexpr size_t MaximumViewCount = 32;
+        static constexpr size_t ItemsPerTask = 1024;
+
+        const Scene *mScene = nullptr;
+        const SharedResourceStorage *mResourceStorage = nullptr;
+        bool mMultithreadingEnabled = true;
+
+        Bounds mBounds;
+        std::vector<DrawItem> mItems;
+
+#pragma mark - Member functions
+
+        /**
+         Extracts 6 clip planes from a view-projection matrix. Planes point inwards.
+         */
+        static std::array<glm::vec4, 6> FrustumPlanes(const glm::mat4 &viewProjection);
+
+        /**
+         Computes view masks for a range of bounding boxes
+
+         @param views Frustum planes of every view
+         @param sphere Optional sphere boxes must intersect to be visible in any view
+         @param begin First box of the range
+         @param end Box past the last one in the range
+         @param viewMasks Masks of all boxes, only the range is written
+         */
+        void cullRange(const std::vector<std::array<glm::vec4, 6>> &views, const BoundingSphere *sphere, size_t begin, size_t end,
+                       std::vector<uint32_t> &viewMasks) const;
+
+        void cull(const std::vector<glm::mat4> &viewProjections, const BoundingSphere *sphere, VisibleSet &visibleSet) const;
+
+    public:
+
+#pragma mark - Lifecycle
+
+        VisibilityCuller(const Scene *scene, const SharedResourceStorage *resourceStorage);
+
+#pragma mark - Getters
+
+        bool isMultithreadingEnabled() const;
+
+#pragma mark - Setters
+
+        void setMultithreadingEnabled(bool enabled);
+
+#pragma mark - Culling
+
+        /**
+         Recomputes world space bounding boxes of all sub meshes of all mesh instances.
+         Has to be called whenever instances move, before any culling queries.
+         Chunks of scene's mesh instance table are processed in parallel.
+         */
+        void updateBounds();
+
+        void cullForCamera(const Camera &camera, VisibleSet &visibleSet) const;
+
+        /**
+         Culls against every cascade, items visible in at least one cascade are emitted
+         */
+        void cullForCascades(const FrustumCascades &cascades, VisibleSet &visibleSet) const;
+
+        /**
+         Culls against light's radius and its 6 cube faces
+         */
+        void cullForPointLight(const PointLight &light, VisibleSet &visibleSet) const;
+    };
+
+}
+
+#endif /* VisibilityCuller_hpp */
@@ -0,0 +1,253 @@
+//
+//  CompressedImage.cpp
+//  EARenderer
+//
+//  Created by Pavlo Muratov on 17.10.2026.
+//  Copyright © 2026 MPO. All rights reserved.
+//
+
+#include "CompressedImage.hpp"
+#include "CRC32.hpp"
+#include "StringUtils.hpp"
+
+#include <algorithm>
+#include <stdexcept>
+#include <sys/stat.h>
+
+#include "stb_image.h"
+
+namespace EARenderer {
+
+    static constexpr uint32_t CompressedImageContentTag = ctcrc32("CompressedImage");
+    static constexpr uint32_t ImageRecordSectionTag = ctcrc32("ImageRecord");
+    static constexpr uint32_t MipLevelsSectionTag = ctcrc32("MipLevels");
+    static constexpr uint32_t BlocksSectionTag = ctcrc32("Blocks");
+
+    /// Bumped whenever mip filtering or block encoding changes, so that stale compiled images are rebuilt
+    static constexpr uint32_t CompressedImageFormatVersion = 2;
+
+    const std::string CompressedImage::CompiledFileSuffix = ".eatex";
+
+    struct CompressedImageRecord {
+        uint32_t formatVersion;
+
+        /// CRC32 of the record itself, computed with this field zeroed, followed by mip levels and blocks
+        uint32_t payloadChecksum;
+        uint64_t sourceFileSize;
+        int64_t sourceModificationTime;
+        uint32_t blockFormat;
+        uint32_t levelCount;
+    };
+
+    static bool SourceFileStamp(const std::string &filePath, uint64_t &size, int64_t &modificationTime) {
+        struct stat fileStatus;
+        if (stat(filePath.c_str(), &fileStatus) != 0) {
+            return false;
+        }
+        size = static_cast<uint64_t>(fileStatus.st_size);
+        modificationTime = static_cast<int64_t>(fileStatus.st_mtime);
+        return true;
+    }
+
+    static const char *FormatName(BlockCompressor::Format format) {
+        switch (format) {
+            case BlockCompressor::Format::BC1:
+                return "bc1";
+            case BlockCompressor::Format::BC3:
+                return "bc3";
+            case BlockCompressor::Format::BC4:
+                return "bc4";
+            case BlockCompressor::Format::BC5:
+                return "bc5";
+        }
+        throw std::invalid_argument("Unknown block compression format");
+    }
+
+#pragma mark - Lifecycle
+
+    CompressedImage::CompressedImage(const std::string &imagePath, BlockCompressor::Format format)
+            :
+            mFormat(format) {
+        std::string compiledFilePath = CompiledFilePath(imagePath, format);
+
+        if (!loadCompiled(compiledFilePath, imagePath)) {
+            compileSource(imagePath);
+
+            try {
+                writeCompiled(compiledFilePath, imagePath);
+            } catch (const std::runtime_error &) {
+                // Source directory may be read-only, image will just be compiled again next time
+            }
+        }
+    }
+
+#pragma mark - Mip levels
+
+    std::vector<uint8_t> CompressedImage::Downsample(const std::vector<uint8_t> &rgbaTexels, uint32_t width, uint32_t height) {
+        uint32_t halfWidth = std::max(width / 2, 1u);
+        uint32_t halfHeight = std::max(height / 2, 1u);
+        std::vector<uint8_t> halfTexels(size_t(halfWidth) * halfHeight * 4);
+
+        for (uint32_t y = 0; y < halfHeight; y++) {
+            uint32_t y0 = std::min(y * 2, height - 1);
+            uint32_t y1 = std::min(y * 2 + 1, height - 1);
+
+            for (uint32_t x = 0; x < halfWidth; x++) {
+                uint32_t x0 = std::min(x * 2, width - 1);
+                uint32_t x1 = std::min(x * 2 + 1, width - 1);
+
+                for (size_t channel = 0; channel < 4; channel++) {
+                    uint32_t sum = rgbaTexels[(size_t(y0) * width + x0) * 4 + channel] +
+                                   rgbaTexels[(size_t(y0) * width + x1) * 4 + channel] +
+                                   rgbaTexels[(size_t(y1) * width + x0) * 4 + channel] +
+                                   rgbaTexels[(size_t(y1) * width + x1) * 4 + channel];
+                    halfTexels[(size_t(y) * halfWidth + x) * 4 + channel] = uint8_t((sum + 2) / 4);
+                }
+            }
+        }
+
+        return halfTexels;
+    }
+
+#pragma mark - Private helpers
+
+    bool CompressedImage::loadCompiled(const std::string &compiledFilePath, const std::string &sourceFilePath) {
+        uint64_t sourceSize = 0;
+        int64_t sourceModificationTime = 0;
+
+        if (!SourceFileStamp(sourceFilePath, sourceSize, sourceModificationTime) || !BakeContainer::HasSignature(compiledFilePath)) {
+            return false;
+        }
+
+        try {
+            auto container = std::make_unique<BakeContainer>(compiledFilePath, CompressedImageContentTag);
+
+            auto imageRecords = container->section<CompressedImageRecord>(ImageRecordSectionTag);
+            auto mipLevels = container->section<MipLevel>(MipLevelsSectionTag);
+            auto blocks = container->section<uint8_t>(BlocksSectionTag);
+
+            if (imageRecords.size() != 1) {
+                return false;
+            }
+
+            const CompressedImageRecord &record = *imageRecords.begin();
+
+            if (record.formatVersion != CompressedImageFormatVersion ||
+                    record.blockFormat != static_cast<uint32_t>(mFormat) ||
+                    record.levelCount != mipLevels.size() ||
+                    record.sourceFileSize != sourceSize ||
+                    record.sourceModificationTime != sourceModificationTime) {
+                return false;
+            }
+
+            CompressedImageRecord uncheckedRecord = record;
+            uncheckedRecord.payloadChecksum = 0;
+
+            uint32_t checksum = crc32(&uncheckedRecord, sizeof(CompressedImageRecord));
+            checksum = crc32(mipLevels.data(), sizeof(MipLevel) * mipLevels.size(), checksum);
+            checksum = crc32(blocks.data(), blocks.size(), checksum);
+
+            if (checksum != record.payloadChecksum) {
+                return false;
+            }
+
+            for (const MipLevel &level : mipLevels) {
+                if (level.offset + level.byteSize > blocks.size()) {
+                    return false;
+                }
+            }
+
+            mMipLevels.assign(mipLevels.begin(), mipLevels.end());
+            mBlocks = blocks.data();
+            mContainer = std::move(container);
+            return true;
+        } catch (const std::runtime_error &) {
+            return false;
+        }
+    }
+
+    void CompressedImage::compileSource(const std::string &sourceFilePath) {
+        int32_t width = 0;
+        int32_t height = 0;
+        int32_t components = 0;
+        stbi_uc *pixelData = stbi_load(sourceFilePath.c_str(), &width, &height, &components, STBI_rgb_alpha);
+
+        if (!pixelData) {
+            throw std::invalid_argument(string_format("Failed to load texture file (%s)", sourceFilePath.c_str()));
+        }
+
+        std::vector<uint8_t> texels(pixelData, pixelData + size_t(width) * height * 4);
+        stbi_image_free(pixelData);
+
+        uint32_t levelWidth = width;
+        uint32_t levelHeight = height;
+
+        while (true) {
+            auto levelBlocks = BlockCompressor::Compress(mFormat, texels.data(), levelWidth, levelHeight);
+            mMipLevels.push_back({levelWidth, levelHeight, mCompiledBlocks.size(), levelBlocks.size()});
+            mCompiledBlocks.insert(mCompiledBlocks.end(), levelBlocks.begin(), levelBlocks.end());
+
+            if (levelWidth == 1 && levelHeight == 1) {
+                break;
+            }
+
+            texels = Downsample(texels, levelWidth, levelHeight);
+            levelWidth = std::max(levelWidth / 2, 1u);
+            levelHeight = std::max(levelHeight / 2, 1u);
+        }
+
+        mBlocks = mCompiledBlocks.data();
+    }
+
+    void CompressedImage::writeCompiled(const std::string &compiledFilePath, const std::string &sourceFilePath) const {
+        CompressedImageRecord record{};
+
+        if (!SourceFileStamp(sourceFilePath, record.sourceFileSize, record.sourceModificationTime)) {
+            return;
+        }
+
+        record.formatVersion = CompressedImageFormatVersion;
+        record.blockFormat = static_cast<uint32_t>(mFormat);
+        record.levelCount = static_cast<uint32_t>(mMipLevels.size());
+
+        record.payloadChecksum = 0;
+
+        uint32_t checksum = crc32(&record, sizeof(CompressedImageRecord));
+        checksum = crc32(mMipLevels.data(), sizeof(MipLevel) * mMipLevels.size(), checksum);
+        record.payloadChecksum = crc32(mCompiledBlocks.data(), mCompiledBlocks.size(), checksum);
+
+        BakeContainer::Writer writer(CompressedImageContentTag);
+        writer.addSection(ImageRecordSectionTag, &record, sizeof(CompressedImageRecord), 1);
+        writer.addSection(MipLevelsSectionTag, mMipLevels);
+        writer.addSection(BlocksSectionTag, mCompiledBlocks);
+        writer.write(compiledFilePath);
+    }
+
+#pragma mark - Getters
+
+    std::string CompressedImage::CompiledFilePath(const std::string &imagePath, BlockCompressor::Format format) {
+        // Same image may be compiled into several formats
+        return string_format("%s.%s%s", imagePath.c_str(), FormatName(format), CompiledFileSuffix.c_str());
+    }
+
+    BlockCompressor::Format CompressedImage::format() const {
+        return mFormat;
+    }
+
+    const std::vector<CompressedImage::MipLevel> &CompressedImage::mipLevels() const {
+        return mMipLevels;
+    }
+
+    const uint8_t *CompressedImage::levelData(size_t level) const {
+        return mBlocks + mMipLevels[level].offset;
+    }
+
+    size_t CompressedImage::byteSize() const {
+        size_t size = 0;
+        for (const MipLevel &level : mMipLevels) {
+            size += level.byteSize;
+        }
+        return size;
+    }
+
+}
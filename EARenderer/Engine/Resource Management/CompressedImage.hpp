@@ -0,0 +1,98 @@
+//
+//  CompressedImage.hpp
+//  EARenderer
+//
+//  Created by Pavlo Muratov on 17.10.2026.
+//  Copyright © 2026 MPO. All rights reserved.
+//
+
+#ifndef CompressedImage_hpp
+#define CompressedImage_hpp
+
+#include "BlockCompressor.hpp"
+#include "BakeContainer.hpp"
+
+#include <string>
+#include <vector>
+#include <memory>
+
+namespace EARenderer {
+
+    // Block compressed image with a complete, pre-filtered mip chain.
+    //
+    // Compiling an image decodes it, builds box-filtered mip levels down to 1x1 and compresses every level.
+    // The result is stored next to the source file, so that subsequent launches only map the compiled
+    // file and hand its levels to OpenGL. Compiled files are rebuilt whenever the source changes.
+
+    class CompressedImage {
+    public:
+        struct MipLevel {
+            uint32_t width;
+            uint32_t height;
+            uint64_t offset;
+            uint64_t byteSize;
+        };
+
+        static const std::string CompiledFileSuffix;
+
+    private:
+        BlockCompressor::Format mFormat;
+        std::vector<MipLevel> mMipLevels;
+        std::vector<uint8_t> mCompiledBlocks;
+        std::unique_ptr<BakeContainer> mContainer;
+        const uint8_t *mBlocks = nullptr;
+
+        bool loadCompiled(const std::string &compiledFilePath, const std::string &sourceFilePath);
+
+        void compileSource(const std::string &sourceFilePath);
+
+        void writeCompiled(const std::string &compiledFilePath, const std::string &sourceFilePath) const;
+
+    public:
+        /**
+         Box filters an 8-bit RGBA image down to the next mip level, odd edges repeat their last texel
+
+         @param rgbaTexels tightly packed rows of 4-byte texels
+         @param width image width in texels
+         @param height image height in texels
+         @return texels of a max(width / 2, 1) by max(height / 2, 1) image
+         */
+        static std::vector<uint8_t> Downsample(const std::vector<uint8_t> &rgbaTexels, uint32_t width, uint32_t height);
+
+        /**
+         Maps the compiled counterpart of an image file, compiling it first if it's missing or stale.
+         Source images are decoded with stb_image, so its vertical flip setting applies.
+
+         @param imagePath path to the source image
+         @param format block compression format
+         @throws std::invalid_argument if the source image can't be decoded
+         */
+        CompressedImage(const std::string &imagePath, BlockCompressor::Format format);
+
+        CompressedImage(const CompressedImage &that) = delete;
+
+        CompressedImage &operator=(const CompressedImage &rhs) = delete;
+
+        /**
+         @return Path of the compiled file for a source image and format
+         */
+        static std::string CompiledFilePath(const std::string &imagePath, BlockCompressor::Format format);
+
+        BlockCompressor::Format format() const;
+
+        /**
+         @return Mip levels starting with the largest one
+         */
+        const std::vector<MipLevel> &mipLevels() const;
+
+        const uint8_t *levelData(size_t level) const;
+
+        /**
+         @return Total size of all levels in bytes
+         */
+        size_t byteSize() const;
+    };
+
+}
+
+#endif /* CompressedImage_hpp */
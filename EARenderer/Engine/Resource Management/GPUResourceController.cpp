@@ -25,13 +25,16 @@ namespace EARenderer {
 
     void GPUResourceController::updateMeshVAO(const SharedResourceStorage &resourceStorage) {
         std::vector<Vertex1P1N2UV1T1BT> vertices;
+        std::vector<GLuint> indices;
 
         resourceStorage.iterateMeshes([&](ID meshID) {
             const Mesh &mesh = resourceStorage.mesh(meshID);
             for (ID subMeshID : mesh.subMeshes()) {
                 const SubMesh &subMesh = mesh.subMeshes()[subMeshID];
-                mSubMeshVBODataLocations[meshID][subMeshID] = {vertices.size(), subMesh.vertices().size()};
+                mSubMeshVBODataLocations[meshID][subMeshID] = {vertices.size(), subMesh.vertices().size(), indices.size(), subMesh.indices().size()};
                 vertices.insert(vertices.end(), subMesh.vertices().begin(), subMesh.vertices().end());
+                // Indices stay relative to the sub mesh, base vertex is supplied at draw time
+                indices.insert(indices.end(), subMesh.indices().begin(), subMesh.indices().end());
             }
         });
 
@@ -44,7 +47,12 @@ namespace EARenderer {
                 GLVertexAttribute::UniqueAttribute(sizeof(glm::vec3), glm::vec3::length())
         };
 
-        mMeshVAO = std::make_unique<GLVertexArray<Vertex1P1N2UV1T1BT>>(vertices.data(), vertices.size(), attributes.data(), attributes.size());
+        if (indices.empty()) {
+            mMeshVAO = std::make_unique<GLVertexArray<Vertex1P1N2UV1T1BT>>(vertices.data(), vertices.size(), attributes.data(), attributes.size());
+        } else {
+            mMeshVAO = std::make_unique<GLVertexArray<Vertex1P1N2UV1T1BT>>(vertices.data(), vertices.size(), indices.data(), indices.size(),
+                    attributes.data(), attributes.size());
+        }
     }
 
     void GPUResourceController::updateUniformBuffer(const SharedResourceStorage &resourceStorage, const Scene &scene) {
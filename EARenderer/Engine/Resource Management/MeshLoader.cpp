@@ -8,9 +8,13 @@
 
 #include "MeshLoader.hpp"
 #include "WavefrontMeshLoader.hpp"
-#include "AutodeskMeshLoader.hpp"
 #include "StringUtils.hpp"
 
+// Autodesk FBX SDK is only set up for the Xcode build
+#ifndef EARENDERER_WITHOUT_FBX
+#include "AutodeskMeshLoader.hpp"
+#endif
+
 #include <stdexcept>
 
 namespace EARenderer {
@@ -28,7 +32,11 @@ namespace EARenderer {
         if (0 == meshPath.compare(meshPath.length() - wavefrontExtension.length(), wavefrontExtension.length(), wavefrontExtension)) {
             return std::make_shared<WavefrontMeshLoader>(meshPath);
         } else if (0 == meshPath.compare(meshPath.length() - autodeskExtension.length(), autodeskExtension.length(), autodeskExtension)) {
+#ifndef EARENDERER_WITHOUT_FBX
             return std::make_shared<AutodeskMeshLoader>(meshPath);
+#else
+            throw std::invalid_argument(string_format("FBX support isn't compiled in: %s", meshPath.c_str()));
+#endif
         } else {
             throw std::invalid_argument(string_format("Unknown file format in path: %s", meshPath.c_str()));
         }
@@ -0,0 +1,89 @@
+//
+//  TextureLoader.cpp
+//  EARenderer
+//
+//  Created by Pavlo Muratov on 17.10.2026.
+//  Copyright © 2026 MPO. All rights reserved.
+//
+
+#include "TextureLoader.hpp"
+
+namespace EARenderer {
+
+#pragma mark - Lifecycle
+
+    TextureLoader::TextureLoader() {
+        // Pool has to outlive the loader, since destroying pending futures waits for their tasks
+        ThreadPool::Default();
+    }
+
+    TextureLoader &TextureLoader::Shared() {
+        static TextureLoader loader;
+        return loader;
+    }
+
+#pragma mark - Getters
+
+    size_t TextureLoader::pendingLoadCount() const {
+        return mPendingDecodes.size();
+    }
+
+#pragma mark - Private helpers
+
+    std::unique_ptr<TextureLoader::DecodedImage> TextureLoader::Decode(const std::string &key, const std::string &imagePath, BlockCompressor::Format format, Upload upload) {
+        auto decoded = std::make_unique<DecodedImage>();
+        decoded->key = key;
+        decoded->imagePath = imagePath;
+        decoded->upload = std::move(upload);
+
+        try {
+            decoded->image = std::make_unique<CompressedImage>(imagePath, format);
+        } catch (const std::invalid_argument &) {
+            // Reported on the context thread when the image is about to be uploaded
+        }
+
+        return decoded;
+    }
+
+    void TextureLoader::enqueueDecode(const std::string &key, const std::string &imagePath, BlockCompressor::Format format, Upload upload) {
+        auto future = ThreadPool::Default().submit([this, key, imagePath, format, upload] {
+            mCompletedDecodes.push(Decode(key, imagePath, format, upload));
+        });
+
+        mPendingDecodes.emplace(key, std::move(future));
+    }
+
+    void TextureLoader::finishLoad(const DecodedImage &image) {
+        // Task has already pushed its result, so releasing the future doesn't block for long
+        mPendingDecodes.erase(image.key);
+
+        if (!image.image) {
+            mRequests.erase(image.key);
+        }
+
+        image.upload(image);
+    }
+
+#pragma mark - Loading
+
+    size_t TextureLoader::processCompletedLoads(size_t maximumCount) {
+        size_t processedCount = 0;
+        std::unique_ptr<DecodedImage> image;
+
+        while (processedCount < maximumCount && mCompletedDecodes.tryPop(image)) {
+            finishLoad(*image);
+            processedCount++;
+        }
+
+        return processedCount;
+    }
+
+    void TextureLoader::finishPendingLoads() {
+        std::unique_ptr<DecodedImage> image;
+
+        while (!mPendingDecodes.empty() && mCompletedDecodes.waitPop(image)) {
+            finishLoad(*image);
+        }
+    }
+
+}
@@ -0,0 +1,132 @@
+//
+//  TextureLoader.hpp
+//  EARenderer
+//
+//  Created by Pavlo Muratov on 17.10.2026.
+//  Copyright © 2026 MPO. All rights reserved.
+//
+
+#ifndef TextureLoader_hpp
+#define TextureLoader_hpp
+
+#include "GLTexture2D.hpp"
+#include "CompressedImage.hpp"
+#include "ThreadPool.hpp"
+#include "ThreadSafeQueue.hpp"
+
+#include <string>
+#include <memory>
+#include <functional>
+#include <limits>
+#include <unordered_map>
+
+namespace EARenderer {
+
+    // Loads LDR images without stalling the thread that owns the GL context.
+    //
+    // Image files are turned into block compressed mip chains (see CompressedImage) on ThreadPool workers.
+    // Finished images are put into a completion queue and uploaded by processCompletedLoads(),
+    // which must be called on the context thread.
+    // Requests for the same path and texture format share a single texture for as long as anybody holds it.
+
+    class TextureLoader {
+    public:
+
+#pragma mark - Nested types
+
+        template<class Texture>
+        class Request {
+        private:
+            friend TextureLoader;
+
+            std::unique_ptr<Texture> mTexture;
+
+        public:
+            /**
+             @return Loaded texture or nullptr if the image hasn't arrived yet
+             */
+            const Texture *texture() const {
+                return mTexture.get();
+            }
+
+            bool isReady() const {
+                return mTexture != nullptr;
+            }
+        };
+
+    private:
+        struct DecodedImage {
+            std::string key;
+            std::string imagePath;
+            std::unique_ptr<CompressedImage> image;
+            std::function<void(const DecodedImage &)> upload;
+        };
+
+        using Upload = std::function<void(const DecodedImage &)>;
+
+#pragma mark - Member variables
+
+        ThreadSafeQueue<std::unique_ptr<DecodedImage>> mCompletedDecodes;
+        std::unordered_map<std::string, ThreadPool::TaskFuture<void>> mPendingDecodes;
+        std::unordered_map<std::string, std::weak_ptr<void>> mRequests;
+
+#pragma mark - Member functions
+
+        TextureLoader();
+
+        static std::unique_ptr<DecodedImage> Decode(const std::string &key, const std::string &imagePath, BlockCompressor::Format format, Upload upload);
+
+        void enqueueDecode(const std::string &key, const std::string &imagePath, BlockCompressor::Format format, Upload upload);
+
+        void finishLoad(const DecodedImage &image);
+
+    public:
+
+#pragma mark - Lifecycle
+
+        static TextureLoader &Shared();
+
+        TextureLoader(const TextureLoader &that) = delete;
+
+        TextureLoader &operator=(const TextureLoader &rhs) = delete;
+
+#pragma mark - Getters
+
+        /**
+         @return Number of images that are requested but not yet turned into textures
+         */
+        size_t pendingLoadCount() const;
+
+#pragma mark - Loading
+
+        /**
+         Schedules decoding of an image file. Repeated requests for the same path and format return the same request.
+
+         @param imagePath path to the image file
+         @return request which receives the texture once the image is decoded and uploaded
+         */
+        template<GLTexture::Normalized Format>
+        std::shared_ptr<const Request<GLNormalizedTexture2D<Format>>> loadLDRImage(const std::string &imagePath);
+
+        /**
+         Creates textures for images decoded so far. Must be called on the thread owning the GL context.
+
+         @param maximumCount upper limit of textures to create, lets callers spread uploads across frames
+         @return number of textures created
+         @throws std::invalid_argument if an image file failed to decode
+         */
+        size_t processCompletedLoads(size_t maximumCount = std::numeric_limits<size_t>::max());
+
+        /**
+         Blocks until every requested image is decoded and uploaded. Must be called on the thread owning the GL context.
+
+         @throws std::invalid_argument if an image file failed to decode
+         */
+        void finishPendingLoads();
+    };
+
+}
+
+#include "TextureLoaderImpl.hpp"
+
+#endif /* TextureLoader_hpp */
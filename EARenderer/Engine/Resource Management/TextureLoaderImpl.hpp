@@ -0,0 +1,50 @@
+//
+//  TextureLoaderImpl.hpp
+//  EARenderer
+//
+//  Created by Pavlo Muratov on 17.10.2026.
+//  Copyright © 2026 MPO. All rights reserved.
+//
+
+#ifndef TextureLoaderImpl_hpp
+#define TextureLoaderImpl_hpp
+
+#include "StringUtils.hpp"
+#include "GLTextureFactory.hpp"
+
+#include <stdexcept>
+
+namespace EARenderer {
+
+#pragma mark - Loading
+
+    template<GLTexture::Normalized Format>
+    std::shared_ptr<const TextureLoader::Request<GLNormalizedTexture2D<Format>>>
+    TextureLoader::loadLDRImage(const std::string &imagePath) {
+        using Texture = GLNormalizedTexture2D<Format>;
+
+        // Same image may be requested in different formats
+        std::string key = string_format("%s#%d", imagePath.c_str(), static_cast<int>(Format));
+
+        if (auto existing = mRequests[key].lock()) {
+            return std::static_pointer_cast<const Request<Texture>>(existing);
+        }
+
+        auto request = std::make_shared<Request<Texture>>();
+        mRequests[key] = request;
+
+        // Upload keeps the request alive until the texture is delivered
+        enqueueDecode(key, imagePath, GLTextureFactory::BlockFormat(Format), [request](const DecodedImage &decoded) {
+            if (!decoded.image) {
+                throw std::invalid_argument(string_format("Failed to load texture file (%s)", decoded.imagePath.c_str()));
+            }
+
+            request->mTexture = GLTextureFactory::MakeTexture<Format>(*decoded.image);
+        });
+
+        return request;
+    }
+
+}
+
+#endif /* TextureLoaderImpl_hpp */
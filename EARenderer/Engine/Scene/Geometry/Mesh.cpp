@@ -8,24 +8,259 @@
 
 #include "Mesh.hpp"
 #include "MeshLoader.hpp"
+#include "BakeContainer.hpp"
+#include "CRC32.hpp"
+
+#include <sys/stat.h>
 
 namespace EARenderer {
 
+    static constexpr uint32_t CompiledMeshContentTag = ctcrc32("CompiledMesh");
+    static constexpr uint32_t MeshRecordSectionTag = ctcrc32("MeshRecord");
+    static constexpr uint32_t SubMeshRecordsSectionTag = ctcrc32("SubMeshRecords");
+    static constexpr uint32_t VerticesSectionTag = ctcrc32("Vertices");
+    static constexpr uint32_t IndicesSectionTag = ctcrc32("Indices");
+    static constexpr uint32_t StringsSectionTag = ctcrc32("Strings");
+
+    /// Bumped whenever vertex layout or mesh processing changes, so that stale compiled meshes are rebuilt
+    static constexpr uint32_t CompiledMeshFormatVersion = 2;
+
+    const std::string Mesh::CompiledFileSuffix = ".eamesh";
+
+    struct CompiledMeshRecord {
+        uint32_t formatVersion;
+
+        /// CRC32 of the record itself, computed with this field zeroed, followed by all other sections
+        uint32_t payloadChecksum;
+        uint64_t sourceFileSize;
+        int64_t sourceModificationTime;
+        glm::vec3 boundingBoxMin;
+        glm::vec3 boundingBoxMax;
+        uint32_t nameOffset;
+        uint32_t nameLength;
+        SubMesh::IndexingStatistics indexingStatistics;
+    };
+
+    struct CompiledSubMeshRecord {
+        uint64_t vertexOffset;
+        uint64_t vertexCount;
+        uint64_t indexOffset;
+        uint64_t indexCount;
+        glm::vec3 boundingBoxMin;
+        glm::vec3 boundingBoxMax;
+        float surfaceArea;
+        uint32_t nameOffset;
+        uint32_t nameLength;
+        uint32_t materialNameOffset;
+        uint32_t materialNameLength;
+    };
+
+    static bool SourceFileStamp(const std::string &filePath, uint64_t &size, int64_t &modificationTime) {
+        struct stat fileStatus;
+        if (stat(filePath.c_str(), &fileStatus) != 0) {
+            return false;
+        }
+        size = static_cast<uint64_t>(fileStatus.st_size);
+        modificationTime = static_cast<int64_t>(fileStatus.st_mtime);
+        return true;
+    }
+
+    template<class T>
+    static uint32_t SectionChecksum(const T *data, size_t count, uint32_t previous) {
+        return crc32(data, sizeof(T) * count, previous);
+    }
+
 #pragma mark - Lifecycle
 
     Mesh::Mesh(const std::string &filePath)
             :
             mSubMeshes(500) {
+        std::string compiledFilePath = filePath + CompiledFileSuffix;
+
+        if (!loadCompiled(compiledFilePath, filePath)) {
+            loadSource(filePath);
+
+            try {
+                writeCompiled(compiledFilePath, filePath);
+            } catch (const std::runtime_error &) {
+                // Source directory may be read-only, mesh will just be parsed again next time
+            }
+        }
+
+        float scaleDown = mBoundingBox.diagonal() * 1.44;
+        mBaseTransform.scale = glm::vec3(1.0 / scaleDown);
+    }
+
+#pragma mark - Private helpers
+
+    void Mesh::loadSource(const std::string &filePath) {
         auto meshLoader = MeshLoader::Create(filePath);
         std::vector<SubMesh> subMeshes;
 
         meshLoader->load(subMeshes, mName, mBoundingBox);
+
+        float weightedSourceCacheMissRatio = 0.0;
+        float weightedCacheMissRatio = 0.0;
+
         for (auto &subMesh : subMeshes) {
+            auto statistics = subMesh.weldAndOptimize();
+            size_t triangleCount = subMesh.triangleCount();
+
+            mIndexingStatistics.sourceVertexCount += statistics.sourceVertexCount;
+            mIndexingStatistics.vertexCount += statistics.vertexCount;
+            mIndexingStatistics.indexCount += statistics.indexCount;
+            weightedSourceCacheMissRatio += statistics.sourceAverageCacheMissRatio * triangleCount;
+            weightedCacheMissRatio += statistics.averageCacheMissRatio * triangleCount;
+
             mSubMeshes.emplace(std::move(subMesh));
         }
 
-        float scaleDown = mBoundingBox.diagonal() * 1.44;
-        mBaseTransform.scale = glm::vec3(1.0 / scaleDown);
+        size_t triangleCount = mIndexingStatistics.indexCount / 3;
+        if (triangleCount > 0) {
+            mIndexingStatistics.sourceAverageCacheMissRatio = weightedSourceCacheMissRatio / triangleCount;
+            mIndexingStatistics.averageCacheMissRatio = weightedCacheMissRatio / triangleCount;
+        }
+    }
+
+    bool Mesh::loadCompiled(const std::string &compiledFilePath, const std::string &sourceFilePath) {
+        uint64_t sourceSize = 0;
+        int64_t sourceModificationTime = 0;
+
+        if (!SourceFileStamp(sourceFilePath, sourceSize, sourceModificationTime) || !BakeContainer::HasSignature(compiledFilePath)) {
+            return false;
+        }
+
+        try {
+            BakeContainer container(compiledFilePath, CompiledMeshContentTag);
+
+            auto meshRecords = container.section<CompiledMeshRecord>(MeshRecordSectionTag);
+            auto subMeshRecords = container.section<CompiledSubMeshRecord>(SubMeshRecordsSectionTag);
+            auto vertices = container.section<Vertex1P1N2UV1T1BT>(VerticesSectionTag);
+            auto indices = container.section<uint32_t>(IndicesSectionTag);
+            auto strings = container.section<char>(StringsSectionTag);
+
+            if (meshRecords.size() != 1) {
+                return false;
+            }
+
+            const CompiledMeshRecord &meshRecord = *meshRecords.begin();
+
+            if (meshRecord.formatVersion != CompiledMeshFormatVersion ||
+                meshRecord.sourceFileSize != sourceSize ||
+                meshRecord.sourceModificationTime != sourceModificationTime) {
+                return false;
+            }
+
+            CompiledMeshRecord uncheckedRecord = meshRecord;
+            uncheckedRecord.payloadChecksum = 0;
+
+            uint32_t checksum = SectionChecksum(&uncheckedRecord, 1, 0);
+            checksum = SectionChecksum(subMeshRecords.data(), subMeshRecords.size(), checksum);
+            checksum = SectionChecksum(vertices.data(), vertices.size(), checksum);
+            checksum = SectionChecksum(indices.data(), indices.size(), checksum);
+            checksum = SectionChecksum(strings.data(), strings.size(), checksum);
+
+            if (checksum != meshRecord.payloadChecksum) {
+                return false;
+            }
+
+            auto string = [&](uint32_t offset, uint32_t length) {
+                if (uint64_t(offset) + length > strings.size()) {
+                    throw std::runtime_error("Compiled mesh string is out of bounds");
+                }
+                return std::string(strings.data() + offset, length);
+            };
+
+            // Everything is validated before any sub mesh is created to never leave the mesh half loaded
+            std::vector<SubMesh> subMeshes;
+            subMeshes.reserve(subMeshRecords.size());
+
+            for (const CompiledSubMeshRecord &record : subMeshRecords) {
+                if (record.vertexOffset + record.vertexCount > vertices.size() || record.indexOffset + record.indexCount > indices.size()) {
+                    return false;
+                }
+
+                // The only copy out of the mapping, GPUResourceController stages vertices and indices from here
+                subMeshes.emplace_back(string(record.nameOffset, record.nameLength),
+                        string(record.materialNameOffset, record.materialNameLength),
+                        vertices.data() + record.vertexOffset, record.vertexCount,
+                        indices.data() + record.indexOffset, record.indexCount,
+                        AxisAlignedBox3D(record.boundingBoxMin, record.boundingBoxMax),
+                        record.surfaceArea);
+            }
+
+            mName = string(meshRecord.nameOffset, meshRecord.nameLength);
+            mBoundingBox = AxisAlignedBox3D(meshRecord.boundingBoxMin, meshRecord.boundingBoxMax);
+            mIndexingStatistics = meshRecord.indexingStatistics;
+
+            for (auto &subMesh : subMeshes) {
+                mSubMeshes.emplace(std::move(subMesh));
+            }
+
+            return true;
+        } catch (const std::runtime_error &) {
+            return false;
+        }
+    }
+
+    void Mesh::writeCompiled(const std::string &compiledFilePath, const std::string &sourceFilePath) const {
+        CompiledMeshRecord meshRecord{};
+
+        if (!SourceFileStamp(sourceFilePath, meshRecord.sourceFileSize, meshRecord.sourceModificationTime)) {
+            return;
+        }
+
+        std::vector<CompiledSubMeshRecord> subMeshRecords;
+        std::vector<Vertex1P1N2UV1T1BT> vertices;
+        std::vector<uint32_t> indices;
+        std::vector<char> strings;
+
+        auto appendString = [&](const std::string &string, uint32_t &offset, uint32_t &length) {
+            offset = static_cast<uint32_t>(strings.size());
+            length = static_cast<uint32_t>(string.size());
+            strings.insert(strings.end(), string.begin(), string.end());
+        };
+
+        for (ID subMeshID : mSubMeshes) {
+            const SubMesh &subMesh = mSubMeshes[subMeshID];
+
+            CompiledSubMeshRecord record{};
+            record.vertexOffset = vertices.size();
+            record.vertexCount = subMesh.vertices().size();
+            record.indexOffset = indices.size();
+            record.indexCount = subMesh.indices().size();
+            record.boundingBoxMin = subMesh.boundingBox().min;
+            record.boundingBoxMax = subMesh.boundingBox().max;
+            record.surfaceArea = subMesh.surfaceArea();
+            appendString(subMesh.name(), record.nameOffset, record.nameLength);
+            appendString(subMesh.materialName(), record.materialNameOffset, record.materialNameLength);
+            subMeshRecords.push_back(record);
+
+            vertices.insert(vertices.end(), subMesh.vertices().begin(), subMesh.vertices().end());
+            indices.insert(indices.end(), subMesh.indices().begin(), subMesh.indices().end());
+        }
+
+        meshRecord.formatVersion = CompiledMeshFormatVersion;
+        meshRecord.boundingBoxMin = mBoundingBox.min;
+        meshRecord.boundingBoxMax = mBoundingBox.max;
+        meshRecord.indexingStatistics = mIndexingStatistics;
+        appendString(mName, meshRecord.nameOffset, meshRecord.nameLength);
+
+        meshRecord.payloadChecksum = 0;
+
+        uint32_t checksum = SectionChecksum(&meshRecord, 1, 0);
+        checksum = SectionChecksum(subMeshRecords.data(), subMeshRecords.size(), checksum);
+        checksum = SectionChecksum(vertices.data(), vertices.size(), checksum);
+        checksum = SectionChecksum(indices.data(), indices.size(), checksum);
+        meshRecord.payloadChecksum = SectionChecksum(strings.data(), strings.size(), checksum);
+
+        BakeContainer::Writer writer(CompiledMeshContentTag);
+        writer.addSection(MeshRecordSectionTag, &meshRecord, sizeof(CompiledMeshRecord), 1);
+        writer.addSection(SubMeshRecordsSectionTag, subMeshRecords);
+        writer.addSection(VerticesSectionTag, vertices);
+        writer.addSection(IndicesSectionTag, indices);
+        writer.addSection(StringsSectionTag, strings);
+        writer.write(compiledFilePath);
     }
 
 #pragma mark - Swap
@@ -34,6 +269,7 @@ namespace EARenderer {
         std::swap(mName, that.mName);
         std::swap(mSubMeshes, that.mSubMeshes);
         std::swap(mBoundingBox, that.mBoundingBox);
+        std::swap(mIndexingStatistics, that.mIndexingStatistics);
     }
 
     void swap(Mesh &lhs, Mesh &rhs) {
@@ -62,6 +298,10 @@ namespace EARenderer {
         return mSubMeshes;
     }
 
+    const SubMesh::IndexingStatistics &Mesh::indexingStatistics() const {
+        return mIndexingStatistics;
+    }
+
 #pragma mark - Setters
 
     void Mesh::setName(const std::string &name) {
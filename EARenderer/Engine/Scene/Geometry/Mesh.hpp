@@ -24,8 +24,27 @@ namespace EARenderer {
         Transformation mBaseTransform;
         AxisAlignedBox3D mBoundingBox;
         PackedLookupTable<SubMesh> mSubMeshes;
+        SubMesh::IndexingStatistics mIndexingStatistics;
+
+        void loadSource(const std::string &filePath);
+
+        /**
+         @return false if compiled file is missing, corrupted or outdated relative to the source file
+         */
+        bool loadCompiled(const std::string &compiledFilePath, const std::string &sourceFilePath);
+
+        void writeCompiled(const std::string &compiledFilePath, const std::string &sourceFilePath) const;
 
     public:
+        /// Compiled meshes are stored next to their source files with this suffix appended
+        static const std::string CompiledFileSuffix;
+
+        /**
+         Loads a compiled version of the mesh if it is up to date with the source file,
+         otherwise parses the source file and writes its compiled version for subsequent launches
+
+         @param filePath path to an .obj or .fbx file
+         */
         Mesh(const std::string &filePath);
 
         void swap(Mesh &);
@@ -40,6 +59,12 @@ namespace EARenderer {
 
         PackedLookupTable<SubMesh> &subMeshes();
 
+        /**
+         @return Vertex welding and cache optimization results summed over all sub meshes.
+         Cache miss ratios are averaged over triangles.
+         */
+        const SubMesh::IndexingStatistics &indexingStatistics() const;
+
         void setName(const std::string &name);
 
         void setTransformID(ID transformID);
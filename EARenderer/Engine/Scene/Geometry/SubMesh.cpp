@@ -8,9 +8,39 @@
 
 #include "SubMesh.hpp"
 #include "Triangle3D.hpp"
+#include "VertexCacheOptimizer.hpp"
+#include "CRC32.hpp"
+
+#include <unordered_map>
+#include <cstring>
 
 namespace EARenderer {
 
+#pragma mark - Indexing statistics
+
+    size_t SubMesh::IndexingStatistics::sourceByteSize() const {
+        return sourceVertexCount * sizeof(Vertex1P1N2UV1T1BT);
+    }
+
+    size_t SubMesh::IndexingStatistics::byteSize() const {
+        return vertexCount * sizeof(Vertex1P1N2UV1T1BT) + indexCount * sizeof(uint32_t);
+    }
+
+#pragma mark - Lifecycle
+
+    SubMesh::SubMesh(const std::string &name, const std::string &materialName,
+                     const Vertex1P1N2UV1T1BT *vertices, size_t vertexCount,
+                     const uint32_t *indices, size_t indexCount,
+                     const AxisAlignedBox3D &boundingBox, float surfaceArea)
+            :
+            mName(name),
+            mMaterialName(materialName),
+            mVertices(vertices, vertices + vertexCount),
+            mIndices(indices, indices + indexCount),
+            mBoundingBox(boundingBox),
+            mArea(surfaceArea) {
+    }
+
 #pragma mark - Getters
 
     const std::string &SubMesh::name() const {
@@ -25,6 +55,14 @@ namespace EARenderer {
         return mVertices;
     }
 
+    const std::vector<uint32_t> &SubMesh::indices() const {
+        return mIndices;
+    }
+
+    size_t SubMesh::triangleCount() const {
+        return mIndices.size() / 3;
+    }
+
     const AxisAlignedBox3D &SubMesh::boundingBox() const {
         return mBoundingBox;
     }
@@ -52,17 +90,66 @@ namespace EARenderer {
     void SubMesh::addVertex(const Vertex1P1N2UV1T1BT &vertex) {
         mBoundingBox.min = glm::min(glm::vec3(vertex.position), mBoundingBox.min);
         mBoundingBox.max = glm::max(glm::vec3(vertex.position), mBoundingBox.max);
+        mIndices.push_back(static_cast<uint32_t>(mVertices.size()));
         mVertices.push_back(vertex);
 
-        if ((mVertices.size() % 3) == 0) {
-            size_t count = mVertices.size();
-            auto &v0 = mVertices[count - 3];
-            auto &v1 = mVertices[count - 2];
-            auto &v2 = mVertices[count - 1];
+        if ((mIndices.size() % 3) == 0) {
+            size_t count = mIndices.size();
+            auto &v0 = mVertices[mIndices[count - 3]];
+            auto &v1 = mVertices[mIndices[count - 2]];
+            auto &v2 = mVertices[mIndices[count - 1]];
 
             Triangle3D triangle(v0.position, v1.position, v2.position);
             mArea += triangle.area();
         }
     }
 
+    SubMesh::IndexingStatistics SubMesh::weldAndOptimize() {
+        struct VertexHash {
+            size_t operator()(const Vertex1P1N2UV1T1BT &vertex) const {
+                return crc32(&vertex, sizeof(Vertex1P1N2UV1T1BT));
+            }
+        };
+
+        struct VertexEqual {
+            bool operator()(const Vertex1P1N2UV1T1BT &lhs, const Vertex1P1N2UV1T1BT &rhs) const {
+                return memcmp(&lhs, &rhs, sizeof(Vertex1P1N2UV1T1BT)) == 0;
+            }
+        };
+
+        IndexingStatistics statistics;
+        statistics.sourceVertexCount = mVertices.size();
+        statistics.sourceAverageCacheMissRatio = VertexCacheOptimizer::AverageCacheMissRatio(mIndices);
+
+        // Weld
+        std::unordered_map<Vertex1P1N2UV1T1BT, uint32_t, VertexHash, VertexEqual> uniqueVertices;
+        uniqueVertices.reserve(mVertices.size());
+
+        std::vector<Vertex1P1N2UV1T1BT> weldedVertices;
+        weldedVertices.reserve(mVertices.size());
+
+        for (uint32_t &index : mIndices) {
+            auto insertion = uniqueVertices.emplace(mVertices[index], static_cast<uint32_t>(weldedVertices.size()));
+            if (insertion.second) {
+                weldedVertices.push_back(mVertices[index]);
+            }
+            index = insertion.first->second;
+        }
+
+        // Reorder triangles, then vertices
+        mIndices = VertexCacheOptimizer::OptimizeTriangleOrder(mIndices, weldedVertices.size());
+        std::vector<uint32_t> remap = VertexCacheOptimizer::OptimizeVertexOrder(mIndices, weldedVertices.size());
+
+        mVertices = weldedVertices;
+        for (size_t i = 0; i < remap.size(); i++) {
+            mVertices[remap[i]] = weldedVertices[i];
+        }
+
+        statistics.vertexCount = mVertices.size();
+        statistics.indexCount = mIndices.size();
+        statistics.averageCacheMissRatio = VertexCacheOptimizer::AverageCacheMissRatio(mIndices);
+
+        return statistics;
+    }
+
 }
@@ -21,22 +21,51 @@
 namespace EARenderer {
 
     class SubMesh {
+    public:
+        struct IndexingStatistics {
+            size_t sourceVertexCount = 0;
+            size_t vertexCount = 0;
+            size_t indexCount = 0;
+            float sourceAverageCacheMissRatio = 0.0;
+            float averageCacheMissRatio = 0.0;
+
+            size_t sourceByteSize() const;
+
+            size_t byteSize() const;
+        };
+
     private:
         std::string mName;
         std::string mMaterialName;
         std::vector<Vertex1P1N2UV1T1BT> mVertices;
+        std::vector<uint32_t> mIndices;
         AxisAlignedBox3D mBoundingBox = AxisAlignedBox3D::MaximumReversed();
         float mArea = 0.0;
 
     public:
         SubMesh() = default;
 
+        /**
+         Creates an already indexed sub mesh, e.g. from a compiled mesh file
+         */
+        SubMesh(const std::string &name, const std::string &materialName,
+                const Vertex1P1N2UV1T1BT *vertices, size_t vertexCount,
+                const uint32_t *indices, size_t indexCount,
+                const AxisAlignedBox3D &boundingBox, float surfaceArea);
+
         const std::string &name() const;
 
         const std::string &materialName() const;
 
         const std::vector<Vertex1P1N2UV1T1BT> &vertices() const;
 
+        /**
+         @return 3 indices into vertices() per triangle
+         */
+        const std::vector<uint32_t> &indices() const;
+
+        size_t triangleCount() const;
+
         const AxisAlignedBox3D &boundingBox() const;
 
         std::vector<Vertex1P1N2UV1T1BT> &vertices();
@@ -47,7 +76,18 @@ namespace EARenderer {
 
         void setMaterialName(const std::string &name);
 
+        /**
+         Appends a vertex along with its index, every 3 added vertices form a new triangle
+         */
         void addVertex(const Vertex1P1N2UV1T1BT &vertex);
+
+        /**
+         Merges bitwise identical vertices, then reorders triangles for post-transform
+         vertex cache locality and vertices in the order of their first use
+
+         @return vertex counts and cache efficiency before and after the optimization
+         */
+        IndexingStatistics weldAndOptimize();
     };
 
 }
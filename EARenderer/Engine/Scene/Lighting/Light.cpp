@@ -32,6 +32,10 @@ namespace EARenderer {
         return mIsEnabled;
     }
 
+    bool Light::castsShadows() const {
+        return mCastsShadows;
+    }
+
     float Light::area() const {
         return mArea;
     }
@@ -54,6 +58,10 @@ namespace EARenderer {
         mIsEnabled = enabled;
     }
 
+    void Light::setCastsShadows(bool castsShadows) {
+        mCastsShadows = castsShadows;
+    }
+
     void Light::setArea(float area) {
         mArea = std::max(area, 0.0f);
     }
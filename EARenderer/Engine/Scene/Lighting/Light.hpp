@@ -17,13 +17,15 @@
 
 namespace EARenderer {
 
-    enum class LightType: uint8_t { Directional = 0, Point = 1 };
+    // ClusteredPoint shades every point light without a shadow map in one pass, see ClusteredLightCuller
+    enum class LightType: uint8_t { Directional = 0, Point = 1, ClusteredPoint = 3 };
 
     class Light {
     protected:
         glm::vec3 mPosition;
         Color mColor = Color::White();
         bool mIsEnabled = true;
+        bool mCastsShadows = true;
         float mArea = 1.0; // Used for penumbra estimation, no physical meaning right now
         float mShadowBias = 0.0;
 
@@ -54,6 +56,12 @@ namespace EARenderer {
 
         bool isEnabled() const;
 
+        /**
+         @return whether shadow maps are rendered for this light. Point lights that don't cast shadows
+         are shaded all at once in a clustered pass, which is what makes large light counts affordable.
+         */
+        bool castsShadows() const;
+
         float shadowBias() const;
 
         void setPosition(const glm::vec3 &position);
@@ -62,6 +70,8 @@ namespace EARenderer {
 
         void setIsEnabled(bool enabled);
 
+        void setCastsShadows(bool castsShadows);
+
         void setArea(float area);
 
         void setShadowBias(float bias);
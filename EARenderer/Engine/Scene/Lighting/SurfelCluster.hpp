@@ -17,6 +17,9 @@
 namespace EARenderer {
 
     struct SurfelCluster {
+        // Surfel count is packed into the lower 8 bits of a cluster's GPU record
+        static constexpr uint32_t MaximumSurfelCount = 255;
+
         uint32_t surfelOffset = 0;
         uint32_t surfelCount = 0;
         glm::vec3 center;
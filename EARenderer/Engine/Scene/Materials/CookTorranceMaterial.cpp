@@ -7,11 +7,22 @@
 //
 
 #include "CookTorranceMaterial.hpp"
-#include "GLTextureFactory.hpp"
 #include "Visitor.hpp"
+#include "CRC32.hpp"
+
+#include <array>
+#include <sys/stat.h>
 
 namespace EARenderer {
 
+    // Neutral values used while image maps are being loaded
+    static const std::array<uint8_t, 4> AlbedoPlaceholder{128, 128, 128, 255};
+    static const std::array<uint8_t, 4> NormalPlaceholder{128, 128, 255, 255};
+    static const std::array<uint8_t, 4> MetallnessPlaceholder{0, 0, 0, 255};
+    static const std::array<uint8_t, 4> RoughnessPlaceholder{255, 255, 255, 255};
+    static const std::array<uint8_t, 4> AmbientOcclusionPlaceholder{255, 255, 255, 255};
+    static const std::array<uint8_t, 4> DisplacementPlaceholder{0, 0, 0, 255};
+
 #pragma mark - Lifecycle
 
     CookTorranceMaterial::CookTorranceMaterial(
@@ -20,31 +31,32 @@ namespace EARenderer {
             std::variant<std::string, float> metalness,
             std::variant<std::string, float> roughness,
             std::variant<std::string, float> ambientOcclusion,
-            std::variant<std::string, float> displacement) {
+            std::variant<std::string, float> displacement)
+            : mAlbedoSource(albedo), mAlbedoChecksum(AlbedoChecksum(albedo)) {
 
         // All std::variant functionality that might throw std::bad_variant_access is marked as available starting with macOS 10.14
         // and that means we can't use std::visit **angry face**
         // https://stackoverflow.com/questions/52310835/xcode-10-call-to-unavailable-function-stdvisit
         //
         if (std::holds_alternative<std::string>(albedo)) {
-            mAlbedoMap = GLTextureFactory::LoadLDRImage<GLTexture::Normalized::RGBACompressedRGBAInput>(*std::get_if<std::string>(&albedo));
-            mAlbedoMap->generateMipMaps();
+            mAlbedoMapRequest = TextureLoader::Shared().loadLDRImage<GLTexture::Normalized::RGBACompressedRGBAInput>(*std::get_if<std::string>(&albedo));
+            mAlbedoMap = std::make_unique<AlbedoMap>(Size2D(1), AlbedoPlaceholder.data());
         } else {
             auto colorData = std::get_if<Color>(&albedo)->rgba();
             mAlbedoMap = std::make_unique<AlbedoMap>(Size2D(1), &colorData);
         }
 
         if (std::holds_alternative<std::string>(normal)) {
-            mNormalMap = GLTextureFactory::LoadLDRImage<GLTexture::Normalized::RGBCompressedRGBAInput>(*std::get_if<std::string>(&normal));
-            mNormalMap->generateMipMaps();
+            mNormalMapRequest = TextureLoader::Shared().loadLDRImage<GLTexture::Normalized::RGBCompressedRGBAInput>(*std::get_if<std::string>(&normal));
+            mNormalMap = std::make_unique<NormalMap>(Size2D(1), NormalPlaceholder.data());
         } else {
             auto normalData = *std::get_if<glm::vec3>(&normal);
             mNormalMap = std::make_unique<NormalMap>(Size2D(1), &normalData);
         }
 
         if (std::holds_alternative<std::string>(metalness)) {
-            mMetallicMap = GLTextureFactory::LoadLDRImage<GLTexture::Normalized::RCompressedRGBAInput>(*std::get_if<std::string>(&metalness));
-            mMetallicMap->generateMipMaps();
+            mMetallicMapRequest = TextureLoader::Shared().loadLDRImage<GLTexture::Normalized::RCompressedRGBAInput>(*std::get_if<std::string>(&metalness));
+            mMetallicMap = std::make_unique<MetallnessMap>(Size2D(1), MetallnessPlaceholder.data());
         } else {
             float value = *std::get_if<float>(&metalness);
             uint8_t unnormalizedValue = uint8_t(value * 255.0);
@@ -52,8 +64,8 @@ namespace EARenderer {
         }
 
         if (std::holds_alternative<std::string>(roughness)) {
-            mRoughnessMap = GLTextureFactory::LoadLDRImage<GLTexture::Normalized::RCompressedRGBAInput>(*std::get_if<std::string>(&roughness));
-            mRoughnessMap->generateMipMaps();
+            mRoughnessMapRequest = TextureLoader::Shared().loadLDRImage<GLTexture::Normalized::RCompressedRGBAInput>(*std::get_if<std::string>(&roughness));
+            mRoughnessMap = std::make_unique<RoughnessMap>(Size2D(1), RoughnessPlaceholder.data());
         } else {
             float value = *std::get_if<float>(&roughness);
             uint8_t unnormalizedValue = uint8_t(value * 255.0);
@@ -61,8 +73,8 @@ namespace EARenderer {
         }
 
         if (std::holds_alternative<std::string>(ambientOcclusion)) {
-            mAmbientOcclusionMap = GLTextureFactory::LoadLDRImage<GLTexture::Normalized::RCompressedRGBAInput>(*std::get_if<std::string>(&ambientOcclusion));
-            mAmbientOcclusionMap->generateMipMaps();
+            mAmbientOcclusionMapRequest = TextureLoader::Shared().loadLDRImage<GLTexture::Normalized::RCompressedRGBAInput>(*std::get_if<std::string>(&ambientOcclusion));
+            mAmbientOcclusionMap = std::make_unique<AmbientOcclusionMap>(Size2D(1), AmbientOcclusionPlaceholder.data());
         } else {
             float value = *std::get_if<float>(&ambientOcclusion);
             uint8_t unnormalizedValue = uint8_t(value * 255.0);
@@ -70,8 +82,8 @@ namespace EARenderer {
         }
 
         if (std::holds_alternative<std::string>(displacement)) {
-            mDisplacementMap = GLTextureFactory::LoadLDRImage<GLTexture::Normalized::RCompressedRGBAInput>(*std::get_if<std::string>(&displacement));
-            mDisplacementMap->generateMipMaps();
+            mDisplacementMapRequest = TextureLoader::Shared().loadLDRImage<GLTexture::Normalized::RCompressedRGBAInput>(*std::get_if<std::string>(&displacement));
+            mDisplacementMap = std::make_unique<DisplacementMap>(Size2D(1), DisplacementPlaceholder.data());
         } else {
             float value = *std::get_if<float>(&displacement);
             uint8_t unnormalizedValue = uint8_t(value * 255.0);
@@ -80,30 +92,82 @@ namespace EARenderer {
 
     }
 
+    CookTorranceMaterial CookTorranceMaterial::BakingProxy(std::variant<std::string, Color> albedo) {
+        CookTorranceMaterial material;
+        material.mAlbedoSource = albedo;
+        material.mAlbedoChecksum = AlbedoChecksum(albedo);
+        return material;
+    }
+
+#pragma mark - Private helpers
+
+    template<class Map>
+    const Map *CookTorranceMaterial::ResolveMap(const MapRequest<Map> &request, const std::unique_ptr<Map> &fallback) {
+        return request && request->isReady() ? request->texture() : fallback.get();
+    }
+
+    uint32_t CookTorranceMaterial::AlbedoChecksum(const std::variant<std::string, Color> &albedo) {
+        if (std::holds_alternative<std::string>(albedo)) {
+            const std::string &path = *std::get_if<std::string>(&albedo);
+            uint32_t checksum = ctcrc32(path);
+
+            // Size and modification time catch images edited in place, a missing file only contributes its path
+            struct stat fileStatus;
+            if (stat(path.c_str(), &fileStatus) == 0) {
+                uint64_t size = static_cast<uint64_t>(fileStatus.st_size);
+                int64_t modificationTime = static_cast<int64_t>(fileStatus.st_mtime);
+                checksum = crc32(&size, sizeof(size), checksum);
+                checksum = crc32(&modificationTime, sizeof(modificationTime), checksum);
+            }
+
+            return checksum;
+        }
+
+        auto colorData = std::get_if<Color>(&albedo)->rgba();
+        return crc32(&colorData, sizeof(colorData));
+    }
+
 #pragma mark - Getters
 
+    bool CookTorranceMaterial::areMapsLoaded() const {
+        auto loaded = [](const auto &request) {
+            return !request || request->isReady();
+        };
+
+        return loaded(mAlbedoMapRequest) && loaded(mNormalMapRequest) && loaded(mMetallicMapRequest) &&
+               loaded(mRoughnessMapRequest) && loaded(mAmbientOcclusionMapRequest) && loaded(mDisplacementMapRequest);
+    }
+
     const CookTorranceMaterial::AlbedoMap *CookTorranceMaterial::albedoMap() const {
-        return mAlbedoMap.get();
+        return ResolveMap(mAlbedoMapRequest, mAlbedoMap);
+    }
+
+    const std::variant<std::string, Color> &CookTorranceMaterial::albedoSource() const {
+        return mAlbedoSource;
+    }
+
+    uint32_t CookTorranceMaterial::albedoChecksum() const {
+        return mAlbedoChecksum;
     }
 
     const CookTorranceMaterial::NormalMap *CookTorranceMaterial::normalMap() const {
-        return mNormalMap.get();
+        return ResolveMap(mNormalMapRequest, mNormalMap);
     }
 
     const CookTorranceMaterial::MetallnessMap *CookTorranceMaterial::metallicMap() const {
-        return mMetallicMap.get();
+        return ResolveMap(mMetallicMapRequest, mMetallicMap);
     }
 
     const CookTorranceMaterial::RoughnessMap *CookTorranceMaterial::roughnessMap() const {
-        return mRoughnessMap.get();
+        return ResolveMap(mRoughnessMapRequest, mRoughnessMap);
     }
 
     const CookTorranceMaterial::AmbientOcclusionMap *CookTorranceMaterial::ambientOcclusionMap() const {
-        return mAmbientOcclusionMap.get();
+        return ResolveMap(mAmbientOcclusionMapRequest, mAmbientOcclusionMap);
     }
 
     const CookTorranceMaterial::DisplacementMap *CookTorranceMaterial::displacementMap() const {
-        return mDisplacementMap.get();
+        return ResolveMap(mDisplacementMapRequest, mDisplacementMap);
     }
 
 }
@@ -16,6 +16,7 @@
 #include <glm/vec3.hpp>
 
 #include "GLTexture2D.hpp"
+#include "TextureLoader.hpp"
 #include "Color.hpp"
 
 namespace EARenderer {
@@ -30,6 +31,10 @@ namespace EARenderer {
         using DisplacementMap       = GLNormalizedTexture2D<GLTexture::Normalized::RCompressedRGBAInput>;
 
     private:
+        template<class Map>
+        using MapRequest = std::shared_ptr<const TextureLoader::Request<Map>>;
+
+        // Constant maps, or placeholders shown until requested images arrive
         std::unique_ptr<AlbedoMap> mAlbedoMap;
         std::unique_ptr<NormalMap> mNormalMap;
         std::unique_ptr<MetallnessMap> mMetallicMap;
@@ -37,7 +42,28 @@ namespace EARenderer {
         std::unique_ptr<AmbientOcclusionMap> mAmbientOcclusionMap;
         std::unique_ptr<DisplacementMap> mDisplacementMap;
 
+        MapRequest<AlbedoMap> mAlbedoMapRequest;
+        MapRequest<NormalMap> mNormalMapRequest;
+        MapRequest<MetallnessMap> mMetallicMapRequest;
+        MapRequest<RoughnessMap> mRoughnessMapRequest;
+        MapRequest<AmbientOcclusionMap> mAmbientOcclusionMapRequest;
+        MapRequest<DisplacementMap> mDisplacementMapRequest;
+
+        std::variant<std::string, Color> mAlbedoSource;
+        uint32_t mAlbedoChecksum = 0;
+
+        CookTorranceMaterial() = default;
+
+        template<class Map>
+        static const Map *ResolveMap(const MapRequest<Map> &request, const std::unique_ptr<Map> &fallback);
+
+        static uint32_t AlbedoChecksum(const std::variant<std::string, Color> &albedo);
+
     public:
+        /**
+         Image maps are decoded asynchronously by TextureLoader::Shared(). Until they arrive
+         the material is rendered with neutral 1x1 placeholders.
+         */
         CookTorranceMaterial(
                 std::variant<std::string, Color> albedo,
                 std::variant<std::string, glm::vec3> normal,
@@ -47,8 +73,33 @@ namespace EARenderer {
                 std::variant<std::string, float> displacement
         );
 
+        /**
+         Creates a material that only carries what light baking reads, i.e. its albedo source.
+         No textures are created or requested, so no OpenGL context is needed and all map getters return nullptr.
+
+         @param albedo image path or constant color
+         @return Material suitable for headless baking only
+         */
+        static CookTorranceMaterial BakingProxy(std::variant<std::string, Color> albedo);
+
+        /**
+         @return true if all image maps have been loaded and no placeholders are in use
+         */
+        bool areMapsLoaded() const;
+
         const AlbedoMap *albedoMap() const;
 
+        /**
+         @return Image path or constant color the albedo map is made of
+         */
+        const std::variant<std::string, Color> &albedoSource() const;
+
+        /**
+         @return CRC32 of the albedo source: image path, size and modification time, or constant color.
+         Lets light baking detect albedo changes without decoding the image.
+         */
+        uint32_t albedoChecksum() const;
+
         const NormalMap *normalMap() const;
 
         const MetallnessMap *metallicMap() const;
@@ -8,6 +8,9 @@
 
 #include "Scene.hpp"
 
+#include <map>
+#include <stdexcept>
+
 #include <glm/vec3.hpp>
 #include <glm/gtc/constants.hpp>
 
@@ -24,6 +27,14 @@ namespace EARenderer {
               mPointLights(5),
               mMeshInstances(10) {}
 
+#pragma mark - Private helpers
+
+    void Scene::resetRaytracerInstanceRanges() {
+        for (size_t i = 0; i < mMeshInstances.size(); i++) {
+            mMeshInstances.columnAt<RaytracerInstanceRange>(i) = RaytracerInstanceRange();
+        }
+    }
+
 #pragma mark - Getters
 
     DirectionalLight &Scene::sun() {
@@ -34,7 +45,7 @@ namespace EARenderer {
         return mPointLights;
     }
 
-    PackedLookupTable<MeshInstance> &Scene::meshInstances() {
+    Scene::MeshInstanceTable &Scene::meshInstances() {
         return mMeshInstances;
     }
 
@@ -46,7 +57,7 @@ namespace EARenderer {
         return mPointLights;
     }
 
-    const PackedLookupTable<MeshInstance> &Scene::meshInstances() const {
+    const Scene::MeshInstanceTable &Scene::meshInstances() const {
         return mMeshInstances;
     }
 
@@ -168,43 +179,97 @@ namespace EARenderer {
             for (ID subMeshID : mesh.subMeshes()) {
                 auto &subMesh = mesh.subMeshes()[subMeshID];
 
-                for (size_t i = 0; i < subMesh.vertices().size(); i += 3) {
-                    Triangle3D triangle(modelMatrix * subMesh.vertices()[i].position,
-                            modelMatrix * subMesh.vertices()[i + 1].position,
-                            modelMatrix * subMesh.vertices()[i + 2].position);
+                auto &vertices = subMesh.vertices();
+                auto &indices = subMesh.indices();
+
+                for (size_t i = 0; i < indices.size(); i += 3) {
+                    Triangle3D triangle(modelMatrix * vertices[indices[i]].position,
+                            modelMatrix * vertices[indices[i + 1]].position,
+                            modelMatrix * vertices[indices[i + 2]].position);
 
                     MeshTriangleRef ref({meshInstanceID, subMeshID, triangle});
                     mOctree->insert(ref);
                 }
             }
         }
+
+        mOctree->build();
     }
 
     void Scene::buildStaticGeometryRaytracer(const SharedResourceStorage &resourceStorage) {
-        std::vector<Triangle3D> triangles;
+        mRaytracer = std::make_shared<EmbreeRayTracer>();
+        resetRaytracerInstanceRanges();
+
+        // Mesh ID, sub mesh ID -> ray tracer geometry ID
+        std::map<std::pair<ID, ID>, uint32_t> geometryIDs;
 
         for (ID meshInstanceID : mStaticMeshInstanceIDs) {
             const auto &meshInstance = mMeshInstances[meshInstanceID];
             const auto &mesh = resourceStorage.mesh(meshInstance.meshID());
 
-            auto modelMatrix = meshInstance.modelMatrix();
+            auto &instanceRange = mMeshInstances.column<RaytracerInstanceRange>(meshInstanceID);
 
             for (ID subMeshID : mesh.subMeshes()) {
                 const auto &subMesh = mesh.subMeshes()[subMeshID];
 
-                for (size_t i = 0; i < subMesh.vertices().size(); i += 3) {
-                    triangles.emplace_back(modelMatrix * subMesh.vertices()[i].position,
-                            modelMatrix * subMesh.vertices()[i + 1].position,
-                            modelMatrix * subMesh.vertices()[i + 2].position);
+                if (subMesh.indices().empty()) {
+                    continue;
+                }
+
+                auto key = std::make_pair(meshInstance.meshID(), subMeshID);
+                auto geometryIt = geometryIDs.find(key);
+
+                if (geometryIt == geometryIDs.end()) {
+                    uint32_t geometryID = mRaytracer->addGeometry(&subMesh.vertices().front().position,
+                            sizeof(Vertex1P1N2UV1T1BT),
+                            subMesh.vertices().size(),
+                            subMesh.indices().data(),
+                            subMesh.triangleCount());
+
+                    geometryIt = geometryIDs.emplace(key, geometryID).first;
+                }
+
+                uint32_t instanceID = mRaytracer->addInstance(geometryIt->second, meshInstance.modelMatrix());
+
+                if (instanceRange.count == 0) {
+                    instanceRange.first = instanceID;
+                } else if (instanceID != instanceRange.first + instanceRange.count) {
+                    throw std::logic_error("Ray tracer instances of a mesh instance are expected to be contiguous");
                 }
+
+                instanceRange.count++;
+            }
+        }
+
+        mRaytracer->commit();
+    }
+
+    void Scene::updateStaticGeometryRaytracerTransforms() const {
+        if (!mRaytracer) {
+            return;
+        }
+
+        for (size_t i = 0; i < mMeshInstances.size(); i++) {
+            const auto &instanceRange = mMeshInstances.columnAt<RaytracerInstanceRange>(i);
+
+            // Dynamic instances aren't in the ray tracer
+            if (instanceRange.count == 0) {
+                continue;
+            }
+
+            glm::mat4 modelMatrix = mMeshInstances.objectAt(i).modelMatrix();
+
+            for (uint32_t instanceID = instanceRange.first; instanceID < instanceRange.first + instanceRange.count; instanceID++) {
+                mRaytracer->setInstanceTransform(instanceID, modelMatrix);
             }
         }
 
-        mRaytracer = std::make_shared<EmbreeRayTracer>(triangles);
+        mRaytracer->commit();
     }
 
     void Scene::destroyAuxiliaryData() {
         mRaytracer = nullptr;
+        resetRaytracerInstanceRanges();
         mOctree = nullptr;
     }
 
@@ -30,16 +30,29 @@
 
 #include <vector>
 #include <list>
+#include <unordered_map>
 #include <memory>
 
 namespace EARenderer {
 
     class SharedResourceStorage;
 
+    /**
+     Ray tracer instances a static mesh instance was placed into, one per non-empty sub mesh.
+     Stored as a column of the scene's mesh instance table, so that transform updates don't touch instances themselves.
+     Lives at namespace scope because the table checks its columns while Scene is still incomplete.
+     */
+    struct RaytracerInstanceRange {
+        uint32_t first = 0;
+        uint32_t count = 0;
+    };
+
     class Scene {
     public:
         using SubMeshInstancePair = std::pair<ID, ID>;
 
+        using MeshInstanceTable = PackedLookupTable<MeshInstance, RaytracerInstanceRange>;
+
     private:
 
 #pragma mark - Member variables
@@ -52,7 +65,7 @@ namespace EARenderer {
 
         DirectionalLight mDirectionalLight;
         PackedLookupTable<PointLight> mPointLights;
-        PackedLookupTable<MeshInstance> mMeshInstances;
+        MeshInstanceTable mMeshInstances;
 
         std::vector<Surfel> mSurfels;
         std::vector<SurfelCluster> mSurfelClusters;
@@ -71,6 +84,10 @@ namespace EARenderer {
         AxisAlignedBox3D mBoundingBox;
         AxisAlignedBox3D mLightBakingVolume;
 
+#pragma mark - Member functions
+
+        void resetRaytracerInstanceRanges();
+
     public:
 
 #pragma mark - Lifecycle
@@ -83,13 +100,13 @@ namespace EARenderer {
 
         PackedLookupTable<PointLight> &pointLights();
 
-        PackedLookupTable<MeshInstance> &meshInstances();
+        MeshInstanceTable &meshInstances();
 
         const DirectionalLight &sun() const;
 
         const PackedLookupTable<PointLight> &pointLights() const;
 
-        const PackedLookupTable<MeshInstance> &meshInstances() const;
+        const MeshInstanceTable &meshInstances() const;
 
         std::shared_ptr<SparseOctree<MeshTriangleRef>> octree() const;
 
@@ -139,8 +156,20 @@ namespace EARenderer {
 
         void buildStaticGeometryOctree(const SharedResourceStorage& resourceStorage);
 
+        /**
+         Builds ray tracer over static geometry. Every sub mesh is uploaded once and placed
+         into the ray tracer as an instance for each mesh instance referencing it.
+         Ray tracer references vertex data of the sub meshes, so the resource storage must outlive it.
+         */
         void buildStaticGeometryRaytracer(const SharedResourceStorage& resourceStorage);
 
+        /**
+         Synchronizes ray tracer with current transformations of static mesh instances.
+         Only refits the top level of ray tracer's acceleration structure.
+         Ray tracer is auxiliary data, so moved instances can be synchronized through a const scene.
+         */
+        void updateStaticGeometryRaytracerTransforms() const;
+
         /**
          Destroy helper objects that take up a lot of memory, but can be recreated at any time (ray tracers, etc.)
          */
@@ -0,0 +1,210 @@
+//
+//  BakeContainer.cpp
+//  EARenderer
+//
+//  Created by Pavlo Muratov on 17.10.2026.
+//  Copyright © 2026 MPO. All rights reserved.
+//
+
+#include "BakeContainer.hpp"
+#include "CRC32.hpp"
+#include "StringUtils.hpp"
+
+#include <fstream>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+
+namespace EARenderer {
+
+#pragma mark - Writer
+
+    BakeContainer::Writer::Writer(uint32_t contentTag)
+            :
+            mContentTag(contentTag) {
+    }
+
+    void BakeContainer::Writer::addSection(uint32_t tag, const void *data, size_t elementSize, size_t count) {
+        for (auto &section : mSections) {
+            if (section.tag == tag) {
+                throw std::invalid_argument(string_format("Bake container section %u is added twice", tag));
+            }
+        }
+        mSections.push_back({tag, static_cast<uint32_t>(elementSize), count, data});
+    }
+
+    void BakeContainer::Writer::write(const std::string &filePath) const {
+        auto align = [](uint64_t offset) {
+            return (offset + SectionAlignment - 1) / SectionAlignment * SectionAlignment;
+        };
+
+        std::vector<SectionEntry> entries;
+        uint64_t offset = sizeof(Header) + sizeof(SectionEntry) * mSections.size();
+
+        for (auto &section : mSections) {
+            offset = align(offset);
+            entries.push_back({section.tag, section.elementSize, section.elementCount, offset});
+            offset += section.elementSize * section.elementCount;
+        }
+
+        Header header{};
+        header.magic = Magic;
+        header.version = Version;
+        header.contentTag = mContentTag;
+        header.sectionCount = static_cast<uint32_t>(entries.size());
+        header.fileSize = offset;
+        header.checksum = Checksum(header, entries.data());
+
+        std::ofstream stream(filePath, std::ios::trunc | std::ios::binary);
+        if (!stream.is_open()) {
+            throw std::runtime_error(string_format("Unable to write bake container: %s", filePath.c_str()));
+        }
+
+        stream.write(reinterpret_cast<const char *>(&header), sizeof(Header));
+        stream.write(reinterpret_cast<const char *>(entries.data()), sizeof(SectionEntry) * entries.size());
+
+        const char padding[SectionAlignment] = {};
+        uint64_t position = sizeof(Header) + sizeof(SectionEntry) * entries.size();
+
+        for (size_t i = 0; i < mSections.size(); i++) {
+            stream.write(padding, entries[i].offset - position);
+            stream.write(reinterpret_cast<const char *>(mSections[i].data), mSections[i].elementSize * mSections[i].elementCount);
+            position = entries[i].offset + mSections[i].elementSize * mSections[i].elementCount;
+        }
+
+        if (!stream.good()) {
+            throw std::runtime_error(string_format("Failed to write bake container: %s", filePath.c_str()));
+        }
+    }
+
+#pragma mark - Lifecycle
+
+    BakeContainer::BakeContainer(const std::string &filePath, uint32_t contentTag)
+            :
+            mFilePath(filePath) {
+        int descriptor = open(filePath.c_str(), O_RDONLY);
+        if (descriptor == -1) {
+            throw std::runtime_error(string_format("Unable to open bake container: %s", filePath.c_str()));
+        }
+
+        struct stat fileStatus;
+        if (fstat(descriptor, &fileStatus) == -1 || fileStatus.st_size < (off_t) sizeof(Header)) {
+            close(descriptor);
+            throw std::runtime_error(string_format("Bake container is truncated: %s", filePath.c_str()));
+        }
+
+        mLength = fileStatus.st_size;
+        void *mapping = mmap(nullptr, mLength, PROT_READ, MAP_PRIVATE, descriptor, 0);
+
+        // Mapping keeps its own reference to the file
+        close(descriptor);
+
+        if (mapping == MAP_FAILED) {
+            throw std::runtime_error(string_format("Unable to map bake container: %s", filePath.c_str()));
+        }
+
+        mBytes = reinterpret_cast<const uint8_t *>(mapping);
+
+        try {
+            validate(contentTag);
+        } catch (...) {
+            munmap(const_cast<uint8_t *>(mBytes), mLength);
+            throw;
+        }
+    }
+
+    BakeContainer::~BakeContainer() {
+        munmap(const_cast<uint8_t *>(mBytes), mLength);
+    }
+
+#pragma mark - Private helpers
+
+    uint32_t BakeContainer::Checksum(const Header &header, const SectionEntry *entries) {
+        Header copy = header;
+        copy.checksum = 0;
+        uint32_t checksum = crc32(&copy, sizeof(Header));
+        return crc32(entries, sizeof(SectionEntry) * header.sectionCount, checksum);
+    }
+
+    const BakeContainer::Header &BakeContainer::header() const {
+        return *reinterpret_cast<const Header *>(mBytes);
+    }
+
+    const BakeContainer::SectionEntry *BakeContainer::entries() const {
+        return reinterpret_cast<const SectionEntry *>(mBytes + sizeof(Header));
+    }
+
+    const BakeContainer::SectionEntry *BakeContainer::findEntry(uint32_t tag) const {
+        const SectionEntry *begin = entries();
+        const SectionEntry *end = begin + header().sectionCount;
+        for (const SectionEntry *entry = begin; entry != end; ++entry) {
+            if (entry->tag == tag) {
+                return entry;
+            }
+        }
+        return nullptr;
+    }
+
+    void BakeContainer::validate(uint32_t contentTag) const {
+        const Header &h = header();
+
+        if (h.magic != Magic) {
+            throw std::runtime_error(string_format("Not a bake container: %s", mFilePath.c_str()));
+        }
+
+        if (h.version != Version) {
+            throw std::runtime_error(string_format("Unsupported bake container version %u: %s", h.version, mFilePath.c_str()));
+        }
+
+        if (h.contentTag != contentTag) {
+            throw std::runtime_error(string_format("Unexpected bake container content: %s", mFilePath.c_str()));
+        }
+
+        uint64_t tableEnd = sizeof(Header) + uint64_t(h.sectionCount) * sizeof(SectionEntry);
+        if (tableEnd > mLength || h.fileSize != mLength) {
+            throw std::runtime_error(string_format("Bake container is truncated: %s", mFilePath.c_str()));
+        }
+
+        if (Checksum(h, entries()) != h.checksum) {
+            throw std::runtime_error(string_format("Bake container checksum mismatch: %s", mFilePath.c_str()));
+        }
+
+        for (uint32_t i = 0; i < h.sectionCount; i++) {
+            const SectionEntry &entry = entries()[i];
+            uint64_t size = uint64_t(entry.elementSize) * entry.elementCount;
+            if (entry.offset % SectionAlignment != 0 || entry.offset < tableEnd || entry.offset + size > mLength) {
+                throw std::runtime_error(string_format("Bake container section %u is out of bounds: %s", entry.tag, mFilePath.c_str()));
+            }
+        }
+    }
+
+    const void *BakeContainer::sectionData(uint32_t tag, size_t elementSize, size_t &count) const {
+        const SectionEntry *entry = findEntry(tag);
+        if (!entry) {
+            throw std::runtime_error(string_format("Bake container section %u is missing: %s", tag, mFilePath.c_str()));
+        }
+
+        if (entry->elementSize != elementSize) {
+            throw std::runtime_error(string_format("Bake container section %u has element size %u, expected %zu: %s",
+                    tag, entry->elementSize, elementSize, mFilePath.c_str()));
+        }
+
+        count = entry->elementCount;
+        return mBytes + entry->offset;
+    }
+
+#pragma mark - Queries
+
+    bool BakeContainer::HasSignature(const std::string &filePath) {
+        std::ifstream stream(filePath, std::ios::binary);
+        uint32_t magic = 0;
+        stream.read(reinterpret_cast<char *>(&magic), sizeof(magic));
+        return stream.good() && magic == Magic;
+    }
+
+    bool BakeContainer::hasSection(uint32_t tag) const {
+        return findEntry(tag) != nullptr;
+    }
+
+}
@@ -0,0 +1,180 @@
+//
+//  BakeContainer.hpp
+//  EARenderer
+//
+//  Created by Pavlo Muratov on 17.10.2026.
+//  Copyright © 2026 MPO. All rights reserved.
+//
+
+#ifndef BakeContainer_hpp
+#define BakeContainer_hpp
+
+#include <string>
+#include <vector>
+#include <stdexcept>
+#include <type_traits>
+#include <cstdint>
+
+namespace EARenderer {
+
+    // Versioned binary container for baked data.
+    //
+    // A file consists of a header, a section table and section payloads.
+    // Every payload is a tightly packed array of trivially copyable elements stored exactly
+    // as they are laid out in memory and starts at an offset aligned to SectionAlignment,
+    // so that a memory mapped file can be handed to OpenGL or copied into vectors without decoding.
+    // Header and section table are protected by a CRC32 checksum. Payloads are not checksummed
+    // to keep loading free of any per-byte work.
+
+    class BakeContainer {
+    public:
+
+#pragma mark - Nested types
+
+        static constexpr uint32_t Magic = 0x4B424145; // "EABK"
+        static constexpr uint32_t Version = 1;
+        static constexpr uint64_t SectionAlignment = 64;
+
+        template<class T>
+        class Section {
+        private:
+            friend BakeContainer;
+
+            const T *mData = nullptr;
+            size_t mCount = 0;
+
+            Section(const T *data, size_t count) : mData(data), mCount(count) {}
+
+        public:
+            const T *data() const { return mData; }
+
+            size_t size() const { return mCount; }
+
+            const T *begin() const { return mData; }
+
+            const T *end() const { return mData + mCount; }
+        };
+
+        class Writer {
+        private:
+            struct PendingSection {
+                uint32_t tag;
+                uint32_t elementSize;
+                uint64_t elementCount;
+                const void *data;
+            };
+
+            uint32_t mContentTag;
+            std::vector<PendingSection> mSections;
+
+        public:
+            Writer(uint32_t contentTag);
+
+            /**
+             Registers a section. Data is not copied and must stay alive until write() is called.
+
+             @param tag unique section identifier
+             @param data pointer to the first element
+             @param elementSize size of a single element in bytes
+             @param count number of elements
+             */
+            void addSection(uint32_t tag, const void *data, size_t elementSize, size_t count);
+
+            template<class T>
+            void addSection(uint32_t tag, const std::vector<T> &elements) {
+                static_assert(std::is_trivially_copyable<T>::value, "Only trivially copyable types can be stored in a bake container");
+                addSection(tag, elements.data(), sizeof(T), elements.size());
+            }
+
+            void write(const std::string &filePath) const;
+        };
+
+    private:
+        struct Header {
+            uint32_t magic;
+            uint32_t version;
+            uint32_t contentTag;
+            uint32_t sectionCount;
+            uint64_t fileSize;
+            uint32_t checksum;
+            uint32_t reserved;
+        };
+
+        struct SectionEntry {
+            uint32_t tag;
+            uint32_t elementSize;
+            uint64_t elementCount;
+            uint64_t offset;
+        };
+
+        static_assert(sizeof(Header) == 32, "Header layout is a part of the file format");
+        static_assert(sizeof(SectionEntry) == 24, "Section entry layout is a part of the file format");
+
+#pragma mark - Member variables
+
+        const uint8_t *mBytes = nullptr;
+        size_t mLength = 0;
+        std::string mFilePath;
+
+#pragma mark - Member functions
+
+        static uint32_t Checksum(const Header &header, const SectionEntry *entries);
+
+        const Header &header() const;
+
+        const SectionEntry *entries() const;
+
+        const SectionEntry *findEntry(uint32_t tag) const;
+
+        const void *sectionData(uint32_t tag, size_t elementSize, size_t &count) const;
+
+        void validate(uint32_t contentTag) const;
+
+    public:
+
+#pragma mark - Lifecycle
+
+        /**
+         Maps the file into memory and validates its header and section table
+
+         @param filePath path to a container file
+         @param contentTag expected kind of content, guards against loading a container of a different kind
+         @throws std::runtime_error if the file cannot be mapped or is not a valid container of the expected kind
+         */
+        BakeContainer(const std::string &filePath, uint32_t contentTag);
+
+        BakeContainer(const BakeContainer &that) = delete;
+
+        BakeContainer &operator=(const BakeContainer &rhs) = delete;
+
+        ~BakeContainer();
+
+#pragma mark - Queries
+
+        /**
+         Cheap check used to tell containers from files in other formats
+
+         @param filePath path to a file
+         @return true if the file starts with container's magic number
+         */
+        static bool HasSignature(const std::string &filePath);
+
+        bool hasSection(uint32_t tag) const;
+
+        /**
+         @param tag section identifier
+         @return view into the mapped memory, valid for the lifetime of the container
+         @throws std::runtime_error if the section is missing or was written with a different element size
+         */
+        template<class T>
+        Section<T> section(uint32_t tag) const {
+            static_assert(std::is_trivially_copyable<T>::value, "Only trivially copyable types can be stored in a bake container");
+            size_t count = 0;
+            const void *data = sectionData(tag, sizeof(T), count);
+            return Section<T>(reinterpret_cast<const T *>(data), count);
+        }
+    };
+
+}
+
+#endif /* BakeContainer_hpp */
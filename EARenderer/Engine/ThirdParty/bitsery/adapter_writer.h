@@ -27,6 +27,7 @@
 
 #include <cassert>
 #include <utility>
+#include <limits>
 
 namespace bitsery {
 
@@ -0,0 +1,152 @@
+//
+//  MPMCQueue.hpp
+//  EARenderer
+//
+//  Created by Pavlo Muratov on 17.10.2026.
+//  Copyright © 2026 MPO. All rights reserved.
+//
+
+#ifndef MPMCQueue_hpp
+#define MPMCQueue_hpp
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+namespace EARenderer {
+
+    // Bounded lock-free multi-producer/multi-consumer queue after Dmitry Vyukov's ring buffer.
+    //
+    // Every slot carries a sequence number telling whether it's ready to be written or read on the
+    // current lap, so producers and consumers only contend on their own position counter and never
+    // on each other. Counters and slots are padded to cache lines to keep them from false sharing.
+    //
+    // Non-blocking operations (tryPush, tryPop) never lock. Blocking ones (push, waitPop) spin for
+    // a while, then yield and finally park on a condition variable. The spin budget adapts to how
+    // long waits have recently taken, so short waits stay cheap while long ones don't burn a core.
+    // Mirrors the interface of ThreadSafeQueue.
+
+    template<typename T>
+    class MPMCQueue {
+    private:
+        static constexpr size_t CacheLineSize = 64;
+        static constexpr uint32_t MinimumSpinLimit = 16;
+        static constexpr uint32_t MaximumSpinLimit = 4096;
+        static constexpr uint32_t YieldCount = 16;
+
+        struct alignas(CacheLineSize) Slot {
+            std::atomic<size_t> sequence;
+            typename std::aligned_storage<sizeof(T), alignof(T)>::type storage;
+
+            T *item();
+        };
+
+        /**
+         * Threads waiting for the queue to become non-empty (consumers) or non-full (producers)
+         */
+        struct alignas(CacheLineSize) Parking {
+            std::atomic<uint32_t> parkedCount{0};
+            std::atomic<uint32_t> spinLimit{MinimumSpinLimit * 4};
+            std::mutex mutex;
+            std::condition_variable condition;
+        };
+
+        size_t mCapacity;
+        size_t mMask;
+        std::unique_ptr<Slot[]> mSlots;
+
+        alignas(CacheLineSize) std::atomic<size_t> mEnqueuePosition{0};
+        alignas(CacheLineSize) std::atomic<size_t> mDequeuePosition{0};
+        alignas(CacheLineSize) std::atomic_bool mValid{true};
+
+        Parking mConsumers;
+        Parking mProducers;
+
+        static void Pause();
+
+        bool isFull() const;
+
+        /**
+         @return true once the predicate held, false if the queue got invalidated first
+         */
+        template<typename Predicate>
+        bool waitUntil(Parking &parking, Predicate &&predicate);
+
+        void wakeUp(Parking &parking);
+
+    public:
+        /**
+         @param capacity maximum number of items, rounded up to a power of two
+         */
+        explicit MPMCQueue(size_t capacity = 1024);
+
+        /**
+         * Destroys items that are still enqueued.
+         */
+        ~MPMCQueue();
+
+        MPMCQueue(const MPMCQueue &that) = delete;
+
+        MPMCQueue &operator=(const MPMCQueue &rhs) = delete;
+
+        size_t capacity() const;
+
+        /**
+         * Check whether or not the queue is empty. Only a snapshot when other threads use the queue.
+         */
+        bool empty() const;
+
+        /**
+         * Returns whether or not this queue is valid.
+         */
+        bool isValid() const;
+
+        /**
+         * Attempt to push a value.
+         * Returns false if the queue is full or invalid, in which case the value is left untouched.
+         */
+        bool tryPush(T &&value);
+
+        /**
+         * Push a new value onto the queue.
+         * Will block while the queue is full unless it gets invalidated.
+         * Returns true if the value was enqueued, false otherwise.
+         */
+        bool push(T value);
+
+        /**
+         * Attempt to get the first value in the queue.
+         * Returns true if a value was successfully written to the out parameter, false otherwise.
+         */
+        bool tryPop(T &out);
+
+        /**
+         * Get the first value in the queue.
+         * Will block until a value is available unless the queue is invalidated.
+         * Returns true if a value was successfully written to the out parameter, false otherwise.
+         */
+        bool waitPop(T &out);
+
+        /**
+         * Clear all items from the queue.
+         */
+        void clear();
+
+        /**
+         * Invalidate the queue, waking up every blocked thread.
+         * Pushes and pops fail on an invalid queue, items still enqueued are destroyed along with the queue.
+         */
+        void invalidate();
+    };
+
+}
+
+#include "MPMCQueueImpl.hpp"
+
+#endif /* MPMCQueue_hpp */
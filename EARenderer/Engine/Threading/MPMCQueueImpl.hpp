@@ -0,0 +1,269 @@
+//
+//  MPMCQueueImpl.hpp
+//  EARenderer
+//
+//  Created by Pavlo Muratov on 17.10.2026.
+//  Copyright © 2026 MPO. All rights reserved.
+//
+
+#ifndef MPMCQueueImpl_h
+#define MPMCQueueImpl_h
+
+#include <algorithm>
+#include <thread>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#endif
+
+namespace EARenderer {
+
+#pragma mark - Slot
+
+    template<typename T>
+    T *
+    MPMCQueue<T>::Slot::item() {
+        return std::launder(reinterpret_cast<T *>(&storage));
+    }
+
+#pragma mark - Lifecycle
+
+    template<typename T>
+    MPMCQueue<T>::MPMCQueue(size_t capacity) {
+        mCapacity = 2;
+        while (mCapacity < capacity) {
+            mCapacity *= 2;
+        }
+
+        mMask = mCapacity - 1;
+        mSlots = std::make_unique<Slot[]>(mCapacity);
+
+        for (size_t i = 0; i < mCapacity; i++) {
+            mSlots[i].sequence.store(i, std::memory_order_relaxed);
+        }
+    }
+
+    template<typename T>
+    MPMCQueue<T>::~MPMCQueue() {
+        invalidate();
+
+        size_t position = mDequeuePosition.load(std::memory_order_relaxed);
+        size_t end = mEnqueuePosition.load(std::memory_order_relaxed);
+
+        for (; position != end; position++) {
+            mSlots[position & mMask].item()->~T();
+        }
+    }
+
+#pragma mark - Getters
+
+    template<typename T>
+    size_t
+    MPMCQueue<T>::capacity() const {
+        return mCapacity;
+    }
+
+    template<typename T>
+    bool
+    MPMCQueue<T>::empty() const {
+        size_t position = mDequeuePosition.load(std::memory_order_relaxed);
+        size_t sequence = mSlots[position & mMask].sequence.load(std::memory_order_acquire);
+        return intptr_t(sequence) - intptr_t(position + 1) < 0;
+    }
+
+    template<typename T>
+    bool
+    MPMCQueue<T>::isValid() const {
+        return mValid.load(std::memory_order_acquire);
+    }
+
+#pragma mark - Private helpers
+
+    template<typename T>
+    void
+    MPMCQueue<T>::Pause() {
+#if defined(__x86_64__) || defined(__i386__)
+        _mm_pause();
+#elif defined(__aarch64__)
+        asm volatile("yield");
+#endif
+    }
+
+    template<typename T>
+    bool
+    MPMCQueue<T>::isFull() const {
+        size_t position = mEnqueuePosition.load(std::memory_order_relaxed);
+        size_t sequence = mSlots[position & mMask].sequence.load(std::memory_order_acquire);
+        return intptr_t(sequence) - intptr_t(position) < 0;
+    }
+
+    template<typename T>
+    template<typename Predicate>
+    bool
+    MPMCQueue<T>::waitUntil(Parking &parking, Predicate &&predicate) {
+        uint32_t spinLimit = parking.spinLimit.load(std::memory_order_relaxed);
+
+        for (uint32_t i = 0; i < spinLimit + YieldCount; i++) {
+            if (!isValid()) {
+                return false;
+            }
+            if (predicate()) {
+                // Moves the budget towards the number of spins this wait took, like adaptive mutexes do
+                uint32_t spinCount = std::max(std::min(i * 2, MaximumSpinLimit), MinimumSpinLimit);
+                parking.spinLimit.store(spinLimit + (int32_t(spinCount) - int32_t(spinLimit)) / 8, std::memory_order_relaxed);
+                return true;
+            }
+
+            if (i < spinLimit) {
+                Pause();
+            } else {
+                std::this_thread::yield();
+            }
+        }
+
+        // Spinning didn't pay off, so spin less next time
+        parking.spinLimit.store(std::max(spinLimit - spinLimit / 8, MinimumSpinLimit), std::memory_order_relaxed);
+
+        std::unique_lock<std::mutex> lock(parking.mutex);
+        parking.parkedCount.fetch_add(1, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        parking.condition.wait(lock, [&] {
+            return !isValid() || predicate();
+        });
+        parking.parkedCount.fetch_sub(1, std::memory_order_relaxed);
+
+        return isValid();
+    }
+
+    template<typename T>
+    void
+    MPMCQueue<T>::wakeUp(Parking &parking) {
+        // Pairs with the parked count increment: either the parking thread sees the new state
+        // in its predicate or this thread sees it parking
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+
+        if (parking.parkedCount.load(std::memory_order_relaxed) > 0) {
+            std::lock_guard<std::mutex> lock(parking.mutex);
+            parking.condition.notify_one();
+        }
+    }
+
+#pragma mark - Pushing
+
+    template<typename T>
+    bool
+    MPMCQueue<T>::tryPush(T &&value) {
+        if (!isValid()) {
+            return false;
+        }
+
+        size_t position = mEnqueuePosition.load(std::memory_order_relaxed);
+        Slot *slot = nullptr;
+
+        while (true) {
+            slot = &mSlots[position & mMask];
+            size_t sequence = slot->sequence.load(std::memory_order_acquire);
+            intptr_t difference = intptr_t(sequence) - intptr_t(position);
+
+            if (difference == 0) {
+                if (mEnqueuePosition.compare_exchange_weak(position, position + 1, std::memory_order_relaxed)) {
+                    break;
+                }
+            } else if (difference < 0) {
+                return false;
+            } else {
+                position = mEnqueuePosition.load(std::memory_order_relaxed);
+            }
+        }
+
+        new(&slot->storage) T(std::move(value));
+        slot->sequence.store(position + 1, std::memory_order_release);
+
+        wakeUp(mConsumers);
+        return true;
+    }
+
+    template<typename T>
+    bool
+    MPMCQueue<T>::push(T value) {
+        while (!tryPush(std::move(value))) {
+            if (!waitUntil(mProducers, [this] { return !isFull(); })) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+#pragma mark - Popping
+
+    template<typename T>
+    bool
+    MPMCQueue<T>::tryPop(T &out) {
+        if (!isValid()) {
+            return false;
+        }
+
+        size_t position = mDequeuePosition.load(std::memory_order_relaxed);
+        Slot *slot = nullptr;
+
+        while (true) {
+            slot = &mSlots[position & mMask];
+            size_t sequence = slot->sequence.load(std::memory_order_acquire);
+            intptr_t difference = intptr_t(sequence) - intptr_t(position + 1);
+
+            if (difference == 0) {
+                if (mDequeuePosition.compare_exchange_weak(position, position + 1, std::memory_order_relaxed)) {
+                    break;
+                }
+            } else if (difference < 0) {
+                return false;
+            } else {
+                position = mDequeuePosition.load(std::memory_order_relaxed);
+            }
+        }
+
+        T *item = slot->item();
+        out = std::move(*item);
+        item->~T();
+
+        // Marks the slot as writable on the next lap
+        slot->sequence.store(position + mCapacity, std::memory_order_release);
+
+        wakeUp(mProducers);
+        return true;
+    }
+
+    template<typename T>
+    bool
+    MPMCQueue<T>::waitPop(T &out) {
+        while (!tryPop(out)) {
+            if (!waitUntil(mConsumers, [this] { return !empty(); })) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+#pragma mark - Maintenance
+
+    template<typename T>
+    void
+    MPMCQueue<T>::clear() {
+        T item;
+        while (tryPop(item)) {}
+    }
+
+    template<typename T>
+    void
+    MPMCQueue<T>::invalidate() {
+        mValid.store(false, std::memory_order_release);
+
+        for (Parking *parking : {&mConsumers, &mProducers}) {
+            std::lock_guard<std::mutex> lock(parking->mutex);
+            parking->condition.notify_all();
+        }
+    }
+
+}
+
+#endif /* MPMCQueueImpl_h */
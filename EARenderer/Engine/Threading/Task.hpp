@@ -0,0 +1,163 @@
+//
+//  Task.hpp
+//  EARenderer
+//
+//  Created by Pavlo Muratov on 17.10.2026.
+//  Copyright © 2026 MPO. All rights reserved.
+//
+
+#ifndef Task_hpp
+#define Task_hpp
+
+#include <atomic>
+#include <cstddef>
+#include <exception>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+namespace EARenderer {
+
+#pragma mark - Task Counter
+
+    /**
+     * Tracks completion of a set of tasks and keeps the first exception any of them has thrown.
+     */
+    class TaskCounter {
+    private:
+        std::atomic<size_t> mPendingCount{0};
+        std::atomic_bool mHasFailed{false};
+        std::exception_ptr mException;
+
+    public:
+        TaskCounter() = default;
+
+        TaskCounter(const TaskCounter &that) = delete;
+
+        TaskCounter &operator=(const TaskCounter &rhs) = delete;
+
+        bool isDone() const {
+            return mPendingCount.load(std::memory_order_acquire) == 0;
+        }
+
+        void increment() {
+            mPendingCount.fetch_add(1, std::memory_order_relaxed);
+        }
+
+        /**
+         * Has to be the last access to the counter by a finishing task,
+         * since a waiting thread may destroy the counter right after.
+         */
+        void decrement() {
+            mPendingCount.fetch_sub(1, std::memory_order_acq_rel);
+        }
+
+        void captureException(std::exception_ptr exception) {
+            if (!mHasFailed.exchange(true, std::memory_order_relaxed)) {
+                mException = exception;
+            }
+        }
+
+        /**
+         * Only valid once the counter is done.
+         */
+        void rethrowIfFailed() {
+            if (mException) {
+                std::exception_ptr exception = mException;
+                mException = nullptr;
+                mHasFailed.store(false, std::memory_order_relaxed);
+                std::rethrow_exception(exception);
+            }
+        }
+    };
+
+#pragma mark - Task
+
+    /**
+     * A type-erased callable. Callables that fit into InlineStorageSize bytes (lambdas capturing
+     * a handful of references or values) are stored inline, so scheduling them doesn't touch the heap.
+     *
+     * Tasks are neither copied nor moved, schedulers pass them around by pointer. Whoever creates
+     * a task keeps it alive until its counter reports completion.
+     */
+    class Task {
+    public:
+        static constexpr size_t InlineStorageSize = 48;
+
+    private:
+        using Invoker = void (*)(void *storage);
+        using Destroyer = void (*)(void *storage);
+
+        alignas(std::max_align_t) unsigned char mStorage[InlineStorageSize];
+        Invoker mInvoke = nullptr;
+        Destroyer mDestroy = nullptr;
+        TaskCounter *mCounter = nullptr;
+
+        template<typename Callable>
+        static constexpr bool IsStoredInline() {
+            return sizeof(Callable) <= InlineStorageSize && alignof(Callable) <= alignof(std::max_align_t);
+        }
+
+        void destroyCallable() {
+            if (mDestroy) {
+                mDestroy(mStorage);
+                mDestroy = nullptr;
+            }
+        }
+
+    public:
+        /**
+         @param func callable with no arguments
+         @param counter decremented once the task has finished, can be null
+         */
+        template<typename Func>
+        Task(Func &&func, TaskCounter *counter)
+                : mCounter(counter) {
+            using Callable = std::decay_t<Func>;
+
+            if constexpr (IsStoredInline<Callable>()) {
+                new(mStorage) Callable(std::forward<Func>(func));
+                mInvoke = [](void *storage) { (*reinterpret_cast<Callable *>(storage))(); };
+                mDestroy = [](void *storage) { reinterpret_cast<Callable *>(storage)->~Callable(); };
+            } else {
+                *reinterpret_cast<Callable **>(mStorage) = new Callable(std::forward<Func>(func));
+                mInvoke = [](void *storage) { (**reinterpret_cast<Callable **>(storage))(); };
+                mDestroy = [](void *storage) { delete *reinterpret_cast<Callable **>(storage); };
+            }
+        }
+
+        ~Task() {
+            destroyCallable();
+        }
+
+        Task(const Task &that) = delete;
+
+        Task &operator=(const Task &rhs) = delete;
+
+        /**
+         * Runs the callable, forwards its exception to the counter if there is one
+         * and signals completion. Must be executed exactly once.
+         */
+        void execute() {
+            TaskCounter *counter = mCounter;
+
+            try {
+                mInvoke(mStorage);
+            } catch (...) {
+                if (!counter) {
+                    throw;
+                }
+                counter->captureException(std::current_exception());
+            }
+
+            destroyCallable();
+
+            if (counter) {
+                counter->decrement();
+            }
+        }
+    };
+
+}
+
+#endif /* Task_hpp */
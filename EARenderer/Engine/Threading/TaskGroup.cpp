@@ -0,0 +1,30 @@
+//
+//  TaskGroup.cpp
+//  EARenderer
+//
+//  Created by Pavlo Muratov on 17.10.2026.
+//  Copyright © 2026 MPO. All rights reserved.
+//
+
+#include "TaskGroup.hpp"
+
+namespace EARenderer {
+
+#pragma mark - Lifecycle
+
+    TaskGroup::TaskGroup(ThreadPool &pool)
+            : mPool(pool), mQueueScope(pool) {}
+
+    TaskGroup::~TaskGroup() {
+        mPool.wait(mCounter);
+    }
+
+#pragma mark - Waiting
+
+    void TaskGroup::wait() {
+        mPool.wait(mCounter);
+        mTasks.clear();
+        mCounter.rethrowIfFailed();
+    }
+
+}
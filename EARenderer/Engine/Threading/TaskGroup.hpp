@@ -0,0 +1,72 @@
+//
+//  TaskGroup.hpp
+//  EARenderer
+//
+//  Created by Pavlo Muratov on 17.10.2026.
+//  Copyright © 2026 MPO. All rights reserved.
+//
+
+#ifndef TaskGroup_hpp
+#define TaskGroup_hpp
+
+#include "ThreadPool.hpp"
+
+#include <deque>
+
+namespace EARenderer {
+
+    // Fork/join set of tasks of arbitrary count.
+    //
+    // Tasks are stored inside the group in chunks, so spawning doesn't allocate per task.
+    // run() and wait() have to be called by the thread that created the group,
+    // tasks that want to spawn more work create nested groups of their own.
+
+    class TaskGroup {
+    private:
+        ThreadPool &mPool;
+        ThreadPool::QueueScope mQueueScope;
+        TaskCounter mCounter;
+        std::deque<Task> mTasks;
+
+    public:
+        explicit TaskGroup(ThreadPool &pool = ThreadPool::Default());
+
+        /**
+         Waits for tasks that are still running, exceptions thrown by them are dropped
+         */
+        ~TaskGroup();
+
+        TaskGroup(const TaskGroup &that) = delete;
+
+        TaskGroup &operator=(const TaskGroup &rhs) = delete;
+
+        /**
+         Schedules a callable taking no arguments
+
+         @param func callable to run
+         */
+        template<typename Func>
+        void run(Func &&func) {
+            mCounter.increment();
+
+            if (!mQueueScope.isBound()) {
+                // No deque is available for the calling thread, so there is no one to steal the task
+                Task task(std::forward<Func>(func), &mCounter);
+                task.execute();
+                return;
+            }
+
+            mTasks.emplace_back(std::forward<Func>(func), &mCounter);
+            mPool.schedule(&mTasks.back());
+        }
+
+        /**
+         Runs scheduled tasks on the calling thread along with the pool until all of them are finished.
+         Rethrows the first exception thrown by a task.
+         */
+        void wait();
+    };
+
+}
+
+#endif /* TaskGroup_hpp */
@@ -0,0 +1,218 @@
+//
+//  ThreadPool.cpp
+//  EARenderer
+//
+//  Created by Pavlo Muratov on 17.10.2026.
+//  Copyright © 2026 MPO. All rights reserved.
+//
+
+#include "ThreadPool.hpp"
+
+namespace EARenderer {
+
+    thread_local ThreadPool::ThreadContext ThreadPool::tThreadContext;
+
+    /**
+     * Xorshift, only used to spread thieves across victims
+     */
+    static uint32_t NextRandomNumber() {
+        static thread_local uint32_t state = uint32_t(std::hash<std::thread::id>()(std::this_thread::get_id())) | 1u;
+        state ^= state << 13;
+        state ^= state >> 17;
+        state ^= state << 5;
+        return state;
+    }
+
+#pragma mark - Queue scope
+
+    ThreadPool::QueueScope::QueueScope(ThreadPool &pool)
+            : mPool(&pool), mPreviousContext(tThreadContext) {
+        if (tThreadContext.pool == mPool) {
+            return;
+        }
+
+        for (size_t i = 0; i < ExternalQueueCount; i++) {
+            bool isClaimed = mPool->mExternalQueueClaims[i].load(std::memory_order_relaxed);
+            if (!isClaimed && !mPool->mExternalQueueClaims[i].exchange(true, std::memory_order_acquire)) {
+                tThreadContext = ThreadContext{mPool, mPool->mThreads.size() + i};
+                mHasClaimedQueue = true;
+                return;
+            }
+        }
+    }
+
+    ThreadPool::QueueScope::~QueueScope() {
+        if (!mHasClaimedQueue) {
+            return;
+        }
+
+        // Everything spawned within the scope has been joined, so the deque is empty again
+        size_t externalQueueIndex = tThreadContext.queueIndex - mPool->mThreads.size();
+        tThreadContext = mPreviousContext;
+        mPool->mExternalQueueClaims[externalQueueIndex].store(false, std::memory_order_release);
+    }
+
+    bool ThreadPool::QueueScope::isBound() const {
+        return tThreadContext.pool == mPool;
+    }
+
+#pragma mark - Lifecycle
+
+    ThreadPool::ThreadPool(const std::uint32_t numThreads)
+            : mExternalQueueClaims(std::make_unique<std::atomic_bool[]>(ExternalQueueCount)),
+              mSubmittedTasks(SubmittedTaskCapacity) {
+        for (size_t i = 0; i < numThreads + ExternalQueueCount; i++) {
+            mQueues.emplace_back(std::make_unique<WorkStealingDeque<Task *>>());
+        }
+
+        for (size_t i = 0; i < ExternalQueueCount; i++) {
+            mExternalQueueClaims[i].store(false, std::memory_order_relaxed);
+        }
+
+        try {
+            mThreads.reserve(numThreads);
+            for (std::uint32_t i = 0; i < numThreads; ++i) {
+                mThreads.emplace_back(&ThreadPool::worker, this, i);
+            }
+        }
+        catch (...) {
+            destroy();
+            throw;
+        }
+    }
+
+    ThreadPool::~ThreadPool() {
+        destroy();
+    }
+
+#pragma mark - Getters
+
+    bool ThreadPool::isWorkerThread() const {
+        return tThreadContext.pool == this && tThreadContext.queueIndex < mThreads.size();
+    }
+
+#pragma mark - Private helpers
+
+    size_t ThreadPool::automaticGrainSize(size_t count) const {
+        // Several chunks per thread, so that stealing can even out uneven chunk costs
+        size_t chunkCount = (mThreads.size() + 1) * 8;
+        return std::max(count / chunkCount, size_t(1));
+    }
+
+    size_t ThreadPool::currentQueueIndex() const {
+        return tThreadContext.pool == this ? tThreadContext.queueIndex : NoQueue;
+    }
+
+    void ThreadPool::schedule(Task *task) {
+        mQueues[currentQueueIndex()]->push(task);
+        notifyWorkAvailable();
+    }
+
+    void ThreadPool::notifyWorkAvailable() {
+        mWorkEpoch.fetch_add(1, std::memory_order_seq_cst);
+
+        // Pairs with the sleeping counter increment in worker(): either the worker sees the new epoch
+        // or this thread sees the worker going to sleep
+        if (mSleepingThreadCount.load(std::memory_order_seq_cst) > 0) {
+            std::lock_guard<std::mutex> lock(mSleepMutex);
+            mSleepCondition.notify_one();
+        }
+    }
+
+    bool ThreadPool::runNextTask(size_t queueIndex, bool takesSubmittedTasks) {
+        Task *task = nullptr;
+
+        if (queueIndex != NoQueue && mQueues[queueIndex]->pop(task)) {
+            task->execute();
+            return true;
+        }
+
+        size_t queueCount = mQueues.size();
+        size_t firstVictim = NextRandomNumber() % queueCount;
+
+        for (size_t i = 0; i < queueCount; i++) {
+            size_t victim = (firstVictim + i) % queueCount;
+            if (victim != queueIndex && mQueues[victim]->steal(task)) {
+                task->execute();
+                return true;
+            }
+        }
+
+        if (takesSubmittedTasks) {
+            std::unique_ptr<Task> submittedTask;
+            if (mSubmittedTasks.tryPop(submittedTask)) {
+                submittedTask->execute();
+                return true;
+            }
+        }
+
+        return false;
+    }
+
+    void ThreadPool::wait(TaskCounter &counter) {
+        size_t queueIndex = currentQueueIndex();
+        size_t idleIterationCount = 0;
+        std::chrono::microseconds sleepDuration = MinimumWaitSleep;
+
+        while (!counter.isDone()) {
+            if (runNextTask(queueIndex, false)) {
+                idleIterationCount = 0;
+                sleepDuration = MinimumWaitSleep;
+            } else if (++idleIterationCount < IdleSpinCount) {
+                std::this_thread::yield();
+            } else {
+                // The remaining work is being run by other threads, the longer it takes the less often to check
+                std::this_thread::sleep_for(sleepDuration);
+                sleepDuration = std::min(sleepDuration * 2, MaximumWaitSleep);
+            }
+        }
+    }
+
+    void ThreadPool::worker(size_t queueIndex) {
+        tThreadContext = ThreadContext{this, queueIndex};
+
+        while (!mDone) {
+            uint64_t workEpoch = mWorkEpoch.load(std::memory_order_seq_cst);
+
+            bool hasFoundWork = false;
+            for (size_t i = 0; i < IdleSpinCount && !hasFoundWork && !mDone; i++) {
+                hasFoundWork = runNextTask(queueIndex, true);
+                if (!hasFoundWork) {
+                    std::this_thread::yield();
+                }
+            }
+
+            if (hasFoundWork) {
+                continue;
+            }
+
+            std::unique_lock<std::mutex> lock(mSleepMutex);
+            mSleepingThreadCount.fetch_add(1, std::memory_order_seq_cst);
+            mSleepCondition.wait(lock, [this, workEpoch] {
+                return mDone || mWorkEpoch.load(std::memory_order_seq_cst) != workEpoch;
+            });
+            mSleepingThreadCount.fetch_sub(1, std::memory_order_seq_cst);
+        }
+
+        tThreadContext = ThreadContext();
+    }
+
+    void ThreadPool::destroy() {
+        {
+            std::lock_guard<std::mutex> lock(mSleepMutex);
+            mDone = true;
+            mSleepCondition.notify_all();
+        }
+
+        for (auto &thread : mThreads) {
+            if (thread.joinable()) {
+                thread.join();
+            }
+        }
+
+        // Jobs that never ran break their promises, so whoever waits on them gets an exception
+        mSubmittedTasks.clear();
+        mSubmittedTasks.invalidate();
+    }
+
+}
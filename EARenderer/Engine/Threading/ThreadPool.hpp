@@ -9,71 +9,44 @@
 #ifndef ThreadPool_hpp
 #define ThreadPool_hpp
 
-#include "ThreadSafeQueue.hpp"
+#include "MPMCQueue.hpp"
+#include "WorkStealingDeque.hpp"
+#include "Task.hpp"
 
 #include <algorithm>
 #include <atomic>
+#include <chrono>
+#include <condition_variable>
 #include <cstdint>
 #include <functional>
 #include <future>
 #include <memory>
+#include <mutex>
+#include <stdexcept>
 #include <thread>
 #include <type_traits>
 #include <utility>
 #include <vector>
 
-// http://roar11.com/2016/01/a-platform-independent-thread-pool-using-c14/
-
 namespace EARenderer {
 
-    class ThreadPool {
-    private:
-
-#pragma mark - Thread Task Interface
-
-        class IThreadTask {
-        public:
-            IThreadTask(void) = default;
-
-            virtual ~IThreadTask(void) = default;
-
-            IThreadTask(const IThreadTask &rhs) = delete;
-
-            IThreadTask &operator=(const IThreadTask &rhs) = delete;
-
-            IThreadTask(IThreadTask &&other) = default;
-
-            IThreadTask &operator=(IThreadTask &&other) = default;
-
-            virtual void execute() = 0;
-        };
-
-#pragma mark - Thread Task
-
-        template<typename Func>
-        class ThreadTask : public IThreadTask {
-        private:
-            Func mFunc;
-
-        public:
-            ThreadTask(Func &&func) : mFunc(std::move(func)) {
-            }
-
-            ~ThreadTask(void) override = default;
-
-            ThreadTask(const ThreadTask &rhs) = delete;
-
-            ThreadTask &operator=(const ThreadTask &rhs) = delete;
-
-            ThreadTask(ThreadTask &&other) = default;
-
-            ThreadTask &operator=(ThreadTask &&other) = default;
-
-            void execute() override {
-                mFunc();
-            }
-        };
+    class TaskGroup;
+
+    // Work stealing thread pool.
+    //
+    // Every worker owns a Chase-Lev deque. Tasks spawned by fork/join primitives (join, parallelFor,
+    // parallelReduce, TaskGroup) are pushed to the deque of the spawning thread and stolen
+    // oldest-first by idle workers, so the scheduler doesn't serialize on a lock. Such tasks live on the
+    // stack of the spawning function or in its TaskGroup, they are never heap allocated.
+    //
+    // Threads outside of the pool borrow one of ExternalQueueCount deques for the duration of a
+    // fork/join call. Threads waiting for spawned work help run tasks instead of blocking.
+    //
+    // Jobs passed to submit() are long running and independent (texture decoding and alike).
+    // They go through a separate lock-free queue served by workers only, so waiting on a fork/join
+    // call never gets stuck behind one of them.
 
+    class ThreadPool {
     public:
 
 #pragma mark - Task Future
@@ -110,100 +83,231 @@ namespace EARenderer {
             }
         };
 
+    private:
+        friend class TaskGroup;
+
+#pragma mark - Thread Context
+
+        static constexpr size_t NoQueue = -1;
+
+        /// Number of deques lent to threads outside of the pool
+        static constexpr size_t ExternalQueueCount = 4;
+
+        /// Failed attempts to find work before an idle thread backs off
+        static constexpr size_t IdleSpinCount = 64;
+
+        /// Sleep range of a thread waiting for tasks other threads are busy with, doubled on every idle attempt
+        static constexpr std::chrono::microseconds MinimumWaitSleep{10};
+        static constexpr std::chrono::microseconds MaximumWaitSleep{1000};
+
+        /// Jobs submitted past this many pending ones block the submitting thread, or run on it if it's a worker
+        static constexpr size_t SubmittedTaskCapacity = 1024;
+
+        struct ThreadContext {
+            ThreadPool *pool = nullptr;
+            size_t queueIndex = NoQueue;
+        };
+
+        static thread_local ThreadContext tThreadContext;
+
+        /**
+         * Binds the calling thread to a deque of the pool for its lifetime.
+         * Worker threads are already bound to their own deques, in which case nothing happens.
+         */
+        class QueueScope {
+        private:
+            ThreadPool *mPool = nullptr;
+            ThreadContext mPreviousContext;
+            bool mHasClaimedQueue = false;
+
+        public:
+            QueueScope(ThreadPool &pool);
+
+            ~QueueScope();
+
+            QueueScope(const QueueScope &that) = delete;
+
+            QueueScope &operator=(const QueueScope &rhs) = delete;
+
+            /**
+             @return false if all external deques are in use, spawned tasks have to be run inline then
+             */
+            bool isBound() const;
+        };
+
 #pragma mark - Thread Pool Member Variables
 
-    private:
         std::atomic_bool mDone = false;
-        ThreadSafeQueue<std::unique_ptr<IThreadTask>> mTaskQueue;
+        std::vector<std::unique_ptr<WorkStealingDeque<Task *>>> mQueues;
+        std::unique_ptr<std::atomic_bool[]> mExternalQueueClaims;
+        MPMCQueue<std::unique_ptr<Task>> mSubmittedTasks;
         std::vector<std::thread> mThreads;
 
+        std::mutex mSleepMutex;
+        std::condition_variable mSleepCondition;
+        std::atomic<uint64_t> mWorkEpoch = 0;
+        std::atomic<uint32_t> mSleepingThreadCount = 0;
+
     public:
 
 #pragma mark - Thread Pool Lifecycle
 
-        static ThreadPool &Default() {
-            static ThreadPool defaultPool;
-            return defaultPool;
-        }
-
-        ThreadPool()
-                :
-                ThreadPool(std::max(std::thread::hardware_concurrency(), 2u) - 1u) {
+    private:
+        static std::uint32_t &DefaultPoolThreadCount() {
             /*
              * Always create at least one thread.  If hardware_concurrency() returns 0,
              * subtracting one would turn it to UINT_MAX, so get the maximum of
              * hardware_concurrency() and 2 before subtracting 1.
              */
+            static std::uint32_t threadCount = std::max(std::thread::hardware_concurrency(), 2u) - 1u;
+            return threadCount;
         }
 
-        explicit ThreadPool(const std::uint32_t numThreads) {
-            try {
-                for (std::uint32_t i = 0; i < numThreads; ++i) {
-                    mThreads.emplace_back(&ThreadPool::worker, this);
-                }
-            }
-            catch (...) {
-                destroy();
-                throw;
+        static bool &IsDefaultPoolCreated() {
+            static bool isCreated = false;
+            return isCreated;
+        }
+
+    public:
+        static ThreadPool &Default() {
+            static ThreadPool defaultPool([] {
+                IsDefaultPoolCreated() = true;
+                return DefaultPoolThreadCount();
+            }());
+            return defaultPool;
+        }
+
+        /**
+         Overrides the number of workers of the default pool. Has to be called before the default pool is first used.
+
+         @param threadCount number of worker threads, at least one
+         */
+        static void SetDefaultThreadCount(std::uint32_t threadCount) {
+            if (IsDefaultPoolCreated()) {
+                throw std::logic_error("Default thread pool has already been created");
             }
+            DefaultPoolThreadCount() = std::max(threadCount, 1u);
         }
 
+        ThreadPool()
+                :
+                ThreadPool(DefaultPoolThreadCount()) {}
+
+        explicit ThreadPool(const std::uint32_t numThreads);
+
         ThreadPool(const ThreadPool &rhs) = delete;
 
         ThreadPool &operator=(const ThreadPool &rhs) = delete;
 
-        ~ThreadPool() {
-            destroy();
+        ~ThreadPool();
+
+#pragma mark - Thread Pool Getters
+
+        std::size_t threadCount() const {
+            return mThreads.size();
         }
 
+        /**
+         @return whether the calling thread is one of this pool's workers
+         */
+        bool isWorkerThread() const;
+
 #pragma mark - Thread Pool Job Submission
 
         /**
-         * Submit a job to be run by the thread pool.
+         * Submit a long running, independent job to be run by the thread pool.
+         * Fine grained work should use parallelFor(), parallelReduce() or TaskGroup instead.
+         *
+         * When SubmittedTaskCapacity jobs are already pending, threads outside of the pool block until
+         * a worker takes one, while workers run the job themselves. Jobs submitted to a pool that is
+         * being destroyed are dropped, their futures report a broken promise.
          */
         template<typename Func, typename... Args>
-        auto submit(Func &&func, Args &&... args) {
-            auto boundTask = std::bind(std::forward<Func>(func), std::forward<Args>(args)...);
-            using ResultType = std::result_of_t<decltype(boundTask)()>;
-            using PackagedTask = std::packaged_task<ResultType()>;
-            using TaskType = ThreadTask<PackagedTask>;
-
-            PackagedTask task(std::move(boundTask));
-            TaskFuture<ResultType> result(task.get_future());
-            mTaskQueue.push(std::make_unique<TaskType>(std::move(task)));
-            return result;
-        }
+        auto submit(Func &&func, Args &&... args);
+
+#pragma mark - Fork/Join
+
+        /**
+         Runs both callables, potentially in parallel, and returns once both have finished.
+         The calling thread runs the first one and helps with other work while waiting for the second.
+         The first exception thrown by either callable is rethrown.
+         */
+        template<typename FuncA, typename FuncB>
+        void join(FuncA &&a, FuncB &&b);
+
+        /**
+         Splits [begin, end) into chunks and processes them in parallel.
+
+         @param begin first index
+         @param end index past the last one
+         @param grainSize maximum number of indices per chunk, 0 picks one automatically
+         @param func callable taking (size_t chunkBegin, size_t chunkEnd)
+         */
+        template<typename Func>
+        void parallelFor(size_t begin, size_t end, size_t grainSize, Func &&func);
+
+        /**
+         Splits [begin, end) into chunks, maps each of them to a value and combines the values.
+         Chunks are combined in index order, so reduce doesn't need to be commutative.
+
+         @param begin first index
+         @param end index past the last one
+         @param grainSize maximum number of indices per chunk, 0 picks one automatically
+         @param identity result for an empty range
+         @param map callable taking (size_t chunkBegin, size_t chunkEnd) and returning T
+         @param reduce callable taking (T, T) and returning T
+         @return reduced value
+         */
+        template<typename T, typename Map, typename Reduce>
+        T parallelReduce(size_t begin, size_t end, size_t grainSize, const T &identity, Map &&map, Reduce &&reduce);
 
     private:
 
 #pragma mark - Thread Pool Private Heplers
 
+        size_t automaticGrainSize(size_t count) const;
+
+        size_t currentQueueIndex() const;
+
+        template<typename Func>
+        void parallelForRange(size_t begin, size_t end, size_t grainSize, Func &func);
+
+        template<typename T, typename Map, typename Reduce>
+        T parallelReduceRange(size_t begin, size_t end, size_t grainSize, const T &identity, Map &map, Reduce &reduce);
+
         /**
-         * Constantly running function each thread uses to acquire work items from the queue.
+         * Pushes a task to the deque of the calling thread, which has to be bound to the pool.
          */
-        void worker() {
-            while (!mDone) {
-                std::unique_ptr<IThreadTask> pTask(nullptr);
-                if (mTaskQueue.waitPop(pTask)) {
-                    pTask->execute();
-                }
-            }
-        }
+        void schedule(Task *task);
+
+        void notifyWorkAvailable();
 
         /**
-         * Invalidates the queue and joins all running threads.
+         * Runs one task taken from the own deque, stolen from another one or, optionally, a submitted job.
+         *
+         * @return false if no work was found
          */
-        void destroy() {
-            mDone = true;
-            mTaskQueue.invalidate();
+        bool runNextTask(size_t queueIndex, bool takesSubmittedTasks);
 
-            for (auto &thread : mThreads) {
-                if (thread.joinable()) {
-                    thread.join();
-                }
-            }
-        }
+        /**
+         * Runs other tasks until the counter is done.
+         * Sleeps with exponential backoff once there is nothing left to help with.
+         */
+        void wait(TaskCounter &counter);
+
+        /**
+         * Constantly running function each thread uses to acquire work items.
+         */
+        void worker(size_t queueIndex);
+
+        /**
+         * Wakes up and joins all running threads.
+         */
+        void destroy();
     };
+
 }
 
+#include "ThreadPoolImpl.hpp"
+
 #endif /* ThreadPool_hpp */
@@ -0,0 +1,143 @@
+//
+//  ThreadPoolImpl.hpp
+//  EARenderer
+//
+//  Created by Pavlo Muratov on 17.10.2026.
+//  Copyright © 2026 MPO. All rights reserved.
+//
+
+#ifndef ThreadPoolImpl_h
+#define ThreadPoolImpl_h
+
+namespace EARenderer {
+
+#pragma mark - Job Submission
+
+    template<typename Func, typename... Args>
+    auto
+    ThreadPool::submit(Func &&func, Args &&... args) {
+        auto boundTask = std::bind(std::forward<Func>(func), std::forward<Args>(args)...);
+        using ResultType = std::result_of_t<decltype(boundTask)()>;
+        using PackagedTask = std::packaged_task<ResultType()>;
+
+        PackagedTask packagedTask(std::move(boundTask));
+        TaskFuture<ResultType> result(packagedTask.get_future());
+
+        auto task = std::make_unique<Task>([packagedTask = std::move(packagedTask)]() mutable {
+            packagedTask();
+        }, nullptr);
+
+        if (mSubmittedTasks.tryPush(std::move(task))) {
+            notifyWorkAvailable();
+        } else if (isWorkerThread()) {
+            // Blocking until a worker frees up a slot could deadlock when every worker does the same
+            task->execute();
+        } else if (mSubmittedTasks.push(std::move(task))) {
+            // Backpressure: the submitting thread has waited for workers to catch up instead of running the job itself
+            notifyWorkAvailable();
+        }
+
+        return result;
+    }
+
+#pragma mark - Fork/Join
+
+    template<typename FuncA, typename FuncB>
+    void
+    ThreadPool::join(FuncA &&a, FuncB &&b) {
+        QueueScope queueScope(*this);
+
+        if (!queueScope.isBound()) {
+            a();
+            b();
+            return;
+        }
+
+        TaskCounter counter;
+        counter.increment();
+
+        Task task(std::forward<FuncB>(b), &counter);
+        schedule(&task);
+
+        // The spawned task lives on this stack frame, so it has to finish even if the first callable throws
+        std::exception_ptr exception;
+        try {
+            a();
+        } catch (...) {
+            exception = std::current_exception();
+        }
+
+        // Anything pushed by the first callable has been joined already, so the bottom of the deque is
+        // either the spawned task or, if it was stolen, nothing at all (thieves take the oldest tasks first)
+        Task *bottomTask = nullptr;
+        if (mQueues[currentQueueIndex()]->pop(bottomTask)) {
+            bottomTask->execute();
+        }
+
+        wait(counter);
+
+        if (exception) {
+            std::rethrow_exception(exception);
+        }
+        counter.rethrowIfFailed();
+    }
+
+    template<typename Func>
+    void
+    ThreadPool::parallelFor(size_t begin, size_t end, size_t grainSize, Func &&func) {
+        if (begin >= end) {
+            return;
+        }
+
+        // Bind once for the whole recursion instead of on every split
+        QueueScope queueScope(*this);
+        parallelForRange(begin, end, grainSize ? grainSize : automaticGrainSize(end - begin), func);
+    }
+
+    template<typename T, typename Map, typename Reduce>
+    T
+    ThreadPool::parallelReduce(size_t begin, size_t end, size_t grainSize, const T &identity, Map &&map, Reduce &&reduce) {
+        if (begin >= end) {
+            return identity;
+        }
+
+        QueueScope queueScope(*this);
+        return parallelReduceRange(begin, end, grainSize ? grainSize : automaticGrainSize(end - begin), identity, map, reduce);
+    }
+
+#pragma mark - Private helpers
+
+    template<typename Func>
+    void
+    ThreadPool::parallelForRange(size_t begin, size_t end, size_t grainSize, Func &func) {
+        if (end - begin <= grainSize) {
+            func(begin, end);
+            return;
+        }
+
+        size_t middle = begin + (end - begin) / 2;
+
+        join([&] { parallelForRange(begin, middle, grainSize, func); },
+             [&] { parallelForRange(middle, end, grainSize, func); });
+    }
+
+    template<typename T, typename Map, typename Reduce>
+    T
+    ThreadPool::parallelReduceRange(size_t begin, size_t end, size_t grainSize, const T &identity, Map &map, Reduce &reduce) {
+        if (end - begin <= grainSize) {
+            return map(begin, end);
+        }
+
+        size_t middle = begin + (end - begin) / 2;
+        T left = identity;
+        T right = identity;
+
+        join([&] { left = parallelReduceRange(begin, middle, grainSize, identity, map, reduce); },
+             [&] { right = parallelReduceRange(middle, end, grainSize, identity, map, reduce); });
+
+        return reduce(std::move(left), std::move(right));
+    }
+
+}
+
+#endif /* ThreadPoolImpl_h */
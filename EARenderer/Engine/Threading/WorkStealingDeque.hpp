@@ -0,0 +1,102 @@
+//
+//  WorkStealingDeque.hpp
+//  EARenderer
+//
+//  Created by Pavlo Muratov on 17.10.2026.
+//  Copyright © 2026 MPO. All rights reserved.
+//
+
+#ifndef WorkStealingDeque_hpp
+#define WorkStealingDeque_hpp
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <vector>
+#include <type_traits>
+
+namespace EARenderer {
+
+    // Chase-Lev work stealing deque with the memory orderings of Lê et al.,
+    // "Correct and Efficient Work-Stealing for Weak Memory Models".
+    //
+    // The owning thread pushes and pops at the bottom without taking any locks,
+    // other threads steal from the top, so the oldest (and usually the largest) work is stolen first.
+    // Storage grows on demand. Replaced buffers are kept alive until the deque is destroyed,
+    // since a thief may still be reading from them.
+
+    template<typename T>
+    class WorkStealingDeque {
+    public:
+        static_assert(std::is_trivially_copyable<T>::value, "Work stealing deque elements must be trivially copyable");
+
+    private:
+        class Buffer {
+        private:
+            int64_t mCapacity;
+            int64_t mMask;
+            std::unique_ptr<std::atomic<T>[]> mItems;
+
+        public:
+            Buffer(int64_t capacity);
+
+            int64_t capacity() const;
+
+            T get(int64_t index) const;
+
+            void put(int64_t index, T item);
+
+            std::unique_ptr<Buffer> grown(int64_t bottom, int64_t top) const;
+        };
+
+        static constexpr size_t CacheLineSize = 64;
+
+        alignas(CacheLineSize) std::atomic<int64_t> mTop;
+        alignas(CacheLineSize) std::atomic<int64_t> mBottom;
+        alignas(CacheLineSize) std::atomic<Buffer *> mBuffer;
+
+        /// Owner-only, holds the current buffer along with all replaced ones
+        std::vector<std::unique_ptr<Buffer>> mBuffers;
+
+    public:
+        /**
+         @param capacity initial capacity, rounded up to a power of two
+         */
+        explicit WorkStealingDeque(size_t capacity = 256);
+
+        WorkStealingDeque(const WorkStealingDeque &that) = delete;
+
+        WorkStealingDeque &operator=(const WorkStealingDeque &rhs) = delete;
+
+        /**
+         @return approximate emptiness, exact only when called by the owner with no thieves around
+         */
+        bool isEmpty() const;
+
+        /**
+         Owner only
+         */
+        void push(T item);
+
+        /**
+         Owner only. Takes the most recently pushed item.
+
+         @param item receives the popped item
+         @return false if the deque was empty
+         */
+        bool pop(T &item);
+
+        /**
+         Can be called from any thread. Takes the least recently pushed item.
+
+         @param item receives the stolen item
+         @return false if the deque was empty or another thread won the race for the item
+         */
+        bool steal(T &item);
+    };
+
+}
+
+#include "WorkStealingDequeImpl.hpp"
+
+#endif /* WorkStealingDeque_hpp */
@@ -0,0 +1,143 @@
+//
+//  WorkStealingDequeImpl.hpp
+//  EARenderer
+//
+//  Created by Pavlo Muratov on 17.10.2026.
+//  Copyright © 2026 MPO. All rights reserved.
+//
+
+#ifndef WorkStealingDequeImpl_h
+#define WorkStealingDequeImpl_h
+
+namespace EARenderer {
+
+#pragma mark - Buffer
+
+    template<typename T>
+    WorkStealingDeque<T>::Buffer::Buffer(int64_t capacity)
+            : mCapacity(capacity), mMask(capacity - 1), mItems(std::make_unique<std::atomic<T>[]>(capacity)) {}
+
+    template<typename T>
+    int64_t
+    WorkStealingDeque<T>::Buffer::capacity() const {
+        return mCapacity;
+    }
+
+    template<typename T>
+    T
+    WorkStealingDeque<T>::Buffer::get(int64_t index) const {
+        return mItems[index & mMask].load(std::memory_order_relaxed);
+    }
+
+    template<typename T>
+    void
+    WorkStealingDeque<T>::Buffer::put(int64_t index, T item) {
+        mItems[index & mMask].store(item, std::memory_order_relaxed);
+    }
+
+    template<typename T>
+    std::unique_ptr<typename WorkStealingDeque<T>::Buffer>
+    WorkStealingDeque<T>::Buffer::grown(int64_t bottom, int64_t top) const {
+        auto buffer = std::make_unique<Buffer>(mCapacity * 2);
+        for (int64_t i = top; i < bottom; i++) {
+            buffer->put(i, get(i));
+        }
+        return buffer;
+    }
+
+#pragma mark - Lifecycle
+
+    template<typename T>
+    WorkStealingDeque<T>::WorkStealingDeque(size_t capacity)
+            : mTop(0), mBottom(0) {
+        int64_t powerOfTwoCapacity = 1;
+        while (powerOfTwoCapacity < int64_t(capacity)) {
+            powerOfTwoCapacity *= 2;
+        }
+
+        mBuffers.emplace_back(std::make_unique<Buffer>(powerOfTwoCapacity));
+        mBuffer.store(mBuffers.back().get(), std::memory_order_relaxed);
+    }
+
+#pragma mark - Getters
+
+    template<typename T>
+    bool
+    WorkStealingDeque<T>::isEmpty() const {
+        int64_t bottom = mBottom.load(std::memory_order_relaxed);
+        int64_t top = mTop.load(std::memory_order_relaxed);
+        return bottom <= top;
+    }
+
+#pragma mark - Owner operations
+
+    template<typename T>
+    void
+    WorkStealingDeque<T>::push(T item) {
+        int64_t bottom = mBottom.load(std::memory_order_relaxed);
+        int64_t top = mTop.load(std::memory_order_acquire);
+        Buffer *buffer = mBuffer.load(std::memory_order_relaxed);
+
+        if (bottom - top > buffer->capacity() - 1) {
+            mBuffers.emplace_back(buffer->grown(bottom, top));
+            buffer = mBuffers.back().get();
+            mBuffer.store(buffer, std::memory_order_release);
+        }
+
+        buffer->put(bottom, item);
+        mBottom.store(bottom + 1, std::memory_order_release);
+    }
+
+    template<typename T>
+    bool
+    WorkStealingDeque<T>::pop(T &item) {
+        int64_t bottom = mBottom.load(std::memory_order_relaxed) - 1;
+        Buffer *buffer = mBuffer.load(std::memory_order_relaxed);
+        mBottom.store(bottom, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        int64_t top = mTop.load(std::memory_order_relaxed);
+
+        if (top > bottom) {
+            mBottom.store(bottom + 1, std::memory_order_relaxed);
+            return false;
+        }
+
+        item = buffer->get(bottom);
+
+        if (top == bottom) {
+            // Last item, race against thieves for it
+            bool isWon = mTop.compare_exchange_strong(top, top + 1, std::memory_order_seq_cst, std::memory_order_relaxed);
+            mBottom.store(bottom + 1, std::memory_order_relaxed);
+            return isWon;
+        }
+
+        return true;
+    }
+
+#pragma mark - Stealing
+
+    template<typename T>
+    bool
+    WorkStealingDeque<T>::steal(T &item) {
+        int64_t top = mTop.load(std::memory_order_acquire);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        int64_t bottom = mBottom.load(std::memory_order_acquire);
+
+        if (top >= bottom) {
+            return false;
+        }
+
+        Buffer *buffer = mBuffer.load(std::memory_order_acquire);
+        T stolenItem = buffer->get(top);
+
+        if (!mTop.compare_exchange_strong(top, top + 1, std::memory_order_seq_cst, std::memory_order_relaxed)) {
+            return false;
+        }
+
+        item = stolenItem;
+        return true;
+    }
+
+}
+
+#endif /* WorkStealingDequeImpl_h */
@@ -0,0 +1,204 @@
+//
+//  SceneDescription.cpp
+//  EARenderer
+//
+//  Created by Pavlo Muratov on 17.10.2026.
+//  Copyright © 2026 MPO. All rights reserved.
+//
+
+#include "SceneDescription.hpp"
+#include "StringUtils.hpp"
+
+#include <fstream>
+#include <sstream>
+#include <unordered_map>
+#include <stdexcept>
+
+#include <glm/gtc/matrix_transform.hpp>
+
+namespace EARenderer {
+
+    static std::string ResolvedPath(const std::string &path, const std::string &directory) {
+        if (path.empty() || path.front() == '/' || directory.empty()) {
+            return path;
+        }
+        return directory + "/" + path;
+    }
+
+    template<class T>
+    static T ReadArgument(std::istringstream &arguments, const std::string &keyword) {
+        T value;
+        if (!(arguments >> value)) {
+            throw std::invalid_argument(string_format("Missing or malformed argument of '%s'", keyword.c_str()));
+        }
+        return value;
+    }
+
+    static glm::vec3 ReadVector(std::istringstream &arguments, const std::string &keyword) {
+        float x = ReadArgument<float>(arguments, keyword);
+        float y = ReadArgument<float>(arguments, keyword);
+        float z = ReadArgument<float>(arguments, keyword);
+        return glm::vec3(x, y, z);
+    }
+
+#pragma mark - Lifecycle
+
+    SceneDescription::SceneDescription(const std::string &filePath) {
+        std::ifstream stream(filePath);
+        if (!stream.is_open()) {
+            throw std::invalid_argument(string_format("Failed to open scene description (%s)", filePath.c_str()));
+        }
+
+        size_t separator = filePath.find_last_of('/');
+        std::string directory = separator == std::string::npos ? "" : filePath.substr(0, separator);
+
+        std::string line;
+        size_t lineNumber = 0;
+
+        while (std::getline(stream, line)) {
+            lineNumber++;
+            line = line.substr(0, line.find('#'));
+
+            std::istringstream arguments(line);
+            std::string keyword;
+            if (!(arguments >> keyword)) {
+                continue;
+            }
+
+            try {
+                parseStatement(keyword, arguments, directory);
+            } catch (const std::invalid_argument &error) {
+                throw std::invalid_argument(string_format("%s:%zu: %s", filePath.c_str(), lineNumber, error.what()));
+            }
+        }
+    }
+
+#pragma mark - Parsing
+
+    void SceneDescription::parseStatement(const std::string &keyword, std::istringstream &arguments, const std::string &directory) {
+        if (keyword == "name") {
+            mName = ReadArgument<std::string>(arguments, keyword);
+        } else if (keyword == "surfel_spacing") {
+            mSurfelSpacing = ReadArgument<float>(arguments, keyword);
+        } else if (keyword == "probe_spacing") {
+            mDiffuseProbeSpacing = ReadArgument<float>(arguments, keyword);
+        } else if (keyword == "baking_volume_scale") {
+            mBakingVolumeScale = ReadVector(arguments, keyword);
+        } else if (keyword == "material") {
+            MaterialEntry material;
+            material.name = ReadArgument<std::string>(arguments, keyword);
+            auto source = ReadArgument<std::string>(arguments, keyword);
+
+            if (source == "albedo") {
+                material.albedo = ResolvedPath(ReadArgument<std::string>(arguments, keyword), directory);
+            } else if (source == "color") {
+                glm::vec3 rgb = ReadVector(arguments, keyword);
+                material.albedo = Color(rgb.r, rgb.g, rgb.b);
+            } else {
+                throw std::invalid_argument(string_format("Unknown albedo source '%s'", source.c_str()));
+            }
+
+            mMaterials.push_back(material);
+        } else if (keyword == "mesh") {
+            MeshEntry mesh;
+            mesh.name = ReadArgument<std::string>(arguments, keyword);
+            mesh.path = ResolvedPath(ReadArgument<std::string>(arguments, keyword), directory);
+            mMeshes.push_back(mesh);
+        } else if (keyword == "instance") {
+            InstanceEntry instance;
+            instance.meshName = ReadArgument<std::string>(arguments, keyword);
+
+            std::string option;
+            while (arguments >> option) {
+                if (option == "translation") {
+                    instance.translation = ReadVector(arguments, option);
+                } else if (option == "scale") {
+                    instance.scale = ReadArgument<float>(arguments, option);
+                } else if (option == "material") {
+                    instance.materialName = ReadArgument<std::string>(arguments, option);
+                } else {
+                    throw std::invalid_argument(string_format("Unknown instance option '%s'", option.c_str()));
+                }
+            }
+
+            mInstances.push_back(instance);
+        } else if (keyword == "sub_mesh_material") {
+            if (mInstances.empty()) {
+                throw std::invalid_argument("'sub_mesh_material' must follow an instance");
+            }
+
+            auto subMeshMaterialName = ReadArgument<std::string>(arguments, keyword);
+            auto materialName = ReadArgument<std::string>(arguments, keyword);
+            mInstances.back().subMeshMaterials.emplace_back(subMeshMaterialName, materialName);
+        } else {
+            throw std::invalid_argument(string_format("Unknown statement '%s'", keyword.c_str()));
+        }
+    }
+
+#pragma mark - Getters
+
+    const std::string &SceneDescription::name() const {
+        return mName;
+    }
+
+#pragma mark - Loading
+
+    void SceneDescription::load(SharedResourceStorage &resourceStorage, Scene &scene) const {
+        std::unordered_map<std::string, MaterialReference> materials;
+        std::unordered_map<std::string, ID> meshes;
+
+        auto material = [&](const std::string &name) {
+            auto it = materials.find(name);
+            if (it == materials.end()) {
+                throw std::invalid_argument(string_format("Unknown material '%s'", name.c_str()));
+            }
+            return it->second;
+        };
+
+        for (auto &entry : mMaterials) {
+            materials[entry.name] = resourceStorage.addMaterial(CookTorranceMaterial::BakingProxy(entry.albedo));
+        }
+
+        for (auto &entry : mMeshes) {
+            meshes[entry.name] = resourceStorage.addMesh(Mesh(entry.path));
+        }
+
+        for (auto &entry : mInstances) {
+            auto meshIt = meshes.find(entry.meshName);
+            if (meshIt == meshes.end()) {
+                throw std::invalid_argument(string_format("Unknown mesh '%s'", entry.meshName.c_str()));
+            }
+
+            const Mesh &mesh = resourceStorage.mesh(meshIt->second);
+            MeshInstance instance(meshIt->second, mesh);
+
+            Transformation transformation = instance.transformation();
+            transformation.translation = entry.translation;
+            transformation.scale *= entry.scale;
+            instance.setTransformation(transformation);
+
+            if (!entry.materialName.empty()) {
+                instance.materialReference = material(entry.materialName);
+            }
+
+            for (auto &subMeshMaterial : entry.subMeshMaterials) {
+                MaterialReference reference = material(subMeshMaterial.second);
+
+                for (ID subMeshID : mesh.subMeshes()) {
+                    if (mesh.subMeshes()[subMeshID].materialName() == subMeshMaterial.first) {
+                        instance.setMaterialReferenceForSubMeshID(reference, subMeshID);
+                    }
+                }
+            }
+
+            scene.addMeshInstanceWithIDAsStatic(scene.meshInstances().insert(instance));
+        }
+
+        scene.calculateGeometricProperties(resourceStorage);
+        scene.setLightBakingVolume(scene.boundingBox().transformedBy(glm::scale(glm::mat4(1.0), mBakingVolumeScale)));
+        scene.setName(mName);
+        scene.setSurfelSpacing(mSurfelSpacing);
+        scene.setDiffuseProbeSpacing(mDiffuseProbeSpacing);
+    }
+
+}
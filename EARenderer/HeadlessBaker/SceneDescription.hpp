@@ -0,0 +1,91 @@
+//
+//  SceneDescription.hpp
+//  EARenderer
+//
+//  Created by Pavlo Muratov on 17.10.2026.
+//  Copyright © 2026 MPO. All rights reserved.
+//
+
+#ifndef SceneDescription_hpp
+#define SceneDescription_hpp
+
+#include "Scene.hpp"
+#include "SharedResourceStorage.hpp"
+#include "Color.hpp"
+
+#include <string>
+#include <vector>
+#include <variant>
+#include <utility>
+#include <glm/vec3.hpp>
+
+namespace EARenderer {
+
+    // Plain text description of a scene to bake, one statement per line:
+    //
+    //   name <scene name>
+    //   surfel_spacing <distance>
+    //   probe_spacing <distance>
+    //   baking_volume_scale <x> <y> <z>
+    //   material <name> albedo <image path>
+    //   material <name> color <r> <g> <b>
+    //   mesh <name> <path>
+    //   instance <mesh name> [translation <x> <y> <z>] [scale <factor>] [material <material name>]
+    //   sub_mesh_material <sub mesh material name> <material name>
+    //
+    // '#' starts a comment. Relative paths are resolved against the directory of the description file.
+    // All instances are static, sub_mesh_material statements apply to the instance preceding them.
+    // Baking volume is the scene's bounding box scaled relative to the origin.
+
+    class SceneDescription {
+    private:
+        struct MaterialEntry {
+            std::string name;
+            std::variant<std::string, Color> albedo;
+        };
+
+        struct MeshEntry {
+            std::string name;
+            std::string path;
+        };
+
+        struct InstanceEntry {
+            std::string meshName;
+            glm::vec3 translation = glm::vec3(0.0);
+            float scale = 1.0;
+            std::string materialName;
+            std::vector<std::pair<std::string, std::string>> subMeshMaterials;
+        };
+
+        std::string mName = "scene";
+        float mSurfelSpacing = 0.05;
+        float mDiffuseProbeSpacing = 0.25;
+        glm::vec3 mBakingVolumeScale = glm::vec3(1.0);
+        std::vector<MaterialEntry> mMaterials;
+        std::vector<MeshEntry> mMeshes;
+        std::vector<InstanceEntry> mInstances;
+
+        void parseStatement(const std::string &keyword, std::istringstream &arguments, const std::string &directory);
+
+    public:
+        /**
+         @param filePath path to the description file
+         @throws std::invalid_argument if the file can't be read or contains a malformed statement
+         */
+        SceneDescription(const std::string &filePath);
+
+        const std::string &name() const;
+
+        /**
+         Loads meshes and materials into the storage and composes the scene out of them.
+         Materials are baking proxies, so no OpenGL context is required.
+         The ray tracer is left for the caller to build.
+
+         @throws std::invalid_argument if a statement references an unknown mesh or material
+         */
+        void load(SharedResourceStorage &resourceStorage, Scene &scene) const;
+    };
+
+}
+
+#endif /* SceneDescription_hpp */
@@ -0,0 +1,103 @@
+//
+//  main.cpp
+//  EARenderer
+//
+//  Created by Pavlo Muratov on 17.10.2026.
+//  Copyright © 2026 MPO. All rights reserved.
+//
+
+// Bakes surfels and diffuse light probes of a scene without a window or an OpenGL context.
+//
+//   EARendererBake [--threads <count>] [--seed <seed>] [--force] <scene description>
+//
+// --threads 0 disables multithreading, by default all hardware threads but one are used.
+// --seed makes surfel generation reproducible, the seed of every bake is printed in its report.
+// Bake files are written into the working directory, the same way the editor does it.
+
+#include "SceneDescription.hpp"
+#include "SceneBaker.hpp"
+#include "ThreadPool.hpp"
+#include "Measurement.hpp"
+
+#include <cstdio>
+#include <cstdint>
+#include <cstdlib>
+#include <string>
+#include <stdexcept>
+
+static void PrintUsage(const char *executable) {
+    fprintf(stderr, "Usage: %s [--threads <count>] [--seed <seed>] [--force] <scene description>\n", executable);
+}
+
+int main(int argc, const char *argv[]) {
+    std::string descriptionPath;
+    EARenderer::SceneBaker::Settings settings;
+    settings.gpuUploadEnabled = false;
+
+    for (int i = 1; i < argc; i++) {
+        std::string argument(argv[i]);
+
+        if (argument == "--threads" && i + 1 < argc) {
+            char *end = nullptr;
+            long threadCount = strtol(argv[++i], &end, 10);
+
+            if (*end != '\0' || threadCount < 0) {
+                PrintUsage(argv[0]);
+                return EXIT_FAILURE;
+            }
+
+            if (threadCount == 0) {
+                settings.multithreadingEnabled = false;
+            } else {
+                EARenderer::ThreadPool::SetDefaultThreadCount(uint32_t(threadCount));
+            }
+        } else if (argument == "--seed" && i + 1 < argc) {
+            char *end = nullptr;
+            unsigned long seed = strtoul(argv[++i], &end, 10);
+
+            if (*end != '\0' || seed > UINT32_MAX) {
+                PrintUsage(argv[0]);
+                return EXIT_FAILURE;
+            }
+
+            settings.seed = uint32_t(seed);
+        } else if (argument == "--force") {
+            settings.forceRebake = true;
+        } else if (descriptionPath.empty() && argument[0] != '-') {
+            descriptionPath = argument;
+        } else {
+            PrintUsage(argv[0]);
+            return EXIT_FAILURE;
+        }
+    }
+
+    if (descriptionPath.empty()) {
+        PrintUsage(argv[0]);
+        return EXIT_FAILURE;
+    }
+
+    try {
+        EARenderer::SceneDescription description(descriptionPath);
+        EARenderer::SharedResourceStorage resourceStorage;
+        EARenderer::Scene scene;
+
+        EARenderer::Measurement::ExecutionTime("Loading meshes and composing the scene took", [&]() {
+            description.load(resourceStorage, scene);
+        });
+
+        EARenderer::Measurement::ExecutionTime("Embree BVH generation took", [&]() {
+            scene.buildStaticGeometryRaytracer(resourceStorage);
+        });
+
+        EARenderer::SceneBaker baker(&resourceStorage, &scene, settings);
+        baker.bake();
+
+        printf("%s\n", baker.report().description().c_str());
+        printf("Bake files: %s, %s\n", baker.surfelStorageFileName().c_str(), baker.diffuseProbeStorageFileName().c_str());
+    } catch (const std::exception &error) {
+        fprintf(stderr, "%s\n", error.what());
+        return EXIT_FAILURE;
+    }
+
+    return EXIT_SUCCESS;
+}
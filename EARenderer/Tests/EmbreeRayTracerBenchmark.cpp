@@ -0,0 +1,122 @@
+//
+//  EmbreeRayTracerBenchmark.cpp
+//  EARenderer
+//
+//  Created by Pavlo Muratov on 17.10.2026.
+//  Copyright © 2026 MPO. All rights reserved.
+//
+
+// Traces random segments and rays through a cloud of random triangles one by one and in packets,
+// checks that both paths agree and prints the time per ray in ns.
+//
+//   EmbreeRayTracerBenchmark [--triangles <count>] [--rays <count>] [--repetitions <count>]
+
+#include "EmbreeRayTracer.hpp"
+#include "TestUtils.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <limits>
+#include <random>
+
+using namespace EARenderer;
+
+namespace {
+
+    double NanosecondsPerItem(std::chrono::steady_clock::time_point start, size_t itemCount) {
+        return std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count() / itemCount;
+    }
+
+    const char *FaceFilterName(EmbreeRayTracer::FaceFilter filter) {
+        switch (filter) {
+            case EmbreeRayTracer::FaceFilter::None: return "no culling";
+            case EmbreeRayTracer::FaceFilter::CullFront: return "front culling";
+            case EmbreeRayTracer::FaceFilter::CullBack: return "back culling";
+        }
+        return "";
+    }
+
+}
+
+int main(int argc, const char *argv[]) {
+    size_t triangleCount = TestUtils::IntegerOption(argc, argv, "--triangles", 100000);
+    size_t rayCount = TestUtils::IntegerOption(argc, argv, "--rays", 1000000);
+    size_t repetitionCount = TestUtils::IntegerOption(argc, argv, "--repetitions", 3);
+
+    std::mt19937 engine(42);
+    std::uniform_real_distribution<float> coordinate(-1.0f, 1.0f);
+    std::uniform_real_distribution<float> offset(-0.02f, 0.02f);
+
+    auto randomPoint = [&] {
+        return glm::vec3(coordinate(engine), coordinate(engine), coordinate(engine));
+    };
+
+    // Small triangles scattered through a cube, so that rays are neither all blocked nor all free
+    std::vector<Triangle3D> triangles;
+    for (size_t i = 0; i < triangleCount; i++) {
+        glm::vec3 a = randomPoint();
+        triangles.emplace_back(a,
+                a + glm::vec3(offset(engine), offset(engine), offset(engine)),
+                a + glm::vec3(offset(engine), offset(engine), offset(engine)));
+    }
+
+    EmbreeRayTracer rayTracer(triangles);
+
+    std::vector<EmbreeRayTracer::LineSegment> segments;
+    std::vector<Ray3D> rays;
+    for (size_t i = 0; i < rayCount; i++) {
+        segments.push_back({randomPoint(), randomPoint()});
+        rays.emplace_back(randomPoint(), glm::normalize(randomPoint() + glm::vec3(1e-3f)));
+    }
+
+    for (auto filter : {EmbreeRayTracer::FaceFilter::None, EmbreeRayTracer::FaceFilter::CullBack}) {
+        double singleOcclusion = 1e9, packetOcclusion = 1e9;
+        double singleHit = 1e9, packetHit = 1e9;
+        size_t occludedCount = 0, hitCount = 0;
+
+        for (size_t repetition = 0; repetition < repetitionCount; repetition++) {
+            std::vector<bool> singleOccluded(segments.size());
+            auto start = std::chrono::steady_clock::now();
+            for (size_t i = 0; i < segments.size(); i++) {
+                singleOccluded[i] = rayTracer.lineSegmentOccluded(segments[i].p0, segments[i].p1, 0.0f, 0.0f, filter);
+            }
+            singleOcclusion = std::min(singleOcclusion, NanosecondsPerItem(start, segments.size()));
+
+            std::vector<bool> packetOccluded;
+            start = std::chrono::steady_clock::now();
+            rayTracer.lineSegmentsOccluded(segments, packetOccluded, 0.0f, 0.0f, filter);
+            packetOcclusion = std::min(packetOcclusion, NanosecondsPerItem(start, segments.size()));
+
+            EXPECT(singleOccluded == packetOccluded, "Packet occlusion differs from single segment occlusion with %s", FaceFilterName(filter));
+            occludedCount = std::count(packetOccluded.begin(), packetOccluded.end(), true);
+
+            std::vector<float> singleDistances(rays.size());
+            start = std::chrono::steady_clock::now();
+            for (size_t i = 0; i < rays.size(); i++) {
+                if (!rayTracer.rayHit(rays[i], singleDistances[i], filter)) {
+                    singleDistances[i] = std::numeric_limits<float>::max();
+                }
+            }
+            singleHit = std::min(singleHit, NanosecondsPerItem(start, rays.size()));
+
+            std::vector<float> packetDistances;
+            start = std::chrono::steady_clock::now();
+            hitCount = rayTracer.raysHit(rays, packetDistances, filter);
+            packetHit = std::min(packetHit, NanosecondsPerItem(start, rays.size()));
+
+            for (size_t i = 0; i < rays.size(); i++) {
+                float tolerance = 1e-4f * std::max(1.0f, singleDistances[i]);
+                EXPECT(std::abs(singleDistances[i] - packetDistances[i]) <= tolerance,
+                        "Ray %zu hit at %f alone and at %f in a packet with %s", i, singleDistances[i], packetDistances[i], FaceFilterName(filter));
+            }
+        }
+
+        printf("%s, %zu of %zu segments occluded: single %.0f, packet %.0f ns per segment\n",
+                FaceFilterName(filter), occludedCount, segments.size(), singleOcclusion, packetOcclusion);
+        printf("%s, %zu of %zu rays hit: single %.0f, packet %.0f ns per ray\n",
+                FaceFilterName(filter), hitCount, rays.size(), singleHit, packetHit);
+    }
+
+    return TestUtils::ExitCode();
+}
@@ -0,0 +1,140 @@
+//
+//  EmbreeRayTracerStressTest.cpp
+//  EARenderer
+//
+//  Created by Pavlo Muratov on 17.10.2026.
+//  Copyright © 2026 MPO. All rights reserved.
+//
+
+// Issues single and packet queries with different face filters from ThreadPool workers at the same time
+// and compares every result with the one computed on a single thread beforehand.
+//
+//   EmbreeRayTracerStressTest [--triangles <count>] [--queries <count>] [--iterations <count>]
+
+#include "EmbreeRayTracer.hpp"
+#include "ThreadPool.hpp"
+#include "TestUtils.hpp"
+
+#include <algorithm>
+#include <limits>
+#include <random>
+#include <thread>
+
+using namespace EARenderer;
+
+namespace {
+
+    constexpr size_t BatchSize = 40;
+
+    // Neighbouring batches use different filters, so that concurrent queries disagree on what to cull
+    EmbreeRayTracer::FaceFilter BatchFaceFilter(size_t batch) {
+        static const EmbreeRayTracer::FaceFilter Filters[] = {
+                EmbreeRayTracer::FaceFilter::None,
+                EmbreeRayTracer::FaceFilter::CullFront,
+                EmbreeRayTracer::FaceFilter::CullBack
+        };
+        return Filters[batch % 3];
+    }
+
+    // Results of single and packet queries of a batch, in the order of its queries
+    struct BatchResults {
+        std::vector<bool> occluded;
+        std::vector<bool> packetOccluded;
+        std::vector<float> distances;
+        std::vector<float> packetDistances;
+    };
+
+    BatchResults TraceBatch(const EmbreeRayTracer &rayTracer,
+                            const std::vector<EmbreeRayTracer::LineSegment> &segments,
+                            const std::vector<Ray3D> &rays,
+                            size_t batch) {
+        size_t begin = batch * BatchSize;
+        size_t end = std::min(begin + BatchSize, segments.size());
+        auto filter = BatchFaceFilter(batch);
+
+        BatchResults results;
+
+        for (size_t i = begin; i < end; i++) {
+            results.occluded.push_back(rayTracer.lineSegmentOccluded(segments[i].p0, segments[i].p1, 0.0f, 0.0f, filter));
+
+            float distance = std::numeric_limits<float>::max();
+            results.distances.push_back(rayTracer.rayHit(rays[i], distance, filter) ? distance : std::numeric_limits<float>::max());
+        }
+
+        rayTracer.lineSegmentsOccluded({segments.begin() + begin, segments.begin() + end}, results.packetOccluded, 0.0f, 0.0f, filter);
+        rayTracer.raysHit({rays.begin() + begin, rays.begin() + end}, results.packetDistances, filter);
+
+        return results;
+    }
+
+}
+
+int main(int argc, const char *argv[]) {
+    size_t triangleCount = TestUtils::IntegerOption(argc, argv, "--triangles", 5000);
+    size_t queryCount = TestUtils::IntegerOption(argc, argv, "--queries", 4000);
+    size_t iterationCount = TestUtils::IntegerOption(argc, argv, "--iterations", 3);
+
+    std::mt19937 engine(7);
+    std::uniform_real_distribution<float> coordinate(-1.0f, 1.0f);
+    std::uniform_real_distribution<float> offset(-0.05f, 0.05f);
+
+    auto randomPoint = [&] {
+        return glm::vec3(coordinate(engine), coordinate(engine), coordinate(engine));
+    };
+
+    std::vector<Triangle3D> triangles;
+    for (size_t i = 0; i < triangleCount; i++) {
+        glm::vec3 a = randomPoint();
+        triangles.emplace_back(a,
+                a + glm::vec3(offset(engine), offset(engine), offset(engine)),
+                a + glm::vec3(offset(engine), offset(engine), offset(engine)));
+    }
+
+    EmbreeRayTracer rayTracer(triangles);
+
+    std::vector<EmbreeRayTracer::LineSegment> segments;
+    std::vector<Ray3D> rays;
+    for (size_t i = 0; i < queryCount; i++) {
+        segments.push_back({randomPoint(), randomPoint()});
+        rays.emplace_back(randomPoint(), glm::normalize(randomPoint() + glm::vec3(1e-3f)));
+    }
+
+    size_t batchCount = (queryCount + BatchSize - 1) / BatchSize;
+
+    std::vector<BatchResults> expected;
+    size_t occludedCount = 0;
+    for (size_t batch = 0; batch < batchCount; batch++) {
+        expected.push_back(TraceBatch(rayTracer, segments, rays, batch));
+        occludedCount += std::count(expected.back().occluded.begin(), expected.back().occluded.end(), true);
+    }
+
+    EXPECT(occludedCount > 0 && occludedCount < queryCount, "Scene occludes %zu of %zu segments, results won't tell filters apart", occludedCount, queryCount);
+
+    ThreadPool pool(std::max(std::thread::hardware_concurrency(), 4u));
+
+    for (size_t iteration = 0; iteration < iterationCount; iteration++) {
+        std::vector<BatchResults> actual(batchCount);
+
+        pool.parallelFor(0, batchCount, 1, [&](size_t begin, size_t end) {
+            for (size_t batch = begin; batch < end; batch++) {
+                actual[batch] = TraceBatch(rayTracer, segments, rays, batch);
+            }
+        });
+
+        for (size_t batch = 0; batch < batchCount; batch++) {
+            for (size_t i = 0; i < expected[batch].occluded.size(); i++) {
+                size_t query = batch * BatchSize + i;
+                EXPECT(actual[batch].occluded[i] == expected[batch].occluded[i], "Segment %zu occlusion changed under concurrency", query);
+                EXPECT(actual[batch].packetOccluded[i] == expected[batch].packetOccluded[i], "Packet segment %zu occlusion changed under concurrency", query);
+                EXPECT(actual[batch].distances[i] == expected[batch].distances[i], "Ray %zu hit at %f instead of %f under concurrency",
+                        query, actual[batch].distances[i], expected[batch].distances[i]);
+                EXPECT(actual[batch].packetDistances[i] == expected[batch].packetDistances[i], "Packet ray %zu hit at %f instead of %f under concurrency",
+                        query, actual[batch].packetDistances[i], expected[batch].packetDistances[i]);
+            }
+        }
+    }
+
+    printf("%zu iterations of %zu concurrent queries checked, %zu segments occluded\n", iterationCount, queryCount, occludedCount);
+
+    return TestUtils::ExitCode();
+}
@@ -0,0 +1,145 @@
+//
+//  LogarithmicBinBenchmark.cpp
+//  EARenderer
+//
+//  Created by Pavlo Muratov on 17.10.2026.
+//  Copyright © 2026 MPO. All rights reserved.
+//
+
+// Fills LogarithmicBin with triangle-like weights spread log-uniformly over a 4096x range and measures
+// building the bin, sampling it, and the sample-erase-split step surfel generation performs on triangles.
+// Also checks that sampling follows object weights and is reproducible with an injected engine.
+//
+//   LogarithmicBinBenchmark [--objects <count>] [--samples <count>] [--repetitions <count>]
+
+#include "LogarithmicBin.hpp"
+#include "TestUtils.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <random>
+
+using namespace EARenderer;
+
+namespace {
+
+    constexpr float MinimumWeight = 1.0f;
+    constexpr float MaximumWeight = 4096.0f;
+
+    double MillisecondsSince(std::chrono::steady_clock::time_point start) {
+        return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+    }
+
+    double NanosecondsPerItem(std::chrono::steady_clock::time_point start, size_t itemCount) {
+        return std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count() / itemCount;
+    }
+
+    void TestWeightShares() {
+        LogarithmicBin<uint32_t> bin(MinimumWeight, MaximumWeight);
+        std::vector<float> weights{1.0f, 3.0f, 17.0f, 250.0f, 4000.0f};
+
+        float totalWeight = 0.0f;
+        for (uint32_t i = 0; i < weights.size(); i++) {
+            bin.insert(i, weights[i]);
+            totalWeight += weights[i];
+        }
+
+        constexpr size_t SampleCount = 1000000;
+        std::vector<size_t> hits(weights.size(), 0);
+        std::mt19937 engine(1);
+
+        for (size_t i = 0; i < SampleCount; i++) {
+            hits[*bin.random(engine)]++;
+        }
+
+        for (size_t i = 0; i < weights.size(); i++) {
+            double expected = weights[i] / totalWeight;
+            double observed = double(hits[i]) / SampleCount;
+            EXPECT(std::abs(observed - expected) < 0.002, "Object of weight %f was picked with frequency %f instead of %f",
+                    weights[i], observed, expected);
+        }
+    }
+
+    void TestDeterminism(const std::vector<float> &weights) {
+        // Bins seeded differently have to agree when sampled through the same injected engine
+        LogarithmicBin<uint32_t> first(MinimumWeight, MaximumWeight, 1);
+        LogarithmicBin<uint32_t> second(MinimumWeight, MaximumWeight, 2);
+
+        for (uint32_t i = 0; i < weights.size(); i++) {
+            first.insert(i, weights[i]);
+            second.insert(i, weights[i]);
+        }
+
+        std::mt19937 firstEngine(99);
+        std::mt19937 secondEngine(99);
+
+        for (size_t i = 0; i < 10000; i++) {
+            uint32_t firstPick = *first.random(firstEngine);
+            uint32_t secondPick = *second.random(secondEngine);
+            EXPECT(firstPick == secondPick, "Sample %zu picked %u and %u with identical engines", i, firstPick, secondPick);
+        }
+    }
+
+}
+
+int main(int argc, const char *argv[]) {
+    size_t objectCount = TestUtils::IntegerOption(argc, argv, "--objects", 1000000);
+    size_t sampleCount = TestUtils::IntegerOption(argc, argv, "--samples", 1000000);
+    size_t repetitionCount = TestUtils::IntegerOption(argc, argv, "--repetitions", 3);
+
+    std::mt19937 engine(42);
+    std::uniform_real_distribution<float> exponent(std::log2(MinimumWeight), std::log2(MaximumWeight));
+
+    std::vector<float> weights;
+    for (size_t i = 0; i < objectCount; i++) {
+        weights.push_back(std::exp2(exponent(engine)));
+    }
+
+    TestWeightShares();
+    TestDeterminism(weights);
+
+    double build = 1e9, sample = 1e9, split = 1e9;
+
+    for (size_t repetition = 0; repetition < repetitionCount; repetition++) {
+        // Objects are their own weights, so that split objects know the weight of their quarters
+        auto start = std::chrono::steady_clock::now();
+        LogarithmicBin<float> bin(MinimumWeight, MaximumWeight);
+        for (float weight : weights) {
+            bin.insert(weight, weight);
+        }
+        build = std::min(build, MillisecondsSince(start));
+
+        double checksum = 0.0;
+        start = std::chrono::steady_clock::now();
+        for (size_t i = 0; i < sampleCount; i++) {
+            checksum += *bin.random(engine);
+        }
+        sample = std::min(sample, NanosecondsPerItem(start, sampleCount));
+
+        // Surfel generation replaces a picked triangle by its four quarters, unless they get too small
+        size_t expectedSize = objectCount;
+        start = std::chrono::steady_clock::now();
+        for (size_t i = 0; i < sampleCount && !bin.empty(); i++) {
+            auto it = bin.random(engine);
+            float quarterWeight = *it * 0.25f;
+            bin.erase(it);
+            expectedSize--;
+
+            if (quarterWeight >= MinimumWeight) {
+                for (size_t quarter = 0; quarter < 4; quarter++) {
+                    bin.insert(quarterWeight, quarterWeight);
+                }
+                expectedSize += 4;
+            }
+        }
+        split = std::min(split, NanosecondsPerItem(start, sampleCount));
+
+        EXPECT(bin.size() == expectedSize, "Bin holds %llu objects instead of %zu", (unsigned long long) bin.size(), expectedSize);
+        EXPECT(checksum > 0.0 || objectCount == 0, "Samples didn't touch the objects");
+    }
+
+    printf("%zu objects: build %.1f ms, sample %.0f ns, split step %.0f ns\n", objectCount, build, sample, split);
+
+    return TestUtils::ExitCode();
+}
@@ -0,0 +1,192 @@
+//
+//  MPMCQueueStressTest.cpp
+//  EARenderer
+//
+//  Created by Pavlo Muratov on 17.10.2026.
+//  Copyright © 2026 MPO. All rights reserved.
+//
+
+// Pushes unique values through MPMCQueue from several producers to several consumers and checks
+// that each of them arrives exactly once and in the order its producer pushed it.
+// Also floods ThreadPool::submit() past the queue capacity from inside and outside of the pool.
+//
+//   MPMCQueueStressTest [--items <count per producer>]
+
+#include "MPMCQueue.hpp"
+#include "ThreadPool.hpp"
+#include "TestUtils.hpp"
+
+#include <atomic>
+#include <chrono>
+#include <thread>
+#include <vector>
+
+using namespace EARenderer;
+
+static void TestTransfer(size_t producerCount, size_t consumerCount, size_t itemsPerProducer, bool isBlocking) {
+    // Small capacity keeps the queue wrapping around and producers running into a full queue
+    MPMCQueue<uint64_t> queue(16);
+
+    std::vector<std::atomic<uint8_t>> received(producerCount * itemsPerProducer);
+    for (auto &flag : received) {
+        flag.store(0, std::memory_order_relaxed);
+    }
+
+    std::atomic<size_t> consumedCount{0};
+    size_t totalCount = producerCount * itemsPerProducer;
+
+    std::vector<std::thread> threads;
+
+    for (size_t p = 0; p < producerCount; p++) {
+        threads.emplace_back([&, p] {
+            for (size_t i = 0; i < itemsPerProducer; i++) {
+                // Producer index in the high bits, sequence number in the low ones
+                uint64_t value = (uint64_t(p) << 32) | i;
+                if (isBlocking) {
+                    EXPECT(queue.push(value), "Blocking push failed on a valid queue");
+                } else {
+                    while (!queue.tryPush(std::move(value))) {
+                        std::this_thread::yield();
+                    }
+                }
+            }
+        });
+    }
+
+    for (size_t c = 0; c < consumerCount; c++) {
+        threads.emplace_back([&] {
+            std::vector<int64_t> lastSequences(producerCount, -1);
+
+            while (consumedCount.load(std::memory_order_relaxed) < totalCount) {
+                uint64_t value = 0;
+                bool hasValue = isBlocking ? queue.waitPop(value) : queue.tryPop(value);
+
+                if (!hasValue) {
+                    if (!queue.isValid()) {
+                        return;
+                    }
+                    std::this_thread::yield();
+                    continue;
+                }
+
+                size_t producer = size_t(value >> 32);
+                int64_t sequence = int64_t(value & 0xFFFFFFFF);
+
+                EXPECT(producer < producerCount, "Popped a value of nonexistent producer %zu", producer);
+                if (producer >= producerCount) {
+                    continue;
+                }
+
+                // A single consumer sees values of every producer in the order they were pushed
+                EXPECT(sequence > lastSequences[producer], "Producer %zu value %lld popped after %lld",
+                        producer, (long long) sequence, (long long) lastSequences[producer]);
+                lastSequences[producer] = sequence;
+
+                uint8_t previous = received[producer * itemsPerProducer + size_t(sequence)].fetch_add(1);
+                EXPECT(previous == 0, "Producer %zu value %lld popped twice", producer, (long long) sequence);
+
+                if (consumedCount.fetch_add(1) + 1 == totalCount) {
+                    // Lets consumers blocked in waitPop() go
+                    queue.invalidate();
+                }
+            }
+        });
+    }
+
+    for (auto &thread : threads) {
+        thread.join();
+    }
+
+    EXPECT(consumedCount.load() == totalCount, "Consumed %zu values instead of %zu", consumedCount.load(), totalCount);
+    EXPECT(queue.empty(), "Queue isn't empty after every value was consumed");
+}
+
+static void TestInvalidation() {
+    // Blocked consumers and producers have to return once their queue is invalidated
+    MPMCQueue<int> emptyQueue(4);
+    MPMCQueue<int> fullQueue(4);
+
+    while (fullQueue.tryPush(42)) {}
+
+    std::thread consumer([&] {
+        int value = 0;
+        EXPECT(!emptyQueue.waitPop(value), "waitPop succeeded on an empty invalidated queue");
+    });
+
+    std::thread producer([&] {
+        EXPECT(!fullQueue.push(7), "Blocking push succeeded on a full invalidated queue");
+    });
+
+    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    emptyQueue.invalidate();
+    fullQueue.invalidate();
+
+    consumer.join();
+    producer.join();
+
+    EXPECT(!emptyQueue.tryPush(1), "tryPush succeeded on an invalidated queue");
+
+    int value = 0;
+    EXPECT(!fullQueue.tryPop(value), "tryPop succeeded on an invalidated queue");
+}
+
+static void TestSubmission(size_t jobCount) {
+    ThreadPool pool(std::max(std::thread::hardware_concurrency(), 2u));
+
+    // External threads flood the submission queue past its capacity and get blocked by backpressure
+    std::vector<std::thread> threads;
+    std::atomic<size_t> sum{0};
+
+    for (size_t t = 0; t < 4; t++) {
+        threads.emplace_back([&, t] {
+            std::vector<ThreadPool::TaskFuture<size_t>> futures;
+            for (size_t i = 0; i < jobCount; i++) {
+                futures.emplace_back(pool.submit([i, t] {
+                    return i * 4 + t;
+                }));
+            }
+            for (auto &future : futures) {
+                sum += future.get();
+            }
+        });
+    }
+
+    for (auto &thread : threads) {
+        thread.join();
+    }
+
+    size_t expectedSum = 4 * jobCount * (4 * jobCount - 1) / 2;
+    EXPECT(sum.load() == expectedSum, "Submitted jobs summed up to %zu instead of %zu", sum.load(), expectedSum);
+
+    // Workers submitting more jobs than fit in the queue run the excess themselves instead of blocking
+    std::atomic<size_t> nestedCount{0};
+    auto outer = pool.submit([&] {
+        std::vector<ThreadPool::TaskFuture<void>> futures;
+        for (size_t i = 0; i < jobCount; i++) {
+            futures.emplace_back(pool.submit([&] {
+                nestedCount++;
+            }));
+        }
+    });
+    outer.get();
+
+    EXPECT(nestedCount.load() == jobCount, "Nested submissions ran %zu jobs instead of %zu", nestedCount.load(), jobCount);
+}
+
+int main(int argc, const char *argv[]) {
+    size_t itemCount = TestUtils::IntegerOption(argc, argv, "--items", 50000);
+
+    for (bool isBlocking : {false, true}) {
+        TestTransfer(1, 1, itemCount, isBlocking);
+        TestTransfer(4, 1, itemCount, isBlocking);
+        TestTransfer(1, 4, itemCount, isBlocking);
+        TestTransfer(4, 4, itemCount, isBlocking);
+    }
+
+    TestInvalidation();
+    TestSubmission(itemCount / 10);
+
+    printf("MPMCQueue and job submission checks finished\n");
+
+    return TestUtils::ExitCode();
+}
@@ -0,0 +1,123 @@
+//
+//  PackedLookupTableBenchmark.cpp
+//  EARenderer
+//
+//  Created by Pavlo Muratov on 17.10.2026.
+//  Copyright © 2026 MPO. All rights reserved.
+//
+
+// Inserts objects of a mesh instance's size into PackedLookupTable, looks them up in random order,
+// erases every other one and iterates over the rest, first reading the objects and then only
+// a column stored next to them. Checks that column values follow their objects on erase.
+// Prints the best time of each phase in ms.
+//
+//   PackedLookupTableBenchmark [--objects <count>] [--repetitions <count>]
+
+#include "PackedLookupTable.hpp"
+#include "TestUtils.hpp"
+
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <random>
+
+using namespace EARenderer;
+
+namespace {
+
+    struct Object {
+        std::array<float, 36> payload;
+    };
+
+    static_assert(sizeof(Object) == 144, "Benchmark object is meant to be as large as a mesh instance");
+
+    // Hot field that tight loops read without touching the objects
+    struct Weight {
+        float value = 0.0f;
+    };
+
+    struct Timings {
+        double insert = 1e9;
+        double lookup = 1e9;
+        double erase = 1e9;
+        double iterate = 1e9;
+        double iterateColumn = 1e9;
+    };
+
+    double MillisecondsSince(std::chrono::steady_clock::time_point start) {
+        return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+    }
+
+}
+
+int main(int argc, const char *argv[]) {
+    size_t objectCount = TestUtils::IntegerOption(argc, argv, "--objects", 1000000);
+    size_t repetitionCount = TestUtils::IntegerOption(argc, argv, "--repetitions", 5);
+
+    Timings best;
+    std::mt19937 engine(42);
+
+    for (size_t repetition = 0; repetition < repetitionCount; repetition++) {
+        // Starts small, so that growth is part of the measurement
+        PackedLookupTable<Object, Weight> table(16);
+        std::vector<ID> ids;
+        ids.reserve(objectCount);
+
+        auto start = std::chrono::steady_clock::now();
+        for (size_t i = 0; i < objectCount; i++) {
+            Object object;
+            object.payload.fill(float(i));
+            ids.push_back(table.insert(object));
+            table.column<Weight>(ids.back()).value = float(i);
+        }
+        best.insert = std::min(best.insert, MillisecondsSince(start));
+
+        std::vector<ID> shuffledIDs = ids;
+        std::shuffle(shuffledIDs.begin(), shuffledIDs.end(), engine);
+
+        float checksum = 0.0f;
+        start = std::chrono::steady_clock::now();
+        for (ID id : shuffledIDs) {
+            checksum += table[id].payload[0];
+        }
+        best.lookup = std::min(best.lookup, MillisecondsSince(start));
+
+        start = std::chrono::steady_clock::now();
+        for (size_t i = 0; i < ids.size(); i += 2) {
+            table.erase(ids[i]);
+        }
+        best.erase = std::min(best.erase, MillisecondsSince(start));
+
+        start = std::chrono::steady_clock::now();
+        for (ID id : table) {
+            checksum += table[id].payload[1];
+        }
+        best.iterate = std::min(best.iterate, MillisecondsSince(start));
+
+        float columnChecksum = 0.0f;
+        start = std::chrono::steady_clock::now();
+        for (size_t i = 0; i < table.size(); i++) {
+            columnChecksum += table.columnAt<Weight>(i).value;
+        }
+        best.iterateColumn = std::min(best.iterateColumn, MillisecondsSince(start));
+
+        size_t misplacedCount = 0;
+        for (size_t i = 0; i < table.size(); i++) {
+            misplacedCount += table.columnAt<Weight>(i).value != table.objectAt(i).payload[0];
+        }
+        for (size_t i = 1; i < ids.size(); i += 2) {
+            misplacedCount += table.column<Weight>(ids[i]).value != float(i);
+        }
+
+        EXPECT(misplacedCount == 0, "%zu column values didn't follow their objects", misplacedCount);
+        EXPECT(columnChecksum > 0.0f || objectCount < 4, "Column iteration didn't touch the values");
+
+        EXPECT(table.size() == objectCount / 2, "%zu objects left instead of %zu", table.size(), objectCount / 2);
+        EXPECT(checksum > 0.0f || objectCount < 2, "Lookups didn't touch the objects");
+    }
+
+    printf("%zu objects: insert %.1f, lookup %.1f, erase %.1f, iterate %.1f, iterate column %.1f ms\n",
+            objectCount, best.insert, best.lookup, best.erase, best.iterate, best.iterateColumn);
+
+    return TestUtils::ExitCode();
+}
@@ -0,0 +1,118 @@
+//
+//  SpatialHashBenchmark.cpp
+//  EARenderer
+//
+//  Created by Pavlo Muratov on 17.10.2026.
+//  Copyright © 2026 MPO. All rights reserved.
+//
+
+// Fills SpatialHash and CompactSpatialHash with the same random points, checks that they return
+// the same neighbourhoods and prints insertion time and neighbourhood query throughput of both.
+//
+//   SpatialHashBenchmark [--objects <count>] [--resolution <cells per axis>] [--queries <count>] [--repetitions <count>]
+
+#include "SpatialHash.hpp"
+#include "CompactSpatialHash.hpp"
+#include "TestUtils.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <random>
+
+using namespace EARenderer;
+
+namespace {
+
+    double MillisecondsSince(std::chrono::steady_clock::time_point start) {
+        return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+    }
+
+    template<class Hash>
+    std::vector<uint32_t> SortedNeighbours(Hash &hash, const glm::vec3 &position) {
+        std::vector<uint32_t> neighbours;
+        for (uint32_t object : hash.neighbours(position)) {
+            neighbours.push_back(object);
+        }
+        std::sort(neighbours.begin(), neighbours.end());
+        return neighbours;
+    }
+
+    /**
+     @return query time in ns, the sum of visited objects goes to the checksum so that queries can't be optimized out
+     */
+    template<class Hash>
+    double QueryTime(Hash &hash, const std::vector<glm::vec3> &queries, uint64_t &checksum) {
+        auto start = std::chrono::steady_clock::now();
+        for (const glm::vec3 &position : queries) {
+            for (uint32_t object : hash.neighbours(position)) {
+                checksum += object;
+            }
+        }
+        return MillisecondsSince(start) * 1e6 / queries.size();
+    }
+
+}
+
+int main(int argc, const char *argv[]) {
+    size_t objectCount = TestUtils::IntegerOption(argc, argv, "--objects", 1000000);
+    uint32_t resolution = uint32_t(TestUtils::IntegerOption(argc, argv, "--resolution", 100));
+    size_t queryCount = TestUtils::IntegerOption(argc, argv, "--queries", 1000000);
+    size_t repetitionCount = TestUtils::IntegerOption(argc, argv, "--repetitions", 3);
+
+    AxisAlignedBox3D boundaries(glm::vec3(-1.0f), glm::vec3(1.0f));
+
+    std::mt19937 engine(42);
+    std::uniform_real_distribution<float> coordinate(-1.0f, 1.0f);
+
+    auto randomPoints = [&](size_t count) {
+        std::vector<glm::vec3> points;
+        for (size_t i = 0; i < count; i++) {
+            points.emplace_back(coordinate(engine), coordinate(engine), coordinate(engine));
+        }
+        return points;
+    };
+
+    std::vector<glm::vec3> positions = randomPoints(objectCount);
+    std::vector<glm::vec3> queries = randomPoints(queryCount);
+
+    double spatialHashInsert = 1e9, compactHashInsert = 1e9;
+    double spatialHashQuery = 1e9, compactHashQuery = 1e9;
+
+    for (size_t repetition = 0; repetition < repetitionCount; repetition++) {
+        auto start = std::chrono::steady_clock::now();
+        SpatialHash<uint32_t> spatialHash(boundaries, resolution);
+        for (size_t i = 0; i < positions.size(); i++) {
+            spatialHash.insert(uint32_t(i), positions[i]);
+        }
+        spatialHashInsert = std::min(spatialHashInsert, MillisecondsSince(start));
+
+        start = std::chrono::steady_clock::now();
+        CompactSpatialHash<uint32_t> compactHash(boundaries, resolution);
+        for (size_t i = 0; i < positions.size(); i++) {
+            compactHash.insert(uint32_t(i), positions[i]);
+        }
+        compactHashInsert = std::min(compactHashInsert, MillisecondsSince(start));
+
+        uint64_t spatialHashChecksum = 0;
+        uint64_t compactHashChecksum = 0;
+        spatialHashQuery = std::min(spatialHashQuery, QueryTime(spatialHash, queries, spatialHashChecksum));
+        compactHashQuery = std::min(compactHashQuery, QueryTime(compactHash, queries, compactHashChecksum));
+
+        EXPECT(spatialHashChecksum == compactHashChecksum, "Neighbourhoods of all queries add up to %llu and %llu",
+                (unsigned long long) spatialHashChecksum, (unsigned long long) compactHashChecksum);
+
+        if (repetition == 0) {
+            size_t checkedCount = std::min<size_t>(queries.size(), 10000);
+            for (size_t i = 0; i < checkedCount; i++) {
+                EXPECT(SortedNeighbours(spatialHash, queries[i]) == SortedNeighbours(compactHash, queries[i]),
+                        "Hashes returned different neighbours for query %zu", i);
+            }
+        }
+    }
+
+    printf("%zu objects, %u cells per axis\n", objectCount, resolution);
+    printf("SpatialHash: insert %.1f ms, neighbourhood query %.0f ns\n", spatialHashInsert, spatialHashQuery);
+    printf("CompactSpatialHash: insert %.1f ms, neighbourhood query %.0f ns\n", compactHashInsert, compactHashQuery);
+
+    return TestUtils::ExitCode();
+}
@@ -0,0 +1,76 @@
+//
+//  TestUtils.hpp
+//  EARenderer
+//
+//  Created by Pavlo Muratov on 17.10.2026.
+//  Copyright © 2026 MPO. All rights reserved.
+//
+
+#ifndef TestUtils_hpp
+#define TestUtils_hpp
+
+#include <atomic>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+
+// Stress tests and benchmarks are plain executables run by CTest, a nonzero exit code marks a failure.
+
+namespace EARenderer {
+    namespace TestUtils {
+
+        inline std::atomic<size_t> &FailureCount() {
+            static std::atomic<size_t> count{0};
+            return count;
+        }
+
+        inline int ExitCode() {
+            size_t failureCount = FailureCount().load();
+            if (failureCount > 0) {
+                fprintf(stderr, "%zu checks failed\n", failureCount);
+                return EXIT_FAILURE;
+            }
+            return EXIT_SUCCESS;
+        }
+
+        /**
+         @return value following the option on the command line or the fallback if the option is missing
+         */
+        inline size_t IntegerOption(int argc, const char *argv[], const char *option, size_t fallback) {
+            for (int i = 1; i + 1 < argc; i++) {
+                if (strcmp(argv[i], option) == 0) {
+                    return strtoull(argv[i + 1], nullptr, 10);
+                }
+            }
+            return fallback;
+        }
+
+        inline bool FlagOption(int argc, const char *argv[], const char *option) {
+            for (int i = 1; i < argc; i++) {
+                if (strcmp(argv[i], option) == 0) {
+                    return true;
+                }
+            }
+            return false;
+        }
+
+    }
+}
+
+/**
+ Reports a failed check without aborting, so that a single run shows every broken invariant.
+ Thread safe. Only the first few failures are printed.
+ */
+#define EXPECT(condition, ...) \
+    do { \
+        if (!(condition)) { \
+            if (EARenderer::TestUtils::FailureCount().fetch_add(1) < 16) { \
+                fprintf(stderr, "%s:%d: ", __FILE__, __LINE__); \
+                fprintf(stderr, __VA_ARGS__); \
+                fprintf(stderr, "\n"); \
+            } \
+        } \
+    } while (false)
+
+#endif /* TestUtils_hpp */
@@ -0,0 +1,211 @@
+//
+//  ThreadPoolStressTest.cpp
+//  EARenderer
+//
+//  Created by Pavlo Muratov on 17.10.2026.
+//  Copyright © 2026 MPO. All rights reserved.
+//
+
+// Hammers the work stealing scheduler with nested fork/join calls from workers and outside threads
+// and compares every result with a single threaded computation.
+//
+//   ThreadPoolStressTest [--iterations <count>]
+
+#include "ThreadPool.hpp"
+#include "TaskGroup.hpp"
+#include "TestUtils.hpp"
+
+#include <atomic>
+#include <numeric>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace EARenderer;
+
+static void TestParallelFor(ThreadPool &pool) {
+    constexpr size_t Count = 100000;
+
+    for (size_t grainSize : {size_t(0), size_t(1), size_t(7), size_t(1000), Count}) {
+        std::vector<std::atomic<uint32_t>> hits(Count);
+        for (auto &hit : hits) {
+            hit.store(0, std::memory_order_relaxed);
+        }
+
+        pool.parallelFor(0, Count, grainSize, [&](size_t begin, size_t end) {
+            for (size_t i = begin; i < end; i++) {
+                hits[i].fetch_add(1, std::memory_order_relaxed);
+            }
+        });
+
+        for (size_t i = 0; i < Count; i++) {
+            EXPECT(hits[i].load() == 1, "parallelFor visited index %zu %u times with grain size %zu", i, hits[i].load(), grainSize);
+        }
+    }
+}
+
+static void TestNestedParallelFor(ThreadPool &pool) {
+    constexpr size_t Outer = 64;
+    constexpr size_t Inner = 2000;
+
+    std::vector<uint64_t> sums(Outer, 0);
+
+    pool.parallelFor(0, Outer, 1, [&](size_t begin, size_t end) {
+        for (size_t i = begin; i < end; i++) {
+            sums[i] = pool.parallelReduce(0, Inner, 16, uint64_t(0), [&](size_t b, size_t e) {
+                uint64_t sum = 0;
+                for (size_t j = b; j < e; j++) {
+                    sum += i * Inner + j;
+                }
+                return sum;
+            }, [](uint64_t a, uint64_t b) {
+                return a + b;
+            });
+        }
+    });
+
+    for (size_t i = 0; i < Outer; i++) {
+        uint64_t expected = 0;
+        for (size_t j = 0; j < Inner; j++) {
+            expected += i * Inner + j;
+        }
+        EXPECT(sums[i] == expected, "Nested reduction %zu is %llu instead of %llu", i, (unsigned long long) sums[i], (unsigned long long) expected);
+    }
+}
+
+static void TestReductionOrder(ThreadPool &pool) {
+    constexpr size_t Count = 5000;
+
+    // Concatenation isn't commutative, so any reordering of chunks changes the result
+    std::string expected;
+    for (size_t i = 0; i < Count; i++) {
+        expected += char('a' + i % 26);
+    }
+
+    std::string result = pool.parallelReduce(0, Count, 3, std::string(), [](size_t begin, size_t end) {
+        std::string chunk;
+        for (size_t i = begin; i < end; i++) {
+            chunk += char('a' + i % 26);
+        }
+        return chunk;
+    }, [](std::string a, std::string b) {
+        return a + b;
+    });
+
+    EXPECT(result == expected, "parallelReduce combined chunks out of order");
+}
+
+static void TestExceptions(ThreadPool &pool) {
+    bool hasThrown = false;
+    std::atomic<size_t> visitedCount{0};
+
+    try {
+        pool.parallelFor(0, 10000, 10, [&](size_t begin, size_t end) {
+            visitedCount += end - begin;
+            if (begin <= 5000 && 5000 < end) {
+                throw std::runtime_error("Chunk failure");
+            }
+        });
+    } catch (const std::runtime_error &) {
+        hasThrown = true;
+    }
+
+    EXPECT(hasThrown, "Exception thrown by a parallelFor chunk wasn't rethrown");
+
+    TaskGroup group(pool);
+    for (size_t i = 0; i < 100; i++) {
+        group.run([i] {
+            if (i == 50) {
+                throw std::logic_error("Task failure");
+            }
+        });
+    }
+
+    hasThrown = false;
+    try {
+        group.wait();
+    } catch (const std::logic_error &) {
+        hasThrown = true;
+    }
+
+    EXPECT(hasThrown, "Exception thrown by a TaskGroup task wasn't rethrown");
+}
+
+static void TestTaskGroups(ThreadPool &pool) {
+    constexpr size_t GroupCount = 32;
+    constexpr size_t TasksPerGroup = 256;
+
+    std::atomic<size_t> counter{0};
+
+    TaskGroup outerGroup(pool);
+    for (size_t i = 0; i < GroupCount; i++) {
+        outerGroup.run([&] {
+            TaskGroup innerGroup(pool);
+            for (size_t j = 0; j < TasksPerGroup; j++) {
+                innerGroup.run([&] {
+                    counter.fetch_add(1, std::memory_order_relaxed);
+                });
+            }
+            innerGroup.wait();
+        });
+    }
+    outerGroup.wait();
+
+    EXPECT(counter.load() == GroupCount * TasksPerGroup, "TaskGroups ran %zu tasks instead of %zu", counter.load(), GroupCount * TasksPerGroup);
+}
+
+static void TestExternalThreads(ThreadPool &pool) {
+    // More callers than external deques, so some of them run their work inline
+    constexpr size_t ThreadCount = 12;
+    constexpr size_t Count = 20000;
+
+    std::vector<uint64_t> sums(ThreadCount, 0);
+    std::vector<std::thread> threads;
+
+    for (size_t t = 0; t < ThreadCount; t++) {
+        threads.emplace_back([&, t] {
+            for (size_t repetition = 0; repetition < 10; repetition++) {
+                sums[t] = pool.parallelReduce(0, Count, 0, uint64_t(0), [&](size_t begin, size_t end) {
+                    uint64_t sum = 0;
+                    for (size_t i = begin; i < end; i++) {
+                        sum += i * (t + 1);
+                    }
+                    return sum;
+                }, [](uint64_t a, uint64_t b) {
+                    return a + b;
+                });
+            }
+        });
+    }
+
+    for (auto &thread : threads) {
+        thread.join();
+    }
+
+    for (size_t t = 0; t < ThreadCount; t++) {
+        uint64_t expected = uint64_t(Count) * (Count - 1) / 2 * (t + 1);
+        EXPECT(sums[t] == expected, "External thread %zu reduced to %llu instead of %llu", t, (unsigned long long) sums[t], (unsigned long long) expected);
+    }
+}
+
+int main(int argc, const char *argv[]) {
+    size_t iterationCount = TestUtils::IntegerOption(argc, argv, "--iterations", 20);
+
+    for (uint32_t threadCount : {1u, 2u, std::max(std::thread::hardware_concurrency(), 4u)}) {
+        ThreadPool pool(threadCount);
+
+        for (size_t i = 0; i < iterationCount; i++) {
+            TestParallelFor(pool);
+            TestNestedParallelFor(pool);
+            TestReductionOrder(pool);
+            TestExceptions(pool);
+            TestTaskGroups(pool);
+            TestExternalThreads(pool);
+        }
+
+        printf("%u worker threads: %zu iterations passed\n", threadCount, iterationCount);
+    }
+
+    return TestUtils::ExitCode();
+}
@@ -142,6 +142,16 @@
     pointLight1.meshInstance->transformation().scale = glm::vec3(0.002);
     scene->pointLights().insert(pointLight1);
 
+    // Dim unshadowed fill lights, shaded in a single clustered pass
+    EARenderer::PointLight::Attenuation fillLightAttenuation{1.0, 0.0, 16.0};
+    for (int i = 0; i < 16; i++) {
+        float angle = float(i) / 16.0f * 2.0f * M_PI;
+        EARenderer::Color color(0.3 + 0.3 * std::sin(angle), 0.3, 0.3 + 0.3 * std::cos(angle));
+        EARenderer::PointLight fillLight(glm::vec3(2.0 * std::cos(angle), -0.4, 2.0 * std::sin(angle)), color, 1.5, 0.1, 1.0, 0.0, fillLightAttenuation);
+        fillLight.setCastsShadows(false);
+        scene->pointLights().insert(fillLight);
+    }
+
     NSString *hdrSkyboxPath = [[NSBundle mainBundle] pathForResource:@"sunset" ofType:@"hdr"];
     scene->setSkybox(std::make_unique<EARenderer::Skybox>(std::string(hdrSkyboxPath.UTF8String), 0.6));
 
@@ -25,15 +25,18 @@
 #import "SceneInteractor.hpp"
 #import "Cameraman.hpp"
 #import "FileManager.hpp"
-#import "SurfelGenerator.hpp"
+#import "SceneBaker.hpp"
 #import "TriangleRenderer.hpp"
 #import "BoxRenderer.hpp"
 #import "Measurement.hpp"
-#import "DiffuseLightProbeGenerator.hpp"
 #import "DiffuseLightProbeRenderer.hpp"
 #import "LogUtils.hpp"
+#import "TextureLoader.hpp"
+#import "GLStateStatistics.hpp"
+#import "Profiler.hpp"
 
 static float const FrequentEventsThrottleCooldownMS = 100;
+static float const GLStateStatisticsLogCooldownMS = 5000;
 
 @interface MainViewController () <SceneGLViewDelegate, MeshListTabViewItemDelegate, SettingsTabViewItemDelegate>
 
@@ -59,6 +62,8 @@ static float const FrequentEventsThrottleCooldownMS = 100;
     std::unique_ptr<EARenderer::Cameraman> cameraman;
     std::unique_ptr<EARenderer::FrameMeter> frameMeter;
     std::unique_ptr<EARenderer::Throttle> frequentEventsThrottle;
+    std::unique_ptr<EARenderer::Throttle> glStateStatisticsThrottle;
+    BOOL glStateStatisticsLoggingEnabled;
     std::unique_ptr<EARenderer::SurfelRenderer> surfelRenderer;
     std::unique_ptr<EARenderer::DiffuseLightProbeRenderer> probeRenderer;
     std::unique_ptr<EARenderer::TriangleRenderer> triangleRenderer;
@@ -89,6 +94,7 @@ static float const FrequentEventsThrottleCooldownMS = 100;
     self->defaultRenderComponentsProvider = std::make_unique<DefaultRenderComponentsProvider>(&EARenderer::GLViewport::Main());
     self->frameMeter = std::make_unique<EARenderer::FrameMeter>();
     self->frequentEventsThrottle = std::make_unique<EARenderer::Throttle>(FrequentEventsThrottleCooldownMS);
+    self->glStateStatisticsThrottle = std::make_unique<EARenderer::Throttle>(GLStateStatisticsLogCooldownMS);
 
     auto camera = std::make_unique<EARenderer::Camera>(100.f, 0.05f, 25.f);
     self->cameraman = std::make_unique<EARenderer::Cameraman>(camera.get(), &EARenderer::Input::shared(), &EARenderer::GLViewport::Main());
@@ -98,25 +104,22 @@ static float const FrequentEventsThrottleCooldownMS = 100;
     self.demoScene = [[DemoScene1 alloc] init];
     [self.demoScene loadResourcesToPool:self->sharedResourceStorage.get() andComposeScene:self->scene.get()];
 
-    EARenderer::SurfelGenerator surfelGenerator(self->sharedResourceStorage.get(), self->scene.get());
-    self->surfelData = std::make_unique<EARenderer::SurfelData>();
-    std::string surfelStorageFileName = "surfels_" + self->scene->name();
-
-    NSLog(@"Loading/generating surfels");
-    if (!self->surfelData->deserialize(surfelStorageFileName)) {
-        self->surfelData = surfelGenerator.generateStaticGeometrySurfels();
-        self->surfelData->serialize(surfelStorageFileName);
-    }
-
-    EARenderer::DiffuseLightProbeGenerator lightProbeGenerator;
-    self->diffuseProbeData = std::make_unique<EARenderer::DiffuseLightProbeData>();
-    std::string probeStorageFileName = "diffuse_light_probes_" + self->scene->name();
+    self->sharedResourceStorage->iterateMeshes([&](EARenderer::ID meshID) {
+        const EARenderer::Mesh &mesh = self->sharedResourceStorage->mesh(meshID);
+        const auto &statistics = mesh.indexingStatistics();
+        NSLog(@"Mesh '%s': %zu -> %zu vertices, %.1f -> %.1f KB, ACMR %.2f -> %.2f",
+                mesh.name().c_str(),
+                statistics.sourceVertexCount, statistics.vertexCount,
+                statistics.sourceByteSize() / 1024.0, statistics.byteSize() / 1024.0,
+                statistics.sourceAverageCacheMissRatio, statistics.averageCacheMissRatio);
+    });
 
-    NSLog(@"Loading/generating probes");
-    if (!self->diffuseProbeData->deserialize(probeStorageFileName)) {
-        self->diffuseProbeData = lightProbeGenerator.generateProbes(*self->scene, *self->surfelData);
-        self->diffuseProbeData->serialize(probeStorageFileName);
-    }
+    NSLog(@"Loading/generating surfels and probes");
+    EARenderer::SceneBaker baker(self->sharedResourceStorage.get(), self->scene.get());
+    EARenderer::SceneBaker::Result bakeResult = baker.bake();
+    self->surfelData = std::move(bakeResult.surfelData);
+    self->diffuseProbeData = std::move(bakeResult.diffuseProbeData);
+    NSLog(@"%s", baker.report().description().c_str());
 
     self->triangleRenderer = std::make_unique<EARenderer::TriangleRenderer>(
             self->scene.get(), self->sharedResourceStorage.get(), self->gpuResourceController.get()
@@ -154,6 +157,10 @@ static float const FrequentEventsThrottleCooldownMS = 100;
 }
 
 - (void)glViewIsReadyToRenderFrame:(SceneGLView *)view {
+    EARenderer::Profiler::Shared().beginFrame();
+
+    // Materials are rendered with placeholders until their maps are decoded
+    EARenderer::TextureLoader::Shared().processCompletedLoads();
     self->cameraman->updateCamera();
     self->sceneGBufferRenderer->render();
     self->gpuResourceController->updateUniformBuffer(*self->sharedResourceStorage, *self->scene);
@@ -178,6 +185,15 @@ static float const FrequentEventsThrottleCooldownMS = 100;
 
     self->axesRenderer->render();
 
+    // Redundant state change counters of the finished frame stay available until the next one ends
+    EARenderer::GLStateStatistics::Shared().finishFrame();
+    if (self->glStateStatisticsLoggingEnabled) {
+        self->glStateStatisticsThrottle->attemptToPerformAction([]() {
+            NSLog(@"GL state changes of the last frame:\n%s", EARenderer::GLStateStatistics::Shared().previousFrame().description().c_str());
+        });
+    }
+    EARenderer::Profiler::Shared().endFrame();
+
     auto frameCharacteristics = self->frameMeter->tick();
     self.fpsView.frameCharacteristics = frameCharacteristics;
     self.fpsView.viewportResolution = view.bounds.size;
@@ -284,6 +300,23 @@ static float const FrequentEventsThrottleCooldownMS = 100;
     self->sceneInteractor->allObjectsDeselectionEvent() += {"Main.controller.deselect.all", [self]() {
         [self.sceneObjectsTabView.meshesTab deselectAll];
     }};
+
+    EARenderer::Input::shared().keyboardEvent()[EARenderer::Input::KeyboardAction::KeyDown] += {"Main.controller.profiler.capture", [](const EARenderer::Input *input) {
+        if (!input->isKeyPressed(EARenderer::Input::Key::P)) {
+            return;
+        }
+        NSString *tracePath = [NSTemporaryDirectory() stringByAppendingPathComponent:@"EARenderer.trace.json"];
+        NSLog(@"Capturing profiler trace to %@", tracePath);
+        EARenderer::Profiler::Shared().captureTrace(tracePath.UTF8String, 60);
+    }};
+
+    EARenderer::Input::shared().keyboardEvent()[EARenderer::Input::KeyboardAction::KeyDown] += {"Main.controller.gl.statistics.toggle", [self](const EARenderer::Input *input) {
+        if (!input->isKeyPressed(EARenderer::Input::Key::G)) {
+            return;
+        }
+        self->glStateStatisticsLoggingEnabled = !self->glStateStatisticsLoggingEnabled;
+        NSLog(@"GL state change logging %@", self->glStateStatisticsLoggingEnabled ? @"enabled" : @"disabled");
+    }};
 }
 
 - (std::string)resourceDirectory {